@@ -141,6 +141,7 @@ mkdir -p "$(dirname "${EDITOR_LOG}")"
     -resy=720 \
     -log \
     -RCWebControlEnable \
+    -PlayUnreal \
     -ExecCmds="WebControl.EnableServerOnStartup 1" \
     > "${EDITOR_LOG}" 2>&1 &
 EDITOR_PID=$!
@@ -135,6 +135,7 @@ if [ "${SKIP_LAUNCH}" = false ]; then
         -resy=720 \
         -log \
         -RCWebControlEnable \
+        -PlayUnreal \
         -ExecCmds="WebControl.EnableServerOnStartup 1" \
         > "${EDITOR_LOG}" 2>&1 &
     EDITOR_PID=$!
@@ -23,6 +23,8 @@
 #   ./ci/run-ci.sh --skip-ue-tests         # Skip NullRHI automation tests
 #   ./ci/run-ci.sh --game-only             # Skip build + UE tests, just run game tests
 #   ./ci/run-ci.sh --timeout 180           # Custom startup timeout (seconds)
+#   ./ci/run-ci.sh --headless              # Launch the game with -nullrhi (no GPU; screenshots skipped)
+#   ./ci/run-ci.sh --offscreen             # Launch with -RenderOffScreen (GPU, no window)
 #
 # Environment variables:
 #   UE_ENGINE_DIR   — Path to UE installation (default: auto-detect)
@@ -105,6 +107,7 @@ SKIP_BUILD=false
 SKIP_UE_TESTS=false
 GAME_ONLY=false
 STARTUP_TIMEOUT=120
+RENDER_FLAGS=(-windowed -resx=1280 -resy=720)
 
 while [[ $# -gt 0 ]]; do
     case "$1" in
@@ -112,6 +115,8 @@ while [[ $# -gt 0 ]]; do
         --skip-ue-tests)  SKIP_UE_TESTS=true; shift ;;
         --game-only)      GAME_ONLY=true; SKIP_BUILD=true; SKIP_UE_TESTS=true; shift ;;
         --timeout)        STARTUP_TIMEOUT="$2"; shift 2 ;;
+        --headless)       RENDER_FLAGS=(-nullrhi -unattended); shift ;;
+        --offscreen)      RENDER_FLAGS=(-RenderOffScreen -resx=1280 -resy=720 -unattended); shift ;;
         *)                echo "Unknown argument: $1"; exit 2 ;;
     esac
 done
@@ -288,18 +293,17 @@ fi
 EDITOR_LOG="${LOG_DIR}/editor_${TIMESTAMP}.log"
 
 echo "  Launching: ${EDITOR_APP}"
-echo "  Flags: -game -windowed -resx=1280 -resy=720 -RCWebControlEnable"
+echo "  Flags: -game ${RENDER_FLAGS[*]} -RCWebControlEnable -PlayUnreal"
 echo "  Log: ${EDITOR_LOG}"
 
 "${EDITOR_APP}" \
     "${PROJECT_FILE}" \
     -game \
-    -windowed \
-    -resx=1280 \
-    -resy=720 \
+    "${RENDER_FLAGS[@]}" \
     -log \
     -nosound \
     -RCWebControlEnable \
+    -PlayUnreal \
     -ExecCmds="WebControl.EnableServerOnStartup 1" \
     > "${EDITOR_LOG}" 2>&1 &
 EDITOR_PID=$!
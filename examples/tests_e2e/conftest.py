@@ -61,3 +61,23 @@ def screenshot_dir(tmp_path):
     d = tmp_path / "screenshots"
     d.mkdir()
     return d
+
+
+@pytest.fixture(scope="session")
+def driver(pu):
+    """The session client, for tests that need an APlayUnrealDriver.
+
+    Skips when no driver is in the level.
+    """
+    if pu.render_mode() is None:
+        pytest.skip("No APlayUnrealDriver in the level")
+    return pu
+
+
+@pytest.fixture
+def gm_path(pu):
+    """Object path of the running GameMode."""
+    paths = pu.resolve_objects(["UnrealFrogGameMode"]).get("UnrealFrogGameMode")
+    if not paths:
+        pytest.skip("No UnrealFrogGameMode in play")
+    return paths[0]
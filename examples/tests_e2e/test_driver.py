@@ -0,0 +1,79 @@
+"""E2E tests: driver batches, watch sets and session replay."""
+
+import time
+
+import pytest
+
+from playunreal import PlayUnrealError
+
+
+def test_batch_runs_in_order(driver, playing_game):
+    """execute_batch() returns one result per command, in order."""
+    resp = driver.execute_batch([("Ping", {}), ("ElementExists", {"Id": "NoSuchWidget"})])
+    results = driver.get_batch_results(resp["batch"]) if not resp["complete"] else resp
+    assert [r["method"] for r in results["results"]] == ["Ping", "ElementExists"]
+    assert results["results"][0]["ok"] is True
+    # A false return counts as a failure.
+    assert results["results"][1]["ok"] is False
+
+
+def test_batch_defers_framed_commands(driver, playing_game):
+    """Commands with a frame offset run on later frames."""
+    resp = driver.execute_batch([
+        {"method": "Ping"},
+        {"method": "Ping", "frame": 3},
+    ])
+    assert resp["complete"] is False
+    results = driver.get_batch_results(resp["batch"])["results"]
+    assert len(results) == 2
+    assert results[0]["frame"] == 0
+    assert results[1]["frame"] >= 3
+
+
+def test_batch_stop_on_error_skips_the_rest(driver, playing_game):
+    """With stop_on_error, commands after a failure do not run."""
+    resp = driver.execute_batch([
+        ("ElementExists", {"Id": "NoSuchWidget"}),
+        ("Ping", {}),
+    ], stop_on_error=True)
+    results = driver.get_batch_results(resp["batch"]) if not resp["complete"] else resp
+    assert len(results["results"]) == 1
+    assert results["results"][0]["ok"] is False
+
+
+def test_watch_set_reports_changes(driver, playing_game, gm_path):
+    """A watch set returns every value, then only the ones that changed."""
+    watch, values = driver.watch_properties([(gm_path, "RemainingTime")])
+    try:
+        assert "RemainingTime" in values
+        driver.watched_values(watch, changes_only=True)  # prime the baseline
+        time.sleep(1.5)
+        changed = driver.watched_values(watch, changes_only=True)
+        assert "RemainingTime" in changed, "Timer change not reported"
+        assert changed["RemainingTime"] != values["RemainingTime"]
+    finally:
+        assert driver.unwatch_properties(watch)
+
+
+def test_unwatched_set_is_gone(driver, playing_game, gm_path):
+    """Reading a removed watch set fails."""
+    watch, _ = driver.watch_properties([{"key": "wave", "object": gm_path,
+                                        "property": "CurrentWave"}])
+    assert driver.unwatch_properties(watch)
+    with pytest.raises(PlayUnrealError):
+        driver.watched_values(watch)
+
+
+def test_recorded_session_replays_cleanly(driver, playing_game):
+    """A recorded session replays in the engine without mismatches."""
+    driver.start_recording("PlayUnreal/Sessions/e2e-replay.pulog")
+    try:
+        driver.element_exists("NoSuchWidget")
+        driver.query_widgets("UserWidget", limit=1)
+    finally:
+        log = driver.stop_recording()
+    assert log["commands"] >= 2
+
+    report = driver.replay_session(log["path"], timeout=60)
+    assert report["commands"] == log["commands"]
+    assert report["mismatchCount"] == 0, report["mismatches"]
@@ -0,0 +1,49 @@
+"""E2E tests: widget selectors."""
+
+import pytest
+
+from playunreal import PlayUnrealError
+
+
+def test_class_selector_matches_subclasses(driver, playing_game):
+    """"Widget" matches every widget, "UserWidget" only the roots and nested user widgets."""
+    widgets = driver.query_widgets("Widget")
+    roots = driver.query_widgets("UserWidget")
+    assert len(widgets) >= len(roots)
+    for widget in widgets:
+        assert {"name", "class", "path", "visible"} <= widget.keys()
+
+
+def test_limit_caps_matches(driver, playing_game):
+    """limit stops the scan after that many matches."""
+    assert len(driver.query_widgets("Widget", limit=1)) <= 1
+
+
+def test_visibility_filters_partition(driver, playing_game):
+    """:visible and :hidden split the matches between them."""
+    everything = driver.query_widgets("Widget")
+    visible = driver.query_widgets("Widget:visible")
+    hidden = driver.query_widgets("Widget:hidden")
+    assert len(visible) + len(hidden) == len(everything)
+    assert all(w["visible"] for w in visible)
+    assert not any(w["visible"] for w in hidden)
+
+
+def test_child_is_a_subset_of_descendant(driver, playing_game):
+    """"A > B" matches no more than "A B"."""
+    children = {w["path"] for w in driver.query_widgets("UserWidget > Widget")}
+    descendants = {w["path"] for w in driver.query_widgets("UserWidget Widget")}
+    assert children <= descendants
+
+
+def test_budgeted_scan_matches_immediate(driver, playing_game):
+    """A budgeted scan finds the same widgets as an immediate one."""
+    immediate = [w["path"] for w in driver.query_widgets("UserWidget")]
+    budgeted = [w["path"] for w in driver.query_widgets("UserWidget", budgeted=True)]
+    assert budgeted == immediate
+
+
+def test_malformed_selector_raises(driver):
+    """A selector that does not parse is reported as an error."""
+    with pytest.raises(PlayUnrealError):
+        driver.query_widgets("Button[text=")
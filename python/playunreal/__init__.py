@@ -13,13 +13,13 @@ Quick start::
     state = pu.get_state()
     print(state)
 
-For async usage (planned)::
+For asyncio, with pooled and pipelined calls::
 
-    from playunreal import Unreal
+    from playunreal import AsyncPlayUnreal
 
-    async with Unreal.launch(uproject="MyGame.uproject") as ue:
-        page = ue.page()
-        await page.screenshot("artifacts/screenshot.png")
+    async with AsyncPlayUnreal() as pu:
+        await pu.click("StartButton")
+        await pu.wait_frames(2)
 """
 
 __version__ = "0.1.0"
@@ -30,10 +30,18 @@ from playunreal.client import (
     RCConnectionError,
     CallError,
 )
+from playunreal.aio import AsyncPlayUnreal
+from playunreal.frames import FrameChannelError, FrameReader
+from playunreal.stream import StateStream, StreamError
 
 __all__ = [
     "PlayUnreal",
     "PlayUnrealError",
     "RCConnectionError",
     "CallError",
+    "AsyncPlayUnreal",
+    "StateStream",
+    "StreamError",
+    "FrameReader",
+    "FrameChannelError",
 ]
@@ -0,0 +1,971 @@
+"""PlayUnreal asyncio client — concurrent driver calls on kept-open connections.
+
+``AsyncPlayUnreal`` is the asyncio counterpart of ``PlayUnreal`` for test
+harnesses that issue many calls at once. It keeps its connections open:
+
+- the plugin's TCP transport when it is reachable. One connection carries
+  any number of in-flight calls, matched to their replies by request ID,
+  so ``asyncio.gather()`` over many calls costs about one engine tick;
+- otherwise a pool of keep-alive HTTP/1.1 connections to Remote Control.
+  HTTP/1.1 cannot overlap requests on one connection, so up to
+  ``pool_size`` calls run at once and the rest queue for a free
+  connection. When Ping advertises ``msgpack`` and the msgpack package is
+  installed, driver responses come back as MessagePack.
+
+Waits are tied to the engine's push events: over TCP the reply to
+``WaitForFrames`` and friends arrives on completion, and over Remote
+Control the state stream's ``completed`` push ends them. Both fall back to
+polling. ``subscribe()`` exposes the stream's ``changed`` pushes.
+
+Usage::
+
+    import asyncio
+    from playunreal.aio import AsyncPlayUnreal
+
+    async def main():
+        async with AsyncPlayUnreal() as pu:
+            hud, start = await asyncio.gather(
+                pu.element_exists("HUD"), pu.element_exists("StartButton"))
+            await pu.click("StartButton")
+            await pu.wait_frames(2)
+            async with await pu.subscribe([
+                    {"key": "wave", "object": gm_path, "property": "CurrentWave"}]) as sub:
+                print(await sub.next(timeout=30))
+
+    asyncio.run(main())
+"""
+
+import asyncio
+import base64
+import hashlib
+import json
+import os
+import socket
+import struct
+
+from playunreal.client import (
+    CallError,
+    PlayUnrealError,
+    RCConnectionError,
+    _STATICS_PATH,
+    _json_value,
+)
+from playunreal.stream import (
+    DEFAULT_STREAM_PORT,
+    StreamError,
+    _OP_BINARY,
+    _OP_CLOSE,
+    _OP_CONTINUATION,
+    _OP_PING,
+    _OP_PONG,
+    _OP_TEXT,
+    _WS_GUID,
+)
+from playunreal.transport import DEFAULT_TCP_PORT, TransportError
+from playunreal.wire import FAST_MSGPACK, decode_response
+
+
+def _tcp_result(reply):
+    """A TCP reply's result, decoded like a Remote Control return value."""
+    result = reply.get("result")
+    if isinstance(result, str) and result.startswith(("{", "[")):
+        try:
+            return json.loads(result)
+        except json.JSONDecodeError:
+            pass
+    return {} if result in (None, "") else result
+
+
+class AsyncTcpTransport:
+    """asyncio client for the plugin's TCP call transport.
+
+    Requests are written as soon as they are made and a single reader task
+    resolves each one's future when its reply arrives, in whatever order
+    the engine answers.
+
+    Args:
+        host: Server host (default localhost; the plugin only binds loopback)
+        port: Server port (default 30041)
+        timeout: Connect timeout in seconds (default 5)
+    """
+
+    def __init__(self, host="localhost", port=DEFAULT_TCP_PORT, timeout=5):
+        self.host = host
+        self.port = port
+        self.timeout = timeout
+        self._reader = None
+        self._writer = None
+        self._read_task = None
+        self._next_id = 1
+        self._pending = {}
+
+    async def connect(self):
+        """Open the connection.
+
+        Raises:
+            TransportError: If the server is not reachable.
+        """
+        try:
+            self._reader, self._writer = await asyncio.wait_for(
+                asyncio.open_connection(self.host, self.port), self.timeout)
+        except (OSError, asyncio.TimeoutError) as e:
+            raise TransportError(
+                f"Cannot reach PlayUnreal TCP transport at "
+                f"{self.host}:{self.port}: {e}")
+        sock = self._writer.get_extra_info("socket")
+        if sock is not None:
+            sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        self._read_task = asyncio.ensure_future(self._read_loop())
+
+    async def close(self):
+        """Close the connection, failing calls still in flight."""
+        if self._writer is None:
+            return
+        writer, self._writer = self._writer, None
+        self._read_task.cancel()
+        writer.close()
+        try:
+            await writer.wait_closed()
+        except OSError:
+            pass
+        self._fail_pending(TransportError("TCP transport closed"))
+
+    @property
+    def connected(self):
+        return self._writer is not None
+
+    async def call(self, method, params=None, timeout=None, await_result=True):
+        """Call a driver method and wait for its reply.
+
+        Args:
+            method: Driver method name
+            params: Parameters by name
+            timeout: Seconds the engine keeps an async call open before
+                failing it with "Timed out" (None = no limit)
+            await_result: For calls that start an async operation, reply
+                with its outcome (default) rather than the bare handle
+
+        Returns:
+            The reply dict: {"id", "ok", "result"} or {"id", "ok", "error"}
+        """
+        message = {"method": method, "params": params or {}}
+        if timeout is not None:
+            message["timeout"] = timeout
+        if not await_result:
+            message["await"] = False
+        return await self._request(message)
+
+    async def cancel(self, request_id):
+        """Cancel an in-flight async call. Returns True if it was running."""
+        reply = await self._request({"cancel": request_id})
+        return bool(reply.get("ok") and reply.get("result", {}).get("cancelled"))
+
+    async def _request(self, message):
+        if self._writer is None:
+            raise TransportError("TCP transport is not connected")
+        request_id = self._next_id
+        self._next_id += 1
+        message["id"] = request_id
+        future = asyncio.get_running_loop().create_future()
+        self._pending[request_id] = future
+
+        payload = json.dumps(message).encode("utf-8")
+        self._writer.write(struct.pack("<I", len(payload)) + payload)
+        try:
+            await self._writer.drain()
+            return await future
+        finally:
+            self._pending.pop(request_id, None)
+
+    async def _read_loop(self):
+        try:
+            while True:
+                (length,) = struct.unpack("<I", await self._reader.readexactly(4))
+                reply = json.loads(await self._reader.readexactly(length))
+                future = self._pending.get(reply.get("id"))
+                if future is not None and not future.done():
+                    future.set_result(reply)
+        except asyncio.CancelledError:
+            raise
+        except (asyncio.IncompleteReadError, OSError, ValueError) as e:
+            self._writer = None
+            self._fail_pending(TransportError(f"TCP transport lost: {e}"))
+
+    def _fail_pending(self, error):
+        for future in self._pending.values():
+            if not future.done():
+                future.set_exception(error)
+        self._pending.clear()
+
+
+class _HttpConnection:
+    """One persistent HTTP/1.1 connection to Remote Control."""
+
+    def __init__(self, host, port, timeout):
+        self.host = host
+        self.port = port
+        self.timeout = timeout
+        self.reader = None
+        self.writer = None
+
+    async def open(self):
+        self.reader, self.writer = await asyncio.wait_for(
+            asyncio.open_connection(self.host, self.port), self.timeout)
+
+    def close(self):
+        if self.writer is not None:
+            self.writer.close()
+            self.writer = None
+
+    async def put(self, endpoint, body):
+        """PUT a JSON body; returns (status, body bytes, keep-alive)."""
+        request = (
+            f"PUT {endpoint} HTTP/1.1\r\n"
+            f"Host: {self.host}:{self.port}\r\n"
+            f"Content-Type: application/json\r\n"
+            f"Content-Length: {len(body)}\r\n"
+            f"Connection: keep-alive\r\n\r\n"
+        ).encode("ascii") + body
+        self.writer.write(request)
+        await self.writer.drain()
+        return await asyncio.wait_for(self._read_response(), self.timeout)
+
+    async def _read_response(self):
+        status_line = await self.reader.readline()
+        if not status_line:
+            raise ConnectionResetError("Remote Control closed the connection")
+        status = int(status_line.split()[1])
+
+        headers = {}
+        while True:
+            line = await self.reader.readline()
+            if line in (b"\r\n", b"\n", b""):
+                break
+            name, _, value = line.decode("latin-1").partition(":")
+            headers[name.strip().lower()] = value.strip()
+
+        if headers.get("transfer-encoding", "").lower() == "chunked":
+            chunks = []
+            while True:
+                size = int((await self.reader.readline()).split(b";")[0], 16)
+                if size == 0:
+                    await self.reader.readline()
+                    break
+                chunks.append(await self.reader.readexactly(size))
+                await self.reader.readexactly(2)
+            body = b"".join(chunks)
+        else:
+            body = await self.reader.readexactly(int(headers.get("content-length", 0)))
+        return status, body, headers.get("connection", "").lower() != "close"
+
+
+class _HttpPool:
+    """Up to ``size`` keep-alive connections, reused most recent first."""
+
+    def __init__(self, host, port, timeout, size):
+        self.base_url = f"http://{host}:{port}"
+        self._host = host
+        self._port = port
+        self._timeout = timeout
+        self._idle = []
+        self._slots = asyncio.Semaphore(size)
+
+    async def put(self, endpoint, body):
+        """PUT a JSON body and return the decoded JSON response."""
+        data = json.dumps(body).encode("utf-8")
+        async with self._slots:
+            # A kept-alive connection may have been closed by the server in
+            # the meantime. Only that case is retried, once on a fresh
+            # connection: the request never reached the engine. Any other
+            # failure may have run the call, which need not be idempotent.
+            for attempt in range(2):
+                fresh = not self._idle
+                conn = self._idle.pop() if self._idle else \
+                    _HttpConnection(self._host, self._port, self._timeout)
+                try:
+                    if fresh:
+                        await conn.open()
+                    status, resp_body, keep_alive = await conn.put(endpoint, data)
+                except (OSError, asyncio.IncompleteReadError, asyncio.TimeoutError,
+                        ValueError) as e:
+                    conn.close()
+                    if fresh or attempt or not isinstance(
+                            e, (ConnectionResetError, BrokenPipeError)):
+                        raise RCConnectionError(
+                            f"Cannot reach Remote Control API at {self.base_url}. "
+                            f"Is the editor running with -RCWebControlEnable? Error: {e}")
+                    continue
+                if keep_alive:
+                    self._idle.append(conn)
+                else:
+                    conn.close()
+                break
+
+        if status >= 400:
+            raise CallError(
+                f"RC API call failed: {status} on {endpoint}. "
+                f"Body: {resp_body.decode('utf-8', 'replace')}")
+        if not resp_body:
+            return {}
+        try:
+            return json.loads(resp_body)
+        except json.JSONDecodeError:
+            return {"raw": resp_body.decode("utf-8", "replace")}
+
+    def close(self):
+        for conn in self._idle:
+            conn.close()
+        self._idle.clear()
+
+
+class AsyncStateStream:
+    """asyncio client for the plugin's WebSocket state stream.
+
+    A reader task routes ``completed`` pushes to await_handle() callers and
+    ``changed`` pushes to their Subscription.
+
+    Args:
+        host: Stream server host (default localhost)
+        port: Stream server port (default 30040)
+        timeout: Connect timeout in seconds (default 2)
+    """
+
+    def __init__(self, host="localhost", port=DEFAULT_STREAM_PORT, timeout=2):
+        self.host = host
+        self.port = port
+        self.timeout = timeout
+        self._reader = None
+        self._writer = None
+        self._read_task = None
+        self._completed = {}
+        self._handle_waiters = {}
+        self._subscriptions = {}
+        self._next_sub = 1
+
+    async def connect(self):
+        """Open the connection and perform the WebSocket handshake.
+
+        Raises:
+            StreamError: If the server is not reachable.
+        """
+        try:
+            self._reader, self._writer = await asyncio.wait_for(
+                asyncio.open_connection(self.host, self.port), self.timeout)
+            key = base64.b64encode(os.urandom(16)).decode("ascii")
+            self._writer.write((
+                f"GET / HTTP/1.1\r\n"
+                f"Host: {self.host}:{self.port}\r\n"
+                f"Upgrade: websocket\r\n"
+                f"Connection: Upgrade\r\n"
+                f"Sec-WebSocket-Key: {key}\r\n"
+                f"Sec-WebSocket-Version: 13\r\n\r\n"
+            ).encode("ascii"))
+            header = await asyncio.wait_for(
+                self._reader.readuntil(b"\r\n\r\n"), self.timeout)
+        except (OSError, asyncio.TimeoutError, asyncio.IncompleteReadError) as e:
+            self._drop()
+            raise StreamError(
+                f"Cannot reach PlayUnreal stream at {self.host}:{self.port}: {e}")
+
+        expected = base64.b64encode(hashlib.sha1(
+            (key + _WS_GUID).encode("ascii")).digest())
+        if b" 101 " not in header.split(b"\r\n", 1)[0] or expected not in header:
+            self._drop()
+            raise StreamError(f"Unexpected handshake response: {header[:200]!r}")
+        self._read_task = asyncio.ensure_future(self._read_loop())
+
+    async def close(self):
+        """Close the connection."""
+        if self._writer is None:
+            return
+        try:
+            self._send_frame(_OP_CLOSE, b"")
+        except OSError:
+            pass
+        self._read_task.cancel()
+        self._drop()
+
+    @property
+    def connected(self):
+        return self._writer is not None
+
+    async def await_handle(self, handle, timeout=None):
+        """Wait for the ``completed`` push of an async operation.
+
+        Returns:
+            The push: {"op": "completed", "handle", "status", "result" | "error"}
+        """
+        done = self._completed.pop(handle, None)
+        if done is not None:
+            return done
+        future = self._handle_waiters.get(handle)
+        if future is None:
+            future = asyncio.get_running_loop().create_future()
+            self._handle_waiters[handle] = future
+            self.send({"op": "await", "handle": handle})
+        try:
+            return await asyncio.wait_for(asyncio.shield(future), timeout)
+        finally:
+            if future.done():
+                self._handle_waiters.pop(handle, None)
+
+    async def subscribe(self, watches, sub_id=None, timeout=5):
+        """Subscribe to watches; see AsyncPlayUnreal.subscribe()."""
+        if sub_id is None:
+            sub_id = f"aio{self._next_sub}"
+            self._next_sub += 1
+        subscription = Subscription(self, sub_id)
+        self._subscriptions[sub_id] = subscription
+        self.send({"op": "subscribe", "id": sub_id, "watches": watches})
+        try:
+            await asyncio.wait_for(asyncio.shield(subscription._ready), timeout)
+        except asyncio.TimeoutError:
+            self._subscriptions.pop(sub_id, None)
+            raise StreamError(f"No reply to subscription {sub_id!r} after {timeout}s")
+        return subscription
+
+    def unsubscribe(self, sub_id):
+        if self._subscriptions.pop(sub_id, None) is not None and self.connected:
+            self.send({"op": "unsubscribe", "id": sub_id})
+
+    def send(self, message):
+        """Send a JSON message."""
+        self._send_frame(_OP_TEXT, json.dumps(message).encode("utf-8"))
+
+    def _dispatch(self, msg):
+        op = msg.get("op")
+        if op == "completed":
+            future = self._handle_waiters.get(msg.get("handle"))
+            if future is not None and not future.done():
+                future.set_result(msg)
+            else:
+                self._completed[msg.get("handle")] = msg
+            return
+        subscription = self._subscriptions.get(msg.get("id"))
+        if subscription is not None:
+            subscription._apply(msg)
+
+    async def _read_loop(self):
+        error = StreamError("Stream server closed the connection")
+        try:
+            while True:
+                opcode, payload = await self._recv_frame()
+                if opcode in (_OP_TEXT, _OP_BINARY):
+                    try:
+                        self._dispatch(json.loads(payload.decode("utf-8")))
+                    except (UnicodeDecodeError, json.JSONDecodeError):
+                        continue
+                elif opcode == _OP_PING:
+                    self._send_frame(_OP_PONG, payload)
+                elif opcode == _OP_CLOSE:
+                    break
+        except asyncio.CancelledError:
+            raise
+        except (asyncio.IncompleteReadError, OSError) as e:
+            error = StreamError(f"Stream connection lost: {e}")
+        self._drop()
+        for future in self._handle_waiters.values():
+            if not future.done():
+                future.set_exception(error)
+        self._handle_waiters.clear()
+        for subscription in self._subscriptions.values():
+            subscription._close(error)
+
+    def _drop(self):
+        if self._writer is not None:
+            self._writer.close()
+            self._writer = None
+
+    # -- Framing -------------------------------------------------------------
+
+    def _send_frame(self, opcode, payload):
+        if self._writer is None:
+            raise StreamError("Stream is not connected")
+        header = bytes([0x80 | opcode])
+        length = len(payload)
+        # Client frames are always masked (RFC 6455 section 5.3).
+        if length < 126:
+            header += bytes([0x80 | length])
+        elif length < 65536:
+            header += bytes([0x80 | 126]) + struct.pack("!H", length)
+        else:
+            header += bytes([0x80 | 127]) + struct.pack("!Q", length)
+        mask = os.urandom(4)
+        masked = bytes(b ^ mask[i % 4] for i, b in enumerate(payload))
+        self._writer.write(header + mask + masked)
+
+    async def _recv_frame(self):
+        """Read one complete (possibly fragmented) message."""
+        message_opcode = None
+        payload = b""
+        while True:
+            head = await self._reader.readexactly(2)
+            fin = head[0] & 0x80
+            opcode = head[0] & 0x0F
+            length = head[1] & 0x7F
+            if length == 126:
+                length = struct.unpack("!H", await self._reader.readexactly(2))[0]
+            elif length == 127:
+                length = struct.unpack("!Q", await self._reader.readexactly(8))[0]
+            mask = await self._reader.readexactly(4) if head[1] & 0x80 else None
+            data = await self._reader.readexactly(length) if length else b""
+            if mask:
+                data = bytes(b ^ mask[i % 4] for i, b in enumerate(data))
+            if opcode >= _OP_CLOSE:
+                return opcode, data
+            if opcode != _OP_CONTINUATION:
+                message_opcode = opcode
+            payload += data
+            if fin:
+                return message_opcode, payload
+
+
+class Subscription:
+    """Pushed changes of one state stream subscription.
+
+    ``values`` always holds the latest value of every watch. next() waits
+    for the next ``changed`` push; ``async for`` iterates over them. Use
+    ``async with`` (or close()) to unsubscribe.
+    """
+
+    def __init__(self, stream, sub_id):
+        self.id = sub_id
+        self.values = {}
+        self.frame = None
+        self._stream = stream
+        self._ready = asyncio.get_running_loop().create_future()
+        self._changes = asyncio.Queue()
+        self._error = None
+
+    async def next(self, timeout=None):
+        """Wait for the next change: {"frame", "values": {changed keys}}.
+
+        Raises:
+            asyncio.TimeoutError: If nothing changes within timeout
+            StreamError: If the stream closes
+        """
+        if self._error is not None and self._changes.empty():
+            raise self._error
+        change = await asyncio.wait_for(self._changes.get(), timeout)
+        if isinstance(change, Exception):
+            raise change
+        return change
+
+    async def wait_for(self, key, predicate, timeout=None):
+        """Wait until predicate(values[key]) holds; returns the value.
+
+        The current value is checked first, then every push that changes it.
+        """
+        async def _wait():
+            while not (key in self.values and predicate(self.values[key])):
+                await self.next()
+            return self.values[key]
+        return await asyncio.wait_for(_wait(), timeout)
+
+    def close(self):
+        """Unsubscribe."""
+        self._stream.unsubscribe(self.id)
+
+    def __aiter__(self):
+        return self
+
+    async def __anext__(self):
+        try:
+            return await self.next()
+        except StreamError:
+            raise StopAsyncIteration
+
+    async def __aenter__(self):
+        return self
+
+    async def __aexit__(self, *exc):
+        self.close()
+
+    def _apply(self, msg):
+        values = msg.get("values", {})
+        self.values.update(values)
+        self.frame = msg.get("frame", self.frame)
+        if msg.get("op") == "subscribed":
+            if not self._ready.done():
+                self._ready.set_result(None)
+        elif msg.get("op") == "changed":
+            self._changes.put_nowait({"frame": self.frame, "values": values})
+
+    def _close(self, error):
+        self._error = error
+        self._changes.put_nowait(error)
+
+
+class AsyncPlayUnreal:
+    """asyncio client for the PlayUnreal driver.
+
+    Prefers the plugin's TCP transport; falls back to a keep-alive HTTP
+    pool over Remote Control. Calls may be issued concurrently (e.g. with
+    asyncio.gather): over TCP they are pipelined on one connection, over
+    Remote Control spread across the pool's connections. Requires an
+    APlayUnrealDriver in the level.
+
+    Args:
+        host: Engine host (default localhost)
+        port: Remote Control port (default 30010)
+        tcp_port: Plugin TCP transport port (default 30041). None forces
+            Remote Control.
+        stream_port: State stream port (default 30040). None disables push
+            waits and subscribe().
+        timeout: Connect and HTTP timeout in seconds (default 5)
+        pool_size: Concurrent Remote Control connections (default 4)
+        wire_format: "auto" (MessagePack when offered and the msgpack C
+            extension is installed), "json" or "msgpack"
+    """
+
+    def __init__(self, host="localhost", port=30010, tcp_port=DEFAULT_TCP_PORT,
+                 stream_port=DEFAULT_STREAM_PORT, timeout=5, pool_size=4,
+                 wire_format="auto"):
+        self._host = host
+        self._tcp_port = tcp_port
+        self._stream_port = stream_port
+        self._timeout = timeout
+        self._wire_format = wire_format
+        self._http = _HttpPool(host, port, timeout, pool_size)
+        self._tcp = None
+        self._stream = None
+        self._stream_failed = False
+        self._driver_path = None
+        self.features = []
+
+    async def __aenter__(self):
+        await self.connect()
+        return self
+
+    async def __aexit__(self, *exc):
+        await self.close()
+
+    async def connect(self):
+        """Find the driver, pick a transport and read its Ping features.
+
+        Returns:
+            The Ping response dict.
+        """
+        await self._connect_tcp()
+        if self._tcp is None:
+            self._driver_path = await self._resolve_driver()
+
+        ping = await self.call("Ping")
+        self.features = list(ping.get("features", []))
+        if self._tcp is None and "tcp" in self.features:
+            # Started by the call above when the game runs without -PlayUnreal.
+            await self._connect_tcp()
+
+        if self._tcp is None and self._wire_format != "json":
+            # The pure-Python decoder loses to json.loads, so "auto" takes
+            # MessagePack only with the C extension.
+            offered = "msgpack" in self.features
+            wanted = "msgpack" if offered and (self._wire_format == "msgpack"
+                                               or FAST_MSGPACK) else "json"
+            resp = await self.call("SetWireFormat", {"Format": wanted})
+            self._wire_format = resp.get("format", "json") \
+                if isinstance(resp, dict) else "json"
+        return ping
+
+    async def close(self):
+        """Close every connection."""
+        if self._tcp is not None:
+            await self._tcp.close()
+            self._tcp = None
+        if self._stream is not None:
+            await self._stream.close()
+            self._stream = None
+        self._http.close()
+
+    @property
+    def transport(self):
+        """"tcp" or "rc", whichever carries driver calls."""
+        return "tcp" if self._tcp is not None else "rc"
+
+    # -- Calls ---------------------------------------------------------------
+
+    async def call(self, method, params=None):
+        """Call a driver UFUNCTION and return its decoded result.
+
+        Uses Remote Control if the TCP connection was already lost. A call
+        already sent over TCP is never resent, since it may have run.
+
+        Raises:
+            CallError: If the driver reports {"ok": false}
+            TransportError: If the TCP connection is lost while the call is
+                in flight
+        """
+        tcp = self._connected_tcp()
+        if tcp is not None:
+            try:
+                reply = await tcp.call(method, params, await_result=False)
+            except TransportError:
+                self._tcp = None
+                raise
+            if not reply.get("ok"):
+                raise CallError(f"{method} failed: {reply.get('error', '')}")
+            return _tcp_result(reply)
+
+        if self._driver_path is None:
+            self._driver_path = await self._resolve_driver()
+        result = await self.call_function(self._driver_path, method, params)
+        value = result.get("ReturnValue", "")
+        if isinstance(value, str):
+            value = decode_response(value) if value else {}
+            if isinstance(value, str):
+                try:
+                    value = json.loads(value)
+                except json.JSONDecodeError:
+                    pass
+        if isinstance(value, dict) and value.get("ok") is False:
+            raise CallError(f"{method} failed: {value.get('error', '')}")
+        return value
+
+    async def call_function(self, object_path, function_name, parameters=None):
+        """Call any BlueprintCallable function over Remote Control.
+
+        Returns:
+            The Remote Control response dict (ReturnValue and out params).
+        """
+        body = {"ObjectPath": object_path, "FunctionName": function_name}
+        if parameters:
+            body["Parameters"] = parameters
+        return await self._http.put("/remote/object/call", body)
+
+    async def read_property(self, object_path, property_name):
+        """Read one property over Remote Control."""
+        result = await self._http.put("/remote/object/property", {
+            "ObjectPath": object_path,
+            "PropertyName": property_name,
+        })
+        return result.get(property_name, result)
+
+    async def batch(self, commands, stop_on_error=False):
+        """Run several driver calls as one ExecuteBatch.
+
+        Without the batch feature the calls are pipelined concurrently
+        instead, and the result has the same shape.
+
+        Args:
+            commands: (method, params) tuples or dicts with method, params
+                and optional frame
+
+        Returns:
+            dict with keys: batch, complete, results
+        """
+        normalized = []
+        for command in commands:
+            if isinstance(command, dict):
+                normalized.append(command)
+            else:
+                method, params = command
+                normalized.append({"method": method, "params": params or {}})
+
+        if "batch" in self.features:
+            payload = json.dumps({"commands": normalized,
+                                  "stopOnError": bool(stop_on_error)})
+            return await self.call("ExecuteBatch", {"CommandsJSON": payload})
+
+        async def _one(command):
+            try:
+                result = await self.call(command["method"], command.get("params"))
+            except CallError as e:
+                return {"method": command["method"], "ok": False, "error": str(e)}
+            return {"method": command["method"], "ok": result is not False,
+                    "result": result}
+        results = []
+        if stop_on_error:
+            for command in normalized:
+                results.append(await _one(command))
+                if not results[-1]["ok"]:
+                    break
+        else:
+            results = list(await asyncio.gather(*(_one(c) for c in normalized)))
+        return {"batch": None, "complete": True, "results": results}
+
+    # -- Widgets -------------------------------------------------------------
+
+    async def element_exists(self, selector):
+        """True if a widget matches an automation ID or selector."""
+        return await self.call("ElementExists", {"Id": selector}) is True
+
+    async def is_visible(self, selector):
+        """True if a matching widget is effectively visible."""
+        return await self.call("IsVisible", {"Id": selector}) is True
+
+    async def click(self, selector):
+        """Click the widget with an automation ID or selector (see PlayUnreal.click)."""
+        if await self.call("ClickById", {"Id": selector}) is not True:
+            raise CallError(f"ClickById({selector!r}) failed")
+
+    async def query_widgets(self, selector, limit=0):
+        """Matches of a selector: [{"id", "class", "path", "visible", ...}]."""
+        resp = await self.call("QueryWidgets", {"Selector": selector, "Limit": limit})
+        if not isinstance(resp, dict) or "widgets" not in resp:
+            raise CallError(f"QueryWidgets({selector}) failed: {resp}")
+        return resp["widgets"]
+
+    # -- Waits ---------------------------------------------------------------
+
+    async def run_async(self, method, params=None, timeout=30):
+        """Run a driver call that starts an async operation, to completion.
+
+        Over TCP the engine answers when the operation ends. Over Remote
+        Control the call returns a handle, which is awaited on the state
+        stream's completed push, or polled if there is no stream.
+
+        Returns:
+            The operation's result dict
+
+        Raises:
+            CallError: If the operation failed
+            PlayUnrealError: On timeout
+            TransportError: If the TCP connection is lost while the call is
+                in flight
+        """
+        tcp = self._connected_tcp()
+        if tcp is not None:
+            try:
+                reply = await asyncio.wait_for(
+                    tcp.call(method, params, timeout=timeout), timeout + 5)
+            except asyncio.TimeoutError:
+                raise PlayUnrealError(f"Timed out waiting for {method} after {timeout}s")
+            except TransportError:
+                self._tcp = None
+                raise
+            if not reply.get("ok"):
+                raise CallError(f"{method} failed: {reply.get('error', '')}")
+            return _tcp_result(reply)
+
+        resp = await self.call(method, params)
+        if not isinstance(resp, dict) or "handle" not in resp:
+            raise CallError(f"{method} failed: {resp}")
+        return await self.wait_for_result(resp["handle"], timeout=timeout)
+
+    async def wait_for_result(self, handle, timeout=10):
+        """Wait for an async driver operation by handle.
+
+        Returns:
+            The operation's result dict
+        """
+        stream = await self._get_stream()
+        if stream is not None:
+            try:
+                done = await stream.await_handle(handle, timeout=timeout)
+            except asyncio.TimeoutError:
+                raise PlayUnrealError(
+                    f"Timed out waiting for operation {handle} after {timeout}s")
+            except StreamError:
+                self._stream = None
+            else:
+                if done.get("status") != "done":
+                    raise CallError(f"Operation {handle} failed: {done.get('error', done)}")
+                return done.get("result", {})
+
+        loop = asyncio.get_running_loop()
+        deadline = loop.time() + timeout
+        while True:
+            resp = await self.call("GetAsyncResult", {"Handle": handle})
+            status = resp.get("status") if isinstance(resp, dict) else None
+            if status == "done":
+                return resp.get("result", {})
+            if status != "pending":
+                raise CallError(f"Operation {handle} failed: {resp}")
+            if loop.time() >= deadline:
+                raise PlayUnrealError(
+                    f"Timed out waiting for operation {handle} after {timeout}s")
+            await asyncio.sleep(0.02)
+
+    async def wait_frames(self, frames, timeout=30):
+        """Wait until the engine has rendered the given number of frames."""
+        return await self.run_async("WaitForFrames", {"Frames": int(frames)}, timeout)
+
+    async def wait_seconds(self, seconds, timeout=None):
+        """Wait for seconds of game time (pause and dilation respected)."""
+        if timeout is None:
+            timeout = seconds * 2 + 5
+        return await self.run_async("WaitForSeconds", {"Seconds": float(seconds)}, timeout)
+
+    async def wait_for_condition(self, object_path, *, property_name=None,
+                                 function_name=None, field=None, op="eq",
+                                 value=None, timeout=10):
+        """Wait in-engine until a property or query matches.
+
+        Same arguments as PlayUnreal.wait_for_condition().
+        """
+        condition = {"object": object_path, "op": op, "timeout": timeout}
+        if property_name:
+            condition["property"] = property_name
+        if function_name:
+            condition["function"] = function_name
+        if field:
+            condition["field"] = field
+        if value is not None:
+            condition["value"] = value
+        return await self.run_async(
+            "WaitForCondition", {"ConditionJSON": json.dumps(condition)}, timeout)
+
+    # -- Push ----------------------------------------------------------------
+
+    async def subscribe(self, watches, sub_id=None):
+        """Subscribe to pushed value changes on the state stream.
+
+        Args:
+            watches: [{"key", "object", "property" | "function"}]
+            sub_id: Subscription ID (default: a fresh one)
+
+        Returns:
+            A Subscription; ``values`` holds the initial values.
+
+        Raises:
+            PlayUnrealError: If the state stream is not reachable
+        """
+        stream = await self._get_stream()
+        if stream is None:
+            raise PlayUnrealError(
+                f"subscribe() needs the PlayUnreal state stream (port "
+                f"{self._stream_port}); it is not reachable")
+        return await stream.subscribe(watches, sub_id=sub_id)
+
+    # -- Internals -----------------------------------------------------------
+
+    async def _connect_tcp(self):
+        if self._tcp_port is None:
+            return
+        tcp = AsyncTcpTransport(self._host, self._tcp_port, timeout=self._timeout)
+        try:
+            await tcp.connect()
+        except TransportError:
+            return
+        self._tcp = tcp
+
+    def _connected_tcp(self):
+        if self._tcp is not None and not self._tcp.connected:
+            self._tcp = None
+        return self._tcp
+
+    async def _get_stream(self):
+        if self._stream is not None and self._stream.connected:
+            return self._stream
+        if self._stream_port is None or self._stream_failed:
+            return None
+        stream = AsyncStateStream(self._host, self._stream_port)
+        try:
+            await stream.connect()
+        except StreamError:
+            self._stream_failed = True
+            return None
+        self._stream = stream
+        return stream
+
+    async def _resolve_driver(self):
+        result = await self.call_function(_STATICS_PATH, "ResolveObjects",
+                                          {"ClassNames": ["PlayUnrealDriver"]})
+        resp = _json_value(result.get("ReturnValue", ""))
+        paths = resp.get("objects", {}).get("PlayUnrealDriver", []) \
+            if isinstance(resp, dict) else []
+        if not paths:
+            raise PlayUnrealError(
+                "No APlayUnrealDriver found in the level. AsyncPlayUnreal "
+                "needs one in play.")
+        return paths[-1]
@@ -13,12 +13,21 @@ Usage::
     state = pu.get_state()
 """
 
+import array
+import base64
 import json
 import os
+import sys
 import time
+from collections import deque
 import urllib.request
 import urllib.error
 
+from playunreal.frames import FrameChannelError, FrameReader
+from playunreal.stream import DEFAULT_STREAM_PORT, StateStream, StreamError
+from playunreal.transport import DEFAULT_TCP_PORT, TcpTransport, TransportError
+from playunreal.wire import decode_response
+
 
 class PlayUnrealError(Exception):
     """Base exception for PlayUnreal client errors."""
@@ -44,6 +53,30 @@ _DIRECTIONS = {
 }
 
 
+# Class default object of UPlayUnrealStatics: a fixed path, so it can be
+# called before anything in the level has been found.
+_STATICS_PATH = "/Script/PlayUnrealAutomation.Default__PlayUnrealStatics"
+
+
+def _json_value(ret_val):
+    """A JSON-string ReturnValue, or one the driver already embedded as data."""
+    return json.loads(ret_val) if isinstance(ret_val, str) else ret_val
+
+
+_STATE_NAMES = {0: "Title", 1: "Spawning", 2: "Playing", 3: "Paused",
+                4: "Dying", 5: "RoundComplete", 6: "GameOver"}
+
+
+def _state_matches(state, target_state):
+    """True if a state dict's gameState matches the target name."""
+    current = state.get("gameState", "")
+    if isinstance(current, str):
+        return bool(current) and target_state.lower() in current.lower()
+    if isinstance(current, int):
+        return _STATE_NAMES.get(current, "").lower() == target_state.lower()
+    return False
+
+
 class PlayUnreal:
     """Client for controlling Unreal Engine games via Remote Control API.
 
@@ -56,14 +89,45 @@ class PlayUnreal:
         port: RC API port (default 30010)
         timeout: HTTP request timeout in seconds (default 5)
         map_name: Default map name for object path discovery (default "FroggerMain")
+        stream_port: PlayUnreal state stream port (default 30040). Set to
+            None to always poll over Remote Control.
+        world: Pin driver calls to one world over the TCP transport, e.g.
+            "auto" (least busy), "pie:1" or a world name. None (default)
+            talks to the most recent driver in play.
     """
 
-    def __init__(self, host="localhost", port=30010, timeout=5, map_name="FroggerMain"):
+    def __init__(self, host="localhost", port=30010, timeout=5, map_name="FroggerMain",
+                 stream_port=DEFAULT_STREAM_PORT, wire_format="json",
+                 tcp_port=DEFAULT_TCP_PORT, world=None):
         self.base_url = f"http://{host}:{port}"
+        self._host = host
+        self._stream_port = stream_port
+        self._stream_port_unreachable = None
+        self._transports_retried = False
+        self._stream = None
+        self._stream_completed = {}
         self.timeout = timeout
         self._map_name = map_name
         self._gm_path = None
         self._frog_path = None
+        self._driver_path = None
+        self._resolved = None
+        self._world_generation = None
+        self._resolve_unavailable = False
+        self._has_driver = None
+        self._bindings = {}
+        self._state_watch = None
+        self._wire_format = wire_format
+        self._call_times = {}
+        self._tcp_port = tcp_port
+        self._tcp = None
+        self._tcp_failed = False
+        self._world = world
+        self._session = None
+        self._fixed_step = False
+        self._render_mode = None
+        self._stream_values = None
+        self._frame_reader = None
         self._prev_state = None
         self._gm_class = "UnrealFrogGameMode"
         self._frog_class = "FrogCharacter"
@@ -92,8 +156,66 @@ class PlayUnreal:
         if map_name:
             self._map_name = map_name
         # Clear cached paths so they'll be re-discovered
-        self._gm_path = None
-        self._frog_path = None
+        self._invalidate_paths()
+        self._has_driver = None
+        self._bindings = {}
+        self._stream_values = None
+
+    def resolve_objects(self, class_names):
+        """Live object paths for several classes, in one round trip.
+
+        Needs the PlayUnrealAutomation plugin. Goes through the driver over
+        TCP when connected, else through UPlayUnrealStatics over Remote
+        Control, which needs no object path of its own.
+
+        Args:
+            class_names: Short class names or full class paths
+
+        Returns:
+            dict of class name -> list of object paths
+        """
+        names = list(class_names)
+        resp = None
+        tcp = self._get_tcp()
+        if tcp is not None:
+            try:
+                resp = self._call_driver_tcp(tcp, "ResolveObjects",
+                                             {"ClassNames": names})
+            except TransportError:
+                self._tcp = None
+                if self._world is not None:
+                    raise
+            if isinstance(resp, dict) and resp.get("ok") is False \
+                    and self._world is None:
+                resp = None  # No driver in play yet.
+        if resp is None:
+            result = self._call_function(_STATICS_PATH, "ResolveObjects",
+                                         {"ClassNames": names})
+            resp = _json_value(result.get("ReturnValue", ""))
+        if not isinstance(resp, dict) or "objects" not in resp:
+            raise CallError(f"ResolveObjects failed: {resp}")
+        self._world_generation = resp.get("worldGeneration")
+        return resp["objects"]
+
+    def refresh_paths(self):
+        """Drop cached object paths if the engine has changed worlds.
+
+        Costs one call. Paths are cached against the engine's world
+        generation, which moves on every level load or PIE restart.
+
+        Returns:
+            True if the cached paths were dropped
+        """
+        cached = self._world_generation
+        try:
+            self.resolve_objects([])
+        except (CallError, RCConnectionError):
+            return False
+        if cached is not None and cached == self._world_generation:
+            return False
+        self._invalidate_paths()
+        self._bindings = {}
+        return True
 
     # -- Public API ----------------------------------------------------------
 
@@ -119,10 +241,184 @@ class PlayUnreal:
             raise ValueError(
                 f"Invalid direction '{direction}'. Use: up, down, left, right")
         frog_path = self._get_frog_path()
-        self._call_function(frog_path, "RequestHop", {
+        self._call_bound(frog_path, "RequestHop", {
             "Direction": _DIRECTIONS[direction]
         })
 
+    # -- Input injection -----------------------------------------------------
+
+    def press_key(self, key_chord):
+        """Press and release a key through Slate, like hardware input.
+
+        Args:
+            key_chord: Key name with optional modifiers, e.g. "SpaceBar",
+                "Up" or "Ctrl+Shift+S"
+        """
+        if self._call_driver("PressKey", {"KeyChord": key_chord}) is not True:
+            raise CallError(f"PressKey({key_chord}) failed")
+
+    def type_text(self, text):
+        """Type text into the focused widget as Slate char events."""
+        if self._call_driver("TypeText", {"Text": text}) is not True:
+            raise CallError("TypeText failed")
+
+    def send_input(self, events, wait=True, timeout=10):
+        """Inject a timed sequence of input events in one round trip.
+
+        Events run on frame offsets counted in the engine, so their spacing
+        does not depend on network jitter. Each event is a dict with a
+        "type" (keyDown, keyUp, key, char, text, mouseMove, mouseDown,
+        mouseUp, click, wheel), an optional "frame" offset, and "key",
+        "hold", "text", "x"/"y" (viewport pixels), "button", "delta" or
+        "modifiers" as the type needs.
+
+        Args:
+            events: list of event dicts
+            wait: Wait until the last event is dispatched
+            timeout: Max seconds to wait
+
+        Returns:
+            dict with frame, frames and events once finished, or the
+            handle if wait is False
+        """
+        resp = self._call_driver("SendInput", {"EventsJSON": json.dumps(events)})
+        if not isinstance(resp, dict) or "handle" not in resp:
+            raise CallError(f"SendInput failed: {resp}")
+        if not wait:
+            return resp["handle"]
+        return self.wait_for_result(resp["handle"], timeout=timeout)
+
+    def key_sequence(self, keys, every_frames=6, hold=1, wait=True, timeout=10):
+        """Press several keys at a fixed frame spacing in one call.
+
+        Args:
+            keys: Key names, e.g. ["Up", "Up", "Left"]
+            every_frames: Frames between presses
+            hold: Frames each key stays down
+        """
+        events = [{"frame": i * every_frames, "type": "key", "key": key,
+                   "hold": hold}
+                  for i, key in enumerate(keys)]
+        return self.send_input(events, wait=wait, timeout=timeout)
+
+    # -- Widget queries ------------------------------------------------------
+
+    def query_widgets(self, selector, limit=0, budgeted=False, timeout=10):
+        """Every UMG widget matching a selector, in one round trip.
+
+        Selectors chain steps with whitespace (descendant) or ">" (child).
+        A step combines a class, "#id", "@name", "[text=...]" ("*=" contains,
+        "^=" starts with) and ":visible"/":hidden". "id=X" and
+        "path=A/B/C" work too. The engine caches compiled selectors, so
+        polling the same one is cheap.
+
+        Args:
+            selector: e.g. "MainMenu_C > Button:visible"
+            limit: Stop after this many matches (0 = all)
+            budgeted: Spread the scan over frames within the engine's
+                frame budget (see set_frame_budget), for large UIs while
+                frame timing matters
+            timeout: Max seconds to wait for a budgeted scan
+
+        Returns:
+            list of dicts with id, name, class, path, visible, text and
+            rect (viewport pixels) where known
+        """
+        params = {"Selector": selector, "Limit": limit}
+        if budgeted:
+            handle = self._start_wait("QueryWidgetsAsync", params)
+            return self.wait_for_result(handle, timeout=timeout)["widgets"]
+        resp = self._call_driver("QueryWidgets", params)
+        if not isinstance(resp, dict) or "widgets" not in resp:
+            raise CallError(f"QueryWidgets({selector}) failed: {resp}")
+        return resp["widgets"]
+
+    def element_exists(self, selector):
+        """True if an automation ID or selector matches a widget."""
+        return self._call_driver("ElementExists", {"Id": selector}) is True
+
+    def is_visible(self, selector):
+        """True if the first widget matching an ID or selector is visible."""
+        return self._call_driver("IsVisible", {"Id": selector}) is True
+
+    def click(self, selector):
+        """Click the first widget matching an automation ID or selector.
+
+        Enabled, visible buttons fire OnClicked; other widgets get a real
+        mouse click at their centre (down now, up next frame) and must be
+        on screen.
+        """
+        if self._call_driver("ClickById", {"Id": selector}) is not True:
+            raise CallError(f"ClickById({selector}) failed")
+
+    def track_visibility(self, ids):
+        """Start per-frame visibility tracking for a set of automation IDs.
+
+        The engine resolves each tracked ID once per frame, so polling
+        many widgets becomes one diff per call (see visibility_changes).
+
+        Returns:
+            (tracker, widgets): the tracker ID and a dict of every ID's
+            {"exists", "visible", "rect"} state
+        """
+        resp = self._call_driver("TrackVisibility", {"IdsJSON": json.dumps(list(ids))})
+        if not isinstance(resp, dict) or "tracker" not in resp:
+            raise CallError(f"TrackVisibility failed: {resp}")
+        return resp["tracker"], resp.get("widgets", {})
+
+    def visibility_changes(self, tracker):
+        """States of tracked IDs that changed since the last call."""
+        resp = self._call_driver("GetVisibilityChanges", {"Tracker": tracker})
+        if not isinstance(resp, dict) or "widgets" not in resp:
+            raise CallError(f"GetVisibilityChanges failed: {resp}")
+        return resp["widgets"]
+
+    def untrack_visibility(self, tracker):
+        """Stop a visibility tracker."""
+        return self._call_driver("UntrackVisibility", {"Tracker": tracker}) is True
+
+    def watch_properties(self, entries):
+        """Register a set of properties to read in one call.
+
+        The engine resolves each property once and compares it against its
+        last value every frame. Requires an APlayUnrealDriver.
+
+        Args:
+            entries: List of (object_path, property_name) tuples or dicts
+                with keys object, property and optional key (the name in
+                the results; defaults to the property name)
+
+        Returns:
+            (watch, values): the watch ID and a dict of every current value
+        """
+        normalized = []
+        for entry in entries:
+            if isinstance(entry, dict):
+                normalized.append(entry)
+            else:
+                object_path, property_name = entry
+                normalized.append({"object": object_path,
+                                   "property": property_name})
+        resp = self._call_driver("WatchProperties",
+                                 {"WatchJSON": json.dumps(normalized)})
+        if not isinstance(resp, dict) or "watch" not in resp:
+            raise CallError(f"WatchProperties failed: {resp}")
+        return resp["watch"], resp.get("values", {})
+
+    def watched_values(self, watch, changes_only=False):
+        """Values of a watch set; with changes_only, those changed since the last read."""
+        resp = self._call_driver("GetWatchedValues", {
+            "Watch": watch,
+            "bChangesOnly": bool(changes_only),
+        })
+        if not isinstance(resp, dict) or "values" not in resp:
+            raise CallError(f"GetWatchedValues failed: {resp}")
+        return resp["values"]
+
+    def unwatch_properties(self, watch):
+        """Stop a property watch."""
+        return self._call_driver("UnwatchProperties", {"Watch": watch}) is True
+
     def set_invincible(self, enabled):
         """Enable or disable frog invincibility.
 
@@ -148,14 +444,18 @@ class PlayUnreal:
 
         # Try GetGameStateJSON first
         try:
-            result = self._call_function(gm_path, "GetGameStateJSON")
+            result = self._call_bound(gm_path, "GetGameStateJSON")
             ret_val = result.get("ReturnValue", "")
             if ret_val:
-                return json.loads(ret_val)
+                return _json_value(ret_val)
         except (CallError, json.JSONDecodeError):
             pass
 
-        # Fallback: read individual properties
+        # Fallback: one watch set on the driver, else individual properties
+        state = self._get_watched_state(gm_path)
+        if state is not None:
+            return state
+
         state = {}
         try:
             state["gameState"] = self._read_property(gm_path, "CurrentState")
@@ -182,12 +482,17 @@ class PlayUnreal:
     def get_state_diff(self):
         """Get current state and a diff from the previous state.
 
+        Uses the plugin's state stream when it is available (draining the
+        pushes received since the last call), otherwise calls get_state().
+
         Returns:
             dict with keys:
                 current: full current state dict
                 changes: dict of keys that changed, each with {old, new}
         """
-        current = self.get_state()
+        current = self._get_streamed_state()
+        if current is None:
+            current = self.get_state()
         changes = {}
 
         if self._prev_state is not None:
@@ -201,6 +506,50 @@ class PlayUnreal:
         self._prev_state = current
         return {"current": current, "changes": changes}
 
+    def snapshot_actors(self, class_name=None, tag=None, fields=("x", "y", "z"),
+                        paths=False):
+        """Capture a filtered set of actors in one engine pass.
+
+        Requires an APlayUnrealDriver in the level. The columns are packed
+        float32 data; for numpy use
+        ``np.frombuffer(snap["data"], "<f4").reshape(len(snap["fields"]), -1)``.
+
+        Args:
+            class_name: Actor class filter (short name or path)
+            tag: Actor tag filter
+            fields: Built-ins (x, y, z, vx, vy, vz, ex, ey, ez, yaw) or
+                numeric/bool property names; missing ones read as NaN
+            paths: Also return the actor paths, in row order
+
+        Returns:
+            dict with keys: frame, time, count, fields, data (bytes),
+            columns (field -> array.array of float), and paths if asked
+        """
+        query = {"fields": list(fields), "paths": bool(paths)}
+        if class_name:
+            query["class"] = class_name
+        if tag:
+            query["tag"] = tag
+        snap = self._call_driver("SnapshotActors",
+                                 {"QueryJSON": json.dumps(query)})
+        if not isinstance(snap, dict) or "data" not in snap:
+            raise CallError(f"SnapshotActors failed: {snap}")
+
+        data = snap["data"]
+        if isinstance(data, str):
+            data = base64.b64decode(data)
+        snap["data"] = data
+        values = array.array("f")
+        values.frombytes(data)
+        if sys.byteorder != "little":
+            values.byteswap()
+        count = snap.get("count", 0)
+        snap["columns"] = {
+            name: values[i * count:(i + 1) * count]
+            for i, name in enumerate(snap.get("fields", []))
+        }
+        return snap
+
     def get_hazards(self):
         """Get all hazard positions and properties as a list of dicts.
 
@@ -210,10 +559,10 @@ class PlayUnreal:
         """
         gm_path = self._get_gm_path()
         try:
-            result = self._call_function(gm_path, "GetLaneHazardsJSON")
+            result = self._call_bound(gm_path, "GetLaneHazardsJSON")
             ret_val = result.get("ReturnValue", "")
             if ret_val:
-                parsed = json.loads(ret_val)
+                parsed = _json_value(ret_val)
                 return parsed.get("hazards", [])
         except (CallError, json.JSONDecodeError):
             pass
@@ -236,7 +585,7 @@ class PlayUnreal:
             result = self._call_function(gm_path, "GetGameConfigJSON")
             ret_val = result.get("ReturnValue", "")
             if ret_val:
-                config = json.loads(ret_val)
+                config = _json_value(ret_val)
                 PlayUnreal._cached_config = config
                 return config
         except (CallError, RCConnectionError, json.JSONDecodeError):
@@ -244,15 +593,72 @@ class PlayUnreal:
 
         return {}
 
-    def reset_game(self):
+    def snapshot_world(self, class_name=None, tag=None, properties=None,
+                       destroy_spawned=False):
+        """Capture actor state in the engine for a warm-start reset.
+
+        Requires an APlayUnrealDriver in the level. Captures the transform,
+        velocity and chosen properties of the matching actors in memory;
+        restore_world() writes them back within one frame.
+
+        Args:
+            class_name: Actor class filter (short name or path)
+            tag: Actor tag filter
+            properties: Property names to capture; default is each class's
+                SaveGame properties
+            destroy_spawned: On restore, destroy matching actors that did
+                not exist at capture time
+
+        Returns:
+            Snapshot ID for restore_world()
+        """
+        query = {"destroySpawned": bool(destroy_spawned)}
+        if class_name:
+            query["class"] = class_name
+        if tag:
+            query["tag"] = tag
+        if properties is not None:
+            query["properties"] = list(properties)
+        resp = self._call_driver("SnapshotWorld",
+                                 {"QueryJSON": json.dumps(query)})
+        if not isinstance(resp, dict) or "snapshot" not in resp:
+            raise CallError(f"SnapshotWorld failed: {resp}")
+        return resp["snapshot"]
+
+    def restore_world(self, snapshot):
+        """Write a snapshot_world() capture back, without a level reload.
+
+        Returns:
+            dict with keys: restored, missing (actors destroyed since the
+            capture), destroyed (spawned actors removed)
+        """
+        resp = self._call_driver("RestoreWorld", {"Snapshot": snapshot})
+        if not isinstance(resp, dict) or "restored" not in resp:
+            raise CallError(f"RestoreWorld failed: {resp}")
+        return resp
+
+    def release_snapshot(self, snapshot):
+        """Free a snapshot_world() capture in the engine."""
+        self._call_driver("ReleaseSnapshot", {"Snapshot": snapshot})
+
+    def reset_game(self, snapshots=None):
         """Reset the game to title screen and start a new game.
 
+        With snapshots (IDs from snapshot_world() taken while Playing), the
+        reset is a restore_world() of each instead, which takes one frame.
+
         ReturnToTitle starts a transition (fade/level reset) but gameState
         stays in its previous value throughout — Title is not a stable
         observable state. Sleep gives the transition time to clear score
         and state, then wait_for_state("Playing") confirms the game is
         truly ready before returning.
         """
+        if snapshots:
+            for snapshot in snapshots:
+                self.restore_world(snapshot)
+            self._prev_state = None
+            return
+
         gm_path = self._get_gm_path()
         # Retry ReturnToTitle until Title is confirmed. From GameOver the
         # command is ignored until the GameOver screen auto-dismisses, which
@@ -268,7 +674,10 @@ class PlayUnreal:
         self.wait_for_state("Playing", timeout=15)
 
     def wait_for_state(self, target_state, timeout=10):
-        """Poll get_state() until gameState matches target.
+        """Wait until gameState matches target.
+
+        Uses the plugin's state stream when it is available, so the match is
+        seen on the frame it happens. Otherwise polls get_state().
 
         Args:
             target_state: Target game state string (e.g., "Playing")
@@ -282,17 +691,30 @@ class PlayUnreal:
         """
         start = time.time()
         state = {}
+        stream = self._get_stream()
+        if stream is not None:
+            try:
+                state = self._get_streamed_state() or {}
+                while not _state_matches(state, target_state):
+                    remaining = timeout - (time.time() - start)
+                    if remaining <= 0:
+                        break
+                    msg = stream.recv(timeout=remaining)
+                    if msg is not None:
+                        self._apply_stream_message(msg)
+                        state = self._stream_state()
+                else:
+                    return state
+                raise PlayUnrealError(
+                    f"Timed out waiting for state '{target_state}' after {timeout}s. "
+                    f"Last state: {state.get('gameState', 'unknown')}")
+            except StreamError:
+                self._drop_stream()
+
         while time.time() - start < timeout:
             state = self.get_state()
-            current = state.get("gameState", "")
-            if isinstance(current, str) and target_state.lower() in current.lower():
+            if _state_matches(state, target_state):
                 return state
-            if isinstance(current, int):
-                state_map = {0: "Title", 1: "Spawning", 2: "Playing",
-                             3: "Paused", 4: "Dying", 5: "RoundComplete",
-                             6: "GameOver"}
-                if state_map.get(current, "").lower() == target_state.lower():
-                    return state
             time.sleep(0.2)
         raise PlayUnrealError(
             f"Timed out waiting for state '{target_state}' after {timeout}s. "
@@ -301,8 +723,9 @@ class PlayUnreal:
     def screenshot(self, path=None):
         """Take a screenshot of the game window.
 
-        Uses macOS screencapture. Caches window ID after first lookup
-        so subsequent calls are fast.
+        Captures in-engine through APlayUnrealDriver when one is in the
+        level (no window focus or sleeps needed). Otherwise falls back to
+        macOS screencapture.
 
         Args:
             path: File path for the screenshot. Defaults to Saved/Screenshots/.
@@ -319,12 +742,327 @@ class PlayUnreal:
 
         os.makedirs(os.path.dirname(os.path.abspath(path)), exist_ok=True)
 
+        try:
+            fmt = "jpeg" if path.lower().endswith((".jpg", ".jpeg")) else "png"
+            data = self.capture_screenshot(fmt=fmt)
+            with open(path, "wb") as f:
+                f.write(data)
+            return True
+        except PlayUnrealError:
+            # A headless engine has no window for screencapture to grab.
+            if self.render_mode() in ("none", "offscreen"):
+                return False
+
         try:
             subprocess.run(["screencapture", "-x", path], timeout=5)
             return os.path.exists(path)
         except (subprocess.TimeoutExpired, FileNotFoundError):
             return False
 
+    def render_mode(self):
+        """How the engine renders, from the driver's Ping.
+
+        Returns:
+            "gpu", "offscreen" (-RenderOffScreen), "none" (-nullrhi: queries
+            and input work, screenshots fail at once), or None when there is
+            no APlayUnrealDriver to ask
+        """
+        if self._render_mode is None:
+            try:
+                ping = self._call_driver("Ping")
+            except PlayUnrealError:
+                return None
+            if isinstance(ping, dict):
+                self._render_mode = ping.get("render", "gpu")
+        return self._render_mode
+
+    def capture_screenshot(self, saved_path=None, fmt="png", quality=85,
+                           timeout=5):
+        """Capture the next rendered frame in-engine.
+
+        Args:
+            saved_path: Path relative to the project's Saved/ directory to
+                write in-engine. If None, the encoded bytes are returned.
+            fmt: "png" or "jpeg"
+            quality: JPEG quality (1-100)
+            timeout: Max seconds to wait for the capture
+
+        Returns:
+            The image bytes, or the absolute path written by the engine
+            when saved_path is given.
+
+        Raises:
+            PlayUnrealError: If no driver is present or the capture failed
+        """
+        handle = self.begin_screenshot(saved_path, fmt, quality)
+        result = self.wait_for_result(handle, timeout=timeout)
+        if saved_path:
+            return result.get("path", "")
+        return base64.b64decode(result.get("bytes", ""))
+
+    def begin_screenshot(self, saved_path=None, fmt="png", quality=85):
+        """Start an in-engine capture and return its handle without waiting.
+
+        Collect it later with wait_for_result(handle).
+        """
+        options = {"format": fmt, "quality": quality}
+        if saved_path:
+            options["path"] = saved_path
+        resp = self._call_driver("CaptureScreenshot",
+                                 {"OptionsJSON": json.dumps(options)})
+        if not isinstance(resp, dict) or "handle" not in resp:
+            raise CallError(f"CaptureScreenshot failed: {resp}")
+        return resp["handle"]
+
+    def burst_screenshots(self, count=3, every_frames=6, fmt="png", timeout=5):
+        """Capture several frames at a fixed frame spacing in one request.
+
+        Args:
+            count: Number of frames to capture
+            every_frames: Frames between captures (6 = 100 ms at 60 fps)
+            fmt: "png" or "jpeg"
+            timeout: Max seconds to wait for all captures
+
+        Returns:
+            list of image bytes, in capture order
+        """
+        options = json.dumps({"format": fmt})
+        resp = self.execute_batch([
+            {"method": "CaptureScreenshot", "params": {"OptionsJSON": options},
+             "frame": i * every_frames}
+            for i in range(count)
+        ])
+        if not resp.get("complete", True):
+            resp = self.get_batch_results(resp["batch"], timeout=timeout)
+        images = []
+        for entry in resp.get("results", []):
+            handle = json.loads(entry.get("result") or "{}").get("handle")
+            if handle is None:
+                raise CallError(f"Burst capture failed: {entry}")
+            result = self.wait_for_result(handle, timeout=timeout)
+            images.append(base64.b64decode(result.get("bytes", "")))
+        return images
+
+    def open_frame_channel(self, name=None, slots=None, downscale=None,
+                           every_nth=None, crop=None, widget=None):
+        """Stream raw game frames through shared memory.
+
+        The engine must run on this machine. Frames arrive as BGRA8 pixels
+        with sequence numbers, with no encoding or disk in between.
+
+        Args:
+            name: Shared-memory name (default PlayUnrealFrames-<pid>)
+            slots: Ring length, 2-16 (default 3)
+            downscale: Keep every Nth pixel, 1-8 (default 1)
+            every_nth: Publish every Nth frame (default 1)
+            crop: (x, y, w, h) in window pixels (default the game viewport)
+            widget: Automation ID or selector whose geometry to follow
+
+        Returns:
+            FrameReader attached to the channel
+        """
+        options = {}
+        if name is not None:
+            options["name"] = name
+        if slots is not None:
+            options["slots"] = int(slots)
+        if downscale is not None:
+            options["downscale"] = int(downscale)
+        if every_nth is not None:
+            options["everyNth"] = int(every_nth)
+        if crop is not None:
+            x, y, w, h = crop
+            options["crop"] = {"x": x, "y": y, "w": w, "h": h}
+        if widget is not None:
+            options["widget"] = widget
+        resp = self._call_driver("OpenFrameChannel",
+                                 {"OptionsJSON": json.dumps(options)})
+        if not isinstance(resp, dict) or "name" not in resp:
+            raise CallError(f"OpenFrameChannel failed: {resp}")
+        try:
+            self._frame_reader = FrameReader(resp["name"])
+        except FrameChannelError:
+            self._call_driver("CloseFrameChannel")
+            raise
+        return self._frame_reader
+
+    def close_frame_channel(self):
+        """Detach from and close the frame channel.
+
+        Returns:
+            dict with frames (published) and skipped
+        """
+        if self._frame_reader is not None:
+            self._frame_reader.close()
+            self._frame_reader = None
+        resp = self._call_driver("CloseFrameChannel")
+        if not isinstance(resp, dict) or "frames" not in resp:
+            raise CallError(f"CloseFrameChannel failed: {resp}")
+        return resp
+
+    def wait_for_result(self, handle, timeout=10):
+        """Wait for an asynchronous driver operation to finish.
+
+        Args:
+            handle: Handle returned by an asynchronous driver call
+            timeout: Max seconds to wait
+
+        Returns:
+            The operation's result dict
+
+        Raises:
+            PlayUnrealError: If the operation failed or timed out
+        """
+        start = time.time()
+        stream = self._get_stream()
+        if stream is not None:
+            try:
+                return self._await_on_stream(stream, handle, timeout)
+            except StreamError:
+                self._drop_stream()
+
+        while True:
+            resp = self._call_driver("GetAsyncResult", {"Handle": handle})
+            status = resp.get("status") if isinstance(resp, dict) else None
+            if status == "done":
+                return resp.get("result", {})
+            if status != "pending":
+                raise CallError(
+                    f"Operation {handle} failed: {resp.get('error', resp)}")
+            if time.time() - start >= timeout:
+                raise PlayUnrealError(
+                    f"Timed out waiting for operation {handle} after {timeout}s")
+            time.sleep(0.02)
+
+    def submit(self, function_name, parameters=None, timeout=None):
+        """Start a driver call without waiting for it.
+
+        Async operations (CaptureScreenshot, WaitFor*) are answered when
+        they complete, so several calls can be in flight at once and finish
+        in any order. Requires the plugin's TCP transport.
+
+        Args:
+            function_name: Driver method, e.g. "WaitForCondition"
+            parameters: Dict of parameters (optional)
+            timeout: Seconds before the engine fails the call (None = none)
+
+        Returns:
+            A playunreal.transport.PendingCall with done(), result() and
+            cancel()
+        """
+        tcp = self._get_tcp()
+        if tcp is None:
+            raise PlayUnrealError(
+                "submit() needs the PlayUnreal TCP transport (port "
+                f"{self._tcp_port}); it is not reachable")
+        return tcp.submit(function_name, parameters, timeout=timeout)
+
+    def cancel(self, handle):
+        """Cancel a pending async operation by handle.
+
+        Returns:
+            True if it was still pending
+        """
+        return bool(self._call_driver("CancelAsync", {"Handle": handle}))
+
+    def wait_frames(self, frames, timeout=30):
+        """Wait until the engine has rendered the given number of frames.
+
+        Returns:
+            dict with frame, frames and seconds (elapsed game time)
+        """
+        handle = self._start_wait("WaitForFrames", {"Frames": int(frames)})
+        return self.wait_for_result(handle, timeout=timeout)
+
+    def wait_seconds(self, seconds, timeout=None):
+        """Wait for the given number of seconds of game time.
+
+        Unlike time.sleep(), this follows the engine clock, so pauses and
+        time dilation are respected.
+
+        Returns:
+            dict with frame, frames and seconds (elapsed game time)
+        """
+        handle = self._start_wait("WaitForSeconds", {"Seconds": float(seconds)})
+        if timeout is None:
+            timeout = seconds * 2 + 5
+        return self.wait_for_result(handle, timeout=timeout)
+
+    def wait_for_condition(self, object_path, *, property_name=None,
+                           function_name=None, field=None, op="eq", value=None,
+                           timeout=10):
+        """Wait in-engine until a property or query on an object matches.
+
+        The condition is checked every frame on the game thread, so the
+        wait ends on the frame the value changes.
+
+        Args:
+            object_path: UE object path
+            property_name: Property to read (or use function_name)
+            function_name: Parameterless function whose return value is read
+            field: Key to pick from an object (or JSON string) value
+            op: eq, ne, lt, le, gt, ge, contains or exists
+            value: Expected value
+            timeout: Max seconds to wait
+
+        Returns:
+            dict with frame, frames, seconds and value
+        """
+        condition = {"object": object_path, "op": op, "timeout": timeout}
+        if property_name:
+            condition["property"] = property_name
+        if function_name:
+            condition["function"] = function_name
+        if field:
+            condition["field"] = field
+        if value is not None:
+            condition["value"] = value
+        handle = self._start_wait("WaitForCondition",
+                                  {"ConditionJSON": json.dumps(condition)})
+        # On a fixed timestep the engine counts the timeout in game time,
+        # which a slow machine may simulate slower than real time.
+        wall_timeout = timeout * 10 + 5 if self._fixed_step else timeout + 1
+        return self.wait_for_result(handle, timeout=wall_timeout)
+
+    def set_fixed_timestep(self, fps=60, render=True):
+        """Step the engine at a fixed delta time, as fast as it can tick.
+
+        Requires an APlayUnrealDriver in the level. Game time then advances
+        exactly 1/fps per frame regardless of the wall clock, so scenarios
+        run faster than real time with reproducible timing. Waits and
+        condition timeouts follow game time. Engine-wide until disabled.
+
+        Args:
+            fps: Fixed steps per game second, or None to restore normal timing
+            render: False also skips world rendering
+
+        Returns:
+            dict with keys: fixed, deltaSeconds, render
+        """
+        options = {"enabled": False} if fps is None else \
+            {"fps": float(fps), "render": bool(render)}
+        resp = self._call_driver("SetFixedTimestep",
+                                 {"OptionsJSON": json.dumps(options)})
+        if not isinstance(resp, dict) or "fixed" not in resp:
+            raise CallError(f"SetFixedTimestep failed: {resp}")
+        self._fixed_step = resp["fixed"]
+        return resp
+
+    def run_until(self, game_seconds, timeout=60):
+        """Let the simulation run until world time reaches game_seconds.
+
+        With set_fixed_timestep() this runs as fast as the machine allows.
+
+        Args:
+            game_seconds: Absolute target world time
+            timeout: Max wall-clock seconds to wait
+
+        Returns:
+            dict with frame, frames and seconds (elapsed game time)
+        """
+        handle = self._start_wait("RunUntil", {"GameSeconds": float(game_seconds)})
+        return self.wait_for_result(handle, timeout=timeout)
+
     def navigate(self, target_col=6, max_deaths=8):
         """Navigate frog to a home slot using predictive path planning.
 
@@ -346,6 +1084,38 @@ class PlayUnreal:
         return navigate_to_home_slot(self, target_col=target_col,
                                      max_deaths=max_deaths)
 
+    def navigate_in_engine(self, target_col=6, target_row=14, max_deaths=8,
+                           goal=None, wait=True, timeout=120):
+        """Navigate to a goal cell with the engine-side hop planner.
+
+        Same strategy as navigate(), but each hop is decided in the engine
+        from that frame's hazards, so no query round trips are in the loop.
+
+        Args:
+            target_col: Goal column
+            target_row: Goal row
+            max_deaths: Give up after this many deaths
+            goal: Extra goal keys (grid, hop, hazards, while, until, ...)
+            wait: Wait for the result; False returns the handle
+            timeout: Max seconds (game and wall-clock) to navigate
+
+        Returns:
+            dict with status, col, row, hops, deaths and decisions,
+            or the handle when wait is False
+        """
+        description = {"targetCol": int(target_col), "targetRow": int(target_row),
+                       "maxDeaths": int(max_deaths), "timeout": float(timeout)}
+        description.update(goal or {})
+        handle = self._start_wait("NavigateTo",
+                                  {"GoalJSON": json.dumps(description)})
+        if not wait:
+            return handle
+        return self.wait_for_result(handle, timeout=timeout)
+
+    def navigation_status(self):
+        """Progress of the current or last navigate_in_engine()."""
+        return self._call_driver("GetNavigationStatus")
+
     def call_function(self, object_path, function_name, parameters=None):
         """Call a UFUNCTION via Remote Control API.
 
@@ -361,6 +1131,309 @@ class PlayUnreal:
         """
         return self._call_function(object_path, function_name, parameters)
 
+    def set_frame_budget(self, milliseconds):
+        """Set the game-thread time per frame deferred driver work may use.
+
+        Returns:
+            dict of scheduler stats: budgetMs, queued, slices, frames,
+            overruns, maxFrameMs
+        """
+        resp = self._call_driver("SetFrameBudget", {"Milliseconds": milliseconds})
+        if not isinstance(resp, dict) or "budgetMs" not in resp:
+            raise CallError(f"SetFrameBudget failed: {resp}")
+        return resp
+
+    def set_wire_format(self, wire_format):
+        """Choose the driver's response encoding for this session.
+
+        "msgpack" makes driver responses compact binary and embeds the
+        JSON-string results of game hooks (GetLaneHazardsJSON, ...) as data,
+        so they are decoded once. Falls back to "json" if the driver does
+        not list the format in Ping().
+
+        Only faster than JSON with the msgpack package's C extension
+        installed (see playunreal.wire.FAST_MSGPACK).
+
+        Args:
+            wire_format: "json" or "msgpack"
+
+        Returns:
+            The format now in use.
+        """
+        self._wire_format = wire_format
+        if self._driver_path:
+            self._negotiate_wire_format()
+        return self._wire_format
+
+    def get_metrics(self, reset=False):
+        """Per-method driver timing, with this client's round trips added.
+
+        Requires an APlayUnrealDriver in the level. Each method entry has
+        count, mean, max, p50, p95 and p99 of game-thread execution time in
+        milliseconds (and "queue" when the engine knows it). Methods this
+        client called also get "client" round-trip percentiles and
+        "overhead_p50": round trip minus execution, i.e. HTTP, Remote
+        Control dispatch and game-thread queueing.
+
+        Args:
+            reset: Clear the engine and client counters after reading
+
+        Returns:
+            dict with keys: unit, methods
+        """
+        metrics = self._call_driver("GetMetrics")
+        if not isinstance(metrics, dict):
+            raise CallError(f"GetMetrics failed: {metrics}")
+        methods = metrics.setdefault("methods", {})
+        for name, times in self._call_times.items():
+            if not times:
+                continue
+            ordered = sorted(times)
+            client = {
+                f"p{q}": ordered[min(len(ordered) - 1,
+                                     int(q / 100 * len(ordered)))] * 1000.0
+                for q in (50, 95, 99)
+            }
+            client["count"] = len(ordered)
+            entry = methods.setdefault(name, {})
+            entry["client"] = client
+            if "p50" in entry:
+                entry["overhead_p50"] = max(0.0, client["p50"] - entry["p50"])
+        if reset:
+            self._call_driver("ResetMetrics")
+            self._call_times.clear()
+        return metrics
+
+    def begin_perf_capture(self, name=None, max_frames=None, hitch_ms=None,
+                           csv=False, trace=False):
+        """Start sampling per-frame timings in the engine.
+
+        Args:
+            name: Label for the capture and its files
+            max_frames: Ring buffer size; older frames drop off (36000)
+            hitch_ms: Frames slower than this count as hitches (50)
+            csv: True, or a path relative to Saved/, to write per-frame CSV
+            trace: True, or a path, to record an Unreal Insights trace
+
+        Returns:
+            The capture name
+        """
+        options = {}
+        if name is not None:
+            options["name"] = name
+        if max_frames is not None:
+            options["maxFrames"] = int(max_frames)
+        if hitch_ms is not None:
+            options["hitchMs"] = float(hitch_ms)
+        if csv:
+            options["csv"] = csv
+        if trace:
+            options["trace"] = trace
+        resp = self._call_driver("BeginPerfCapture",
+                                 {"OptionsJSON": json.dumps(options)})
+        if not isinstance(resp, dict) or not resp.get("ok"):
+            raise CallError(f"BeginPerfCapture failed: {resp}")
+        return resp["name"]
+
+    def end_perf_capture(self):
+        """Stop the capture and return its summary.
+
+        Returns:
+            dict with frames, dropped, seconds, hitches, frame/game/render/
+            rhi/gpu ({mean, p50, p90, p95, p99, max} in ms), drawCalls,
+            primitives, memory, and csv/trace paths when requested
+        """
+        resp = self._call_driver("EndPerfCapture")
+        if not isinstance(resp, dict) or "frames" not in resp:
+            raise CallError(f"EndPerfCapture failed: {resp}")
+        return resp
+
+    # -- Sessions ------------------------------------------------------------
+
+    def open_session(self, world="auto"):
+        """Pin this client's driver calls to one world.
+
+        Each TCP connection is a session on the engine side, with its own
+        metrics. Lets parallel test workers share one editor running
+        multi-client PIE. Sessions need the TCP transport.
+
+        Args:
+            world: "auto" (the world with the fewest sessions), "pie:N" for
+                a PIE instance, or a world name
+
+        Returns:
+            dict with keys: session, world (world, driver, pieInstance, netMode)
+        """
+        self._world = world
+        if self._tcp is not None and self._tcp.connected:
+            self._session = self._call_session("OpenSession", {"world": world})
+        elif self._get_tcp() is None:
+            raise CallError("Sessions need the PlayUnreal TCP transport")
+        return self._session
+
+    def list_worlds(self):
+        """Worlds with a driver in play and how many sessions each serves.
+
+        Returns:
+            list of dicts with keys: world, driver, pieInstance, netMode, sessions
+        """
+        return self._call_session("ListWorlds")
+
+    def get_session_metrics(self):
+        """GetMetrics numbers for this client's session only."""
+        return self._call_session("GetSessionMetrics")
+
+    def bind(self, object_path, function_name):
+        """Resolve a function once on the driver and return its binding ID.
+
+        Later calls through call_binding() skip the object and function
+        lookup. Requires an APlayUnrealDriver in the level.
+
+        Args:
+            object_path: UE object path
+            function_name: Name of the BlueprintCallable function
+
+        Returns:
+            dict with keys: binding, params
+        """
+        resp = self._call_driver("BindFunction", {
+            "ObjectPath": object_path,
+            "FunctionName": function_name,
+        })
+        if not isinstance(resp, dict) or "binding" not in resp:
+            raise CallError(f"BindFunction {function_name} failed: {resp}")
+        self._bindings[(object_path, function_name)] = resp["binding"]
+        return resp
+
+    def call_binding(self, binding, parameters=None):
+        """Call a function bound with bind().
+
+        Args:
+            binding: Binding ID from bind()
+            parameters: Dict of parameters (optional)
+
+        Returns:
+            dict with key ReturnValue and any out parameters, the same
+            shape as call_function()
+        """
+        resp = self._call_driver("CallBinding", {
+            "Binding": binding,
+            "ParamsJSON": json.dumps(parameters or {}),
+        })
+        if isinstance(resp, dict) and resp.get("ok") is False:
+            raise CallError(f"CallBinding {binding} failed: {resp.get('error')}")
+        return resp
+
+    def execute_batch(self, commands, stop_on_error=False):
+        """Run several driver calls in one request via APlayUnrealDriver.
+
+        Each command is either a ``(method, params)`` tuple or a dict with
+        ``method``, optional ``params`` and optional ``frame`` (offset in
+        frames from the start of the batch).
+
+        Args:
+            commands: Ordered list of commands.
+            stop_on_error: Skip the remaining commands after the first failure.
+
+        Returns:
+            dict with keys: batch, complete, results. If the batch is not
+            complete (some commands run on later frames), collect the rest
+            with get_batch_results(batch).
+        """
+        normalized = []
+        for command in commands:
+            if isinstance(command, dict):
+                normalized.append(command)
+            else:
+                method, params = command
+                normalized.append({"method": method, "params": params or {}})
+        payload = json.dumps({"commands": normalized,
+                              "stopOnError": bool(stop_on_error)})
+        return self._call_driver("ExecuteBatch", {"CommandsJSON": payload})
+
+    def get_batch_results(self, batch_id, timeout=10):
+        """Wait for a deferred batch to complete and return its results.
+
+        Args:
+            batch_id: The "batch" value returned by execute_batch()
+            timeout: Max seconds to wait
+
+        Returns:
+            Same shape as execute_batch()
+
+        Raises:
+            PlayUnrealError: If timeout reached
+        """
+        start = time.time()
+        while True:
+            result = self._call_driver("GetBatchResults", {"BatchId": batch_id})
+            if result.get("complete", True):
+                return result
+            if time.time() - start >= timeout:
+                raise PlayUnrealError(
+                    f"Timed out waiting for batch {batch_id} after {timeout}s")
+            time.sleep(0.05)
+
+    def start_recording(self, path=""):
+        """Record every driver call from now on to a session log.
+
+        The log holds each call's frame, parameters and result, and can be
+        replayed in the engine with replay_session(), no client needed.
+
+        Args:
+            path: Log path relative to Saved/ (default
+                PlayUnreal/Sessions/<timestamp>.pulog)
+
+        Returns:
+            Full path of the log
+        """
+        resp = self._call_driver("StartRecording", {"Path": path})
+        if not isinstance(resp, dict) or not resp.get("ok"):
+            raise CallError(f"StartRecording failed: {resp}")
+        return resp["path"]
+
+    def stop_recording(self):
+        """Finish the running recording.
+
+        Returns:
+            dict with path, commands and bytes
+        """
+        resp = self._call_driver("StopRecording")
+        if not isinstance(resp, dict) or "path" not in resp:
+            raise CallError(f"StopRecording failed: {resp}")
+        return resp
+
+    def replay_session(self, path, fps=None, render=False, stop_on_mismatch=False,
+                       ignore=None, timeout=600):
+        """Replay a recorded session in the engine and compare results.
+
+        Calls run on their recorded frame offsets on a fixed timestep, as
+        fast as the engine steps, without round trips.
+
+        Args:
+            path: Log path relative to Saved/ (or absolute)
+            fps: Fixed steps per second (default: the recording's timestep)
+            render: Render the world while replaying
+            stop_on_mismatch: Stop at the first result that differs
+            ignore: Methods whose results are not compared
+                (default Ping, GetMetrics, EndPerfCapture and the frame
+                channel calls)
+            timeout: Max seconds to wait for the replay
+
+        Returns:
+            dict with commands, frames, seconds, mismatchCount and
+            mismatches ({index, frame, method, expected, actual})
+        """
+        options = {"path": path, "render": bool(render),
+                   "stopOnMismatch": bool(stop_on_mismatch)}
+        if fps is not None:
+            options["fps"] = float(fps)
+        if ignore is not None:
+            options["ignore"] = list(ignore)
+        handle = self._start_wait("ReplaySession",
+                                  {"OptionsJSON": json.dumps(options)})
+        return self.wait_for_result(handle, timeout=timeout)
+
     def read_property(self, object_path, property_name):
         """Read a UPROPERTY value via Remote Control API.
 
@@ -425,6 +1498,115 @@ class PlayUnreal:
 
         return report
 
+    # -- State stream --------------------------------------------------------
+
+    def _get_stream(self):
+        """Return a connected state stream, or None if the plugin has none."""
+        if self._stream is not None:
+            return self._stream if self._stream.connected else None
+        if self._stream_port is None:
+            return None
+        stream = StateStream(host=self._host, port=self._stream_port, timeout=1)
+        try:
+            stream.connect()
+        except StreamError:
+            # Don't retry on every call (see _retry_transports).
+            self._stream_port_unreachable = self._stream_port
+            self._stream_port = None
+            return None
+        self._stream = stream
+        return stream
+
+    def _drop_stream(self):
+        if self._stream is not None:
+            self._stream.close()
+        self._stream = None
+        self._stream_values = None
+
+    def _await_on_stream(self, stream, handle, timeout):
+        done = self._stream_completed.pop(handle, None)
+        if done is None:
+            stream.send({"op": "await", "handle": handle})
+        deadline = time.time() + timeout
+        while done is None:
+            remaining = deadline - time.time()
+            if remaining <= 0:
+                raise PlayUnrealError(
+                    f"Timed out waiting for operation {handle} after {timeout}s")
+            msg = stream.recv(timeout=remaining)
+            if msg is not None:
+                self._apply_stream_message(msg)
+                done = self._stream_completed.pop(handle, None)
+        if done.get("status") != "done":
+            raise CallError(
+                f"Operation {handle} failed: {done.get('error', done)}")
+        return done.get("result", {})
+
+    def _get_streamed_state(self):
+        """Latest state from the stream, or None if streaming is unavailable."""
+        stream = self._get_stream()
+        if stream is None:
+            return None
+        try:
+            if self._stream_values is None:
+                self._subscribe_state(stream)
+            msg = stream.recv(timeout=0)
+            while msg is not None:
+                self._apply_stream_message(msg)
+                msg = stream.recv(timeout=0)
+        except StreamError:
+            self._drop_stream()
+            return None
+        return self._stream_state()
+
+    def _subscribe_state(self, stream):
+        gm_path = self._get_gm_path()
+        values = stream.subscribe("state", [
+            {"key": "state", "object": gm_path, "function": "GetGameStateJSON"},
+        ])
+        if not values.get("state"):
+            # No GetGameStateJSON: watch the same properties get_state() reads.
+            frog_path = self._get_frog_path()
+            values = stream.subscribe("state", [
+                {"key": "gameState", "object": gm_path, "property": "CurrentState"},
+                {"key": "wave", "object": gm_path, "property": "CurrentWave"},
+                {"key": "homeSlotsFilledCount", "object": gm_path,
+                 "property": "HomeSlotsFilledCount"},
+                {"key": "timeRemaining", "object": gm_path, "property": "RemainingTime"},
+                {"key": "frogPos", "object": frog_path, "property": "GridPosition"},
+            ])
+        self._stream_values = dict(values)
+
+    def _apply_stream_message(self, msg):
+        if msg.get("op") == "completed":
+            self._stream_completed[msg.get("handle")] = msg
+            return
+        if msg.get("id") != "state" or self._stream_values is None:
+            return
+        if msg.get("op") == "subscribed":
+            self._stream_values = dict(msg.get("values", {}))
+        elif msg.get("op") == "changed":
+            self._stream_values.update(msg.get("values", {}))
+
+    def _stream_state(self):
+        values = self._stream_values or {}
+        raw = values.get("state")
+        if isinstance(raw, str) and raw:
+            try:
+                return json.loads(raw)
+            except json.JSONDecodeError:
+                pass
+        state = {key: values[key] for key in
+                 ("gameState", "wave", "homeSlotsFilledCount", "timeRemaining")
+                 if values.get(key) is not None}
+        grid_pos = values.get("frogPos")
+        if isinstance(grid_pos, dict):
+            state["frogPos"] = [grid_pos.get("X", grid_pos.get("x", 0)),
+                                grid_pos.get("Y", grid_pos.get("y", 0))]
+        else:
+            state["frogPos"] = [0, 0]
+        return state
+
     # -- Object path discovery -----------------------------------------------
 
     def _get_gm_path(self):
@@ -439,8 +1621,51 @@ class PlayUnreal:
         self._frog_path = self._discover_path(self._frog_class)
         return self._frog_path
 
+    def _get_driver_path(self):
+        if self._driver_path:
+            return self._driver_path
+        path = self._discover_path("PlayUnrealDriver")
+        if "Default__" in path:
+            raise PlayUnrealError(
+                "No APlayUnrealDriver found in the level. Place one to use "
+                "driver features such as execute_batch().")
+        self._driver_path = path
+        if self._wire_format != "json":
+            self._negotiate_wire_format()
+        return path
+
+    def _negotiate_wire_format(self):
+        features = self._call_driver("Ping").get("features", [])
+        wanted = self._wire_format if self._wire_format in features else "json"
+        resp = self._call_driver("SetWireFormat", {"Format": wanted})
+        self._wire_format = resp.get("format", "json") if isinstance(resp, dict) \
+            else "json"
+
     def _discover_path(self, class_name):
-        """Discover a live object path by probing candidates."""
+        """Discover a live object path.
+
+        Resolves every class the client needs in one ResolveObjects call,
+        and falls back to probing candidate paths without the plugin.
+        """
+        if self._resolved is None and not self._resolve_unavailable:
+            names = list(dict.fromkeys(
+                [self._gm_class, self._frog_class, "PlayUnrealDriver", class_name]))
+            try:
+                found = self.resolve_objects(names)
+            except CallError:
+                self._resolve_unavailable = True
+            else:
+                self._resolved = {name: paths[0] if paths else None
+                                  for name, paths in found.items()}
+        if self._resolved is not None:
+            if class_name not in self._resolved:
+                paths = self.resolve_objects([class_name]).get(class_name)
+                self._resolved[class_name] = paths[0] if paths else None
+            path = self._resolved[class_name]
+            if path is not None:
+                return path
+            return f"/Script/{self._module_name}.Default__{class_name}"
+
         candidates = self._build_candidates(class_name)
         for path in candidates:
             try:
@@ -451,6 +1676,12 @@ class PlayUnreal:
                 continue
         return f"/Script/{self._module_name}.Default__{class_name}"
 
+    def _invalidate_paths(self):
+        self._gm_path = None
+        self._frog_path = None
+        self._driver_path = None
+        self._resolved = None
+
     def _build_candidates(self, class_name):
         """Build candidate object paths for a given class."""
         candidates = []
@@ -472,7 +1703,186 @@ class PlayUnreal:
         }
         if parameters:
             body["Parameters"] = parameters
-        return self._put("/remote/object/call", body)
+        start = time.perf_counter()
+        result = self._put("/remote/object/call", body)
+        times = self._call_times.get(function_name)
+        if times is None:
+            times = self._call_times[function_name] = deque(maxlen=1000)
+        times.append(time.perf_counter() - start)
+        return result
+
+    def _driver_available(self):
+        if self._has_driver is None:
+            try:
+                self._get_driver_path()
+                self._has_driver = True
+            except PlayUnrealError:
+                # Only remember "no driver" once the engine has answered.
+                self._has_driver = False if self.is_alive() else None
+        return bool(self._has_driver)
+
+    def _get_watched_state(self, gm_path):
+        """get_state() fallback through one driver watch set, or None."""
+        if not self._driver_available():
+            return None
+        try:
+            frog_path = self._get_frog_path()
+        except PlayUnrealError:
+            frog_path = None
+
+        key = (gm_path, frog_path)
+        values = None
+        if self._state_watch is not None:
+            watched_key, watch = self._state_watch
+            self._state_watch = None
+            try:
+                if watched_key == key:
+                    values = self.watched_values(watch)
+                    self._state_watch = (key, watch)
+                else:
+                    self.unwatch_properties(watch)
+            except CallError:
+                # Released by a driver restart; register it again.
+                pass
+        if values is None:
+            entries = [
+                {"object": gm_path, "property": "CurrentState", "key": "gameState"},
+                {"object": gm_path, "property": "CurrentWave", "key": "wave"},
+                {"object": gm_path, "property": "HomeSlotsFilledCount",
+                 "key": "homeSlotsFilledCount"},
+                {"object": gm_path, "property": "RemainingTime",
+                 "key": "timeRemaining"},
+            ]
+            if frog_path:
+                entries.append({"object": frog_path, "property": "GridPosition",
+                                "key": "frogPos"})
+            try:
+                watch, values = self.watch_properties(entries)
+            except CallError:
+                return None
+            self._state_watch = (key, watch)
+
+        state = {k: v for k, v in values.items() if v is not None}
+        grid_pos = state.get("frogPos")
+        if isinstance(grid_pos, dict):
+            state["frogPos"] = [grid_pos.get("X", 0), grid_pos.get("Y", 0)]
+        else:
+            state["frogPos"] = [0, 0]
+        return state
+
+    def _call_bound(self, object_path, function_name, parameters=None):
+        """Call through a cached driver binding, or plain RC without a driver."""
+        if not self._driver_available():
+            return self._call_function(object_path, function_name, parameters)
+
+        key = (object_path, function_name)
+        binding = self._bindings.get(key)
+        if binding is None:
+            binding = self.bind(object_path, function_name)["binding"]
+        try:
+            return self.call_binding(binding, parameters)
+        except CallError:
+            # The binding may have been released by a driver restart.
+            self._bindings.pop(key, None)
+            binding = self.bind(object_path, function_name)["binding"]
+            return self.call_binding(binding, parameters)
+
+    def _get_tcp(self):
+        """Connected TCP transport, or None to use Remote Control."""
+        if self._tcp is not None and self._tcp.connected:
+            return self._tcp
+        if self._tcp_port is None or self._tcp_failed:
+            return None
+        tcp = TcpTransport(self._host, self._tcp_port, timeout=self.timeout)
+        try:
+            tcp.connect()
+        except TransportError:
+            self._tcp_failed = True
+            return None
+        self._tcp = tcp
+        self._session = None
+        if self._world is not None:
+            # A reconnect is a new session; pin it to the same world.
+            self._session = self._call_session("OpenSession",
+                                               {"world": self._world}, tcp)
+        return tcp
+
+    def _retry_transports(self):
+        """Allow one more TCP and stream connect after a Remote Control call.
+
+        Without -PlayUnreal the plugin starts its transports on the first
+        client call, so ports refused before it may be open now.
+        """
+        if self._transports_retried:
+            return
+        self._transports_retried = True
+        self._tcp_failed = False
+        if self._stream_port is None and self._stream_port_unreachable:
+            self._stream_port = self._stream_port_unreachable
+
+    def _call_session(self, method, parameters=None, tcp=None):
+        tcp = tcp or self._get_tcp()
+        if tcp is None:
+            raise CallError("Sessions need the PlayUnreal TCP transport")
+        reply = tcp.call(method, parameters or {})
+        if not reply.get("ok"):
+            raise CallError(f"{method} failed: {reply.get('error')}")
+        return reply.get("result")
+
+    def _call_driver_tcp(self, tcp, function_name, parameters):
+        start = time.perf_counter()
+        # Handles come back as-is, exactly like over Remote Control.
+        reply = tcp.call(function_name, parameters, await_result=False)
+        times = self._call_times.get(function_name)
+        if times is None:
+            times = self._call_times[function_name] = deque(maxlen=1000)
+        times.append(time.perf_counter() - start)
+
+        if not reply.get("ok"):
+            # Same shape the driver returns for errors over Remote Control.
+            return {"ok": False, "error": reply.get("error", "")}
+        result = reply.get("result")
+        if isinstance(result, str) and result.startswith(("{", "[")):
+            try:
+                return json.loads(result)
+            except json.JSONDecodeError:
+                pass
+        return {} if result in (None, "") else result
+
+    def _call_driver(self, function_name, parameters=None):
+        """Call a driver UFUNCTION and decode its JSON string return value.
+
+        Goes over the plugin's TCP transport when it is reachable, else
+        through Remote Control.
+        """
+        tcp = self._get_tcp()
+        if tcp is not None:
+            try:
+                return self._call_driver_tcp(tcp, function_name, parameters)
+            except TransportError:
+                self._tcp = None
+                if self._world is not None:
+                    # Remote Control cannot reach a pinned world.
+                    raise
+
+        result = self._call_function(self._get_driver_path(), function_name,
+                                     parameters)
+        self._retry_transports()
+        ret_val = result.get("ReturnValue", "")
+        if not isinstance(ret_val, str):
+            return ret_val
+        if ret_val.startswith("msgpack:"):
+            return decode_response(ret_val)
+        try:
+            return json.loads(ret_val) if ret_val else {}
+        except json.JSONDecodeError:
+            return ret_val
+
+    def _start_wait(self, function_name, parameters):
+        resp = self._call_driver(function_name, parameters)
+        if not isinstance(resp, dict) or "handle" not in resp:
+            raise CallError(f"{function_name} failed: {resp}")
+        return resp["handle"]
 
     def _read_property(self, object_path, property_name):
         body = {
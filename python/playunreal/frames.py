@@ -0,0 +1,166 @@
+"""PlayUnreal frame channel — raw game frames over shared memory.
+
+After ``OpenFrameChannel`` the plugin publishes every presented game frame
+as BGRA8 pixels into a named shared-memory ring. This module attaches to
+the ring and hands out frames without encoding, disk or sockets; with
+``copy=False`` the pixels are a memoryview straight into shared memory.
+
+Usage::
+
+    from playunreal.frames import FrameReader
+
+    reader = FrameReader(info["name"])       # info from OpenFrameChannel
+    frame = reader.wait_for_frame(timeout=1.0)
+    b, g, r, a = reader.pixel(frame, 10, 20)
+
+The ring layout is documented in PlayUnrealFrameChannel.h. A slot's
+sequence is checked before and after its pixels are read, so a frame the
+engine overwrote in the meantime is dropped rather than returned torn.
+"""
+
+import struct
+import sys
+import time
+from collections import namedtuple
+from multiprocessing import shared_memory
+
+_MAGIC = b"PUFB"
+_VERSION = 1
+_HEADER = struct.Struct("<4sIIIIIQII")
+_SLOT = struct.Struct("<QQIII")
+_HEADER_SIZE = 64
+_SLOT_HEADER_SIZE = 32
+_LATEST_OFFSET = 24
+_FORMAT_BGRA8 = 1
+
+Frame = namedtuple("Frame", "sequence frame width height pixels")
+Frame.__doc__ = """One published frame.
+
+sequence counts published frames from 1, frame is the engine's frame
+number, and pixels hold width * height BGRA8 pixels, rows top to bottom.
+"""
+
+
+class FrameChannelError(Exception):
+    """The frame channel is missing, malformed or closed."""
+    pass
+
+
+def _attach(name):
+    # Python < 3.13 registers attached segments with the resource tracker,
+    # which would unlink the engine's segment when this process exits.
+    if sys.version_info >= (3, 13):
+        return shared_memory.SharedMemory(name=name, create=False, track=False)
+    shm = shared_memory.SharedMemory(name=name, create=False)
+    if sys.platform != "win32":
+        from multiprocessing import resource_tracker
+        resource_tracker.unregister(shm._name, "shared_memory")
+    return shm
+
+
+class FrameReader:
+    """Reader for the plugin's shared-memory frame ring.
+
+    Args:
+        name: Shared-memory name returned by OpenFrameChannel
+    """
+
+    def __init__(self, name):
+        try:
+            self._shm = _attach(name)
+        except (FileNotFoundError, OSError) as e:
+            raise FrameChannelError(f"No frame channel named {name!r}: {e}")
+        self.name = name
+        (magic, version, self.slots, self.slot_bytes, self.max_width,
+         self.max_height, _, fmt, _) = _HEADER.unpack_from(self._shm.buf, 0)
+        if magic != _MAGIC or version != _VERSION or fmt != _FORMAT_BGRA8:
+            self._shm.close()
+            raise FrameChannelError(
+                f"{name!r} is not a version {_VERSION} BGRA8 frame channel")
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+    def close(self):
+        """Detach. Zero-copy frames from read(copy=False) must be released first."""
+        if self._shm is not None:
+            self._shm.close()
+            self._shm = None
+
+    @property
+    def closed(self):
+        """True once the engine closed the channel."""
+        return _HEADER.unpack_from(self._shm.buf, 0)[8] != 0
+
+    def latest_sequence(self):
+        """Sequence of the newest published frame (0 before the first)."""
+        return struct.unpack_from("<Q", self._shm.buf, _LATEST_OFFSET)[0]
+
+    def _slot_offset(self, sequence):
+        return _HEADER_SIZE + ((sequence - 1) % self.slots) * self.slot_bytes
+
+    def _slot_sequence(self, sequence):
+        return struct.unpack_from("<Q", self._shm.buf, self._slot_offset(sequence))[0]
+
+    def read(self, copy=True):
+        """Return the newest frame, or None if there is none yet.
+
+        Args:
+            copy: Copy the pixels out (bytes). With False they are a
+                memoryview into shared memory: check is_current() after
+                using them, and release the view before close().
+        """
+        for _ in range(3):
+            sequence = self.latest_sequence()
+            if sequence == 0:
+                return None
+            offset = self._slot_offset(sequence)
+            slot_seq, frame, width, height, row_bytes = _SLOT.unpack_from(
+                self._shm.buf, offset)
+            if slot_seq != sequence:
+                continue
+            start = offset + _SLOT_HEADER_SIZE
+            pixels = self._shm.buf[start:start + row_bytes * height]
+            if copy:
+                data = bytes(pixels)
+                pixels.release()
+                pixels = data
+            if self._slot_sequence(sequence) == sequence:
+                return Frame(sequence, frame, width, height, pixels)
+            if not copy:
+                pixels.release()
+        return None
+
+    def is_current(self, frame):
+        """True if the frame's slot has not been overwritten since it was read."""
+        return self._slot_sequence(frame.sequence) == frame.sequence
+
+    def wait_for_frame(self, after=None, timeout=5.0, copy=True, poll=0.001):
+        """Wait for a frame newer than sequence ``after`` (default: now).
+
+        Raises:
+            FrameChannelError: On timeout or if the engine closes the channel.
+        """
+        if after is None:
+            after = self.latest_sequence()
+        deadline = time.time() + timeout
+        while True:
+            if self.latest_sequence() > after:
+                frame = self.read(copy=copy)
+                if frame is not None and frame.sequence > after:
+                    return frame
+            if self.closed:
+                raise FrameChannelError(f"Frame channel {self.name!r} was closed")
+            if time.time() >= deadline:
+                raise FrameChannelError(
+                    f"No frame after {after} within {timeout}s")
+            time.sleep(poll)
+
+    @staticmethod
+    def pixel(frame, x, y):
+        """(b, g, r, a) of one pixel of a frame."""
+        i = (y * frame.width + x) * 4
+        return tuple(frame.pixels[i:i + 4])
@@ -0,0 +1,186 @@
+"""PlayUnreal load generator — end-to-end driver throughput and latency.
+
+Complements the in-engine benchmark (``-run=PlayUnrealBenchmark``), which
+measures the driver's own cost: this measures what a client sees, with the
+transport, serialization and game-thread scheduling included. Each worker
+thread owns a PlayUnreal client (and so its own connection) and calls one
+operation back to back until it has made its share of the calls.
+
+Usage::
+
+    python -m playunreal.loadgen --ops ping,element_exists --workers 4 \\
+        --calls 2000 --element BenchRow_0 --output loadgen.json
+
+Results use the benchmark's JSON shape, with latencies in milliseconds and
+one extra field per suite, "throughput" (calls per second over all
+workers)::
+
+    {"version": 1, "suites": [{"name", "params", "unit", "count", "mean",
+     "p50", "p95", "p99", "max", "throughput", "errors"}]}
+"""
+
+import argparse
+import json
+import math
+import sys
+import threading
+import time
+
+from playunreal.client import PlayUnreal, PlayUnrealError
+
+_FORMAT_VERSION = 1
+
+
+def _percentile(ordered, fraction):
+    rank = math.ceil(fraction * len(ordered))
+    return ordered[min(max(rank - 1, 0), len(ordered) - 1)]
+
+
+def _operations(args):
+    """name -> callable(client) for every supported operation."""
+    batch = [("Ping", {})] * args.batch_size
+    return {
+        "ping": lambda pu: pu._call_driver("Ping"),
+        "find_actor": lambda pu: pu._call_driver(
+            "FindActorByName", {"Name": args.actor}),
+        "element_exists": lambda pu: pu.element_exists(args.element),
+        "batch": lambda pu: pu.execute_batch(batch),
+    }
+
+
+def summarize(name, params, samples, elapsed, errors):
+    """One suite entry: latencies in ms, throughput in calls per second."""
+    suite = {"name": name, "params": params, "unit": "ms",
+             "count": len(samples), "errors": errors}
+    if not samples:
+        return suite
+    ordered = sorted(samples)
+    suite.update({
+        "mean": sum(ordered) / len(ordered),
+        "p50": _percentile(ordered, 0.50),
+        "p95": _percentile(ordered, 0.95),
+        "p99": _percentile(ordered, 0.99),
+        "max": ordered[-1],
+        "throughput": len(ordered) / elapsed if elapsed > 0 else 0.0,
+    })
+    return suite
+
+
+def run_operation(name, operation, make_client, workers=1, calls=1000,
+                  warmup=10):
+    """Drive one operation from ``workers`` threads, ``calls`` in total.
+
+    Args:
+        name: Suite name for the results
+        operation: callable(client) making one call
+        make_client: callable() returning a fresh PlayUnreal client
+        workers: Concurrent clients
+        calls: Calls across all workers (after each worker's warmup)
+        warmup: Unmeasured calls per worker first
+
+    Returns:
+        The suite dict (see summarize()).
+    """
+    shares = [calls // workers + (1 if i < calls % workers else 0)
+              for i in range(workers)]
+    samples = [[] for _ in range(workers)]
+    errors = [0] * workers
+    ready = threading.Barrier(workers + 1)
+
+    def worker(index):
+        pu = make_client()
+        try:
+            for _ in range(warmup):
+                operation(pu)
+        except PlayUnrealError:
+            errors[index] += 1
+        ready.wait()
+        out = samples[index]
+        for _ in range(shares[index]):
+            start = time.perf_counter()
+            try:
+                operation(pu)
+            except PlayUnrealError:
+                errors[index] += 1
+                continue
+            out.append((time.perf_counter() - start) * 1000.0)
+
+    threads = [threading.Thread(target=worker, args=(i,), daemon=True)
+               for i in range(workers)]
+    for thread in threads:
+        thread.start()
+    ready.wait()
+    start = time.perf_counter()
+    for thread in threads:
+        thread.join()
+    elapsed = time.perf_counter() - start
+
+    merged = [sample for out in samples for sample in out]
+    return summarize(name, {"workers": workers, "calls": calls}, merged,
+                     elapsed, sum(errors))
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(
+        prog="python -m playunreal.loadgen",
+        description="Measure PlayUnreal driver latency and throughput "
+                    "from the client side.")
+    parser.add_argument("--host", default="localhost")
+    parser.add_argument("--port", type=int, default=30010,
+                        help="Remote Control port (default 30010)")
+    parser.add_argument("--wire-format", default="json",
+                        choices=("json", "msgpack"))
+    parser.add_argument("--ops", default="ping,element_exists,batch",
+                        help="Comma-separated: ping, find_actor, "
+                             "element_exists, batch")
+    parser.add_argument("--workers", default="1",
+                        help="Comma-separated worker counts (default 1)")
+    parser.add_argument("--calls", type=int, default=1000,
+                        help="Measured calls per operation and worker count")
+    parser.add_argument("--warmup", type=int, default=10)
+    parser.add_argument("--actor", default="PlayUnrealDriver",
+                        help="Actor name for find_actor")
+    parser.add_argument("--element", default="BenchRow_0",
+                        help="Automation ID or selector for element_exists")
+    parser.add_argument("--batch-size", type=int, default=50,
+                        help="Pings per ExecuteBatch for batch")
+    parser.add_argument("--output", help="Write the results JSON here")
+    args = parser.parse_args(argv)
+
+    operations = _operations(args)
+    names = [name.strip() for name in args.ops.split(",") if name.strip()]
+    unknown = [name for name in names if name not in operations]
+    if unknown:
+        parser.error(f"unknown operation(s): {', '.join(unknown)}")
+
+    def make_client():
+        return PlayUnreal(host=args.host, port=args.port,
+                          wire_format=args.wire_format)
+
+    if not make_client().is_alive():
+        print(f"No PlayUnreal game at {args.host}:{args.port}", file=sys.stderr)
+        return 1
+
+    results = {"version": _FORMAT_VERSION,
+               "timestamp": time.strftime("%Y-%m-%dT%H:%M:%SZ", time.gmtime()),
+               "suites": []}
+    for name in names:
+        for workers in (int(w) for w in args.workers.split(",")):
+            suite = run_operation(name, operations[name], make_client,
+                                  workers=max(workers, 1), calls=args.calls,
+                                  warmup=args.warmup)
+            results["suites"].append(suite)
+            print(f"{name:<16} workers={workers:<3} "
+                  f"p50={suite.get('p50', 0):.3f}ms "
+                  f"p99={suite.get('p99', 0):.3f}ms "
+                  f"{suite.get('throughput', 0):.0f}/s "
+                  f"errors={suite['errors']}")
+
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(results, f, indent=2)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
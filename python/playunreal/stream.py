@@ -0,0 +1,248 @@
+"""PlayUnreal state stream — push-based value watching over WebSocket.
+
+The PlayUnrealAutomation plugin runs a small WebSocket server (default port
+30040) that evaluates watched properties and parameterless functions once
+per engine frame and pushes only the values that changed. This module is a
+zero-dependency client for it.
+
+Usage::
+
+    from playunreal.stream import StateStream
+
+    stream = StateStream()
+    stream.connect()
+    values = stream.subscribe("s1", [
+        {"key": "wave", "object": gm_path, "property": "CurrentWave"},
+    ])
+    msg = stream.recv(timeout=1.0)   # {"op": "changed", "values": {...}}
+"""
+
+import base64
+import hashlib
+import json
+import os
+import select
+import socket
+import struct
+import time
+
+DEFAULT_STREAM_PORT = 30040
+
+_WS_GUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+
+_OP_CONTINUATION = 0x0
+_OP_TEXT = 0x1
+_OP_BINARY = 0x2
+_OP_CLOSE = 0x8
+_OP_PING = 0x9
+_OP_PONG = 0xA
+
+
+class StreamError(Exception):
+    """The stream connection failed or was closed."""
+    pass
+
+
+class StateStream:
+    """Minimal WebSocket client for the plugin's state stream.
+
+    Args:
+        host: Stream server host (default localhost)
+        port: Stream server port (default 30040)
+        timeout: Connect timeout in seconds (default 2)
+    """
+
+    def __init__(self, host="localhost", port=DEFAULT_STREAM_PORT, timeout=2):
+        self.host = host
+        self.port = port
+        self.timeout = timeout
+        self._sock = None
+        self._buffer = b""
+
+    # -- Connection ----------------------------------------------------------
+
+    def connect(self):
+        """Open the connection and perform the WebSocket handshake.
+
+        Raises:
+            StreamError: If the server is not reachable.
+        """
+        try:
+            sock = socket.create_connection((self.host, self.port),
+                                            timeout=self.timeout)
+        except OSError as e:
+            raise StreamError(
+                f"Cannot reach PlayUnreal stream at {self.host}:{self.port}: {e}")
+
+        key = base64.b64encode(os.urandom(16)).decode("ascii")
+        request = (
+            f"GET / HTTP/1.1\r\n"
+            f"Host: {self.host}:{self.port}\r\n"
+            f"Upgrade: websocket\r\n"
+            f"Connection: Upgrade\r\n"
+            f"Sec-WebSocket-Key: {key}\r\n"
+            f"Sec-WebSocket-Version: 13\r\n\r\n"
+        )
+        sock.sendall(request.encode("ascii"))
+
+        response = b""
+        while b"\r\n\r\n" not in response:
+            chunk = sock.recv(4096)
+            if not chunk:
+                sock.close()
+                raise StreamError("Stream server closed during handshake")
+            response += chunk
+        header, self._buffer = response.split(b"\r\n\r\n", 1)
+
+        expected = base64.b64encode(hashlib.sha1(
+            (key + _WS_GUID).encode("ascii")).digest()).decode("ascii")
+        if b" 101 " not in header.split(b"\r\n", 1)[0] or \
+                expected.encode("ascii") not in header:
+            sock.close()
+            raise StreamError(f"Unexpected handshake response: {header[:200]!r}")
+
+        sock.setblocking(True)
+        self._sock = sock
+
+    def close(self):
+        """Close the connection."""
+        if self._sock is None:
+            return
+        try:
+            self._send_frame(_OP_CLOSE, b"")
+        except OSError:
+            pass
+        self._sock.close()
+        self._sock = None
+
+    @property
+    def connected(self):
+        return self._sock is not None
+
+    # -- Subscriptions -------------------------------------------------------
+
+    def subscribe(self, sub_id, watches, timeout=5):
+        """Subscribe to a set of watches and return their initial values.
+
+        Args:
+            sub_id: Subscription ID, echoed back in every push
+            watches: list of dicts with key, object, and property or function
+            timeout: Max seconds to wait for the initial snapshot
+
+        Returns:
+            dict of key -> initial value
+        """
+        self.send({"op": "subscribe", "id": sub_id, "watches": watches})
+        deadline = time.time() + timeout
+        while True:
+            msg = self.recv(timeout=max(0.0, deadline - time.time()))
+            if msg is None:
+                raise StreamError(f"No reply to subscribe '{sub_id}'")
+            if msg.get("op") == "subscribed" and msg.get("id") == sub_id:
+                return msg.get("values", {})
+
+    def unsubscribe(self, sub_id):
+        """Stop receiving pushes for a subscription."""
+        self.send({"op": "unsubscribe", "id": sub_id})
+
+    def send(self, message):
+        """Send a JSON message."""
+        self._send_frame(_OP_TEXT, json.dumps(message).encode("utf-8"))
+
+    def recv(self, timeout=None):
+        """Receive the next JSON message.
+
+        Args:
+            timeout: Max seconds to wait (None blocks)
+
+        Returns:
+            The decoded message dict, or None on timeout.
+        """
+        deadline = None if timeout is None else time.time() + timeout
+        while True:
+            remaining = None if deadline is None else deadline - time.time()
+            if remaining is not None and remaining <= 0:
+                return None
+            frame = self._recv_frame(remaining)
+            if frame is None:
+                return None
+            opcode, payload = frame
+            if opcode in (_OP_TEXT, _OP_BINARY):
+                try:
+                    return json.loads(payload.decode("utf-8"))
+                except (UnicodeDecodeError, json.JSONDecodeError):
+                    continue
+            if opcode == _OP_PING:
+                self._send_frame(_OP_PONG, payload)
+            elif opcode == _OP_CLOSE:
+                self._sock.close()
+                self._sock = None
+                raise StreamError("Stream server closed the connection")
+
+    # -- Framing -------------------------------------------------------------
+
+    def _send_frame(self, opcode, payload):
+        if self._sock is None:
+            raise StreamError("Stream is not connected")
+        header = bytes([0x80 | opcode])
+        length = len(payload)
+        # Client frames are always masked (RFC 6455 section 5.3).
+        if length < 126:
+            header += bytes([0x80 | length])
+        elif length < 65536:
+            header += bytes([0x80 | 126]) + struct.pack("!H", length)
+        else:
+            header += bytes([0x80 | 127]) + struct.pack("!Q", length)
+        mask = os.urandom(4)
+        masked = bytes(b ^ mask[i % 4] for i, b in enumerate(payload))
+        self._sock.sendall(header + mask + masked)
+
+    def _read_exact(self, count, timeout):
+        deadline = None if timeout is None else time.time() + timeout
+        while len(self._buffer) < count:
+            remaining = None if deadline is None else deadline - time.time()
+            if remaining is not None and remaining <= 0:
+                return None
+            ready, _, _ = select.select([self._sock], [], [], remaining)
+            if not ready:
+                return None
+            chunk = self._sock.recv(65536)
+            if not chunk:
+                self._sock.close()
+                self._sock = None
+                raise StreamError("Stream connection lost")
+            self._buffer += chunk
+        data, self._buffer = self._buffer[:count], self._buffer[count:]
+        return data
+
+    def _recv_frame(self, timeout):
+        """Read one complete (possibly fragmented) message frame."""
+        if self._sock is None:
+            raise StreamError("Stream is not connected")
+        message_opcode = None
+        payload = b""
+        while True:
+            head = self._read_exact(2, timeout)
+            if head is None:
+                return None
+            # Once a frame has started, read it to the end.
+            timeout = None
+            fin = head[0] & 0x80
+            opcode = head[0] & 0x0F
+            length = head[1] & 0x7F
+            if length == 126:
+                length = struct.unpack("!H", self._read_exact(2, None))[0]
+            elif length == 127:
+                length = struct.unpack("!Q", self._read_exact(8, None))[0]
+            mask = self._read_exact(4, None) if head[1] & 0x80 else None
+            data = self._read_exact(length, None) if length else b""
+            if mask:
+                data = bytes(b ^ mask[i % 4] for i, b in enumerate(data))
+
+            if opcode >= _OP_CLOSE:
+                return opcode, data
+            if opcode != _OP_CONTINUATION:
+                message_opcode = opcode
+            payload += data
+            if fin:
+                return message_opcode, payload
@@ -0,0 +1,271 @@
+"""PlayUnreal TCP transport — persistent, pipelined driver calls.
+
+The PlayUnrealAutomation plugin listens on localhost port 30041 for
+length-prefixed JSON requests and dispatches them straight to the
+APlayUnrealDriver in play, skipping the Remote Control HTTP stack. Each
+frame is a little-endian uint32 byte count followed by UTF-8 JSON.
+
+Usage::
+
+    from playunreal.transport import TcpTransport
+
+    tcp = TcpTransport()
+    tcp.connect()
+    tcp.call("Ping")                                  # one round trip
+    tcp.call_many([("ClickById", {"Id": "Start"}),    # pipelined
+                   ("ElementExists", {"Id": "HUD"})])
+
+    shot = tcp.submit("CaptureScreenshot", {"OptionsJSON": "{}"})
+    wait = tcp.submit("WaitForCondition", {...}, timeout=5)
+    tcp.call("ClickById", {"Id": "Start"})           # not blocked by either
+    image = shot.result()                            # replies arrive out of order
+"""
+
+import json
+import select
+import socket
+import struct
+import time
+
+DEFAULT_TCP_PORT = 30041
+
+
+class TransportError(Exception):
+    """The TCP connection failed or was closed."""
+    pass
+
+
+class PendingCall:
+    """A request sent with TcpTransport.submit() whose reply may come later.
+
+    Calls that start an async operation (screenshots, waits) are answered
+    when the operation completes, so several can be in flight at once.
+    """
+
+    def __init__(self, transport, request_id):
+        self._transport = transport
+        self.id = request_id
+
+    def done(self):
+        """True once the reply has arrived (does not block)."""
+        return self._transport.poll(self.id)
+
+    def reply(self, timeout=None):
+        """Wait for the raw reply dict: {"id", "ok", "result" | "error"}."""
+        return self._transport.wait(self.id, timeout=timeout)
+
+    def result(self, timeout=None):
+        """Wait for the reply and return its result.
+
+        Raises:
+            TransportError: If the call failed, timed out or was cancelled.
+        """
+        reply = self.reply(timeout=timeout)
+        if not reply.get("ok"):
+            raise TransportError(reply.get("error", "call failed"))
+        return reply.get("result")
+
+    def cancel(self):
+        """Cancel the call's operation. Returns True if it was still running."""
+        return self._transport.cancel(self.id)
+
+
+class TcpTransport:
+    """Client for the plugin's TCP call transport.
+
+    Args:
+        host: Server host (default localhost; the plugin only binds loopback)
+        port: Server port (default 30041)
+        timeout: Connect timeout, and how long call() and cancel() wait
+            for the reply to a call the engine answers at once (default 5)
+    """
+
+    def __init__(self, host="localhost", port=DEFAULT_TCP_PORT, timeout=5):
+        self.host = host
+        self.port = port
+        self.timeout = timeout
+        self._sock = None
+        self._next_id = 1
+        self._pending = {}
+        self._abandoned = set()
+
+    def connect(self):
+        """Open the connection.
+
+        Raises:
+            TransportError: If the server is not reachable.
+        """
+        try:
+            sock = socket.create_connection((self.host, self.port),
+                                            timeout=self.timeout)
+        except OSError as e:
+            raise TransportError(
+                f"Cannot reach PlayUnreal TCP transport at "
+                f"{self.host}:{self.port}: {e}")
+        sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        # Replies to async calls may be held for longer than any socket
+        # timeout; wait() enforces deadlines with select instead.
+        sock.settimeout(None)
+        self._sock = sock
+
+    def close(self):
+        """Close the connection."""
+        if self._sock is not None:
+            self._sock.close()
+            self._sock = None
+        self._pending.clear()
+        self._abandoned.clear()
+
+    @property
+    def connected(self):
+        return self._sock is not None
+
+    def call(self, method, params=None, timeout=None, await_result=True):
+        """Call a driver method and wait for its reply.
+
+        See send() for timeout and await_result. A call answered at once
+        (await_result=False) waits at most the transport's timeout; an
+        awaited one until the engine replies.
+
+        Returns:
+            The reply dict: {"id", "ok", "result"} or {"id", "ok", "error"}
+
+        Raises:
+            TransportError: If no reply arrives in time. The connection
+                stays open and a late reply is discarded.
+        """
+        request_id = self.send(method, params, timeout=timeout,
+                               await_result=await_result)
+        try:
+            return self.wait(request_id,
+                             timeout=None if await_result else self.timeout)
+        except TransportError:
+            if self._sock is not None:
+                self._abandoned.add(request_id)
+            raise
+
+    def call_many(self, calls):
+        """Send several calls back to back, then collect every reply.
+
+        The engine runs all requests that have arrived in the same tick, so
+        a pipelined list completes in about one round trip.
+
+        Args:
+            calls: list of (method, params) tuples
+
+        Returns:
+            Replies in the same order as calls.
+        """
+        ids = [self.send(method, params) for method, params in calls]
+        return [self.wait(request_id) for request_id in ids]
+
+    def submit(self, method, params=None, timeout=None):
+        """Send a call and return a PendingCall without waiting for it.
+
+        Args:
+            method: Driver method name
+            params: Parameters by name
+            timeout: Seconds the engine keeps an async call open before
+                failing it with "Timed out" (None = no limit)
+        """
+        return PendingCall(self, self.send(method, params, timeout=timeout))
+
+    def cancel(self, request_id):
+        """Cancel an in-flight async call. Returns True if it was running."""
+        reply = self.wait(self._send_message({"cancel": request_id}),
+                          timeout=self.timeout)
+        return bool(reply.get("ok") and reply.get("result", {}).get("cancelled"))
+
+    def send(self, method, params=None, timeout=None, await_result=True):
+        """Send one request without waiting. Returns its request id.
+
+        Args:
+            method: Driver method name
+            params: Parameters by name
+            timeout: Seconds the engine keeps an async call open
+            await_result: For calls that start an async operation, reply
+                with its outcome (default) rather than the bare handle
+        """
+        message = {"method": method, "params": params or {}}
+        if timeout is not None:
+            message["timeout"] = timeout
+        if not await_result:
+            message["await"] = False
+        return self._send_message(message)
+
+    def wait(self, request_id, timeout=None):
+        """Wait for the reply to a request sent with send().
+
+        Replies to other requests that arrive first are kept for them.
+
+        Raises:
+            TransportError: If timeout (seconds) passes without the reply.
+        """
+        deadline = None if timeout is None else time.time() + timeout
+        while request_id not in self._pending:
+            if deadline is not None:
+                remaining = deadline - time.time()
+                if remaining <= 0 or not self._readable(remaining):
+                    raise TransportError(
+                        f"No reply to request {request_id} after {timeout}s")
+            self._store(self._recv_message())
+        return self._pending.pop(request_id)
+
+    def poll(self, request_id):
+        """Read any replies already received; True if request_id's is among them."""
+        while request_id not in self._pending and self._readable(0):
+            self._store(self._recv_message())
+        return request_id in self._pending
+
+    def _store(self, reply):
+        request_id = reply.get("id")
+        if request_id in self._abandoned:
+            self._abandoned.discard(request_id)
+        else:
+            self._pending[request_id] = reply
+
+    def _send_message(self, message):
+        request_id = self._next_id
+        self._next_id += 1
+        message["id"] = request_id
+        payload = json.dumps(message).encode("utf-8")
+        self._sendall(struct.pack("<I", len(payload)) + payload)
+        return request_id
+
+    def _readable(self, timeout):
+        if self._sock is None:
+            raise TransportError("TCP transport is not connected")
+        ready, _, _ = select.select([self._sock], [], [], timeout)
+        return bool(ready)
+
+    # -- Framing -------------------------------------------------------------
+
+    def _sendall(self, data):
+        if self._sock is None:
+            raise TransportError("TCP transport is not connected")
+        try:
+            self._sock.sendall(data)
+        except OSError as e:
+            self.close()
+            raise TransportError(f"TCP send failed: {e}")
+
+    def _recv_exact(self, count):
+        chunks = []
+        while count > 0:
+            try:
+                chunk = self._sock.recv(count)
+            except OSError as e:
+                self.close()
+                raise TransportError(f"TCP receive failed: {e}")
+            if not chunk:
+                self.close()
+                raise TransportError("TCP transport closed by the engine")
+            chunks.append(chunk)
+            count -= len(chunk)
+        return b"".join(chunks)
+
+    def _recv_message(self):
+        if self._sock is None:
+            raise TransportError("TCP transport is not connected")
+        (length,) = struct.unpack("<I", self._recv_exact(4))
+        return json.loads(self._recv_exact(length).decode("utf-8"))
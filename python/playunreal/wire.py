@@ -0,0 +1,156 @@
+"""PlayUnreal wire formats — decoding for binary driver responses.
+
+After ``SetWireFormat("msgpack")`` the driver returns MessagePack payloads
+as ``"msgpack:<base64>"`` strings inside the Remote Control ``ReturnValue``.
+
+Decoding uses the C-accelerated ``msgpack`` package when it is installed
+(``pip install playunreal[fast]``). The built-in pure-Python decoder keeps
+the package dependency-free, but is slower than ``json.loads`` on large
+payloads, so clients only pick MessagePack on their own when
+``FAST_MSGPACK`` is true.
+"""
+
+import base64
+import struct
+
+try:
+    import msgpack as _msgpack
+except ImportError:
+    _msgpack = None
+
+MSGPACK_PREFIX = "msgpack:"
+
+#: True when payloads are decoded by the msgpack C extension.
+FAST_MSGPACK = _msgpack is not None \
+    and not _msgpack.Unpacker.__module__.endswith("fallback")
+
+
+class WireError(Exception):
+    """A binary payload could not be decoded."""
+    pass
+
+
+def decode_response(text):
+    """Decode a driver response string if it carries a binary payload.
+
+    Args:
+        text: ReturnValue string from the driver
+
+    Returns:
+        The decoded value, or ``text`` unchanged if it is not binary.
+    """
+    if not isinstance(text, str) or not text.startswith(MSGPACK_PREFIX):
+        return text
+    return unpackb(base64.b64decode(text[len(MSGPACK_PREFIX):]))
+
+
+def unpackb(data):
+    """Decode one MessagePack value from bytes."""
+    if _msgpack is None:
+        return unpackb_python(data)
+    try:
+        return _msgpack.unpackb(data, raw=False, strict_map_key=False)
+    except (ValueError, TypeError, _msgpack.UnpackException) as e:
+        raise WireError(f"Invalid MessagePack payload: {e}")
+
+
+def unpackb_python(data):
+    """Decode one MessagePack value from bytes with the built-in decoder."""
+    value, offset = _unpack(data, 0)
+    if offset != len(data):
+        raise WireError(f"{len(data) - offset} trailing bytes after value")
+    return value
+
+
+def _unpack(data, offset):
+    try:
+        code = data[offset]
+    except IndexError:
+        raise WireError("Truncated MessagePack payload")
+    offset += 1
+
+    if code <= 0x7f:
+        return code, offset
+    if code >= 0xe0:
+        return code - 0x100, offset
+    if 0xa0 <= code <= 0xbf:
+        return _str(data, offset, code & 0x1f)
+    if 0x90 <= code <= 0x9f:
+        return _array(data, offset, code & 0x0f)
+    if 0x80 <= code <= 0x8f:
+        return _map(data, offset, code & 0x0f)
+
+    if code == 0xc0:
+        return None, offset
+    if code == 0xc2:
+        return False, offset
+    if code == 0xc3:
+        return True, offset
+
+    fixed = _FIXED.get(code)
+    if fixed is not None:
+        fmt, size = fixed
+        _check(data, offset + size)
+        return struct.unpack_from(fmt, data, offset)[0], offset + size
+
+    if code in (0xd9, 0xda, 0xdb):
+        length, offset = _length(data, offset, code - 0xd9)
+        return _str(data, offset, length)
+    if code in (0xc4, 0xc5, 0xc6):
+        length, offset = _length(data, offset, code - 0xc4)
+        _check(data, offset + length)
+        return bytes(data[offset:offset + length]), offset + length
+    if code in (0xdc, 0xdd):
+        length, offset = _length(data, offset, code - 0xdc + 1)
+        return _array(data, offset, length)
+    if code in (0xde, 0xdf):
+        length, offset = _length(data, offset, code - 0xde + 1)
+        return _map(data, offset, length)
+
+    raise WireError(f"Unsupported MessagePack type 0x{code:02x}")
+
+
+_FIXED = {
+    0xca: (">f", 4), 0xcb: (">d", 8),
+    0xcc: (">B", 1), 0xcd: (">H", 2), 0xce: (">I", 4), 0xcf: (">Q", 8),
+    0xd0: (">b", 1), 0xd1: (">h", 2), 0xd2: (">i", 4), 0xd3: (">q", 8),
+}
+
+_LENGTHS = ((">B", 1), (">H", 2), (">I", 4))
+
+
+def _check(data, end):
+    if end > len(data):
+        raise WireError("Truncated MessagePack payload")
+
+
+def _length(data, offset, width_index):
+    fmt, size = _LENGTHS[width_index]
+    _check(data, offset + size)
+    return struct.unpack_from(fmt, data, offset)[0], offset + size
+
+
+def _str(data, offset, length):
+    end = offset + length
+    _check(data, end)
+    try:
+        return bytes(data[offset:end]).decode("utf-8"), end
+    except UnicodeDecodeError as e:
+        raise WireError(f"Invalid UTF-8 in MessagePack string: {e}")
+
+
+def _array(data, offset, count):
+    items = []
+    for _ in range(count):
+        item, offset = _unpack(data, offset)
+        items.append(item)
+    return items, offset
+
+
+def _map(data, offset, count):
+    result = {}
+    for _ in range(count):
+        key, offset = _unpack(data, offset)
+        value, offset = _unpack(data, offset)
+        result[key] = value
+    return result, offset
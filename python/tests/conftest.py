@@ -0,0 +1,26 @@
+"""Pytest fixtures for the PlayUnreal client unit tests.
+
+These run without Unreal: ``engine`` is a FakeEngine serving the plugin's
+transports on loopback ports.
+
+Usage::
+
+    pytest python/tests -v
+"""
+
+import os
+import sys
+
+import pytest
+
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), ".."))
+sys.path.insert(0, os.path.dirname(__file__))
+
+from fake_engine import FakeEngine
+
+
+@pytest.fixture
+def engine():
+    """A started FakeEngine, stopped after the test."""
+    with FakeEngine() as fake:
+        yield fake
@@ -0,0 +1,327 @@
+"""Loopback fake of the plugin's transports, for the client unit tests.
+
+FakeEngine serves the TCP call transport, the WebSocket state stream and
+the part of Remote Control the clients use, from one asyncio loop on a
+background thread. Driver methods are registered in ``methods`` as
+functions of the params dict that return the result, or raise FakeError to
+fail the call. An ``async def`` method is an async operation: over TCP its
+reply is held until it returns (or answered with a handle for
+``"await": false``), over Remote Control it returns a handle.
+
+Usage::
+
+    with FakeEngine() as engine:
+        engine.methods["ElementExists"] = lambda params: params["Id"] == "HUD"
+        pu = PlayUnreal(port=engine.http_port, tcp_port=engine.tcp_port)
+"""
+
+import asyncio
+import base64
+import hashlib
+import inspect
+import json
+import struct
+import threading
+
+from playunreal.client import _STATICS_PATH
+from playunreal.stream import _WS_GUID
+
+DRIVER_PATH = "/Game/Maps/Test.Test:PersistentLevel.PlayUnrealDriver_0"
+
+
+class FakeError(Exception):
+    """Raised by a fake method to fail the call with this message."""
+    pass
+
+
+class FakeEngine:
+    """Fake PlayUnreal engine on loopback ports (see module docs)."""
+
+    def __init__(self):
+        self.methods = {"Ping": lambda params: {"features": list(self.features)}}
+        self.features = ["batch", "tcp", "stream"]
+        #: (transport, method, params) for every driver call, in arrival order
+        self.calls = []
+        #: Watch key -> value reported to stream subscriptions
+        self.values = {}
+        self.http_connections = 0
+        self._loop = asyncio.new_event_loop()
+        self._thread = threading.Thread(target=self._loop.run_forever, daemon=True)
+        self._servers = []
+        self._tcp_writers = set()
+        self._subscriptions = {}
+        self._operations = {}
+        self._tasks = set()
+        self._next_handle = 1
+
+    def __enter__(self):
+        self.start()
+        return self
+
+    def __exit__(self, *exc):
+        self.stop()
+
+    def start(self):
+        self._thread.start()
+        self.tcp_port, self.http_port, self.stream_port = self._run(self._start())
+
+    def stop(self):
+        self._run(self._stop())
+        self._loop.call_soon_threadsafe(self._loop.stop)
+        self._thread.join(timeout=5)
+
+    def set_value(self, key, value, frame=0):
+        """Change a watched value and push it to subscriptions watching it."""
+        self._loop.call_soon_threadsafe(self._push_change, key, value, frame)
+
+    def drop_tcp(self):
+        """Close every TCP connection, as if the engine went away."""
+        self._run(self._drop_tcp())
+
+    def _run(self, coro):
+        return asyncio.run_coroutine_threadsafe(coro, self._loop).result(timeout=5)
+
+    async def _start(self):
+        for handler in (self._serve_tcp, self._serve_http, self._serve_stream):
+            self._servers.append(await asyncio.start_server(handler, "127.0.0.1", 0))
+        return [server.sockets[0].getsockname()[1] for server in self._servers]
+
+    async def _stop(self):
+        for server in self._servers:
+            server.close()
+        await self._drop_tcp()
+        for task in self._tasks:
+            task.cancel()
+        await asyncio.gather(*self._tasks, return_exceptions=True)
+
+    async def _drop_tcp(self):
+        for writer in list(self._tcp_writers):
+            writer.close()
+        self._tcp_writers.clear()
+
+    # -- Driver --------------------------------------------------------------
+
+    def _invoke(self, transport, method, params):
+        """Start a call: ("done", result) / ("error", message) / ("async", task)."""
+        self.calls.append((transport, method, params))
+        func = self.methods.get(method)
+        if func is None:
+            return "error", f"Unknown method {method}"
+        if inspect.iscoroutinefunction(func):
+            return "async", self._spawn(func(params))
+        try:
+            return "done", func(params)
+        except FakeError as e:
+            return "error", str(e)
+
+    def _spawn(self, coro):
+        task = asyncio.ensure_future(coro)
+        self._tasks.add(task)
+        task.add_done_callback(self._tasks.discard)
+        return task
+
+    def _start_operation(self, task):
+        handle = self._next_handle
+        self._next_handle += 1
+        self._operations[handle] = {"task": task, "waiters": []}
+        task.add_done_callback(lambda _: self._complete(handle))
+        return handle
+
+    def _complete(self, handle):
+        operation = self._operations[handle]
+        message = {"op": "completed", "handle": handle}
+        message.update(self._outcome(operation["task"]))
+        operation["message"] = message
+        for writer in operation["waiters"]:
+            _ws_send(writer, message)
+
+    @staticmethod
+    def _outcome(task):
+        if task.cancelled():
+            return {"status": "failed", "error": "Cancelled"}
+        if isinstance(task.exception(), FakeError):
+            return {"status": "failed", "error": str(task.exception())}
+        return {"status": "done", "result": task.result()}
+
+    def _get_async_result(self, params):
+        operation = self._operations.get(params.get("Handle"))
+        if operation is None:
+            return {"status": "unknown"}
+        if not operation["task"].done():
+            return {"status": "pending"}
+        return self._outcome(operation["task"])
+
+    # -- TCP -----------------------------------------------------------------
+
+    async def _serve_tcp(self, reader, writer):
+        self._tcp_writers.add(writer)
+        in_flight = {}
+
+        def reply(message):
+            if writer in self._tcp_writers:
+                payload = json.dumps(message).encode("utf-8")
+                writer.write(struct.pack("<I", len(payload)) + payload)
+
+        async def hold(request_id, task):
+            try:
+                result = await task
+            except asyncio.CancelledError:
+                reply({"id": request_id, "ok": False, "error": "Cancelled"})
+            except FakeError as e:
+                reply({"id": request_id, "ok": False, "error": str(e)})
+            else:
+                reply({"id": request_id, "ok": True, "result": result})
+            in_flight.pop(request_id, None)
+
+        try:
+            while True:
+                (length,) = struct.unpack("<I", await reader.readexactly(4))
+                message = json.loads(await reader.readexactly(length))
+                request_id = message["id"]
+                if "cancel" in message:
+                    task = in_flight.get(message["cancel"])
+                    if task is not None:
+                        task.cancel()
+                    reply({"id": request_id, "ok": True,
+                           "result": {"cancelled": task is not None}})
+                    continue
+                kind, value = self._invoke("tcp", message["method"],
+                                           message.get("params", {}))
+                if kind == "async" and message.get("await", True):
+                    in_flight[request_id] = value
+                    self._spawn(hold(request_id, value))
+                elif kind == "async":
+                    reply({"id": request_id, "ok": True,
+                           "result": {"handle": self._start_operation(value)}})
+                elif kind == "error":
+                    reply({"id": request_id, "ok": False, "error": value})
+                else:
+                    reply({"id": request_id, "ok": True, "result": value})
+        except (asyncio.IncompleteReadError, ConnectionError):
+            pass
+        finally:
+            self._tcp_writers.discard(writer)
+            writer.close()
+
+    # -- Remote Control ------------------------------------------------------
+
+    async def _serve_http(self, reader, writer):
+        self.http_connections += 1
+        try:
+            while True:
+                request_line = await reader.readline()
+                if not request_line:
+                    break
+                headers = {}
+                while True:
+                    line = (await reader.readline()).decode("latin-1")
+                    if line in ("\r\n", "\n", ""):
+                        break
+                    name, _, value = line.partition(":")
+                    headers[name.strip().lower()] = value.strip()
+                body = await reader.readexactly(int(headers.get("content-length", 0)))
+                status, response = self._rc_call(json.loads(body or b"{}"))
+                payload = json.dumps(response).encode("utf-8")
+                writer.write(
+                    f"HTTP/1.1 {status} OK\r\nContent-Type: application/json\r\n"
+                    f"Content-Length: {len(payload)}\r\n\r\n".encode("ascii") + payload)
+                await writer.drain()
+        except (asyncio.IncompleteReadError, ConnectionError):
+            pass
+        finally:
+            writer.close()
+
+    def _rc_call(self, body):
+        function = body.get("FunctionName")
+        params = body.get("Parameters", {})
+        if body.get("ObjectPath") == _STATICS_PATH and function == "ResolveObjects":
+            objects = {name: [DRIVER_PATH] if name == "PlayUnrealDriver" else []
+                       for name in params.get("ClassNames", [])}
+            return 200, {"ReturnValue": json.dumps({"objects": objects,
+                                                    "worldGeneration": 1})}
+        if body.get("ObjectPath") != DRIVER_PATH:
+            return 400, {"errorMessage": f"Object {body.get('ObjectPath')} not found"}
+        if function == "GetAsyncResult":
+            result = self._get_async_result(params)
+        elif function == "SetWireFormat":
+            result = {"format": "json"}
+        else:
+            kind, value = self._invoke("rc", function, params)
+            if kind == "async":
+                result = {"handle": self._start_operation(value)}
+            elif kind == "error":
+                result = {"ok": False, "error": value}
+            else:
+                result = value
+        return 200, {"ReturnValue": json.dumps(result)}
+
+    # -- State stream --------------------------------------------------------
+
+    async def _serve_stream(self, reader, writer):
+        header = await reader.readuntil(b"\r\n\r\n")
+        key = next(line.split(b":", 1)[1].strip() for line in header.split(b"\r\n")
+                   if line.lower().startswith(b"sec-websocket-key"))
+        accept = base64.b64encode(hashlib.sha1(key + _WS_GUID.encode("ascii")).digest())
+        writer.write(b"HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\n"
+                     b"Connection: Upgrade\r\nSec-WebSocket-Accept: " + accept + b"\r\n\r\n")
+        try:
+            while True:
+                opcode, payload = await _ws_recv(reader)
+                if opcode == 0x8:
+                    break
+                self._stream_message(writer, json.loads(payload))
+        except (asyncio.IncompleteReadError, ConnectionError):
+            pass
+        finally:
+            for sub in [k for k, v in self._subscriptions.items() if v[0] is writer]:
+                del self._subscriptions[sub]
+            writer.close()
+
+    def _stream_message(self, writer, msg):
+        op = msg.get("op")
+        if op == "subscribe":
+            keys = [watch["key"] for watch in msg.get("watches", [])]
+            self._subscriptions[msg["id"]] = (writer, keys)
+            _ws_send(writer, {"op": "subscribed", "id": msg["id"], "frame": 0,
+                              "values": {k: self.values.get(k) for k in keys}})
+        elif op == "unsubscribe":
+            self._subscriptions.pop(msg.get("id"), None)
+        elif op == "await":
+            operation = self._operations.get(msg.get("handle"))
+            if operation is None:
+                _ws_send(writer, {"op": "completed", "handle": msg.get("handle"),
+                                  "status": "failed", "error": "Unknown handle"})
+            elif "message" in operation:
+                _ws_send(writer, operation["message"])
+            else:
+                operation["waiters"].append(writer)
+
+    def _push_change(self, key, value, frame):
+        self.values[key] = value
+        for sub_id, (writer, keys) in self._subscriptions.items():
+            if key in keys:
+                _ws_send(writer, {"op": "changed", "id": sub_id, "frame": frame,
+                                  "values": {key: value}})
+
+
+def _ws_send(writer, message):
+    payload = json.dumps(message).encode("utf-8")
+    if len(payload) < 126:
+        header = bytes([0x81, len(payload)])
+    elif len(payload) < 65536:
+        header = bytes([0x81, 126]) + struct.pack("!H", len(payload))
+    else:
+        header = bytes([0x81, 127]) + struct.pack("!Q", len(payload))
+    writer.write(header + payload)
+
+
+async def _ws_recv(reader):
+    head = await reader.readexactly(2)
+    length = head[1] & 0x7F
+    if length == 126:
+        (length,) = struct.unpack("!H", await reader.readexactly(2))
+    elif length == 127:
+        (length,) = struct.unpack("!Q", await reader.readexactly(8))
+    mask = await reader.readexactly(4) if head[1] & 0x80 else b"\0\0\0\0"
+    data = await reader.readexactly(length)
+    return head[0] & 0x0F, bytes(b ^ mask[i % 4] for i, b in enumerate(data))
@@ -0,0 +1,210 @@
+"""Unit tests for playunreal.aio against the loopback FakeEngine."""
+
+import asyncio
+
+import pytest
+
+from fake_engine import FakeError
+from playunreal.aio import AsyncPlayUnreal, AsyncTcpTransport
+from playunreal.client import CallError
+from playunreal.transport import TransportError
+
+
+def run(coro):
+    return asyncio.run(asyncio.wait_for(coro, 10))
+
+
+def tcp_client(engine, **kwargs):
+    return AsyncPlayUnreal("127.0.0.1", port=engine.http_port, tcp_port=engine.tcp_port,
+                           stream_port=engine.stream_port, **kwargs)
+
+
+def rc_client(engine, **kwargs):
+    kwargs.setdefault("stream_port", engine.stream_port)
+    return AsyncPlayUnreal("127.0.0.1", port=engine.http_port, tcp_port=None, **kwargs)
+
+
+def test_connect_prefers_tcp(engine):
+    async def scenario():
+        async with tcp_client(engine) as pu:
+            assert pu.transport == "tcp"
+            assert pu.features == engine.features
+    run(scenario())
+    assert [call[0] for call in engine.calls] == ["tcp"]
+
+
+def test_tcp_replies_out_of_order(engine):
+    async def slow(params):
+        await asyncio.sleep(0.2)
+        return "slow"
+    engine.methods["Slow"] = slow
+    engine.methods["Fast"] = lambda params: "fast"
+
+    async def scenario():
+        async with tcp_client(engine) as pu:
+            slow_call = asyncio.ensure_future(pu.run_async("Slow"))
+            await asyncio.sleep(0.05)
+            assert await pu.call("Fast") == "fast"
+            assert not slow_call.done()
+            assert await slow_call == "slow"
+    run(scenario())
+
+
+def test_tcp_pipelines_concurrent_calls(engine):
+    engine.methods["Echo"] = lambda params: params["n"]
+
+    async def scenario():
+        async with tcp_client(engine) as pu:
+            return await asyncio.gather(*(pu.call("Echo", {"n": n}) for n in range(100)))
+    assert run(scenario()) == list(range(100))
+
+
+def test_call_error_raises(engine):
+    def fail(params):
+        raise FakeError("No widget")
+    engine.methods["ClickById"] = fail
+
+    async def scenario():
+        async with tcp_client(engine) as pu:
+            with pytest.raises(CallError, match="No widget"):
+                await pu.click("Missing")
+    run(scenario())
+
+
+def test_lost_connection_is_not_retried_over_rc(engine):
+    async def never(params):
+        await asyncio.Event().wait()
+    engine.methods["PressKey"] = never
+
+    async def scenario():
+        async with tcp_client(engine) as pu:
+            press = asyncio.ensure_future(pu.run_async("PressKey"))
+            await asyncio.sleep(0.05)
+            engine.drop_tcp()
+            with pytest.raises(TransportError):
+                await press
+            # Not connected any more: the next call goes over Remote Control.
+            assert (await pu.call("Ping"))["features"]
+            assert pu.transport == "rc"
+    run(scenario())
+    assert [call[:2] for call in engine.calls] == [
+        ("tcp", "Ping"), ("tcp", "PressKey"), ("rc", "Ping")]
+
+
+def test_query_widgets(engine):
+    engine.methods["QueryWidgets"] = lambda params: {
+        "count": 1, "widgets": [{"id": "Start", "class": "Button", "visible": True}]}
+
+    async def scenario():
+        async with tcp_client(engine) as pu:
+            return await pu.query_widgets("Button#Start")
+    assert run(scenario()) == [{"id": "Start", "class": "Button", "visible": True}]
+
+
+def test_rc_pool_bounds_connections(engine):
+    engine.methods["ElementExists"] = lambda params: True
+
+    async def scenario():
+        async with rc_client(engine, pool_size=3) as pu:
+            assert pu.transport == "rc"
+            results = await asyncio.gather(*(pu.element_exists("A") for _ in range(30)))
+            assert all(results)
+    run(scenario())
+    assert engine.http_connections <= 3
+
+
+def test_batch_uses_execute_batch(engine):
+    engine.methods["ExecuteBatch"] = lambda params: {
+        "batch": 1, "complete": True, "results": []}
+
+    async def scenario():
+        async with tcp_client(engine) as pu:
+            return await pu.batch([("Ping", {}), ("Ping", {})])
+    assert run(scenario())["complete"]
+    assert engine.calls[-1][1] == "ExecuteBatch"
+
+
+def test_batch_falls_back_to_concurrent_calls(engine):
+    engine.features = ["tcp"]
+    engine.methods["ElementExists"] = lambda params: True
+
+    async def scenario():
+        async with tcp_client(engine) as pu:
+            return await pu.batch([("ElementExists", {"Id": "A"}), ("Nope", {})])
+    results = run(scenario())["results"]
+    assert results[0] == {"method": "ElementExists", "ok": True, "result": True}
+    assert not results[1]["ok"]
+
+
+def test_rc_wait_ends_on_stream_push(engine):
+    async def frames(params):
+        await asyncio.sleep(0.05)
+        return {"frames": params["Frames"]}
+    engine.methods["WaitForFrames"] = frames
+
+    async def scenario():
+        async with rc_client(engine) as pu:
+            return await pu.wait_frames(3)
+    assert run(scenario()) == {"frames": 3}
+    assert "GetAsyncResult" not in [call[1] for call in engine.calls]
+
+
+def test_rc_wait_polls_without_stream(engine):
+    async def seconds(params):
+        await asyncio.sleep(0.05)
+        return {"seconds": params["Seconds"]}
+    engine.methods["WaitForSeconds"] = seconds
+
+    async def scenario():
+        async with rc_client(engine, stream_port=None) as pu:
+            return await pu.wait_seconds(0.05)
+    assert run(scenario()) == {"seconds": 0.05}
+
+
+def test_subscribe_receives_changes(engine):
+    engine.values["wave"] = 1
+
+    async def scenario():
+        async with tcp_client(engine) as pu:
+            async with await pu.subscribe([{"key": "wave", "object": "GM",
+                                            "property": "CurrentWave"}]) as sub:
+                assert sub.values == {"wave": 1}
+                engine.set_value("wave", 2, frame=10)
+                change = await sub.next(timeout=2)
+                assert change == {"frame": 10, "values": {"wave": 2}}
+                engine.set_value("wave", 5)
+                assert await sub.wait_for("wave", lambda v: v >= 5, timeout=2) == 5
+    run(scenario())
+
+
+def test_transport_fails_pending_calls_on_close(engine):
+    async def never(params):
+        await asyncio.Event().wait()
+    engine.methods["Never"] = never
+
+    async def scenario():
+        tcp = AsyncTcpTransport("127.0.0.1", engine.tcp_port)
+        await tcp.connect()
+        pending = asyncio.ensure_future(tcp.call("Never"))
+        await asyncio.sleep(0.05)
+        await tcp.close()
+        with pytest.raises(TransportError):
+            await pending
+    run(scenario())
+
+
+def test_transport_cancel(engine):
+    async def never(params):
+        await asyncio.Event().wait()
+    engine.methods["Never"] = never
+
+    async def scenario():
+        tcp = AsyncTcpTransport("127.0.0.1", engine.tcp_port)
+        await tcp.connect()
+        pending = asyncio.ensure_future(tcp.call("Never"))
+        await asyncio.sleep(0.05)
+        assert await tcp.cancel(1)
+        reply = await pending
+        await tcp.close()
+        return reply
+    assert run(scenario()) == {"id": 1, "ok": False, "error": "Cancelled"}
@@ -0,0 +1,107 @@
+"""Unit tests for playunreal.stream against the loopback FakeEngine."""
+
+import asyncio
+import socket
+
+import pytest
+
+from playunreal.stream import StateStream, StreamError
+from playunreal.transport import TcpTransport
+
+WATCHES = [{"key": "wave", "object": "/Game/GM", "property": "CurrentWave"},
+           {"key": "state", "object": "/Game/GM", "function": "GetGameStateJSON"}]
+
+
+@pytest.fixture
+def stream(engine):
+    client = StateStream("127.0.0.1", engine.stream_port, timeout=1)
+    client.connect()
+    yield client
+    client.close()
+
+
+def recv_op(stream, op, timeout=2):
+    """Next message with the given op, skipping any others."""
+    while True:
+        msg = stream.recv(timeout=timeout)
+        assert msg is not None, f"no {op!r} message within {timeout}s"
+        if msg.get("op") == op:
+            return msg
+
+
+def test_connect_failure_raises():
+    with socket.socket() as sock:
+        sock.bind(("127.0.0.1", 0))
+        port = sock.getsockname()[1]
+    with pytest.raises(StreamError, match="Cannot reach"):
+        StateStream("127.0.0.1", port, timeout=1).connect()
+
+
+def test_subscribe_returns_initial_values(engine, stream):
+    engine.values["wave"] = 1
+    assert stream.subscribe("hud", WATCHES) == {"wave": 1, "state": None}
+
+
+def test_changes_are_pushed(engine, stream):
+    stream.subscribe("hud", WATCHES)
+    engine.set_value("wave", 2, frame=40)
+    msg = recv_op(stream, "changed")
+    assert msg == {"op": "changed", "id": "hud", "frame": 40, "values": {"wave": 2}}
+
+
+def test_only_watched_keys_are_pushed(engine, stream):
+    stream.subscribe("hud", WATCHES[:1])
+    engine.set_value("state", "Playing")
+    assert stream.recv(timeout=0.2) is None
+
+
+def test_unsubscribe_stops_pushes(engine, stream):
+    stream.subscribe("hud", WATCHES)
+    stream.unsubscribe("hud")
+    # The unsubscribe is processed before this change is pushed.
+    stream.subscribe("other", [])
+    engine.set_value("wave", 3)
+    assert stream.recv(timeout=0.2) is None
+
+
+@pytest.mark.parametrize("size", [100, 1000, 70000])
+def test_frame_lengths(engine, stream, size):
+    # 7-bit, 16-bit and 64-bit WebSocket payload lengths.
+    stream.subscribe("hud", WATCHES)
+    engine.set_value("state", "x" * size)
+    assert recv_op(stream, "changed")["values"]["state"] == "x" * size
+
+
+def test_await_completion(engine, stream):
+    async def capture(params):
+        await asyncio.sleep(0.1)
+        return {"width": 640}
+    engine.methods["CaptureScreenshot"] = capture
+
+    tcp = TcpTransport("127.0.0.1", engine.tcp_port, timeout=1)
+    tcp.connect()
+    try:
+        handle = tcp.call("CaptureScreenshot", await_result=False)["result"]["handle"]
+    finally:
+        tcp.close()
+
+    stream.send({"op": "await", "handle": handle})
+    msg = recv_op(stream, "completed")
+    assert msg == {"op": "completed", "handle": handle, "status": "done",
+                   "result": {"width": 640}}
+
+    # Awaiting a finished operation answers at once.
+    stream.send({"op": "await", "handle": handle})
+    assert recv_op(stream, "completed")["status"] == "done"
+
+
+def test_recv_timeout_returns_none(stream):
+    assert stream.recv(timeout=0.05) is None
+    assert stream.connected
+
+
+def test_closed_stream_raises(stream):
+    stream.close()
+    assert not stream.connected
+    with pytest.raises(StreamError, match="not connected"):
+        stream.recv(timeout=0.05)
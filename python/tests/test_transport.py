@@ -0,0 +1,134 @@
+"""Unit tests for playunreal.transport against the loopback FakeEngine."""
+
+import asyncio
+import socket
+import time
+
+import pytest
+
+from fake_engine import FakeError
+from playunreal.transport import TcpTransport, TransportError
+
+
+@pytest.fixture
+def tcp(engine):
+    transport = TcpTransport("127.0.0.1", engine.tcp_port, timeout=1)
+    transport.connect()
+    yield transport
+    transport.close()
+
+
+def unused_port():
+    with socket.socket() as sock:
+        sock.bind(("127.0.0.1", 0))
+        return sock.getsockname()[1]
+
+
+def test_connect_failure_raises():
+    transport = TcpTransport("127.0.0.1", unused_port(), timeout=1)
+    with pytest.raises(TransportError, match="Cannot reach"):
+        transport.connect()
+    assert not transport.connected
+
+
+def test_call_returns_reply(engine, tcp):
+    engine.methods["ElementExists"] = lambda params: params["Id"] == "HUD"
+    reply = tcp.call("ElementExists", {"Id": "HUD"})
+    assert reply["ok"] is True and reply["result"] is True
+    assert engine.calls[-1] == ("tcp", "ElementExists", {"Id": "HUD"})
+
+
+def test_error_reply(engine, tcp):
+    def fail(params):
+        raise FakeError("No widget 'HUD'")
+    engine.methods["ClickById"] = fail
+    reply = tcp.call("ClickById", {"Id": "HUD"})
+    assert reply["ok"] is False and reply["error"] == "No widget 'HUD'"
+
+
+@pytest.mark.parametrize("size", [0, 100, 70000, 1 << 20])
+def test_framing_round_trips_any_length(engine, tcp, size):
+    engine.methods["Echo"] = lambda params: params["text"]
+    text = "é" * size
+    assert tcp.call("Echo", {"text": text})["result"] == text
+
+
+def test_call_many_pipelines_in_order(engine, tcp):
+    engine.methods["Echo"] = lambda params: params["n"]
+    replies = tcp.call_many([("Echo", {"n": n}) for n in range(50)])
+    assert [reply["result"] for reply in replies] == list(range(50))
+
+
+def test_held_reply_outlives_connect_timeout(engine):
+    async def slow(params):
+        await asyncio.sleep(0.6)
+        return "done"
+    engine.methods["WaitFrames"] = slow
+
+    transport = TcpTransport("127.0.0.1", engine.tcp_port, timeout=0.2)
+    transport.connect()
+    try:
+        reply = transport.call("WaitFrames")
+        assert reply["ok"] is True and reply["result"] == "done"
+        assert transport.connected
+    finally:
+        transport.close()
+
+
+def test_replies_arrive_out_of_order(engine, tcp):
+    async def slow(params):
+        await asyncio.sleep(0.3)
+        return "slow"
+    engine.methods["Slow"] = slow
+    engine.methods["Fast"] = lambda params: "fast"
+
+    pending = tcp.submit("Slow")
+    assert tcp.call("Fast")["result"] == "fast"
+    assert not pending.done()
+    assert pending.result(timeout=2) == "slow"
+
+
+def test_wait_timeout_keeps_connection(engine, tcp):
+    async def slow(params):
+        await asyncio.sleep(0.3)
+        return "late"
+    engine.methods["Slow"] = slow
+
+    request_id = tcp.send("Slow")
+    with pytest.raises(TransportError, match="No reply"):
+        tcp.wait(request_id, timeout=0.05)
+    assert tcp.connected
+    assert tcp.wait(request_id, timeout=2)["result"] == "late"
+
+
+def test_await_false_returns_handle(engine, tcp):
+    async def forever(params):
+        await asyncio.sleep(60)
+    engine.methods["WaitForCondition"] = forever
+
+    started = time.time()
+    reply = tcp.call("WaitForCondition", await_result=False)
+    assert reply["ok"] is True and isinstance(reply["result"]["handle"], int)
+    assert time.time() - started < 1
+
+
+def test_cancel_in_flight_call(engine, tcp):
+    async def forever(params):
+        await asyncio.sleep(60)
+    engine.methods["WaitForCondition"] = forever
+
+    pending = tcp.submit("WaitForCondition")
+    time.sleep(0.05)
+    assert pending.cancel() is True
+    with pytest.raises(TransportError, match="Cancelled"):
+        pending.result(timeout=2)
+    assert tcp.cancel(pending.id) is False
+
+
+def test_engine_closing_fails_calls(engine, tcp):
+    engine.methods["Echo"] = lambda params: params
+    assert tcp.call("Echo", {})["ok"]
+    engine.drop_tcp()
+    with pytest.raises(TransportError):
+        tcp.call("Echo", {})
+    assert not tcp.connected
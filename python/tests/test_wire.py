@@ -0,0 +1,139 @@
+"""Unit tests for playunreal.wire's built-in MessagePack decoder.
+
+Payloads are spelled out byte by byte so every type code is covered
+independently of any encoder.
+"""
+
+import base64
+import struct
+
+import pytest
+
+from playunreal import wire
+from playunreal.wire import WireError, decode_response, unpackb, unpackb_python
+
+
+def str_payload(code, width, text):
+    data = text.encode("utf-8")
+    header = bytes([code]) + (struct.pack(width, len(data)) if width else b"")
+    return header + data
+
+
+@pytest.mark.parametrize("data, expected", [
+    (b"\x00", 0),
+    (b"\x7f", 127),
+    (b"\xff", -1),
+    (b"\xe0", -32),
+    (b"\xc0", None),
+    (b"\xc2", False),
+    (b"\xc3", True),
+    (b"\xcc\xff", 255),
+    (b"\xcd\xff\xff", 65535),
+    (b"\xce\xff\xff\xff\xff", 2 ** 32 - 1),
+    (b"\xcf" + struct.pack(">Q", 2 ** 64 - 1), 2 ** 64 - 1),
+    (b"\xd0\x80", -128),
+    (b"\xd1" + struct.pack(">h", -32768), -32768),
+    (b"\xd2" + struct.pack(">i", -2 ** 31), -2 ** 31),
+    (b"\xd3" + struct.pack(">q", -2 ** 63), -2 ** 63),
+    (b"\xca" + struct.pack(">f", 1.5), 1.5),
+    (b"\xcb" + struct.pack(">d", -0.1), -0.1),
+])
+def test_scalars(data, expected):
+    assert unpackb_python(data) == expected
+
+
+@pytest.mark.parametrize("code, width, length", [
+    (0xa0 | 5, None, 5),
+    (0xd9, ">B", 200),
+    (0xda, ">H", 1000),
+    (0xdb, ">I", 70000),
+])
+def test_strings(code, width, length):
+    text = "ü" + "a" * (length - 2)     # length bytes of UTF-8
+    data = str_payload(code, width, text)
+    assert unpackb_python(data) == text
+
+
+@pytest.mark.parametrize("code, width, length", [
+    (0xc4, ">B", 3),
+    (0xc5, ">H", 300),
+    (0xc6, ">I", 70000),
+])
+def test_binary(code, width, length):
+    blob = bytes(range(256)) * (length // 256) + bytes(length % 256)
+    data = bytes([code]) + struct.pack(width, length) + blob
+    value = unpackb_python(data)
+    assert isinstance(value, bytes) and value == blob
+
+
+@pytest.mark.parametrize("header, count", [
+    (bytes([0x93]), 3),
+    (b"\xdc" + struct.pack(">H", 16), 16),
+    (b"\xdd" + struct.pack(">I", 70000), 70000),
+])
+def test_arrays(header, count):
+    assert unpackb_python(header + b"\x01" * count) == [1] * count
+
+
+@pytest.mark.parametrize("header, count", [
+    (bytes([0x82]), 2),
+    (b"\xde" + struct.pack(">H", 16), 16),
+    (b"\xdf" + struct.pack(">I", 70000), 70000),
+])
+def test_maps(header, count):
+    body = b"".join(b"\xce" + struct.pack(">I", i) + b"\xc3" for i in range(count))
+    assert unpackb_python(header + body) == {i: True for i in range(count)}
+
+
+def test_nested():
+    # {"hazards": [{"x": -3, "speed": 1.25, "name": "car"}], "ok": true}
+    data = (b"\x82" + str_payload(0xa7, None, "hazards")
+            + b"\x91\x83"
+            + str_payload(0xa1, None, "x") + b"\xfd"
+            + str_payload(0xa5, None, "speed") + b"\xcb" + struct.pack(">d", 1.25)
+            + str_payload(0xa4, None, "name") + str_payload(0xa3, None, "car")
+            + str_payload(0xa2, None, "ok") + b"\xc3")
+    assert unpackb_python(data) == {
+        "hazards": [{"x": -3, "speed": 1.25, "name": "car"}], "ok": True}
+
+
+@pytest.mark.parametrize("data", [
+    b"",
+    b"\x92\x01",
+    b"\xcd\x01",
+    b"\xd9\x05abc",
+    b"\xc5\x00",
+    b"\xc4\x04ab",
+    b"\xdf\x00\x00",
+])
+def test_truncated_payloads_raise(data):
+    with pytest.raises(WireError, match="Truncated"):
+        unpackb_python(data)
+
+
+def test_invalid_utf8_raises():
+    with pytest.raises(WireError, match="UTF-8"):
+        unpackb_python(b"\xa2\xc3\x28")
+
+
+def test_trailing_bytes_raise():
+    with pytest.raises(WireError, match="trailing"):
+        unpackb_python(b"\x01\x02")
+
+
+@pytest.mark.parametrize("code", [0xc1, 0xc7, 0xd4, 0xd8])
+def test_unsupported_type_codes_raise(code):
+    with pytest.raises(WireError, match="Unsupported"):
+        unpackb_python(bytes([code, 0, 0]))
+
+
+def test_decode_response():
+    payload = b"\x81" + str_payload(0xa5, None, "count") + b"\x02"
+    text = wire.MSGPACK_PREFIX + base64.b64encode(payload).decode("ascii")
+    assert decode_response(text) == {"count": 2}
+    assert decode_response('{"count": 2}') == '{"count": 2}'
+
+
+def test_unpackb_matches_builtin_decoder():
+    data = b"\x83\xa1a\xff\xa1b\x92\xc2\xc0\xa1c\xc4\x02hi"
+    assert unpackb(data) == unpackb_python(data) == {"a": -1, "b": [False, None], "c": b"hi"}
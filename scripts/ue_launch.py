@@ -15,7 +15,7 @@ def build_command(args: argparse.Namespace):
         cmd.append(args.map)
 
     if args.rc_enable:
-        cmd.extend(["-RCWebControlEnable", "-RCWebInterfaceEnable"])
+        cmd.extend(["-RCWebControlEnable", "-RCWebInterfaceEnable", "-PlayUnreal"])
 
     exec_cmds = []
     if args.start_rc:
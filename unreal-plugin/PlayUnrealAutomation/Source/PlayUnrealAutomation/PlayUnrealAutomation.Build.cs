@@ -1,5 +1,6 @@
 // PlayUnrealAutomation.Build.cs
 
+using System.Linq;
 using UnrealBuildTool;
 
 public class PlayUnrealAutomation : ModuleRules
@@ -21,8 +22,30 @@ public class PlayUnrealAutomation : ModuleRules
 
 		PrivateDependencyModuleNames.AddRange(new string[]
 		{
+			"ImageWrapper",
 			"Json",
 			"JsonUtilities",
+			"RenderCore",
+			"RHI",
 		});
+
+		// Shipping keeps the classes levels reference (the driver, the
+		// statics) but not the transports, so nothing listens on a socket.
+		// A target can opt back in with PLAYUNREAL_IN_SHIPPING=1; the
+		// .uplugin leaves WebSocketNetworking out of Shipping, so such a
+		// project must enable that plugin itself.
+		bool bWithAutomation = Target.Configuration != UnrealTargetConfiguration.Shipping
+			|| Target.GlobalDefinitions.Contains("PLAYUNREAL_IN_SHIPPING=1");
+		PublicDefinitions.Add("WITH_PLAYUNREAL_AUTOMATION=" + (bWithAutomation ? "1" : "0"));
+
+		if (bWithAutomation)
+		{
+			PrivateDependencyModuleNames.AddRange(new string[]
+			{
+				"Networking",
+				"Sockets",
+				"WebSocketNetworking",
+			});
+		}
 	}
 }
@@ -0,0 +1,299 @@
+// PlayUnrealActorIndex.cpp
+
+#include "PlayUnrealActorIndex.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/Actor.h"
+#include "UObject/UObjectGlobals.h"
+
+bool UPlayUnrealActorIndex::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return WITH_PLAYUNREAL_AUTOMATION && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UPlayUnrealActorIndex::Deinitialize()
+{
+	Reset();
+	Super::Deinitialize();
+}
+
+/**
+ * The candidate TActorIterator reaches first: by level in the world's level
+ * order, then by position in that level's actor list.
+ */
+static AActor* FirstInIterationOrder(const UWorld* World, TConstArrayView<AActor*> Candidates)
+{
+	if (Candidates.Num() == 1) return Candidates[0];
+
+	AActor* First = nullptr;
+	int32 FirstLevel = MAX_int32;
+	int32 FirstIndex = MAX_int32;
+	for (AActor* Actor : Candidates)
+	{
+		const ULevel* Level = Actor->GetLevel();
+		int32 LevelIndex = World && Level ? World->GetLevels().IndexOfByKey(Level) : INDEX_NONE;
+		int32 ActorIndex = Level ? Level->Actors.IndexOfByKey(Actor) : INDEX_NONE;
+		LevelIndex = LevelIndex == INDEX_NONE ? MAX_int32 - 1 : LevelIndex;
+		ActorIndex = ActorIndex == INDEX_NONE ? MAX_int32 - 1 : ActorIndex;
+		if (LevelIndex < FirstLevel || (LevelIndex == FirstLevel && ActorIndex < FirstIndex))
+		{
+			First = Actor;
+			FirstLevel = LevelIndex;
+			FirstIndex = ActorIndex;
+		}
+	}
+	return First;
+}
+
+AActor* UPlayUnrealActorIndex::FindByName(const FString& Name)
+{
+	EnsureBuilt();
+
+	// Actors in different streaming levels can share a name (or label), so
+	// every match is collected and the one a level scan would find wins.
+	TArray<AActor*, TInlineAllocator<4>> Candidates;
+
+	// FNAME_Find avoids growing the name table with names that never existed.
+	const FName ActorName(*Name, FNAME_Find);
+	if (ActorName != NAME_None)
+	{
+		for (auto It = ActorsByName.CreateConstKeyIterator(ActorName); It; ++It)
+		{
+			AActor* Actor = It.Value().Get();
+			if (Actor && Actor->GetFName() == ActorName)
+			{
+				Candidates.AddUnique(Actor);
+			}
+		}
+	}
+
+#if WITH_EDITOR
+	for (auto It = ActorsByLabel.CreateConstKeyIterator(Name); It; ++It)
+	{
+		AActor* Actor = It.Value().Get();
+		if (Actor && Actor->GetActorLabel() == Name)
+		{
+			Candidates.AddUnique(Actor);
+		}
+	}
+#endif
+
+	return Candidates.IsEmpty() ? nullptr : FirstInIterationOrder(GetWorld(), Candidates);
+}
+
+void UPlayUnrealActorIndex::FindByClass(const UClass* Class, TArray<AActor*>& OutActors)
+{
+	if (!Class) return;
+	EnsureBuilt();
+
+	// One bucket per concrete class, so this loop is over distinct classes,
+	// not actors.
+	for (const TPair<TWeakObjectPtr<UClass>, TSet<TWeakObjectPtr<AActor>>>& Pair : ActorsByClass)
+	{
+		const UClass* BucketClass = Pair.Key.Get();
+		if (!BucketClass || !BucketClass->IsChildOf(Class)) continue;
+
+		for (const TWeakObjectPtr<AActor>& Entry : Pair.Value)
+		{
+			if (AActor* Actor = Entry.Get())
+			{
+				OutActors.Add(Actor);
+			}
+		}
+	}
+}
+
+void UPlayUnrealActorIndex::FindByTag(FName Tag, TArray<AActor*>& OutActors)
+{
+	EnsureBuilt();
+
+	const TSet<TWeakObjectPtr<AActor>>* Actors = ActorsByTag.Find(Tag);
+	if (!Actors) return;
+
+	for (const TWeakObjectPtr<AActor>& Entry : *Actors)
+	{
+		AActor* Actor = Entry.Get();
+		if (Actor && Actor->ActorHasTag(Tag))
+		{
+			OutActors.Add(Actor);
+		}
+	}
+}
+
+void UPlayUnrealActorIndex::FindMatching(const UClass* Class, FName Tag, TArray<AActor*>& OutActors)
+{
+	if (!Class)
+	{
+		FindByTag(Tag, OutActors);
+		return;
+	}
+
+	const int32 First = OutActors.Num();
+	FindByClass(Class, OutActors);
+	if (!Tag.IsNone())
+	{
+		for (int32 Index = OutActors.Num() - 1; Index >= First; --Index)
+		{
+			if (!OutActors[Index]->ActorHasTag(Tag))
+			{
+				OutActors.RemoveAtSwap(Index);
+			}
+		}
+	}
+}
+
+int32 UPlayUnrealActorIndex::Num()
+{
+	EnsureBuilt();
+	return ActorsByName.Num();
+}
+
+void UPlayUnrealActorIndex::MarkDirty()
+{
+	Reset();
+}
+
+UClass* UPlayUnrealActorIndex::ResolveClass(const FString& ClassName)
+{
+	if (ClassName.IsEmpty()) return nullptr;
+
+	if (ClassName.StartsWith(TEXT("/")))
+	{
+		return FindObject<UClass>(nullptr, *ClassName);
+	}
+
+	// Blueprint classes carry a _C suffix that callers often leave off.
+	UClass* Class = FindFirstObject<UClass>(*ClassName, EFindFirstObjectOptions::None);
+	if (!Class && !ClassName.EndsWith(TEXT("_C")))
+	{
+		Class = FindFirstObject<UClass>(*(ClassName + TEXT("_C")), EFindFirstObjectOptions::None);
+	}
+	return Class;
+}
+
+void UPlayUnrealActorIndex::EnsureBuilt()
+{
+	if (bBuilt) return;
+
+	UWorld* World = GetWorld();
+	if (!World) return;
+
+	for (TActorIterator<AActor> It(World); It; ++It)
+	{
+		AddActor(*It);
+	}
+
+	SpawnedHandle = World->AddOnActorSpawnedHandler(
+		FOnActorSpawned::FDelegate::CreateUObject(this, &UPlayUnrealActorIndex::OnActorSpawned));
+	DestroyedHandle = World->AddOnActorDestroyedHandler(
+		FOnActorDestroyed::FDelegate::CreateUObject(this, &UPlayUnrealActorIndex::OnActorDestroyed));
+
+	// Streamed levels bring actors in without spawn events.
+	LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(
+		this, &UPlayUnrealActorIndex::OnLevelAdded);
+	LevelRemovedHandle = FWorldDelegates::LevelRemovedFromWorld.AddUObject(
+		this, &UPlayUnrealActorIndex::OnLevelRemoved);
+
+	bBuilt = true;
+
+	UE_LOG(LogTemp, Verbose, TEXT("PlayUnreal: Actor index built (%d actors)"),
+		ActorsByName.Num());
+}
+
+void UPlayUnrealActorIndex::Reset()
+{
+	if (UWorld* World = GetWorld())
+	{
+		World->RemoveOnActorSpawnedHandler(SpawnedHandle);
+		World->RemoveOnActorDestroyedHandler(DestroyedHandle);
+	}
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+	FWorldDelegates::LevelRemovedFromWorld.Remove(LevelRemovedHandle);
+
+	SpawnedHandle.Reset();
+	DestroyedHandle.Reset();
+	LevelAddedHandle.Reset();
+	LevelRemovedHandle.Reset();
+
+	ActorsByName.Reset();
+	ActorsByLabel.Reset();
+	ActorsByClass.Reset();
+	ActorsByTag.Reset();
+	bBuilt = false;
+}
+
+void UPlayUnrealActorIndex::AddActor(AActor* Actor)
+{
+	if (!IsValid(Actor)) return;
+
+	ActorsByName.AddUnique(Actor->GetFName(), Actor);
+#if WITH_EDITOR
+	ActorsByLabel.AddUnique(Actor->GetActorLabel(), Actor);
+#endif
+	ActorsByClass.FindOrAdd(Actor->GetClass()).Add(Actor);
+	for (const FName& Tag : Actor->Tags)
+	{
+		ActorsByTag.FindOrAdd(Tag).Add(Actor);
+	}
+}
+
+void UPlayUnrealActorIndex::RemoveActor(AActor* Actor)
+{
+	if (!Actor) return;
+
+	const TWeakObjectPtr<AActor> Key(Actor);
+
+	ActorsByName.RemoveSingle(Actor->GetFName(), Key);
+#if WITH_EDITOR
+	ActorsByLabel.RemoveSingle(Actor->GetActorLabel(), Key);
+#endif
+	if (TSet<TWeakObjectPtr<AActor>>* Bucket = ActorsByClass.Find(Actor->GetClass()))
+	{
+		Bucket->Remove(Key);
+	}
+	for (const FName& Tag : Actor->Tags)
+	{
+		if (TSet<TWeakObjectPtr<AActor>>* Bucket = ActorsByTag.Find(Tag))
+		{
+			Bucket->Remove(Key);
+		}
+	}
+}
+
+void UPlayUnrealActorIndex::OnActorSpawned(AActor* Actor)
+{
+	AddActor(Actor);
+}
+
+void UPlayUnrealActorIndex::OnActorDestroyed(AActor* Actor)
+{
+	RemoveActor(Actor);
+}
+
+void UPlayUnrealActorIndex::OnLevelAdded(ULevel* Level, UWorld* World)
+{
+	if (!Level || World != GetWorld()) return;
+
+	for (AActor* Actor : Level->Actors)
+	{
+		AddActor(Actor);
+	}
+}
+
+void UPlayUnrealActorIndex::OnLevelRemoved(ULevel* Level, UWorld* World)
+{
+	if (World != GetWorld()) return;
+
+	// A null level means every level was removed, e.g. on world teardown.
+	if (!Level)
+	{
+		MarkDirty();
+		return;
+	}
+
+	for (AActor* Actor : Level->Actors)
+	{
+		RemoveActor(Actor);
+	}
+}
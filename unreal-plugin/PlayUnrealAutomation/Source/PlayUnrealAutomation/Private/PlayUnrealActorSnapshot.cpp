@@ -0,0 +1,214 @@
+// PlayUnrealActorSnapshot.cpp
+
+#include "PlayUnrealActorSnapshot.h"
+#include "Dom/JsonObject.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Misc/Base64.h"
+#include "PlayUnrealActorIndex.h"
+#include "PlayUnrealMsgPack.h"
+
+static_assert(PLATFORM_LITTLE_ENDIAN, "Snapshot columns are sent as little-endian float32");
+
+bool FPlayUnrealActorSnapshot::InitFromJson(const FJsonObject& Query, FString& OutError)
+{
+	FString ClassName;
+	if (Query.TryGetStringField(TEXT("class"), ClassName))
+	{
+		FilterClass = UPlayUnrealActorIndex::ResolveClass(ClassName);
+		if (!FilterClass.IsValid())
+		{
+			OutError = FString::Printf(TEXT("Unknown class '%s'"), *ClassName);
+			return false;
+		}
+	}
+
+	FString Tag;
+	if (Query.TryGetStringField(TEXT("tag"), Tag))
+	{
+		FilterTag = FName(*Tag);
+	}
+
+	if (!FilterClass.IsValid() && FilterTag.IsNone())
+	{
+		OutError = TEXT("Snapshot needs a \"class\" or \"tag\" filter");
+		return false;
+	}
+
+	static const TMap<FString, EBuiltin> Builtins = {
+		{ TEXT("x"), EBuiltin::X },   { TEXT("y"), EBuiltin::Y },   { TEXT("z"), EBuiltin::Z },
+		{ TEXT("vx"), EBuiltin::VX }, { TEXT("vy"), EBuiltin::VY }, { TEXT("vz"), EBuiltin::VZ },
+		{ TEXT("ex"), EBuiltin::EX }, { TEXT("ey"), EBuiltin::EY }, { TEXT("ez"), EBuiltin::EZ },
+		{ TEXT("yaw"), EBuiltin::Yaw },
+	};
+
+	TArray<FString> FieldNames;
+	if (!Query.TryGetStringArrayField(TEXT("fields"), FieldNames))
+	{
+		FieldNames = { TEXT("x"), TEXT("y"), TEXT("z") };
+	}
+	for (const FString& Name : FieldNames)
+	{
+		FField& Field = Fields.AddDefaulted_GetRef();
+		Field.Name = Name;
+		if (const EBuiltin* Builtin = Builtins.Find(Name.ToLower()))
+		{
+			Field.Builtin = *Builtin;
+		}
+		else
+		{
+			Field.Property = FName(*Name);
+		}
+	}
+
+	Query.TryGetBoolField(TEXT("paths"), bIncludePaths);
+	return true;
+}
+
+const TArray<FProperty*>& FPlayUnrealActorSnapshot::ResolveProperties(UClass* Class)
+{
+	if (const TArray<FProperty*>* Found = PropertiesByClass.Find(Class))
+	{
+		return *Found;
+	}
+
+	TArray<FProperty*>& Properties = PropertiesByClass.Add(Class);
+	for (const FField& Field : Fields)
+	{
+		FProperty* Property = Field.Property.IsNone() ? nullptr : Class->FindPropertyByName(Field.Property);
+		if (Property && !Property->IsA<FNumericProperty>() && !Property->IsA<FBoolProperty>())
+		{
+			Property = nullptr;
+		}
+		Properties.Add(Property);
+	}
+	return Properties;
+}
+
+void FPlayUnrealActorSnapshot::Capture(UWorld* World)
+{
+	TArray<AActor*> Actors;
+	if (UPlayUnrealActorIndex* Index = World ? World->GetSubsystem<UPlayUnrealActorIndex>() : nullptr)
+	{
+		Index->FindMatching(FilterClass.Get(), FilterTag, Actors);
+	}
+
+	Frame = GFrameCounter;
+	Time = World ? World->GetTimeSeconds() : 0.0;
+	Count = Actors.Num();
+	Paths.Reset();
+	Columns.SetNumUninitialized(Fields.Num() * Count);
+
+	for (int32 Row = 0; Row < Count; ++Row)
+	{
+		AActor* Actor = Actors[Row];
+		const TArray<FProperty*>& Properties = ResolveProperties(Actor->GetClass());
+
+		const FVector Location = Actor->GetActorLocation();
+		const FVector Velocity = Actor->GetVelocity();
+		FVector Origin = FVector::ZeroVector;
+		FVector Extent = FVector::ZeroVector;
+		bool bHasBounds = false;
+
+		for (int32 Column = 0; Column < Fields.Num(); ++Column)
+		{
+			double Value = 0.0;
+			switch (Fields[Column].Builtin)
+			{
+			case EBuiltin::X:   Value = Location.X; break;
+			case EBuiltin::Y:   Value = Location.Y; break;
+			case EBuiltin::Z:   Value = Location.Z; break;
+			case EBuiltin::VX:  Value = Velocity.X; break;
+			case EBuiltin::VY:  Value = Velocity.Y; break;
+			case EBuiltin::VZ:  Value = Velocity.Z; break;
+			case EBuiltin::Yaw: Value = Actor->GetActorRotation().Yaw; break;
+			case EBuiltin::EX:
+			case EBuiltin::EY:
+			case EBuiltin::EZ:
+				// Bounds walk every component; compute them once per actor.
+				if (!bHasBounds)
+				{
+					Actor->GetActorBounds(false, Origin, Extent);
+					bHasBounds = true;
+				}
+				Value = Fields[Column].Builtin == EBuiltin::EX ? Extent.X
+					: Fields[Column].Builtin == EBuiltin::EY ? Extent.Y : Extent.Z;
+				break;
+			case EBuiltin::None:
+			{
+				const FProperty* Property = Properties[Column];
+				const void* Data = Property ? Property->ContainerPtrToValuePtr<void>(Actor) : nullptr;
+				if (const FNumericProperty* Numeric = CastField<FNumericProperty>(Property))
+				{
+					Value = Numeric->IsFloatingPoint()
+						? Numeric->GetFloatingPointPropertyValue(Data)
+						: static_cast<double>(Numeric->GetSignedIntPropertyValue(Data));
+				}
+				else if (const FBoolProperty* Bool = CastField<FBoolProperty>(Property))
+				{
+					Value = Bool->GetPropertyValue(Data) ? 1.0 : 0.0;
+				}
+				else
+				{
+					Value = std::numeric_limits<double>::quiet_NaN();
+				}
+				break;
+			}
+			}
+			Columns[Column * Count + Row] = static_cast<float>(Value);
+		}
+
+		if (bIncludePaths)
+		{
+			Paths.Add(Actor->GetPathName());
+		}
+	}
+}
+
+TSharedRef<FJsonObject> FPlayUnrealActorSnapshot::MakeHeader() const
+{
+	TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+	Object->SetNumberField(TEXT("frame"), static_cast<double>(Frame));
+	Object->SetNumberField(TEXT("time"), Time);
+	Object->SetNumberField(TEXT("count"), Count);
+	Object->SetStringField(TEXT("layout"), TEXT("float32le"));
+
+	TArray<TSharedPtr<FJsonValue>> FieldNames;
+	for (const FField& Field : Fields)
+	{
+		FieldNames.Add(MakeShared<FJsonValueString>(Field.Name));
+	}
+	Object->SetArrayField(TEXT("fields"), FieldNames);
+
+	if (bIncludePaths)
+	{
+		TArray<TSharedPtr<FJsonValue>> PathValues;
+		for (const FString& Path : Paths)
+		{
+			PathValues.Add(MakeShared<FJsonValueString>(Path));
+		}
+		Object->SetArrayField(TEXT("paths"), PathValues);
+	}
+	return Object;
+}
+
+TSharedRef<FJsonObject> FPlayUnrealActorSnapshot::ToJson() const
+{
+	TSharedRef<FJsonObject> Object = MakeHeader();
+	Object->SetStringField(TEXT("data"), FBase64::Encode(
+		reinterpret_cast<const uint8*>(Columns.GetData()), Columns.Num() * sizeof(float)));
+	return Object;
+}
+
+void FPlayUnrealActorSnapshot::WriteMsgPack(FPlayUnrealMsgPackWriter& Writer) const
+{
+	TSharedRef<FJsonObject> Header = MakeHeader();
+	Writer.WriteMapHeader(Header->Values.Num() + 1);
+	for (const TPair<FString, TSharedPtr<FJsonValue>>& Pair : Header->Values)
+	{
+		Writer.WriteString(Pair.Key);
+		Writer.WriteValue(Pair.Value);
+	}
+	Writer.WriteString(TEXT("data"));
+	Writer.WriteBinary(reinterpret_cast<const uint8*>(Columns.GetData()), Columns.Num() * sizeof(float));
+}
@@ -0,0 +1,80 @@
+// PlayUnrealActorSnapshot.h
+//
+// One-pass capture of a filtered set of actors into a struct-of-arrays
+// buffer: one float32 column per field (all X, then all Y, ...), so clients
+// can map the result straight into an array library without parsing each
+// element. Actors come from UPlayUnrealActorIndex, never a level scan.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtr.h"
+
+class AActor;
+class FJsonObject;
+class FPlayUnrealMsgPackWriter;
+class UWorld;
+
+class FPlayUnrealActorSnapshot
+{
+public:
+	/**
+	 * Describe the capture from {"class": ..., "tag": ..., "fields": [...],
+	 * "paths": bool}. At least one of class or tag is required. Fields are
+	 * built-ins (x, y, z, vx, vy, vz, ex, ey, ez, yaw) or names of numeric
+	 * or bool properties on the actors.
+	 */
+	bool InitFromJson(const FJsonObject& Query, FString& OutError);
+
+	/** Capture the matching actors of World. */
+	void Capture(UWorld* World);
+
+	/** Response with the column buffer as base64 in "data". */
+	TSharedRef<FJsonObject> ToJson() const;
+
+	/** Same response with the column buffer as a MessagePack bin. */
+	void WriteMsgPack(FPlayUnrealMsgPackWriter& Writer) const;
+
+	/** Actors in the last capture. */
+	int32 GetCount() const { return Count; }
+
+	/** The last capture's column for a field, in InitFromJson order. */
+	TArrayView<const float> GetColumn(int32 Field) const
+	{
+		return TArrayView<const float>(Columns.GetData() + Field * Count, Count);
+	}
+
+private:
+	enum class EBuiltin : uint8
+	{
+		None, X, Y, Z, VX, VY, VZ, EX, EY, EZ, Yaw,
+	};
+
+	struct FField
+	{
+		FString Name;
+		EBuiltin Builtin = EBuiltin::None;
+		FName Property;
+	};
+
+	/** Per-class resolution of property fields (null where missing). */
+	const TArray<FProperty*>& ResolveProperties(UClass* Class);
+
+	/** Shared scalar fields of both response encodings. */
+	TSharedRef<FJsonObject> MakeHeader() const;
+
+	TArray<FField> Fields;
+	TWeakObjectPtr<UClass> FilterClass;
+	FName FilterTag;
+	bool bIncludePaths = false;
+
+	TMap<TWeakObjectPtr<UClass>, TArray<FProperty*>> PropertiesByClass;
+
+	uint64 Frame = 0;
+	double Time = 0.0;
+	int32 Count = 0;
+	TArray<FString> Paths;
+
+	/** Fields.Num() columns of Count floats each. */
+	TArray<float> Columns;
+};
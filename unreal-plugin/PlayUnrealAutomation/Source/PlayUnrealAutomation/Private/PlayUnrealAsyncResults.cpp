@@ -0,0 +1,110 @@
+// PlayUnrealAsyncResults.cpp
+
+#include "PlayUnrealAsyncResults.h"
+#include "Async/Async.h"
+#include "Dom/JsonObject.h"
+#include "Misc/ScopeLock.h"
+
+int32 FPlayUnrealAsyncResults::Create(const FString& Kind)
+{
+	FScopeLock ScopeLock(&Lock);
+
+	// Handles only grow, so the smallest key is always the oldest entry.
+	while (Entries.Num() >= MaxRetained)
+	{
+		int32 Oldest = MAX_int32;
+		for (const TPair<int32, FEntry>& Pair : Entries)
+		{
+			if (Pair.Value.Status != EStatus::Pending)
+			{
+				Oldest = FMath::Min(Oldest, Pair.Key);
+			}
+		}
+		if (Oldest == MAX_int32) break;
+		Entries.Remove(Oldest);
+	}
+
+	const int32 Handle = NextHandle++;
+	Entries.Add(Handle).Kind = Kind;
+	return Handle;
+}
+
+void FPlayUnrealAsyncResults::Succeed(int32 Handle, const TSharedRef<FJsonObject>& Result)
+{
+	Complete(Handle, EStatus::Done, Result, FString());
+}
+
+void FPlayUnrealAsyncResults::Fail(int32 Handle, const FString& Error)
+{
+	Complete(Handle, EStatus::Failed, nullptr, Error);
+}
+
+bool FPlayUnrealAsyncResults::Cancel(int32 Handle, const FString& Reason)
+{
+	if (!IsPending(Handle)) return false;
+	Complete(Handle, EStatus::Failed, nullptr, Reason);
+	return true;
+}
+
+bool FPlayUnrealAsyncResults::IsPending(int32 Handle) const
+{
+	FScopeLock ScopeLock(&Lock);
+	const FEntry* Entry = Entries.Find(Handle);
+	return Entry && Entry->Status == EStatus::Pending;
+}
+
+TSharedPtr<FJsonObject> FPlayUnrealAsyncResults::Take(int32 Handle)
+{
+	FScopeLock ScopeLock(&Lock);
+	const FEntry* Entry = Entries.Find(Handle);
+	if (!Entry) return nullptr;
+
+	TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+	Object->SetNumberField(TEXT("handle"), Handle);
+	Object->SetStringField(TEXT("kind"), Entry->Kind);
+
+	switch (Entry->Status)
+	{
+	case EStatus::Pending:
+		Object->SetStringField(TEXT("status"), TEXT("pending"));
+		return Object;
+	case EStatus::Done:
+		Object->SetStringField(TEXT("status"), TEXT("done"));
+		Object->SetObjectField(TEXT("result"), Entry->Result);
+		break;
+	case EStatus::Failed:
+		Object->SetStringField(TEXT("status"), TEXT("failed"));
+		Object->SetStringField(TEXT("error"), Entry->Error);
+		break;
+	}
+
+	Entries.Remove(Handle);
+	return Object;
+}
+
+void FPlayUnrealAsyncResults::Complete(int32 Handle, EStatus Status,
+                                       const TSharedPtr<FJsonObject>& Result,
+                                       const FString& Error)
+{
+	{
+		FScopeLock ScopeLock(&Lock);
+		FEntry* Entry = Entries.Find(Handle);
+		if (!Entry || Entry->Status != EStatus::Pending) return;
+
+		Entry->Status = Status;
+		Entry->Result = Result;
+		Entry->Error = Error;
+	}
+
+	if (IsInGameThread())
+	{
+		OnCompleted.Broadcast(Handle);
+	}
+	else
+	{
+		AsyncTask(ENamedThreads::GameThread, [this, Handle]()
+		{
+			OnCompleted.Broadcast(Handle);
+		});
+	}
+}
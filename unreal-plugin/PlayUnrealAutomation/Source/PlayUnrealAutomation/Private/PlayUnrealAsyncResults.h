@@ -0,0 +1,71 @@
+// PlayUnrealAsyncResults.h
+//
+// Handle table for driver operations that finish after the call returns
+// (screenshots, latent waits). A call returns {"handle": N}; the client
+// then collects the outcome with APlayUnrealDriver::GetAsyncResult.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+
+class FJsonObject;
+
+class FPlayUnrealAsyncResults
+{
+public:
+	/** Completed results nobody collects are dropped beyond this many. */
+	static constexpr int32 MaxRetained = 256;
+
+	/** Register a new pending operation. Kind is reported back to clients. */
+	int32 Create(const FString& Kind);
+
+	/** Complete an operation successfully. Safe to call from any thread. */
+	void Succeed(int32 Handle, const TSharedRef<FJsonObject>& Result);
+
+	/** Complete an operation with an error. Safe to call from any thread. */
+	void Fail(int32 Handle, const FString& Error);
+
+	/**
+	 * Fail a pending operation with Reason. Its producer's later completion
+	 * is ignored. Returns false if the handle was not pending.
+	 */
+	bool Cancel(int32 Handle, const FString& Reason);
+
+	/** True if the handle exists and has not completed yet. */
+	bool IsPending(int32 Handle) const;
+
+	/**
+	 * Describe an operation as {"handle", "kind", "status", "result"|"error"}
+	 * where status is "pending", "done" or "failed". Completed operations
+	 * are released once read. Returns null for unknown handles.
+	 */
+	TSharedPtr<FJsonObject> Take(int32 Handle);
+
+	/** Broadcast on the game thread whenever an operation completes. */
+	DECLARE_MULTICAST_DELEGATE_OneParam(FOnCompleted, int32 /*Handle*/);
+	FOnCompleted OnCompleted;
+
+private:
+	enum class EStatus : uint8
+	{
+		Pending,
+		Done,
+		Failed,
+	};
+
+	struct FEntry
+	{
+		FString Kind;
+		EStatus Status = EStatus::Pending;
+		TSharedPtr<FJsonObject> Result;
+		FString Error;
+	};
+
+	void Complete(int32 Handle, EStatus Status, const TSharedPtr<FJsonObject>& Result,
+	              const FString& Error);
+
+	mutable FCriticalSection Lock;
+	TMap<int32, FEntry> Entries;
+	int32 NextHandle = 1;
+};
@@ -1,20 +1,203 @@
 // PlayUnrealAutomationModule.cpp
 
 #include "PlayUnrealAutomationModule.h"
+#include "Engine/World.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
 #include "Modules/ModuleManager.h"
+#include "PlayUnrealAsyncResults.h"
+#include "PlayUnrealDriver.h"
+#include "PlayUnrealMetrics.h"
+#include "PlayUnrealScheduler.h"
+#include "PlayUnrealScreenCapture.h"
+#if WITH_PLAYUNREAL_AUTOMATION
+#include "PlayUnrealStreamServer.h"
+#include "PlayUnrealTcpServer.h"
+#endif
 
 #define LOCTEXT_NAMESPACE "FPlayUnrealAutomationModule"
 
+/** Set while the module is started; Get() runs on every driver call. */
+static FPlayUnrealAutomationModule* GPlayUnrealAutomationModule = nullptr;
+
+FPlayUnrealAutomationModule::FPlayUnrealAutomationModule() = default;
+FPlayUnrealAutomationModule::~FPlayUnrealAutomationModule() = default;
+
 void FPlayUnrealAutomationModule::StartupModule()
 {
 	UE_LOG(LogTemp, Log, TEXT("PlayUnrealAutomation: Module started"));
+	GPlayUnrealAutomationModule = this;
+
+	AsyncResults = MakeUnique<FPlayUnrealAsyncResults>();
+	Metrics = MakeUnique<FPlayUnrealMetrics>();
+	Scheduler = MakeUnique<FPlayUnrealScheduler>(*AsyncResults);
+
+	double BudgetMs = FPlayUnrealScheduler::DefaultBudgetMs;
+	if (FParse::Value(FCommandLine::Get(), TEXT("PlayUnrealBudgetMs="), BudgetMs))
+	{
+		Scheduler->SetBudgetMs(BudgetMs);
+	}
+
+	if (FParse::Param(FCommandLine::Get(), TEXT("PlayUnreal")))
+	{
+		Activate();
+	}
+}
+
+void FPlayUnrealAutomationModule::Activate()
+{
+#if WITH_PLAYUNREAL_AUTOMATION
+	if (bActive) return;
+	bActive = true;
+	UE_LOG(LogTemp, Log, TEXT("PlayUnrealAutomation: Activated"));
+
+	WorldInitHandle = FWorldDelegates::OnPostWorldInitialization.AddLambda(
+		[this](UWorld* World, const UWorld::InitializationValues) { OnWorldChanged(World); });
+	WorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddLambda(
+		[this](UWorld* World, bool, bool) { OnWorldChanged(World); });
+
+	// Commandlets never have a client to push to.
+	if (!IsRunningCommandlet())
+	{
+		uint32 StreamPort = FPlayUnrealStreamServer::DefaultPort;
+		FParse::Value(FCommandLine::Get(), TEXT("PlayUnrealStreamPort="), StreamPort);
+
+		StreamServer = MakeUnique<FPlayUnrealStreamServer>(*AsyncResults);
+		if (!StreamServer->Start(StreamPort))
+		{
+			StreamServer.Reset();
+		}
+
+		uint32 TcpPort = FPlayUnrealTcpServer::DefaultPort;
+		FParse::Value(FCommandLine::Get(), TEXT("PlayUnrealTcpPort="), TcpPort);
+		if (TcpPort != 0)
+		{
+			TcpServer = MakeUnique<FPlayUnrealTcpServer>(*AsyncResults, *Metrics);
+			if (!TcpServer->Start(TcpPort))
+			{
+				TcpServer.Reset();
+			}
+		}
+	}
+#endif
 }
 
 void FPlayUnrealAutomationModule::ShutdownModule()
 {
+	if (bActive)
+	{
+		FWorldDelegates::OnPostWorldInitialization.Remove(WorldInitHandle);
+		FWorldDelegates::OnWorldCleanup.Remove(WorldCleanupHandle);
+	}
+	bActive = false;
+
+#if WITH_PLAYUNREAL_AUTOMATION
+	TcpServer.Reset();
+	StreamServer.Reset();
+#endif
+	ScreenCapture.Reset();
+	Scheduler.Reset();
+	AsyncResults.Reset();
+	Metrics.Reset();
+	GPlayUnrealAutomationModule = nullptr;
 	UE_LOG(LogTemp, Log, TEXT("PlayUnrealAutomation: Module shutdown"));
 }
 
+FPlayUnrealAutomationModule& FPlayUnrealAutomationModule::Get()
+{
+	if (GPlayUnrealAutomationModule)
+	{
+		return *GPlayUnrealAutomationModule;
+	}
+	return FModuleManager::LoadModuleChecked<FPlayUnrealAutomationModule>(TEXT("PlayUnrealAutomation"));
+}
+
+uint32 FPlayUnrealAutomationModule::GetStreamPort() const
+{
+#if WITH_PLAYUNREAL_AUTOMATION
+	return StreamServer.IsValid() ? StreamServer->GetPort() : 0;
+#else
+	return 0;
+#endif
+}
+
+uint32 FPlayUnrealAutomationModule::GetTcpPort() const
+{
+#if WITH_PLAYUNREAL_AUTOMATION
+	return TcpServer.IsValid() ? TcpServer->GetPort() : 0;
+#else
+	return 0;
+#endif
+}
+
+void FPlayUnrealAutomationModule::RegisterDriver(APlayUnrealDriver* Driver)
+{
+	Drivers.AddUnique(Driver);
+}
+
+void FPlayUnrealAutomationModule::UnregisterDriver(APlayUnrealDriver* Driver)
+{
+	Drivers.Remove(Driver);
+}
+
+APlayUnrealDriver* FPlayUnrealAutomationModule::GetActiveDriver() const
+{
+	for (int32 Index = Drivers.Num() - 1; Index >= 0; --Index)
+	{
+		if (APlayUnrealDriver* Driver = Drivers[Index].Get())
+		{
+			return Driver;
+		}
+	}
+	return nullptr;
+}
+
+TArray<APlayUnrealDriver*> FPlayUnrealAutomationModule::GetDrivers() const
+{
+	TArray<APlayUnrealDriver*> Result;
+	for (const TWeakObjectPtr<APlayUnrealDriver>& Driver : Drivers)
+	{
+		if (APlayUnrealDriver* Live = Driver.Get())
+		{
+			Result.Add(Live);
+		}
+	}
+	return Result;
+}
+
+FPlayUnrealAsyncResults& FPlayUnrealAutomationModule::GetAsyncResults()
+{
+	return *AsyncResults;
+}
+
+FPlayUnrealMetrics& FPlayUnrealAutomationModule::GetMetrics()
+{
+	return *Metrics;
+}
+
+FPlayUnrealScreenCapture& FPlayUnrealAutomationModule::GetScreenCapture()
+{
+	if (!ScreenCapture.IsValid())
+	{
+		ScreenCapture = MakeUnique<FPlayUnrealScreenCapture>(GetAsyncResults());
+	}
+	return *ScreenCapture;
+}
+
+FPlayUnrealScheduler& FPlayUnrealAutomationModule::GetScheduler()
+{
+	return *Scheduler;
+}
+
+void FPlayUnrealAutomationModule::OnWorldChanged(UWorld* World)
+{
+	// Editor and preview worlds come and go without moving game objects.
+	if (World && World->IsGameWorld())
+	{
+		++WorldGeneration;
+	}
+}
+
 #undef LOCTEXT_NAMESPACE
 
 IMPLEMENT_MODULE(FPlayUnrealAutomationModule, PlayUnrealAutomation)
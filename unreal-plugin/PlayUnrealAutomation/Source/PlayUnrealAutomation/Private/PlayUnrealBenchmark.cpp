@@ -0,0 +1,395 @@
+// PlayUnrealBenchmark.cpp
+
+#include "PlayUnrealBenchmark.h"
+#include "Blueprint/UserWidget.h"
+#include "Blueprint/WidgetTree.h"
+#include "Components/TextBlock.h"
+#include "Components/VerticalBox.h"
+#include "Dom/JsonObject.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/DateTime.h"
+#include "Misc/EngineVersion.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "PlayUnrealAsyncResults.h"
+#include "PlayUnrealAutomationModule.h"
+#include "PlayUnrealDriver.h"
+#include "PlayUnrealFunctionBinding.h"
+#include "PlayUnrealJson.h"
+#include "PlayUnrealScreenCapture.h"
+#include "PlayUnrealSelector.h"
+#include "PlayUnrealStatics.h"
+#include "Serialization/JsonSerializer.h"
+
+namespace
+{
+	constexpr int32 FormatVersion = 1;
+	constexpr int32 WarmupCalls = 10;
+	const FName BenchTag(TEXT("PlayUnrealBench"));
+
+	void ParseCounts(const TCHAR* CommandLine, const TCHAR* Key, TArray<int32>& OutCounts)
+	{
+		FString Text;
+		if (!FParse::Value(CommandLine, Key, Text)) return;
+
+		TArray<FString> Parts;
+		Text.ParseIntoArray(Parts, TEXT(","));
+		OutCounts.Reset();
+		for (const FString& Part : Parts)
+		{
+			const int32 Count = FCString::Atoi(*Part);
+			if (Count > 0)
+			{
+				OutCounts.Add(Count);
+			}
+		}
+		OutCounts.Sort();
+	}
+
+	/** Microseconds per call of Body, after a short warmup. */
+	void Measure(int32 Iterations, TFunctionRef<void()> Body, TArray<double>& OutSamples)
+	{
+		for (int32 Index = 0; Index < FMath::Min(Iterations, WarmupCalls); ++Index)
+		{
+			Body();
+		}
+		OutSamples.Reset(Iterations);
+		for (int32 Index = 0; Index < Iterations; ++Index)
+		{
+			const double Start = FPlatformTime::Seconds();
+			Body();
+			OutSamples.Add((FPlatformTime::Seconds() - Start) * 1e6);
+		}
+	}
+
+	TSharedRef<FJsonObject> CountParam(const TCHAR* Key, int32 Count)
+	{
+		TSharedRef<FJsonObject> Params = MakeShared<FJsonObject>();
+		Params->SetNumberField(Key, Count);
+		return Params;
+	}
+
+	/** Invoke a binding and drop its outputs; the call itself is what is measured. */
+	void Call(FPlayUnrealFunctionBinding& Binding, const TSharedPtr<FJsonObject>& Params)
+	{
+		TSharedPtr<FJsonObject> Outputs;
+		FString Error;
+		Binding.Invoke(Params, Outputs, Error);
+	}
+}
+
+FPlayUnrealBenchmark::FOptions FPlayUnrealBenchmark::ParseOptions(const TCHAR* CommandLine)
+{
+	FOptions Options;
+	ParseCounts(CommandLine, TEXT("Actors="), Options.ActorCounts);
+	ParseCounts(CommandLine, TEXT("Widgets="), Options.WidgetCounts);
+	FParse::Value(CommandLine, TEXT("Iterations="), Options.Iterations);
+	FParse::Value(CommandLine, TEXT("BatchSize="), Options.BatchSize);
+	FParse::Value(CommandLine, TEXT("Screenshots="), Options.Screenshots);
+	Options.Iterations = FMath::Max(Options.Iterations, 1);
+	Options.BatchSize = FMath::Max(Options.BatchSize, 1);
+
+	FString Output;
+	if (!FParse::Value(CommandLine, TEXT("BenchmarkOutput="), Output) || Output.IsEmpty())
+	{
+		Output = FPaths::Combine(TEXT("PlayUnreal/Benchmarks"),
+			TEXT("driver-") + FDateTime::Now().ToString(TEXT("%Y%m%d-%H%M%S")) + TEXT(".json"));
+	}
+	Options.OutputPath = FPaths::IsRelative(Output) ? FPaths::Combine(FPaths::ProjectSavedDir(), Output) : Output;
+	return Options;
+}
+
+UGameInstance* FPlayUnrealBenchmark::CreateStandaloneWorld()
+{
+	UGameInstance* GameInstance = NewObject<UGameInstance>(GEngine);
+	GameInstance->AddToRoot();
+	GameInstance->InitializeStandalone();
+
+	UWorld* World = GameInstance->GetWorld();
+	World->InitializeActorsForPlay(FURL());
+	World->BeginPlay();
+	return GameInstance;
+}
+
+TSharedRef<FJsonObject> FPlayUnrealBenchmark::Summarize(const FString& Name, const TSharedRef<FJsonObject>& Params,
+                                                        const TCHAR* Unit, TArray<double>& Samples)
+{
+	TSharedRef<FJsonObject> Suite = MakeShared<FJsonObject>();
+	Suite->SetStringField(TEXT("name"), Name);
+	Suite->SetObjectField(TEXT("params"), Params);
+	Suite->SetStringField(TEXT("unit"), Unit);
+	Suite->SetNumberField(TEXT("count"), Samples.Num());
+	if (Samples.IsEmpty()) return Suite;
+
+	Samples.Sort();
+	double Sum = 0.0;
+	for (const double Sample : Samples)
+	{
+		Sum += Sample;
+	}
+	const auto Percentile = [&Samples](double Fraction)
+	{
+		const int32 Rank = FMath::CeilToInt32(Fraction * Samples.Num());
+		return Samples[FMath::Clamp(Rank - 1, 0, Samples.Num() - 1)];
+	};
+	Suite->SetNumberField(TEXT("mean"), Sum / Samples.Num());
+	Suite->SetNumberField(TEXT("p50"), Percentile(0.50));
+	Suite->SetNumberField(TEXT("p95"), Percentile(0.95));
+	Suite->SetNumberField(TEXT("p99"), Percentile(0.99));
+	Suite->SetNumberField(TEXT("max"), Samples.Last());
+	return Suite;
+}
+
+void FPlayUnrealBenchmark::AddSuite(FJsonObject& Results, const TSharedRef<FJsonObject>& Suite)
+{
+	TArray<TSharedPtr<FJsonValue>> Suites = Results.GetArrayField(TEXT("suites"));
+	Suites.Add(MakeShared<FJsonValueObject>(Suite));
+	Results.SetArrayField(TEXT("suites"), Suites);
+
+	UE_LOG(LogTemp, Display, TEXT("PlayUnreal: Benchmark %s %s"), *Suite->GetStringField(TEXT("name")),
+		*PlayUnrealJson::ToString(Suite));
+}
+
+void FPlayUnrealBenchmark::AddSkipped(FJsonObject& Results, const FString& Name, const FString& Reason)
+{
+	TSharedRef<FJsonObject> Suite = MakeShared<FJsonObject>();
+	Suite->SetStringField(TEXT("name"), Name);
+	Suite->SetStringField(TEXT("skipped"), Reason);
+	AddSuite(Results, Suite);
+}
+
+TSharedRef<FJsonObject> FPlayUnrealBenchmark::Run(UWorld* World, const FOptions& Options)
+{
+	TSharedRef<FJsonObject> Results = MakeShared<FJsonObject>();
+	Results->SetNumberField(TEXT("version"), FormatVersion);
+	Results->SetStringField(TEXT("engine"), FEngineVersion::Current().ToString());
+	Results->SetStringField(TEXT("platform"), FPlatformProperties::IniPlatformName());
+	Results->SetStringField(TEXT("timestamp"), FDateTime::UtcNow().ToIso8601());
+	Results->SetNumberField(TEXT("iterations"), Options.Iterations);
+	Results->SetArrayField(TEXT("suites"), TArray<TSharedPtr<FJsonValue>>());
+
+	UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+	APlayUnrealDriver* Driver = GameInstance ? World->SpawnActor<APlayUnrealDriver>() : nullptr;
+	if (!Driver)
+	{
+		AddSkipped(*Results, TEXT("All"), TEXT("No game world to spawn a driver in"));
+		return Results;
+	}
+
+	FString Error;
+	const auto Bind = [Driver, &Error](FName Function)
+	{
+		TSharedPtr<FPlayUnrealFunctionBinding> Binding = FPlayUnrealFunctionBinding::Create(Driver, Function, Error);
+		check(Binding.IsValid());
+		return Binding.ToSharedRef();
+	};
+	const int32 Iterations = Options.Iterations;
+	TArray<double> Samples;
+
+	// -- Dispatch ------------------------------------------------------------
+
+	TSharedRef<FPlayUnrealFunctionBinding> Ping = Bind(GET_FUNCTION_NAME_CHECKED(APlayUnrealDriver, Ping));
+	const TSharedPtr<FJsonObject> NoParams = MakeShared<FJsonObject>();
+	Measure(Iterations, [&]() { Call(*Ping, NoParams); }, Samples);
+	AddSuite(*Results, Summarize(TEXT("Ping"), MakeShared<FJsonObject>(), TEXT("us"), Samples));
+
+	// -- Actors --------------------------------------------------------------
+
+	TSharedRef<FPlayUnrealFunctionBinding> FindActor = Bind(GET_FUNCTION_NAME_CHECKED(APlayUnrealDriver, FindActorByName));
+	TArray<AActor*> Actors;
+	for (const int32 Count : Options.ActorCounts)
+	{
+		while (Actors.Num() < Count)
+		{
+			FActorSpawnParameters SpawnParams;
+			SpawnParams.Name = FName(BenchTag, Actors.Num() + 1);
+			AActor* Actor = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParams);
+			if (!Actor) break;
+			Actor->Tags.Add(BenchTag);
+			Actors.Add(Actor);
+		}
+		if (Actors.Num() < Count) break;
+
+		const TSharedPtr<FJsonObject> Params = MakeShared<FJsonObject>();
+		Params->SetStringField(TEXT("Name"), Actors[Count / 2]->GetName());
+		Measure(Iterations, [&]() { Call(*FindActor, Params); }, Samples);
+		AddSuite(*Results, Summarize(TEXT("FindActorByName"), CountParam(TEXT("actors"), Count), TEXT("us"), Samples));
+	}
+
+	// -- Widgets -------------------------------------------------------------
+
+	UUserWidget* Root = CreateWidget<UUserWidget>(GameInstance, UUserWidget::StaticClass());
+	if (Root && !Root->WidgetTree)
+	{
+		Root->WidgetTree = NewObject<UWidgetTree>(Root, TEXT("WidgetTree"));
+	}
+	UVerticalBox* Box = Root ? Root->WidgetTree->ConstructWidget<UVerticalBox>(UVerticalBox::StaticClass()) : nullptr;
+	TArray<UTextBlock*> Rows;
+	if (Box)
+	{
+		Root->WidgetTree->RootWidget = Box;
+
+		TSharedRef<FPlayUnrealFunctionBinding> ElementExists = Bind(GET_FUNCTION_NAME_CHECKED(APlayUnrealDriver, ElementExists));
+		for (const int32 Count : Options.WidgetCounts)
+		{
+			while (Rows.Num() < Count)
+			{
+				UTextBlock* Row = Root->WidgetTree->ConstructWidget<UTextBlock>(UTextBlock::StaticClass());
+				Row->SetText(FText::AsNumber(Rows.Num()));
+				Box->AddChildToVerticalBox(Row);
+				UPlayUnrealStatics::SetAutomationId(Row, FString::Printf(TEXT("BenchRow_%d"), Rows.Num()));
+				Rows.Add(Row);
+			}
+
+			// The last row: the worst case for a tree walk.
+			const FString Id = FString::Printf(TEXT("BenchRow_%d"), Count - 1);
+			const TSharedPtr<FJsonObject> Params = MakeShared<FJsonObject>();
+			Params->SetStringField(TEXT("Id"), Id);
+			Measure(Iterations, [&]() { Call(*ElementExists, Params); }, Samples);
+			AddSuite(*Results, Summarize(TEXT("ElementExists"), CountParam(TEXT("widgets"), Count), TEXT("us"), Samples));
+
+			TSharedPtr<const FPlayUnrealSelector> Selector =
+				FPlayUnrealSelector::Compile(TEXT("VerticalBox > TextBlock#") + Id, Error);
+			TArray<FPlayUnrealSelector::FMatch> Matches;
+			Measure(Iterations, [&]()
+			{
+				Matches.Reset();
+				Selector->MatchRoot(Root, 1, Matches);
+			}, Samples);
+			AddSuite(*Results, Summarize(TEXT("Selector"), CountParam(TEXT("widgets"), Count), TEXT("us"), Samples));
+		}
+
+		// -- Batching --------------------------------------------------------
+
+		const TSharedPtr<FJsonObject> RowParams = MakeShared<FJsonObject>();
+		RowParams->SetStringField(TEXT("Id"), TEXT("BenchRow_0"));
+		Measure(Iterations, [&]()
+		{
+			for (int32 Index = 0; Index < Options.BatchSize; ++Index)
+			{
+				Call(*ElementExists, RowParams);
+			}
+		}, Samples);
+		AddSuite(*Results, Summarize(TEXT("SingleCalls"), CountParam(TEXT("calls"), Options.BatchSize), TEXT("us"), Samples));
+
+		TArray<TSharedPtr<FJsonValue>> Commands;
+		for (int32 Index = 0; Index < Options.BatchSize; ++Index)
+		{
+			TSharedRef<FJsonObject> Command = MakeShared<FJsonObject>();
+			Command->SetStringField(TEXT("method"), TEXT("ElementExists"));
+			Command->SetObjectField(TEXT("params"), RowParams);
+			Commands.Add(MakeShared<FJsonValueObject>(Command));
+		}
+		TSharedRef<FJsonObject> Batch = MakeShared<FJsonObject>();
+		Batch->SetArrayField(TEXT("commands"), Commands);
+		const TSharedPtr<FJsonObject> BatchParams = MakeShared<FJsonObject>();
+		BatchParams->SetStringField(TEXT("CommandsJSON"), PlayUnrealJson::ToString(Batch));
+
+		TSharedRef<FPlayUnrealFunctionBinding> ExecuteBatch = Bind(GET_FUNCTION_NAME_CHECKED(APlayUnrealDriver, ExecuteBatch));
+		Measure(Iterations, [&]() { Call(*ExecuteBatch, BatchParams); }, Samples);
+		AddSuite(*Results, Summarize(TEXT("ExecuteBatch"), CountParam(TEXT("calls"), Options.BatchSize), TEXT("us"), Samples));
+	}
+	else
+	{
+		AddSkipped(*Results, TEXT("ElementExists"), TEXT("Cannot create a user widget in this world"));
+	}
+
+	// Leave the world as it was.
+	for (UTextBlock* Row : Rows)
+	{
+		UPlayUnrealStatics::SetAutomationId(Row, FString());
+	}
+	for (AActor* Actor : Actors)
+	{
+		Actor->Destroy();
+	}
+	Driver->Destroy();
+	return Results;
+}
+
+bool FPlayUnrealBenchmark::Write(const FJsonObject& Results, const FString& Path, FString& OutError)
+{
+	FString Text;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Text);
+	FJsonSerializer::Serialize(MakeShared<FJsonObject>(Results), Writer);
+
+	if (!FFileHelper::SaveStringToFile(Text, *Path, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+	{
+		OutError = FString::Printf(TEXT("Cannot write %s"), *Path);
+		return false;
+	}
+	UE_LOG(LogTemp, Display, TEXT("PlayUnreal: Benchmark results -> %s"), *Path);
+	return true;
+}
+
+// ---------------------------------------------------------------------------
+// Screenshot probe
+// ---------------------------------------------------------------------------
+
+bool FPlayUnrealBenchmark::FScreenshotProbe::Start(FString& OutError)
+{
+	if (FPlayUnrealScreenCapture::GetRenderMode() == FPlayUnrealScreenCapture::ERenderMode::None)
+	{
+		OutError = TEXT("Rendering is disabled (-nullrhi)");
+		return false;
+	}
+
+	FPlayUnrealScreenCapture::FRequest Request;
+	Handle = FPlayUnrealAutomationModule::Get().GetScreenCapture().Request(MoveTemp(Request), OutError);
+	RequestTime = FPlatformTime::Seconds();
+	RequestFrame = GFrameCounter;
+	return Handle != INDEX_NONE;
+}
+
+bool FPlayUnrealBenchmark::FScreenshotProbe::Tick()
+{
+	FPlayUnrealAsyncResults& Results = FPlayUnrealAutomationModule::Get().GetAsyncResults();
+	if (Handle == INDEX_NONE) return true;
+	if (Results.IsPending(Handle)) return false;
+
+	TSharedPtr<FJsonObject> Outcome = Results.Take(Handle);
+	FString Status;
+	if (!Outcome.IsValid() || !Outcome->TryGetStringField(TEXT("status"), Status) || Status != TEXT("done"))
+	{
+		Failure = Outcome.IsValid() ? Outcome->GetStringField(TEXT("error")) : TEXT("Capture lost");
+		Handle = INDEX_NONE;
+		return true;
+	}
+	Milliseconds.Add((FPlatformTime::Seconds() - RequestTime) * 1000.0);
+	Frames.Add(static_cast<double>(GFrameCounter - RequestFrame));
+
+	if (Milliseconds.Num() >= Samples)
+	{
+		Handle = INDEX_NONE;
+		return true;
+	}
+	FString Error;
+	if (!Start(Error))
+	{
+		Failure = Error;
+		return true;
+	}
+	return false;
+}
+
+void FPlayUnrealBenchmark::FScreenshotProbe::AddTo(FJsonObject& Results) const
+{
+	if (!Failure.IsEmpty() && Milliseconds.IsEmpty())
+	{
+		AddSkipped(Results, TEXT("Screenshot"), Failure);
+		return;
+	}
+
+	TArray<double> Sorted = Milliseconds;
+	TSharedRef<FJsonObject> Suite = Summarize(TEXT("Screenshot"), CountParam(TEXT("samples"), Samples), TEXT("ms"), Sorted);
+	TArray<double> FrameCounts = Frames;
+	TSharedRef<FJsonObject> FrameSummary = Summarize(TEXT("frames"), MakeShared<FJsonObject>(), TEXT("frames"), FrameCounts);
+	Suite->SetNumberField(TEXT("framesP50"), FrameSummary->GetNumberField(TEXT("p50")));
+	Suite->SetNumberField(TEXT("framesMax"), FrameSummary->GetNumberField(TEXT("max")));
+	AddSuite(Results, Suite);
+}
@@ -0,0 +1,107 @@
+// PlayUnrealBenchmark.h
+//
+// Benchmarks of the driver's own cost, so changes to it can be tracked
+// across releases. Run from the PlayUnrealBenchmark commandlet (synthetic
+// world, no rendering) or the PlayUnreal.Benchmark.Driver automation test
+// (current game world, adds screenshot latency).
+//
+// Calls go through FPlayUnrealFunctionBinding, the same dispatch the
+// transports use, over synthetic content of each requested size:
+//
+//   Ping              bound call with no work behind it: dispatch overhead
+//   FindActorByName   per level size (actors spawned for the run)
+//   ElementExists     registry ID lookup, per widget tree size
+//   Selector          FPlayUnrealSelector tree walk, per widget tree size
+//   SingleCalls       BatchSize bound calls, one after another
+//   ExecuteBatch      the same calls as one batch
+//   Screenshot        request to completed capture, in ms and frames
+//
+// Results are JSON: {"version", "engine", "platform", "timestamp",
+// "iterations", "suites": [{"name", "params", "unit", "count", "mean",
+// "p50", "p95", "p99", "max"} or {"name", "skipped": reason}]}. Times are
+// microseconds, except Screenshot in milliseconds.
+//
+// Options come from the command line: -Actors=100,1000,10000
+// -Widgets=10,100,1000 -Iterations=200 -BatchSize=50 -Screenshots=10
+// -BenchmarkOutput=path (relative to Saved/).
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FJsonObject;
+class FJsonValue;
+class UGameInstance;
+class UWorld;
+
+class FPlayUnrealBenchmark
+{
+public:
+	struct FOptions
+	{
+		TArray<int32> ActorCounts = { 100, 1000, 10000 };
+		TArray<int32> WidgetCounts = { 10, 100, 1000 };
+		int32 Iterations = 200;
+		int32 BatchSize = 50;
+		int32 Screenshots = 10;
+		/** Absolute path to write the results to. */
+		FString OutputPath;
+	};
+
+	static FOptions ParseOptions(const TCHAR* CommandLine);
+
+	/**
+	 * A game instance with its own game world in play, for running without
+	 * a map. Shut it down with GameInstance->Shutdown().
+	 */
+	static UGameInstance* CreateStandaloneWorld();
+
+	/**
+	 * Run every synchronous suite in World, which needs a game instance.
+	 * Spawns a driver and the synthetic actors and widgets, and removes
+	 * them again afterwards.
+	 *
+	 * @return  The results object, "suites" filled in.
+	 */
+	static TSharedRef<FJsonObject> Run(UWorld* World, const FOptions& Options);
+
+	/** Add a skipped suite to the results. */
+	static void AddSkipped(FJsonObject& Results, const FString& Name, const FString& Reason);
+
+	/** Write the results as pretty JSON. False with a reason on failure. */
+	static bool Write(const FJsonObject& Results, const FString& Path, FString& OutError);
+
+	/**
+	 * Screenshot latency, measured one capture at a time over real frames.
+	 * Tick once per frame until it returns true.
+	 */
+	class FScreenshotProbe
+	{
+	public:
+		explicit FScreenshotProbe(int32 InSamples) : Samples(InSamples) {}
+
+		/** @return  False with a reason if this process cannot capture. */
+		bool Start(FString& OutError);
+
+		bool Tick();
+
+		/** Add the Screenshot suite to the results. */
+		void AddTo(FJsonObject& Results) const;
+
+	private:
+		int32 Samples = 0;
+		int32 Handle = INDEX_NONE;
+		double RequestTime = 0.0;
+		uint64 RequestFrame = 0;
+		TArray<double> Milliseconds;
+		TArray<double> Frames;
+		FString Failure;
+	};
+
+private:
+	/** {"name", "params", "unit", "count", "mean", "p50", "p95", "p99", "max"}. */
+	static TSharedRef<FJsonObject> Summarize(const FString& Name, const TSharedRef<FJsonObject>& Params,
+	                                         const TCHAR* Unit, TArray<double>& Samples);
+
+	static void AddSuite(FJsonObject& Results, const TSharedRef<FJsonObject>& Suite);
+};
@@ -0,0 +1,34 @@
+// PlayUnrealBenchmarkCommandlet.cpp
+
+#include "PlayUnrealBenchmarkCommandlet.h"
+#include "Dom/JsonObject.h"
+#include "Engine/GameInstance.h"
+#include "PlayUnrealBenchmark.h"
+
+UPlayUnrealBenchmarkCommandlet::UPlayUnrealBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UPlayUnrealBenchmarkCommandlet::Main(const FString& Params)
+{
+	const FPlayUnrealBenchmark::FOptions Options = FPlayUnrealBenchmark::ParseOptions(*Params);
+
+	UGameInstance* GameInstance = FPlayUnrealBenchmark::CreateStandaloneWorld();
+	TSharedRef<FJsonObject> Results = FPlayUnrealBenchmark::Run(GameInstance->GetWorld(), Options);
+	FPlayUnrealBenchmark::AddSkipped(*Results, TEXT("Screenshot"), TEXT("Commandlets do not render"));
+
+	GameInstance->Shutdown();
+	GameInstance->RemoveFromRoot();
+
+	FString Error;
+	if (!FPlayUnrealBenchmark::Write(*Results, Options.OutputPath, Error))
+	{
+		UE_LOG(LogTemp, Error, TEXT("PlayUnreal: %s"), *Error);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,27 @@
+// PlayUnrealBenchmarkCommandlet.h
+//
+// Headless driver benchmark (see PlayUnrealBenchmark.h):
+//
+//   UnrealEditor-Cmd <project> -run=PlayUnrealBenchmark [-Iterations=500]
+//       [-Actors=100,1000] [-BenchmarkOutput=bench.json] -unattended
+//
+// Runs in a standalone game world of its own, so no map is needed.
+// Commandlets do not render; the Screenshot suite is reported as skipped.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "PlayUnrealBenchmarkCommandlet.generated.h"
+
+UCLASS()
+class UPlayUnrealBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UPlayUnrealBenchmarkCommandlet();
+
+	/** @return  0 once the results are written, 1 otherwise. */
+	virtual int32 Main(const FString& Params) override;
+};
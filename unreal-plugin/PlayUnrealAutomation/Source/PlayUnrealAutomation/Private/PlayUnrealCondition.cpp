@@ -0,0 +1,95 @@
+// PlayUnrealCondition.cpp
+
+#include "PlayUnrealCondition.h"
+#include "Dom/JsonObject.h"
+#include "PlayUnrealJson.h"
+
+bool FPlayUnrealCondition::InitFromJson(const FJsonObject& Description, FString& OutError)
+{
+	if (!Reader.InitFromJson(Description))
+	{
+		OutError = TEXT("Condition needs \"object\" and \"property\" or \"function\"");
+		return false;
+	}
+
+	Description.TryGetStringField(TEXT("field"), Field);
+	Expected = Description.TryGetField(TEXT("value"));
+
+	FString OpName = TEXT("eq");
+	Description.TryGetStringField(TEXT("op"), OpName);
+	static const TMap<FString, EOp> Ops = {
+		{ TEXT("eq"), EOp::Eq },
+		{ TEXT("ne"), EOp::Ne },
+		{ TEXT("lt"), EOp::Lt },
+		{ TEXT("le"), EOp::Le },
+		{ TEXT("gt"), EOp::Gt },
+		{ TEXT("ge"), EOp::Ge },
+		{ TEXT("contains"), EOp::Contains },
+		{ TEXT("exists"), EOp::Exists },
+	};
+	const EOp* Found = Ops.Find(OpName.ToLower());
+	if (!Found)
+	{
+		OutError = FString::Printf(TEXT("Unknown condition op '%s'"), *OpName);
+		return false;
+	}
+	Op = *Found;
+
+	if (Op != EOp::Exists && !Expected.IsValid())
+	{
+		OutError = TEXT("Condition needs a \"value\"");
+		return false;
+	}
+	return true;
+}
+
+bool FPlayUnrealCondition::Evaluate(TSharedPtr<FJsonValue>& OutValue)
+{
+	OutValue = Reader.Read();
+
+	if (OutValue.IsValid() && !Field.IsEmpty())
+	{
+		TSharedPtr<FJsonObject> Object;
+		if (OutValue->Type == EJson::Object)
+		{
+			Object = OutValue->AsObject();
+		}
+		else if (OutValue->Type == EJson::String)
+		{
+			Object = PlayUnrealJson::ParseObject(OutValue->AsString());
+		}
+		OutValue = Object.IsValid() ? Object->TryGetField(Field) : nullptr;
+	}
+
+	const bool bHasValue = OutValue.IsValid() && OutValue->Type != EJson::Null;
+	if (Op == EOp::Exists) return bHasValue;
+	if (!bHasValue) return false;
+
+	double Actual = 0.0;
+	double Target = 0.0;
+	const bool bNumeric = OutValue->TryGetNumber(Actual) && Expected->TryGetNumber(Target)
+		&& OutValue->Type != EJson::String && Expected->Type != EJson::String;
+
+	switch (Op)
+	{
+	case EOp::Eq:
+		return bNumeric ? Actual == Target
+			: PlayUnrealJson::ValueToString(OutValue) == PlayUnrealJson::ValueToString(Expected);
+	case EOp::Ne:
+		return bNumeric ? Actual != Target
+			: PlayUnrealJson::ValueToString(OutValue) != PlayUnrealJson::ValueToString(Expected);
+	case EOp::Lt: return bNumeric && Actual < Target;
+	case EOp::Le: return bNumeric && Actual <= Target;
+	case EOp::Gt: return bNumeric && Actual > Target;
+	case EOp::Ge: return bNumeric && Actual >= Target;
+	case EOp::Contains:
+	{
+		FString Haystack;
+		FString Needle;
+		return OutValue->TryGetString(Haystack) && Expected->TryGetString(Needle)
+			&& Haystack.Contains(Needle, ESearchCase::IgnoreCase);
+	}
+	default:
+		return false;
+	}
+}
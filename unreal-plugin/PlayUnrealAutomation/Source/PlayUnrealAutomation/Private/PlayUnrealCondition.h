@@ -0,0 +1,51 @@
+// PlayUnrealCondition.h
+//
+// A predicate over a value read from a live object, used by latent waits.
+//
+//   {"object": "/Game/...GameMode_0", "function": "GetGameStateJSON",
+//    "field": "gameState", "op": "contains", "value": "Playing"}
+//
+// "field" picks a key out of an object value (or out of a string holding
+// JSON, which is how most game-side *JSON queries return). Supported ops:
+// eq (default), ne, lt, le, gt, ge, contains (case-insensitive) and exists.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PlayUnrealValueReader.h"
+
+class FJsonObject;
+class FJsonValue;
+
+class FPlayUnrealCondition
+{
+public:
+	/** Parse a condition. Returns false with a reason if it is malformed. */
+	bool InitFromJson(const FJsonObject& Description, FString& OutError);
+
+	/**
+	 * Read the value and test it.
+	 *
+	 * @param OutValue  The value that was tested (null if unreadable).
+	 * @return          True if the condition holds.
+	 */
+	bool Evaluate(TSharedPtr<FJsonValue>& OutValue);
+
+private:
+	enum class EOp : uint8
+	{
+		Eq,
+		Ne,
+		Lt,
+		Le,
+		Gt,
+		Ge,
+		Contains,
+		Exists,
+	};
+
+	FPlayUnrealValueReader Reader;
+	FString Field;
+	EOp Op = EOp::Eq;
+	TSharedPtr<FJsonValue> Expected;
+};
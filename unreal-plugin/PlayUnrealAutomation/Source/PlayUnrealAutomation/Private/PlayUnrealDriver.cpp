@@ -4,165 +4,2409 @@
 
 #include "Blueprint/UserWidget.h"
 #include "Blueprint/WidgetTree.h"
+#include "Components/Button.h"
 #include "Components/Widget.h"
+#include "Dom/JsonObject.h"
+#include "Engine/Engine.h"
+#include "Engine/GameViewportClient.h"
 #include "Engine/World.h"
+#include "Framework/Application/SlateApplication.h"
 #include "GameFramework/Actor.h"
 #include "HAL/FileManager.h"
-#include "JsonObjectConverter.h"
+#include "HAL/IConsoleManager.h"
 #include "Kismet/GameplayStatics.h"
+#include "JsonObjectConverter.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/DateTime.h"
 #include "Misc/FileHelper.h"
 #include "Misc/Guid.h"
+#include "Misc/Parse.h"
 #include "Misc/Paths.h"
+#include "PlayUnrealActorIndex.h"
+#include "PlayUnrealActorSnapshot.h"
+#include "PlayUnrealAsyncResults.h"
+#include "PlayUnrealAutomationModule.h"
+#include "PlayUnrealCondition.h"
+#include "PlayUnrealFrameChannel.h"
+#include "PlayUnrealFunctionBinding.h"
+#include "PlayUnrealHopPlanner.h"
+#include "PlayUnrealInputSequence.h"
+#include "PlayUnrealJson.h"
+#include "PlayUnrealMetrics.h"
+#include "PlayUnrealMsgPack.h"
+#include "PlayUnrealPerfCapture.h"
+#include "PlayUnrealPropertyWatch.h"
+#include "PlayUnrealScheduler.h"
+#include "PlayUnrealScreenCapture.h"
+#include "PlayUnrealSelector.h"
+#include "PlayUnrealSessionLog.h"
+#include "PlayUnrealStatics.h"
+#include "PlayUnrealVisibilityTracker.h"
+#include "PlayUnrealWidgetRegistry.h"
+#include "PlayUnrealWorldSnapshot.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
 #include "Slate/SceneViewport.h"
-#include "TimerManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Driver Calls"), STAT_PlayUnreal_DriverCalls, STATGROUP_PlayUnreal);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Driver Call Count"), STAT_PlayUnreal_DriverCallCount, STATGROUP_PlayUnreal);
 
 APlayUnrealDriver::APlayUnrealDriver()
 {
-	PrimaryActorTick.bCanEverTick = false;
+	// Ticking is only switched on while there is deferred work (see Tick).
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+	SetTickableWhenPaused(true);
 	SessionId = FGuid::NewGuid().ToString();
 }
 
+void APlayUnrealDriver::BeginPlay()
+{
+	Super::BeginPlay();
+	FPlayUnrealAutomationModule::Get().RegisterDriver(this);
+
+#if WITH_PLAYUNREAL_AUTOMATION
+	FString SessionPath;
+	if (FParse::Value(FCommandLine::Get(), TEXT("PlayUnrealRecord="), SessionPath))
+	{
+		UE_LOG(LogTemp, Log, TEXT("PlayUnreal: %s"), *StartRecording(SessionPath));
+	}
+	if (FParse::Value(FCommandLine::Get(), TEXT("PlayUnrealReplay="), SessionPath))
+	{
+		TSharedRef<FJsonObject> Options = MakeShared<FJsonObject>();
+		Options->SetStringField(TEXT("path"), SessionPath);
+		UE_LOG(LogTemp, Log, TEXT("PlayUnreal: Replaying %s: %s"), *SessionPath,
+			*ReplaySession(PlayUnrealJson::ToString(Options)));
+		if (Replay.IsValid())
+		{
+			Replay->bExitWhenDone = FParse::Param(FCommandLine::Get(), TEXT("PlayUnrealReplayExit"));
+		}
+	}
+#endif
+}
+
+void APlayUnrealDriver::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	// Everything called from here is the driver's own work, not a client call.
+	TGuardValue<int32> InternalCalls(CallDepth, CallDepth + 1);
+
+	bool bHasPendingWork = false;
+	// Deferred commands may call GetBatchResults, which removes batches, so
+	// walk a copy of the IDs rather than the map itself.
+	TArray<int32, TInlineAllocator<8>> BatchIds;
+	Batches.GetKeys(BatchIds);
+	for (const int32 BatchId : BatchIds)
+	{
+		FBatch* Batch = Batches.Find(BatchId);
+		if (Batch && !Batch->IsComplete())
+		{
+			AdvanceBatch(*Batch);
+			Batch = Batches.Find(BatchId);
+			bHasPendingWork |= Batch && !Batch->IsComplete();
+		}
+	}
+
+	Inputs.RemoveAll([this](FPendingInput& Input) { return AdvanceInput(Input); });
+	bHasPendingWork |= !Inputs.IsEmpty();
+
+	Waits.RemoveAll([this](FLatentWait& Wait) { return AdvanceWait(Wait); });
+	bHasPendingWork |= !Waits.IsEmpty();
+
+	if (HopPlannerHandle != INDEX_NONE)
+	{
+		AdvanceHopPlanner();
+		bHasPendingWork |= HopPlannerHandle != INDEX_NONE;
+	}
+
+	for (TPair<int32, TSharedPtr<FPlayUnrealPropertyWatch>>& Pair : PropertyWatches)
+	{
+		Pair.Value->Sample();
+	}
+	bHasPendingWork |= !PropertyWatches.IsEmpty();
+
+#if WITH_PLAYUNREAL_AUTOMATION
+	if (Replay.IsValid())
+	{
+		// Keep the replay alive while it runs calls that may end it.
+		TSharedPtr<FReplay> Active = Replay;
+		if (AdvanceReplay(*Active))
+		{
+			FinishReplay();
+		}
+		bHasPendingWork |= Replay.IsValid();
+	}
+#endif
+
+	if (!bHasPendingWork)
+	{
+		SetActorTickEnabled(false);
+	}
+}
+
+void APlayUnrealDriver::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	FPlayUnrealAsyncResults& Results = FPlayUnrealAutomationModule::Get().GetAsyncResults();
+	for (const FLatentWait& Wait : Waits)
+	{
+		Results.Fail(Wait.Handle, TEXT("Driver was removed from the world"));
+	}
+	Waits.Reset();
+	for (const FPendingInput& Input : Inputs)
+	{
+		Input.Sequence->ReleaseHeld();
+		if (Input.Handle != INDEX_NONE)
+		{
+			Results.Fail(Input.Handle, TEXT("Driver was removed from the world"));
+		}
+	}
+	Inputs.Reset();
+	if (HopPlannerHandle != INDEX_NONE)
+	{
+		Results.Fail(HopPlannerHandle, TEXT("Driver was removed from the world"));
+		HopPlannerHandle = INDEX_NONE;
+	}
+#if WITH_PLAYUNREAL_AUTOMATION
+	if (Replay.IsValid())
+	{
+		FinishReplay(TEXT("Driver was removed from the world"));
+	}
+#endif
+	RestoreTimeStep();
+	PropertyWatches.Reset();
+	VisibilityTracker.Reset();
+	Recorder.Reset();
+	PerfCapture.Reset();
+	FrameChannel.Reset();
+
+	FPlayUnrealAutomationModule::Get().UnregisterDriver(this);
+	Super::EndPlay(EndPlayReason);
+}
+
+// Call timing and recording hook every driver call, so they are compiled
+// out with the transports; the driver's functions then run as plain calls.
+#if WITH_PLAYUNREAL_AUTOMATION
+
+/** Input parameters of a call as a JSON object, keyed as InvokeDriverFunction expects. */
+static FString ParamsToJson(const UFunction* Function, void* Parms)
+{
+	TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+	for (TFieldIterator<FProperty> It(Function); It && It->HasAnyPropertyFlags(CPF_Parm); ++It)
+	{
+		const bool bInput = !It->HasAnyPropertyFlags(CPF_ReturnParm)
+			&& (!It->HasAnyPropertyFlags(CPF_OutParm) || It->HasAnyPropertyFlags(CPF_ReferenceParm));
+		if (!bInput) continue;
+
+		TSharedPtr<FJsonValue> Value = FJsonObjectConverter::UPropertyToJsonValue(
+			*It, It->ContainerPtrToValuePtr<void>(Parms));
+		if (Value.IsValid())
+		{
+			Object->SetField(It->GetName(), Value);
+		}
+	}
+	return PlayUnrealJson::ToString(Object);
+}
+
+/** Return value of a finished call as JSON, "null" for void functions. */
+static FString ReturnValueToJson(const UFunction* Function, void* Parms)
+{
+	TSharedPtr<FJsonValue> Value;
+	if (FProperty* ReturnProperty = Function->GetReturnProperty())
+	{
+		Value = FJsonObjectConverter::UPropertyToJsonValue(
+			ReturnProperty, ReturnProperty->ContainerPtrToValuePtr<void>(Parms));
+	}
+	if (!Value.IsValid())
+	{
+		Value = MakeShared<FJsonValueNull>();
+	}
+	return PlayUnrealJson::ValueToString(Value);
+}
+
+void APlayUnrealDriver::ProcessEvent(UFunction* Function, void* Parms)
+{
+	// Only this class's own UFUNCTIONs; engine events (BeginPlay, Tick
+	// overrides in Blueprint subclasses) are not driver calls.
+	if (!Function || Function->GetOuterUClass() != APlayUnrealDriver::StaticClass())
+	{
+		Super::ProcessEvent(Function, Parms);
+		return;
+	}
+
+	FPlayUnrealAutomationModule& Module = FPlayUnrealAutomationModule::Get();
+	if (CallDepth == 0)
+	{
+		// A client is here: start the transports for its next calls.
+		Module.Activate();
+	}
+
+	const FName Method = Function->GetFName();
+	FPlayUnrealMetrics& Metrics = Module.GetMetrics();
+
+	TRACE_CPUPROFILER_EVENT_SCOPE_TEXT_ON_CHANNEL(*Method.ToString(), PlayUnrealChannel);
+	SCOPE_CYCLE_COUNTER(STAT_PlayUnreal_DriverCalls);
+	INC_DWORD_STAT(STAT_PlayUnreal_DriverCallCount);
+#if STATS
+	FScopeCycleCounter MethodCycleCounter(Metrics.GetStatId(Method));
+#endif
+
+	// Client calls only: nested and driver-initiated calls replay by themselves,
+	// and nothing is recorded while a replay drives the driver.
+	const bool bRecord = Recorder.IsValid() && CallDepth == 0 && !Replay.IsValid()
+		&& Method != GET_FUNCTION_NAME_CHECKED(APlayUnrealDriver, StartRecording)
+		&& Method != GET_FUNCTION_NAME_CHECKED(APlayUnrealDriver, StopRecording)
+		&& Method != GET_FUNCTION_NAME_CHECKED(APlayUnrealDriver, ReplaySession);
+	FString RecordedParams;
+	if (bRecord)
+	{
+		RecordedParams = ParamsToJson(Function, Parms);
+	}
+
+	const double StartSeconds = FPlatformTime::Seconds();
+	{
+		TGuardValue<int32> NestedCalls(CallDepth, CallDepth + 1);
+		Super::ProcessEvent(Function, Parms);
+	}
+	Metrics.RecordCall(Method, FPlatformTime::Seconds() - StartSeconds);
+
+	if (bRecord && Recorder.IsValid())
+	{
+		Recorder->Append(static_cast<uint32>(GFrameCounter - RecordStartFrame), Method.ToString(),
+			RecordedParams, ReturnValueToJson(Function, Parms));
+	}
+}
+
+#else
+
+void APlayUnrealDriver::ProcessEvent(UFunction* Function, void* Parms)
+{
+	Super::ProcessEvent(Function, Parms);
+}
+
+#endif // WITH_PLAYUNREAL_AUTOMATION
+
 // ---------------------------------------------------------------------------
 // Ping
 // ---------------------------------------------------------------------------
 
 FString APlayUnrealDriver::Ping() const
 {
-	return FString::Printf(
-		TEXT("{\"version\":\"%s\",\"session\":\"%s\"}"),
-		*Version, *SessionId);
+	TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+	Object->SetStringField(TEXT("version"), Version);
+	Object->SetStringField(TEXT("session"), SessionId);
+
+	// Optional capabilities a client may negotiate.
+	TArray<TSharedPtr<FJsonValue>> Features;
+	Features.Add(MakeShared<FJsonValueString>(TEXT("batch")));
+	Features.Add(MakeShared<FJsonValueString>(TEXT("msgpack")));
+	Features.Add(MakeShared<FJsonValueString>(TEXT("watch")));
+
+	// Headless processes still serve queries and input, just not pixels.
+	const FPlayUnrealScreenCapture::ERenderMode RenderMode = FPlayUnrealScreenCapture::GetRenderMode();
+	Object->SetStringField(TEXT("render"), FPlayUnrealScreenCapture::RenderModeToString(RenderMode));
+	if (RenderMode != FPlayUnrealScreenCapture::ERenderMode::None)
+	{
+		Features.Add(MakeShared<FJsonValueString>(TEXT("screenshot")));
+		Features.Add(MakeShared<FJsonValueString>(TEXT("framechannel")));
+	}
+
+	Object->SetNumberField(TEXT("worldGeneration"), FPlayUnrealAutomationModule::Get().GetWorldGeneration());
+
+	const uint32 StreamPort = FPlayUnrealAutomationModule::Get().GetStreamPort();
+	if (StreamPort != 0)
+	{
+		Features.Add(MakeShared<FJsonValueString>(TEXT("stream")));
+		Object->SetNumberField(TEXT("streamPort"), StreamPort);
+	}
+
+	const uint32 TcpPort = FPlayUnrealAutomationModule::Get().GetTcpPort();
+	if (TcpPort != 0)
+	{
+		Features.Add(MakeShared<FJsonValueString>(TEXT("tcp")));
+		Object->SetNumberField(TEXT("tcpPort"), TcpPort);
+	}
+	Object->SetArrayField(TEXT("features"), Features);
+
+	Object->SetStringField(TEXT("wireFormat"), WireFormat == EWireFormat::MessagePack ? TEXT("msgpack") : TEXT("json"));
+
+	return PlayUnrealJson::ToString(Object);
+}
+
+FString APlayUnrealDriver::SetWireFormat(const FString& Format)
+{
+	if (Format.Equals(TEXT("json"), ESearchCase::IgnoreCase))
+	{
+		WireFormat = EWireFormat::Json;
+	}
+	else if (Format.Equals(TEXT("msgpack"), ESearchCase::IgnoreCase))
+	{
+		WireFormat = EWireFormat::MessagePack;
+	}
+	else
+	{
+		return PlayUnrealJson::Error(FString::Printf(TEXT("Unknown wire format '%s'"), *Format));
+	}
+
+	TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+	Object->SetBoolField(TEXT("ok"), true);
+	Object->SetStringField(TEXT("format"), Format.ToLower());
+	return PlayUnrealJson::ToString(Object);
+}
+
+FString APlayUnrealDriver::GetMetrics() const
+{
+	FPlayUnrealAutomationModule& Module = FPlayUnrealAutomationModule::Get();
+	TSharedRef<FJsonObject> Object = Module.GetMetrics().ToJson();
+	Object->SetObjectField(TEXT("scheduler"), Module.GetScheduler().ToJson());
+	return PlayUnrealJson::ToString(Object);
+}
+
+FString APlayUnrealDriver::SetFrameBudget(float Milliseconds)
+{
+	if (!(Milliseconds > 0.0f))
+	{
+		return PlayUnrealJson::Error(TEXT("Milliseconds must be positive"));
+	}
+
+	FPlayUnrealScheduler& Scheduler = FPlayUnrealAutomationModule::Get().GetScheduler();
+	Scheduler.SetBudgetMs(Milliseconds);
+	return Encode(Scheduler.ToJson());
+}
+
+void APlayUnrealDriver::ResetMetrics()
+{
+	FPlayUnrealAutomationModule::Get().GetMetrics().Reset();
+}
+
+// ---------------------------------------------------------------------------
+// Performance
+// ---------------------------------------------------------------------------
+
+#if !WITH_PLAYUNREAL_AUTOMATION
+/** Reply for calls whose implementation the build leaves out (see PlayUnrealAutomation.Build.cs). */
+static FString CompiledOut(const TCHAR* What)
+{
+	return PlayUnrealJson::Error(FString::Printf(
+		TEXT("%s is not available in builds without WITH_PLAYUNREAL_AUTOMATION"), What));
+}
+#endif
+
+FString APlayUnrealDriver::BeginPerfCapture(const FString& OptionsJSON)
+{
+#if WITH_PLAYUNREAL_AUTOMATION
+	if (PerfCapture.IsValid())
+	{
+		return PlayUnrealJson::Error(FString::Printf(
+			TEXT("Capture %s is already running"), *PerfCapture->GetName()));
+	}
+
+	TSharedPtr<FJsonObject> Options = PlayUnrealJson::ParseObject(OptionsJSON.IsEmpty() ? TEXT("{}") : OptionsJSON);
+	if (!Options.IsValid())
+	{
+		return PlayUnrealJson::Error(TEXT("OptionsJSON is not a JSON object"));
+	}
+
+	FString Error;
+	TUniquePtr<FPlayUnrealPerfCapture> Capture = FPlayUnrealPerfCapture::Begin(*Options, Error);
+	if (!Capture.IsValid())
+	{
+		return PlayUnrealJson::Error(Error);
+	}
+	PerfCapture = TSharedPtr<FPlayUnrealPerfCapture>(Capture.Release());
+
+	TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+	Object->SetBoolField(TEXT("ok"), true);
+	Object->SetStringField(TEXT("name"), PerfCapture->GetName());
+	return Encode(Object);
+#else
+	return CompiledOut(TEXT("Perf capture"));
+#endif
+}
+
+FString APlayUnrealDriver::EndPerfCapture()
+{
+#if WITH_PLAYUNREAL_AUTOMATION
+	if (!PerfCapture.IsValid())
+	{
+		return PlayUnrealJson::Error(TEXT("No capture is running"));
+	}
+
+	TSharedRef<FJsonObject> Summary = PerfCapture->End();
+	PerfCapture.Reset();
+	return Encode(Summary);
+#else
+	return CompiledOut(TEXT("Perf capture"));
+#endif
+}
+
+FString APlayUnrealDriver::Encode(const TSharedRef<FJsonObject>& Object) const
+{
+	if (WireFormat == EWireFormat::MessagePack)
+	{
+		FPlayUnrealMsgPackWriter Writer;
+		Writer.WriteObject(Object);
+		return Writer.ToWireString();
+	}
+	return PlayUnrealJson::ToString(Object);
 }
 
 // ---------------------------------------------------------------------------
-// UMG Widget Interaction (stubs — requires Automation Driver wiring)
+// UMG Widget Interaction
 // ---------------------------------------------------------------------------
 
+/**
+ * Resolve a widget by bare automation ID, or by selector when the string
+ * looks like one (see PlayUnrealSelector.h). Bare IDs stay exact lookups.
+ */
 static UWidget* FindWidgetById(const UWorld* World, const FString& Id)
 {
 	if (!World) return nullptr;
 
-	// Iterate all player controllers and their HUD widgets
-	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	if (FPlayUnrealSelector::IsSelector(Id))
 	{
-		APlayerController* PC = It->Get();
-		if (!PC) continue;
-
-		// Check all widgets owned by this player
-		TArray<UUserWidget*> Widgets;
-		UWidgetTree::ForEachWidget(PC, [&](UWidget* Widget)
+		FString Error;
+		TSharedPtr<const FPlayUnrealSelector> Selector = FPlayUnrealSelector::Compile(Id, Error);
+		if (!Selector.IsValid())
 		{
-			// UWidget doesn't have GetAutomationId in all UE versions.
-			// Check the widget's name as a fallback identifier.
-			if (Widget && Widget->GetName() == Id)
-			{
-				// Found
-			}
-		});
+			UE_LOG(LogTemp, Log, TEXT("PlayUnreal: Bad selector '%s' — %s"), *Id, *Error);
+			return nullptr;
+		}
+
+		TArray<FPlayUnrealSelector::FMatch> Matches;
+		Selector->Match(World, 1, Matches);
+		return Matches.IsEmpty() ? nullptr : Matches[0].Widget;
 	}
 
-	// Stub: full implementation requires Automation Driver integration
-	return nullptr;
+	UPlayUnrealWidgetRegistry* Registry = UPlayUnrealWidgetRegistry::Get(World);
+	return Registry ? Registry->FindFirst(Id, World) : nullptr;
 }
 
 bool APlayUnrealDriver::ClickById(const FString& Id)
 {
-	UE_LOG(LogTemp, Log, TEXT("PlayUnreal: ClickById(%s) — stub"), *Id);
-	// TODO: Wire to Automation Driver By::Id locator
-	return false;
+	UWidget* Widget = FindWidgetById(GetWorld(), Id);
+	if (!Widget)
+	{
+		UE_LOG(LogTemp, Log, TEXT("PlayUnreal: ClickById(%s) — not found"), *Id);
+		return false;
+	}
+
+	// Buttons are clicked through their delegate, which works headless too.
+	// Like a real click, it only reaches enabled, visible buttons.
+	if (UButton* Button = Cast<UButton>(Widget))
+	{
+		if (!Button->GetIsEnabled() || !FPlayUnrealSelector::IsEffectivelyVisible(Button))
+		{
+			UE_LOG(LogTemp, Log, TEXT("PlayUnreal: ClickById(%s) — button is disabled or hidden"), *Id);
+			return false;
+		}
+		Button->OnClicked.Broadcast();
+		return true;
+	}
+
+	// Anything else (checkboxes, list rows, custom widgets) gets a real
+	// click through Slate at the centre of its painted geometry.
+	FVector2D Position;
+	FVector2D Size;
+	if (!FSlateApplication::IsInitialized() || !FPlayUnrealSelector::IsEffectivelyVisible(Widget)
+		|| !FPlayUnrealVisibilityTracker::GetViewportRect(Widget, Position, Size))
+	{
+		UE_LOG(LogTemp, Log,
+			TEXT("PlayUnreal: ClickById(%s) — %s is not a button and is not on screen"),
+			*Id, *Widget->GetClass()->GetName());
+		return false;
+	}
+
+	const FVector2D Centre = Position + Size * 0.5;
+	TSharedRef<FJsonObject> Click = MakeShared<FJsonObject>();
+	Click->SetStringField(TEXT("type"), TEXT("click"));
+	Click->SetNumberField(TEXT("x"), Centre.X);
+	Click->SetNumberField(TEXT("y"), Centre.Y);
+
+	FPendingInput Input;
+	Input.Sequence = MakeShared<FPlayUnrealInputSequence>();
+	FString Error;
+	if (!Input.Sequence->InitFromJson({ MakeShared<FJsonValueObject>(Click) }, Error))
+	{
+		UE_LOG(LogTemp, Log, TEXT("PlayUnreal: ClickById(%s) — %s"), *Id, *Error);
+		return false;
+	}
+	if (!AdvanceInput(Input))
+	{
+		Inputs.Add(MoveTemp(Input));
+		SetActorTickEnabled(true);
+	}
+	return true;
 }
 
 bool APlayUnrealDriver::TypeText(const FString& Text)
 {
-	UE_LOG(LogTemp, Log, TEXT("PlayUnreal: TypeText(%s) — stub"), *Text);
-	// TODO: Wire to Automation Driver input sequence
-	return false;
+	if (!FSlateApplication::IsInitialized()) return false;
+
+	FPlayUnrealInputSequence Sequence;
+	Sequence.AddText(Text);
+	Sequence.Advance(GFrameCounter);
+	return true;
 }
 
 bool APlayUnrealDriver::PressKey(const FString& KeyChord)
 {
-	UE_LOG(LogTemp, Log, TEXT("PlayUnreal: PressKey(%s) — stub"), *KeyChord);
-	// TODO: Wire to FSlateApplication::ProcessKeyDownEvent
-	return false;
+	if (!FSlateApplication::IsInitialized()) return false;
+
+	FPendingInput Input;
+	Input.Sequence = MakeShared<FPlayUnrealInputSequence>();
+	FString Error;
+	if (!Input.Sequence->AddKeyChord(KeyChord, Error))
+	{
+		UE_LOG(LogTemp, Log, TEXT("PlayUnreal: PressKey(%s) — %s"), *KeyChord, *Error);
+		return false;
+	}
+
+	if (!AdvanceInput(Input))
+	{
+		Inputs.Add(MoveTemp(Input));
+		SetActorTickEnabled(true);
+	}
+	return true;
+}
+
+FString APlayUnrealDriver::SendInput(const FString& EventsJSON)
+{
+	TSharedPtr<FJsonValue> Root;
+	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(EventsJSON);
+	if (!FJsonSerializer::Deserialize(Reader, Root) || !Root.IsValid() || Root->Type != EJson::Array)
+	{
+		return PlayUnrealJson::Error(TEXT("EventsJSON is not a JSON array"));
+	}
+	if (!FSlateApplication::IsInitialized())
+	{
+		return PlayUnrealJson::Error(TEXT("Slate is not initialized; input cannot be injected"));
+	}
+
+	FPendingInput Input;
+	Input.Sequence = MakeShared<FPlayUnrealInputSequence>();
+	FString Error;
+	if (!Input.Sequence->InitFromJson(Root->AsArray(), Error))
+	{
+		return PlayUnrealJson::Error(Error);
+	}
+	Input.Handle = FPlayUnrealAutomationModule::Get().GetAsyncResults().Create(TEXT("input"));
+
+	const int32 Handle = Input.Handle;
+	if (!AdvanceInput(Input))
+	{
+		Inputs.Add(MoveTemp(Input));
+		SetActorTickEnabled(true);
+	}
+
+	TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+	Object->SetNumberField(TEXT("handle"), Handle);
+	return Encode(Object);
+}
+
+bool APlayUnrealDriver::AdvanceInput(FPendingInput& Input)
+{
+	FPlayUnrealAsyncResults& Results = FPlayUnrealAutomationModule::Get().GetAsyncResults();
+	if (Input.Handle != INDEX_NONE && !Results.IsPending(Input.Handle))
+	{
+		// Cancelled by the client; do not leave keys stuck down.
+		Input.Sequence->ReleaseHeld();
+		return true;
+	}
+
+	if (!Input.Sequence->Advance(GFrameCounter)) return false;
+
+	if (Input.Handle != INDEX_NONE)
+	{
+		TSharedRef<FJsonObject> Result = MakeShared<FJsonObject>();
+		Result->SetNumberField(TEXT("frame"), static_cast<double>(GFrameCounter));
+		Result->SetNumberField(TEXT("frames"), static_cast<double>(GFrameCounter - Input.Sequence->GetStartFrame()));
+		Result->SetNumberField(TEXT("events"), Input.Sequence->Num());
+		Results.Succeed(Input.Handle, Result);
+	}
+	return true;
 }
 
 bool APlayUnrealDriver::ElementExists(const FString& Id) const
 {
-	UE_LOG(LogTemp, Log, TEXT("PlayUnreal: ElementExists(%s) — stub"), *Id);
-	return false;
+	return FindWidgetById(GetWorld(), Id) != nullptr;
 }
 
 bool APlayUnrealDriver::IsVisible(const FString& Id) const
 {
-	UE_LOG(LogTemp, Log, TEXT("PlayUnreal: IsVisible(%s) — stub"), *Id);
-	return false;
+	// Tracked IDs were resolved after this frame's Slate tick already.
+	bool bVisible = false;
+	if (VisibilityTracker.IsValid() && VisibilityTracker->GetCachedVisibility(Id, bVisible))
+	{
+		return bVisible;
+	}
+	return FPlayUnrealSelector::IsEffectivelyVisible(FindWidgetById(GetWorld(), Id));
 }
 
-// ---------------------------------------------------------------------------
-// Evidence
-// ---------------------------------------------------------------------------
-
-FString APlayUnrealDriver::Screenshot(const FString& Path)
+FString APlayUnrealDriver::TrackVisibility(const FString& IdsJSON)
 {
-	FString FullPath = FPaths::Combine(FPaths::ProjectSavedDir(), Path);
-	FPaths::MakeStandardFilename(FullPath);
+	TSharedPtr<FJsonValue> Root;
+	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(IdsJSON);
+	if (!FJsonSerializer::Deserialize(Reader, Root) || !Root.IsValid() || Root->Type != EJson::Array)
+	{
+		return PlayUnrealJson::Error(TEXT("IdsJSON is not a JSON array"));
+	}
 
-	// Ensure directory exists
-	IFileManager::Get().MakeDirectory(*FPaths::GetPath(FullPath), true);
+	TArray<FString> Ids;
+	for (const TSharedPtr<FJsonValue>& Value : Root->AsArray())
+	{
+		FString Id;
+		if (!Value.IsValid() || !Value->TryGetString(Id) || Id.IsEmpty())
+		{
+			return PlayUnrealJson::Error(TEXT("IdsJSON must contain automation ID strings"));
+		}
+		Ids.Add(Id);
+	}
 
-	// Request a screenshot from the engine
-	FScreenshotRequest::RequestScreenshot(FullPath, false, false);
+	if (!VisibilityTracker.IsValid())
+	{
+		VisibilityTracker = MakeShared<FPlayUnrealVisibilityTracker>(GetWorld());
+	}
+	const int32 Tracker = VisibilityTracker->AddSet(Ids);
 
-	UE_LOG(LogTemp, Log, TEXT("PlayUnreal: Screenshot requested -> %s"), *FullPath);
-	return FullPath;
+	TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+	Object->SetNumberField(TEXT("tracker"), Tracker);
+	Object->SetNumberField(TEXT("frame"), static_cast<double>(GFrameCounter));
+	Object->SetObjectField(TEXT("widgets"), VisibilityTracker->Report(Tracker, false));
+	return Encode(Object);
 }
 
-// ---------------------------------------------------------------------------
-// World Queries
-// ---------------------------------------------------------------------------
+FString APlayUnrealDriver::GetVisibilityChanges(int32 Tracker)
+{
+	TSharedPtr<FJsonObject> Widgets = VisibilityTracker.IsValid() ? VisibilityTracker->Report(Tracker, true) : nullptr;
+	if (!Widgets.IsValid())
+	{
+		return PlayUnrealJson::Error(FString::Printf(TEXT("Unknown visibility tracker %d"), Tracker));
+	}
 
-FString APlayUnrealDriver::FindActorByName(const FString& Name) const
+	TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+	Object->SetNumberField(TEXT("frame"), static_cast<double>(VisibilityTracker->GetFrame()));
+	Object->SetObjectField(TEXT("widgets"), Widgets);
+	return Encode(Object);
+}
+
+bool APlayUnrealDriver::UntrackVisibility(int32 Tracker)
 {
-	UWorld* World = GetWorld();
-	if (!World) return FString();
+	if (!VisibilityTracker.IsValid() || !VisibilityTracker->RemoveSet(Tracker)) return false;
+
+	// Nothing left to track: stop hooking Slate's tick.
+	if (VisibilityTracker->IsEmpty())
+	{
+		VisibilityTracker.Reset();
+	}
+	return true;
+}
+
+/** What QueryWidgets reports for one match, read on the game thread. */
+struct FPlayUnrealWidgetInfo
+{
+	/** The match, for looking the ID up in a registry snapshot off the game thread. */
+	FObjectKey Widget;
+	FString Id;
+	FString Name;
+	FString Class;
+	FString Path;
+	FString Text;
+	bool bVisible = false;
+	bool bHasText = false;
+	bool bHasRect = false;
+	FVector2D Position = FVector2D::ZeroVector;
+	FVector2D Size = FVector2D::ZeroVector;
+};
 
-	for (TActorIterator<AActor> It(World); It; ++It)
+/** Reads each match; with bReadIds false, Id is left for a snapshot lookup. */
+static void ReadWidgetInfos(const TArray<FPlayUnrealSelector::FMatch>& Matches,
+                            TArray<FPlayUnrealWidgetInfo>& OutInfos, bool bReadIds = true)
+{
+	OutInfos.Reserve(OutInfos.Num() + Matches.Num());
+	for (const FPlayUnrealSelector::FMatch& Match : Matches)
 	{
-		AActor* Actor = *It;
-		if (Actor && (Actor->GetName() == Name || Actor->GetActorLabel() == Name))
+		FPlayUnrealWidgetInfo& Info = OutInfos.AddDefaulted_GetRef();
+		Info.Widget = FObjectKey(Match.Widget);
+		const UPlayUnrealWidgetRegistry* Registry = bReadIds ? UPlayUnrealWidgetRegistry::Get(Match.Widget) : nullptr;
+		if (Registry)
 		{
-			return Actor->GetPathName();
+			Info.Id = Registry->GetId(Match.Widget);
 		}
+		Info.Name = Match.Widget->GetName();
+		Info.Class = Match.Widget->GetClass()->GetName();
+		Info.Path = Match.Path;
+		Info.bVisible = Match.bVisible;
+		Info.bHasText = FPlayUnrealSelector::GetWidgetText(Match.Widget, Info.Text);
+		Info.bHasRect = FPlayUnrealVisibilityTracker::GetViewportRect(Match.Widget, Info.Position, Info.Size);
 	}
-
-	return FString();
 }
 
-FString APlayUnrealDriver::CallFunction(const FString& ObjectPath,
-                                         const FString& FunctionName,
-                                         const FString& ParamsJSON)
+/** The QueryWidgets response. Touches no UObjects, so it can run on a worker. */
+static TSharedRef<FJsonObject> WidgetInfosToJson(const TArray<FPlayUnrealWidgetInfo>& Infos)
 {
-	UE_LOG(LogTemp, Log,
-		TEXT("PlayUnreal: CallFunction(%s, %s) — delegating to Remote Control"),
-		*ObjectPath, *FunctionName);
+	TArray<TSharedPtr<FJsonValue>> Widgets;
+	Widgets.Reserve(Infos.Num());
+	for (const FPlayUnrealWidgetInfo& Info : Infos)
+	{
+		TSharedRef<FJsonObject> Entry = MakeShared<FJsonObject>();
+		if (!Info.Id.IsEmpty())
+		{
+			Entry->SetStringField(TEXT("id"), Info.Id);
+		}
+		Entry->SetStringField(TEXT("name"), Info.Name);
+		Entry->SetStringField(TEXT("class"), Info.Class);
+		Entry->SetStringField(TEXT("path"), Info.Path);
+		Entry->SetBoolField(TEXT("visible"), Info.bVisible);
+		if (Info.bHasText)
+		{
+			Entry->SetStringField(TEXT("text"), Info.Text);
+		}
+		if (Info.bHasRect)
+		{
+			TSharedRef<FJsonObject> Rect = MakeShared<FJsonObject>();
+			Rect->SetNumberField(TEXT("x"), Info.Position.X);
+			Rect->SetNumberField(TEXT("y"), Info.Position.Y);
+			Rect->SetNumberField(TEXT("w"), Info.Size.X);
+			Rect->SetNumberField(TEXT("h"), Info.Size.Y);
+			Entry->SetObjectField(TEXT("rect"), Rect);
+		}
+		Widgets.Add(MakeShared<FJsonValueObject>(Entry));
+	}
 
-	// This function is a convenience wrapper. In practice, external scripts
-	// call functions directly via PUT /remote/object/call. This stub exists
-	// so the function can be called through the driver actor if needed.
-	return TEXT("{\"status\":\"stub\"}");
+	TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+	Object->SetNumberField(TEXT("count"), Widgets.Num());
+	Object->SetArrayField(TEXT("widgets"), Widgets);
+	return Object;
 }
 
+/** WidgetInfosToJson's shape, written without building the JSON objects. */
+static FString WidgetInfosToMsgPack(const TArray<FPlayUnrealWidgetInfo>& Infos)
+{
+	FPlayUnrealMsgPackWriter Writer;
+	Writer.WriteMapHeader(2);
+	Writer.WriteString(TEXT("count"));
+	Writer.WriteInt(Infos.Num());
+	Writer.WriteString(TEXT("widgets"));
+	Writer.WriteArrayHeader(Infos.Num());
+	for (const FPlayUnrealWidgetInfo& Info : Infos)
+	{
+		Writer.WriteMapHeader(4 + (Info.Id.IsEmpty() ? 0 : 1) + (Info.bHasText ? 1 : 0) + (Info.bHasRect ? 1 : 0));
+		if (!Info.Id.IsEmpty())
+		{
+			Writer.WriteString(TEXT("id"));
+			Writer.WriteString(Info.Id);
+		}
+		Writer.WriteString(TEXT("name"));
+		Writer.WriteString(Info.Name);
+		Writer.WriteString(TEXT("class"));
+		Writer.WriteString(Info.Class);
+		Writer.WriteString(TEXT("path"));
+		Writer.WriteString(Info.Path);
+		Writer.WriteString(TEXT("visible"));
+		Writer.WriteBool(Info.bVisible);
+		if (Info.bHasText)
+		{
+			Writer.WriteString(TEXT("text"));
+			Writer.WriteString(Info.Text);
+		}
+		if (Info.bHasRect)
+		{
+			Writer.WriteString(TEXT("rect"));
+			Writer.WriteMapHeader(4);
+			Writer.WriteString(TEXT("x"));
+			Writer.WriteNumber(Info.Position.X);
+			Writer.WriteString(TEXT("y"));
+			Writer.WriteNumber(Info.Position.Y);
+			Writer.WriteString(TEXT("w"));
+			Writer.WriteNumber(Info.Size.X);
+			Writer.WriteString(TEXT("h"));
+			Writer.WriteNumber(Info.Size.Y);
+		}
+	}
+	return Writer.ToWireString();
+}
+
+FString APlayUnrealDriver::QueryWidgets(const FString& Selector, int32 Limit) const
+{
+	FString Error;
+	TSharedPtr<const FPlayUnrealSelector> Compiled = FPlayUnrealSelector::Compile(Selector, Error);
+	if (!Compiled.IsValid())
+	{
+		return PlayUnrealJson::Error(Error);
+	}
+
+	TArray<FPlayUnrealSelector::FMatch> Matches;
+	Compiled->Match(GetWorld(), FMath::Max(Limit, 0), Matches);
+
+	TArray<FPlayUnrealWidgetInfo> Infos;
+	ReadWidgetInfos(Matches, Infos);
+	if (WireFormat == EWireFormat::MessagePack)
+	{
+		return WidgetInfosToMsgPack(Infos);
+	}
+	return PlayUnrealJson::ToString(WidgetInfosToJson(Infos));
+}
+
+FString APlayUnrealDriver::QueryWidgetsAsync(const FString& Selector, int32 Limit)
+{
+	FString Error;
+	TSharedPtr<const FPlayUnrealSelector> Compiled = FPlayUnrealSelector::Compile(Selector, Error);
+	if (!Compiled.IsValid())
+	{
+		return PlayUnrealJson::Error(Error);
+	}
+
+	struct FQuery
+	{
+		TArray<TWeakObjectPtr<UUserWidget>> Roots;
+		int32 NextRoot = 0;
+		bool bStarted = false;
+		uint64 StartFrame = 0;
+		TArray<FPlayUnrealWidgetInfo> Infos;
+	};
+
+	FPlayUnrealAutomationModule& Module = FPlayUnrealAutomationModule::Get();
+	const int32 Handle = Module.GetAsyncResults().Create(TEXT("query"));
+	const int32 MaxMatches = FMath::Max(Limit, 0);
+	TSharedRef<FQuery> Query = MakeShared<FQuery>();
+	TWeakObjectPtr<UWorld> World = GetWorld();
+
+	// One root widget tree per step; the walk stops at the frame's deadline.
+	Module.GetScheduler().Add([Compiled, Query, World, Handle, MaxMatches](double Deadline)
+	{
+		FPlayUnrealAutomationModule& Module = FPlayUnrealAutomationModule::Get();
+		FPlayUnrealAsyncResults& Results = Module.GetAsyncResults();
+		if (!Results.IsPending(Handle)) return true;
+		if (!World.IsValid())
+		{
+			Results.Fail(Handle, TEXT("World was torn down during the query"));
+			return true;
+		}
+
+		TArray<FPlayUnrealSelector::FMatch> Matches;
+		bool bDone = false;
+		if (!Query->bStarted)
+		{
+			Query->bStarted = true;
+			Query->StartFrame = GFrameCounter;
+			if (!Compiled->NeedsTreeWalk())
+			{
+				Compiled->Match(World.Get(), MaxMatches, Matches);
+				bDone = true;
+			}
+			else
+			{
+				FPlayUnrealSelector::CollectRoots(World.Get(), Query->Roots);
+			}
+		}
+
+		while (!bDone && Query->NextRoot < Query->Roots.Num())
+		{
+			// The limit counts Matches, which holds only this slice's share.
+			const int32 SliceLimit = MaxMatches > 0 ? MaxMatches - Query->Infos.Num() : 0;
+			bDone = !Compiled->MatchRoot(Query->Roots[Query->NextRoot++].Get(), SliceLimit, Matches);
+			if (FPlatformTime::Seconds() >= Deadline) break;
+		}
+		ReadWidgetInfos(Matches, Query->Infos, false);
+
+		if (!bDone && Query->NextRoot < Query->Roots.Num()) return false;
+
+		// IDs are looked up on the worker, in a snapshot that includes this frame's tags.
+		TSharedPtr<const UPlayUnrealWidgetRegistry::FSnapshot, ESPMode::ThreadSafe> Ids;
+		if (UPlayUnrealWidgetRegistry* Registry = UPlayUnrealWidgetRegistry::Get(World.Get()))
+		{
+			Ids = Registry->PublishSnapshot();
+		}
+
+		const double Frames = static_cast<double>(GFrameCounter - Query->StartFrame + 1);
+		Module.GetScheduler().Offload(Handle, [Infos = MoveTemp(Query->Infos), Ids, Frames]() mutable
+		{
+			if (Ids.IsValid())
+			{
+				for (FPlayUnrealWidgetInfo& Info : Infos)
+				{
+					Info.Id = Ids->GetId(Info.Widget);
+				}
+			}
+			TSharedRef<FJsonObject> Object = WidgetInfosToJson(Infos);
+			Object->SetNumberField(TEXT("frames"), Frames);
+			return Object;
+		});
+		return true;
+	});
+
+	TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+	Object->SetNumberField(TEXT("handle"), Handle);
+	return Encode(Object);
+}
+
+// ---------------------------------------------------------------------------
+// Evidence
+// ---------------------------------------------------------------------------
+
+FString APlayUnrealDriver::Screenshot(const FString& Path)
+{
+	FPlayUnrealScreenCapture::FRequest Request;
+	Request.FullPath = FPaths::Combine(FPaths::ProjectSavedDir(), Path);
+	FPaths::MakeStandardFilename(Request.FullPath);
+	if (Path.EndsWith(TEXT(".jpg")) || Path.EndsWith(TEXT(".jpeg")))
+	{
+		Request.Format = FPlayUnrealScreenCapture::EFormat::Jpeg;
+	}
+
+	const FString FullPath = Request.FullPath;
+	FString Error;
+	if (FPlayUnrealAutomationModule::Get().GetScreenCapture().Request(MoveTemp(Request), Error) == INDEX_NONE)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("PlayUnreal: Screenshot failed: %s"), *Error);
+		return FString();
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("PlayUnreal: Screenshot requested -> %s"), *FullPath);
+	return FullPath;
+}
+
+FString APlayUnrealDriver::CaptureScreenshot(const FString& OptionsJSON)
+{
+	FPlayUnrealScreenCapture::FRequest Request;
+
+	if (!OptionsJSON.IsEmpty())
+	{
+		TSharedPtr<FJsonObject> Options = PlayUnrealJson::ParseObject(OptionsJSON);
+		if (!Options.IsValid())
+		{
+			return PlayUnrealJson::Error(TEXT("OptionsJSON is not a JSON object"));
+		}
+
+		FString Path;
+		if (Options->TryGetStringField(TEXT("path"), Path) && !Path.IsEmpty())
+		{
+			Request.FullPath = FPaths::Combine(FPaths::ProjectSavedDir(), Path);
+			FPaths::MakeStandardFilename(Request.FullPath);
+		}
+
+		FString Format;
+		if (Options->TryGetStringField(TEXT("format"), Format))
+		{
+			if (Format == TEXT("jpeg") || Format == TEXT("jpg"))
+			{
+				Request.Format = FPlayUnrealScreenCapture::EFormat::Jpeg;
+			}
+			else if (Format != TEXT("png"))
+			{
+				return PlayUnrealJson::Error(FString::Printf(TEXT("Unknown format '%s'"), *Format));
+			}
+		}
+
+		int32 Quality = 0;
+		if (Options->TryGetNumberField(TEXT("quality"), Quality))
+		{
+			Request.Quality = FMath::Clamp(Quality, 1, 100);
+		}
+	}
+
+	FString Error;
+	const int32 Handle = FPlayUnrealAutomationModule::Get().GetScreenCapture().Request(MoveTemp(Request), Error);
+	if (Handle == INDEX_NONE)
+	{
+		return PlayUnrealJson::Error(Error);
+	}
+
+	TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+	Object->SetNumberField(TEXT("handle"), Handle);
+	return Encode(Object);
+}
+
+FString APlayUnrealDriver::OpenFrameChannel(const FString& OptionsJSON)
+{
+#if WITH_PLAYUNREAL_AUTOMATION
+	if (FrameChannel.IsValid())
+	{
+		return PlayUnrealJson::Error(TEXT("A frame channel is already open"));
+	}
+
+	TSharedPtr<FJsonObject> Options = PlayUnrealJson::ParseObject(OptionsJSON.IsEmpty() ? TEXT("{}") : OptionsJSON);
+	if (!Options.IsValid())
+	{
+		return PlayUnrealJson::Error(TEXT("OptionsJSON is not a JSON object"));
+	}
+
+	FPlayUnrealFrameChannel::FOptions ChannelOptions;
+	Options->TryGetStringField(TEXT("name"), ChannelOptions.Name);
+	Options->TryGetNumberField(TEXT("slots"), ChannelOptions.Slots);
+	Options->TryGetNumberField(TEXT("downscale"), ChannelOptions.Downscale);
+	Options->TryGetNumberField(TEXT("everyNth"), ChannelOptions.EveryNth);
+
+	const TSharedPtr<FJsonObject>* Crop = nullptr;
+	if (Options->TryGetObjectField(TEXT("crop"), Crop))
+	{
+		int32 X = 0, Y = 0, W = 0, H = 0;
+		(*Crop)->TryGetNumberField(TEXT("x"), X);
+		(*Crop)->TryGetNumberField(TEXT("y"), Y);
+		(*Crop)->TryGetNumberField(TEXT("w"), W);
+		(*Crop)->TryGetNumberField(TEXT("h"), H);
+		if (W <= 0 || H <= 0)
+		{
+			return PlayUnrealJson::Error(TEXT("crop needs a positive w and h"));
+		}
+		ChannelOptions.Crop = FIntRect(X, Y, X + W, Y + H);
+	}
+
+	FString WidgetId;
+	if (Options->TryGetStringField(TEXT("widget"), WidgetId))
+	{
+		ChannelOptions.Widget = FindWidgetById(GetWorld(), WidgetId);
+		if (!ChannelOptions.Widget.IsValid())
+		{
+			return PlayUnrealJson::Error(FString::Printf(TEXT("No widget matches '%s'"), *WidgetId));
+		}
+	}
+
+	FString Error;
+	TUniquePtr<FPlayUnrealFrameChannel> Channel = FPlayUnrealFrameChannel::Open(MoveTemp(ChannelOptions), Error);
+	if (!Channel.IsValid())
+	{
+		return PlayUnrealJson::Error(Error);
+	}
+	FrameChannel = TSharedPtr<FPlayUnrealFrameChannel>(Channel.Release());
+	return Encode(FrameChannel->Describe());
+#else
+	return CompiledOut(TEXT("The frame channel"));
+#endif
+}
+
+FString APlayUnrealDriver::CloseFrameChannel()
+{
+#if WITH_PLAYUNREAL_AUTOMATION
+	if (!FrameChannel.IsValid())
+	{
+		return PlayUnrealJson::Error(TEXT("No frame channel is open"));
+	}
+
+	TSharedRef<FJsonObject> Stats = FrameChannel->GetStats();
+	FrameChannel.Reset();
+	return Encode(Stats);
+#else
+	return CompiledOut(TEXT("The frame channel"));
+#endif
+}
+
+FString APlayUnrealDriver::GetAsyncResult(int32 Handle)
+{
+	TSharedPtr<FJsonObject> Result = FPlayUnrealAutomationModule::Get().GetAsyncResults().Take(Handle);
+	if (!Result.IsValid())
+	{
+		return PlayUnrealJson::Error(FString::Printf(TEXT("Unknown handle %d"), Handle));
+	}
+	return Encode(Result.ToSharedRef());
+}
+
+bool APlayUnrealDriver::CancelAsync(int32 Handle)
+{
+	return FPlayUnrealAutomationModule::Get().GetAsyncResults().Cancel(Handle, TEXT("Cancelled"));
+}
+
+// ---------------------------------------------------------------------------
+// World Queries
+// ---------------------------------------------------------------------------
+
+FString APlayUnrealDriver::FindActorByName(const FString& Name) const
+{
+	UWorld* World = GetWorld();
+	UPlayUnrealActorIndex* Index = World ? World->GetSubsystem<UPlayUnrealActorIndex>() : nullptr;
+	if (!Index) return FString();
+
+	const AActor* Actor = Index->FindByName(Name);
+	return Actor ? Actor->GetPathName() : FString();
+}
+
+static FString ActorPathsToJSON(const TArray<AActor*>& Actors)
+{
+	FString Out;
+	TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer =
+		TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Out);
+	Writer->WriteArrayStart();
+	for (const AActor* Actor : Actors)
+	{
+		Writer->WriteValue(Actor->GetPathName());
+	}
+	Writer->WriteArrayEnd();
+	Writer->Close();
+	return Out;
+}
+
+static FString ActorPathsToMsgPack(const TArray<AActor*>& Actors)
+{
+	FPlayUnrealMsgPackWriter Writer;
+	Writer.WriteArrayHeader(Actors.Num());
+	for (const AActor* Actor : Actors)
+	{
+		Writer.WriteString(Actor->GetPathName());
+	}
+	return Writer.ToWireString();
+}
+
+FString APlayUnrealDriver::FindActorsByClass(const FString& ClassName) const
+{
+	UWorld* World = GetWorld();
+	UPlayUnrealActorIndex* Index = World ? World->GetSubsystem<UPlayUnrealActorIndex>() : nullptr;
+	const UClass* Class = UPlayUnrealActorIndex::ResolveClass(ClassName);
+
+	TArray<AActor*> Actors;
+	if (Index && Class)
+	{
+		Index->FindByClass(Class, Actors);
+	}
+	return WireFormat == EWireFormat::MessagePack ? ActorPathsToMsgPack(Actors) : ActorPathsToJSON(Actors);
+}
+
+FString APlayUnrealDriver::FindActorsByTag(const FString& Tag) const
+{
+	UWorld* World = GetWorld();
+	UPlayUnrealActorIndex* Index = World ? World->GetSubsystem<UPlayUnrealActorIndex>() : nullptr;
+
+	TArray<AActor*> Actors;
+	if (Index)
+	{
+		Index->FindByTag(FName(*Tag), Actors);
+	}
+	return WireFormat == EWireFormat::MessagePack ? ActorPathsToMsgPack(Actors) : ActorPathsToJSON(Actors);
+}
+
+FString APlayUnrealDriver::ResolveObjects(const TArray<FString>& ClassNames) const
+{
+	return Encode(UPlayUnrealStatics::ResolveObjectsToJson(ClassNames, GetWorld()));
+}
+
+FString APlayUnrealDriver::SnapshotActors(const FString& QueryJSON) const
+{
+	TSharedPtr<FJsonObject> Query = PlayUnrealJson::ParseObject(QueryJSON);
+	if (!Query.IsValid())
+	{
+		return PlayUnrealJson::Error(TEXT("QueryJSON is not a JSON object"));
+	}
+
+	FPlayUnrealActorSnapshot Snapshot;
+	FString Error;
+	if (!Snapshot.InitFromJson(*Query, Error))
+	{
+		return PlayUnrealJson::Error(Error);
+	}
+	Snapshot.Capture(GetWorld());
+
+	// The capture itself must see one frame; only the encoding is deferred.
+	bool bAsync = false;
+	if (Query->TryGetBoolField(TEXT("async"), bAsync) && bAsync)
+	{
+		FPlayUnrealAutomationModule& Module = FPlayUnrealAutomationModule::Get();
+		const int32 Handle = Module.GetAsyncResults().Create(TEXT("snapshot"));
+		Module.GetScheduler().Offload(Handle, [Captured = MoveTemp(Snapshot)]()
+		{
+			return Captured.ToJson();
+		});
+
+		TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+		Object->SetNumberField(TEXT("handle"), Handle);
+		return Encode(Object);
+	}
+
+	if (WireFormat == EWireFormat::MessagePack)
+	{
+		FPlayUnrealMsgPackWriter Writer;
+		Snapshot.WriteMsgPack(Writer);
+		return Writer.ToWireString();
+	}
+	return PlayUnrealJson::ToString(Snapshot.ToJson());
+}
+
+/** Bindings beyond this count trigger a sweep of ones whose object died. */
+static constexpr int32 BindingSweepThreshold = 256;
+
+FString APlayUnrealDriver::CallFunction(const FString& ObjectPath,
+                                         const FString& FunctionName,
+                                         const FString& ParamsJSON)
+{
+	int32 BindingId = INDEX_NONE;
+	FString Error;
+	TSharedPtr<FPlayUnrealFunctionBinding> Binding = FindOrBind(ObjectPath, FunctionName, BindingId, Error);
+	if (!Binding.IsValid())
+	{
+		return PlayUnrealJson::Error(Error);
+	}
+	return InvokeBinding(*Binding, ParamsJSON);
+}
+
+FString APlayUnrealDriver::BindFunction(const FString& ObjectPath, const FString& FunctionName)
+{
+	int32 BindingId = INDEX_NONE;
+	FString Error;
+	TSharedPtr<FPlayUnrealFunctionBinding> Binding = FindOrBind(ObjectPath, FunctionName, BindingId, Error);
+	if (!Binding.IsValid())
+	{
+		return PlayUnrealJson::Error(Error);
+	}
+
+	TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+	Object->SetNumberField(TEXT("binding"), BindingId);
+	Object->SetArrayField(TEXT("params"), Binding->DescribeParams());
+	return Encode(Object);
+}
+
+FString APlayUnrealDriver::CallBinding(int32 Binding, const FString& ParamsJSON)
+{
+	const TSharedPtr<FPlayUnrealFunctionBinding>* Found = Bindings.Find(Binding);
+	if (!Found)
+	{
+		return PlayUnrealJson::Error(FString::Printf(TEXT("Unknown binding %d"), Binding));
+	}
+	return InvokeBinding(**Found, ParamsJSON);
+}
+
+bool APlayUnrealDriver::ReleaseBinding(int32 Binding)
+{
+	TSharedPtr<FPlayUnrealFunctionBinding> Removed;
+	if (!Bindings.RemoveAndCopyValue(Binding, Removed)) return false;
+
+	for (auto It = BindingIds.CreateIterator(); It; ++It)
+	{
+		if (It.Value() == Binding)
+		{
+			It.RemoveCurrent();
+			break;
+		}
+	}
+	return true;
+}
+
+TSharedPtr<FPlayUnrealFunctionBinding> APlayUnrealDriver::FindOrBind(const FString& ObjectPath,
+                                                                     const FString& FunctionName,
+                                                                     int32& OutBindingId,
+                                                                     FString& OutError)
+{
+	const FString Key = ObjectPath + TEXT("::") + FunctionName;
+	if (const int32* ExistingId = BindingIds.Find(Key))
+	{
+		const TSharedPtr<FPlayUnrealFunctionBinding>& Existing = Bindings.FindChecked(*ExistingId);
+		if (Existing->IsValid())
+		{
+			OutBindingId = *ExistingId;
+			return Existing;
+		}
+	}
+
+	TSharedPtr<FPlayUnrealFunctionBinding> Binding =
+		FPlayUnrealFunctionBinding::Create(ObjectPath, FName(*FunctionName), OutError);
+	if (!Binding.IsValid()) return nullptr;
+
+	if (Bindings.Num() >= BindingSweepThreshold)
+	{
+		for (auto It = Bindings.CreateIterator(); It; ++It)
+		{
+			if (!It.Value()->IsValid())
+			{
+				It.RemoveCurrent();
+			}
+		}
+		for (auto It = BindingIds.CreateIterator(); It; ++It)
+		{
+			if (!Bindings.Contains(It.Value()))
+			{
+				It.RemoveCurrent();
+			}
+		}
+	}
+
+	// A rebind after a level reload reuses the slot of the stale binding.
+	int32& BindingId = BindingIds.FindOrAdd(Key, INDEX_NONE);
+	if (BindingId == INDEX_NONE)
+	{
+		BindingId = NextBindingId++;
+	}
+	Bindings.Add(BindingId, Binding);
+	OutBindingId = BindingId;
+	return Binding;
+}
+
+FString APlayUnrealDriver::InvokeBinding(FPlayUnrealFunctionBinding& Binding,
+                                         const FString& ParamsJSON) const
+{
+	TSharedPtr<FJsonObject> Params;
+	if (!ParamsJSON.IsEmpty())
+	{
+		Params = PlayUnrealJson::ParseObject(ParamsJSON);
+		if (!Params.IsValid())
+		{
+			return PlayUnrealJson::Error(TEXT("ParamsJSON is not a JSON object"));
+		}
+	}
+
+	FString Error;
+	if (WireFormat == EWireFormat::MessagePack)
+	{
+		FPlayUnrealMsgPackWriter Writer;
+		if (!Binding.Invoke(Params, Writer, Error))
+		{
+			return PlayUnrealJson::Error(Error);
+		}
+		return Writer.ToWireString();
+	}
+
+	TSharedPtr<FJsonObject> Outputs;
+	if (!InvokeBindingOutputs(Binding, Params, Outputs, Error))
+	{
+		return PlayUnrealJson::Error(Error);
+	}
+	return Encode(Outputs.ToSharedRef());
+}
+
+bool APlayUnrealDriver::InvokeBindingOutputs(FPlayUnrealFunctionBinding& Binding,
+                                             const TSharedPtr<FJsonObject>& Params,
+                                             TSharedPtr<FJsonObject>& OutOutputs,
+                                             FString& OutError) const
+{
+	if (!Binding.Invoke(Params, OutOutputs, OutError))
+	{
+		return false;
+	}
+
+	// Game hooks such as GetLaneHazardsJSON return JSON text. In binary mode
+	// embed it as data so the client decodes once instead of twice. Only
+	// batches get here in that mode; single calls write straight from the
+	// parameters (see InvokeBinding).
+	if (WireFormat == EWireFormat::MessagePack)
+	{
+		for (TPair<FString, TSharedPtr<FJsonValue>>& Pair : OutOutputs->Values)
+		{
+			FString Text;
+			if (!Pair.Value.IsValid() || !Pair.Value->TryGetString(Text)) continue;
+
+			const TCHAR First = Text.Len() > 0 ? Text[0] : 0;
+			if (First != TCHAR('{') && First != TCHAR('[')) continue;
+
+			TSharedPtr<FJsonValue> Parsed;
+			TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Text);
+			if (FJsonSerializer::Deserialize(Reader, Parsed) && Parsed.IsValid())
+			{
+				Pair.Value = Parsed;
+			}
+		}
+	}
+	return true;
+}
+
+// ---------------------------------------------------------------------------
+// World State
+// ---------------------------------------------------------------------------
+
+FString APlayUnrealDriver::SnapshotWorld(const FString& QueryJSON)
+{
+	TSharedPtr<FJsonObject> Query = PlayUnrealJson::ParseObject(QueryJSON);
+	if (!Query.IsValid())
+	{
+		return PlayUnrealJson::Error(TEXT("QueryJSON is not a JSON object"));
+	}
+
+	TSharedPtr<FPlayUnrealWorldSnapshot> Snapshot = MakeShared<FPlayUnrealWorldSnapshot>();
+	FString Error;
+	if (!Snapshot->InitFromJson(*Query, Error))
+	{
+		return PlayUnrealJson::Error(Error);
+	}
+	Snapshot->Capture(GetWorld());
+
+	const int32 SnapshotId = NextSnapshotId++;
+	WorldSnapshots.Add(SnapshotId, Snapshot);
+
+	TSharedRef<FJsonObject> Object = Snapshot->Describe();
+	Object->SetNumberField(TEXT("snapshot"), SnapshotId);
+	return Encode(Object);
+}
+
+FString APlayUnrealDriver::RestoreWorld(int32 Snapshot)
+{
+	const TSharedPtr<FPlayUnrealWorldSnapshot>* Found = WorldSnapshots.Find(Snapshot);
+	if (!Found)
+	{
+		return PlayUnrealJson::Error(FString::Printf(TEXT("Unknown snapshot %d"), Snapshot));
+	}
+	return Encode((*Found)->Restore(GetWorld()));
+}
+
+bool APlayUnrealDriver::ReleaseSnapshot(int32 Snapshot)
+{
+	return WorldSnapshots.Remove(Snapshot) > 0;
+}
+
+FString APlayUnrealDriver::WatchProperties(const FString& WatchJSON)
+{
+	TSharedPtr<FJsonValue> Root;
+	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(WatchJSON);
+	if (!FJsonSerializer::Deserialize(Reader, Root) || !Root.IsValid() || Root->Type != EJson::Array)
+	{
+		return PlayUnrealJson::Error(TEXT("WatchJSON is not a JSON array"));
+	}
+
+	FString Error;
+	TUniquePtr<FPlayUnrealPropertyWatch> Watch = FPlayUnrealPropertyWatch::Create(Root->AsArray(), Error);
+	if (!Watch.IsValid())
+	{
+		return PlayUnrealJson::Error(Error);
+	}
+
+	const int32 WatchId = NextWatchId++;
+	TSharedPtr<FPlayUnrealPropertyWatch>& Added = PropertyWatches.Add(WatchId, TSharedPtr<FPlayUnrealPropertyWatch>(Watch.Release()));
+	SetActorTickEnabled(true);
+
+	TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+	Object->SetNumberField(TEXT("watch"), WatchId);
+	Object->SetObjectField(TEXT("values"), Added->Report(false));
+	Object->SetNumberField(TEXT("frame"), static_cast<double>(Added->GetFrame()));
+	return Encode(Object);
+}
+
+FString APlayUnrealDriver::GetWatchedValues(int32 Watch, bool bChangesOnly)
+{
+	const TSharedPtr<FPlayUnrealPropertyWatch>* Found = PropertyWatches.Find(Watch);
+	if (!Found)
+	{
+		return PlayUnrealJson::Error(FString::Printf(TEXT("Unknown property watch %d"), Watch));
+	}
+
+	TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+	Object->SetObjectField(TEXT("values"), (*Found)->Report(bChangesOnly));
+	Object->SetNumberField(TEXT("frame"), static_cast<double>((*Found)->GetFrame()));
+	return Encode(Object);
+}
+
+bool APlayUnrealDriver::UnwatchProperties(int32 Watch)
+{
+	// Tick switches itself off once nothing is left to sample.
+	return PropertyWatches.Remove(Watch) > 0;
+}
+
+// ---------------------------------------------------------------------------
+// Timing
+// ---------------------------------------------------------------------------
+
+/** Conditions that never become true give up after this long by default. */
+static constexpr double DefaultConditionTimeoutSeconds = 30.0;
+
+FString APlayUnrealDriver::WaitForSeconds(float Seconds)
+{
+	FLatentWait Wait;
+	Wait.TargetTime = GetWorld()->GetTimeSeconds() + FMath::Max(Seconds, 0.0f);
+	return StartWait(MoveTemp(Wait));
+}
+
+FString APlayUnrealDriver::WaitForFrames(int32 Frames)
+{
+	FLatentWait Wait;
+	Wait.TargetFrame = GFrameCounter + FMath::Max(Frames, 0);
+	return StartWait(MoveTemp(Wait));
+}
+
+FString APlayUnrealDriver::WaitForCondition(const FString& ConditionJSON)
+{
+	TSharedPtr<FJsonObject> Description = PlayUnrealJson::ParseObject(ConditionJSON);
+	if (!Description.IsValid())
+	{
+		return PlayUnrealJson::Error(TEXT("ConditionJSON is not a JSON object"));
+	}
+
+	FLatentWait Wait;
+	Wait.Condition = MakeShared<FPlayUnrealCondition>();
+	FString Error;
+	if (!Wait.Condition->InitFromJson(*Description, Error))
+	{
+		return PlayUnrealJson::Error(Error);
+	}
+
+	// On a fixed timestep game time runs faster than the wall clock, so
+	// timeouts follow it to stay reproducible.
+	double Timeout = DefaultConditionTimeoutSeconds;
+	Description->TryGetNumberField(TEXT("timeout"), Timeout);
+	Wait.bGameTimeDeadline = FApp::UseFixedTimeStep();
+	Wait.Deadline = (Wait.bGameTimeDeadline ? GetWorld()->GetTimeSeconds() : FPlatformTime::Seconds()) + Timeout;
+	return StartWait(MoveTemp(Wait));
+}
+
+FString APlayUnrealDriver::RunUntil(double GameSeconds)
+{
+	FLatentWait Wait;
+	Wait.TargetTime = GameSeconds;
+	return StartWait(MoveTemp(Wait));
+}
+
+FString APlayUnrealDriver::SetFixedTimestep(const FString& OptionsJSON)
+{
+	TSharedPtr<FJsonObject> Options = PlayUnrealJson::ParseObject(OptionsJSON.IsEmpty() ? TEXT("{}") : OptionsJSON);
+	if (!Options.IsValid())
+	{
+		return PlayUnrealJson::Error(TEXT("OptionsJSON is not a JSON object"));
+	}
+
+	bool bEnabled = true;
+	double Fps = 60.0;
+	bool bRender = true;
+	Options->TryGetBoolField(TEXT("enabled"), bEnabled);
+	Options->TryGetNumberField(TEXT("fps"), Fps);
+	Options->TryGetBoolField(TEXT("render"), bRender);
+
+	UGameViewportClient* Viewport = GetWorld()->GetGameViewport();
+	IConsoleVariable* VSyncVar = IConsoleManager::Get().FindConsoleVariable(TEXT("r.VSync"));
+
+	if (!bEnabled)
+	{
+		RestoreTimeStep();
+	}
+	else
+	{
+		if (Fps <= 0.0)
+		{
+			return PlayUnrealJson::Error(TEXT("fps must be positive"));
+		}
+
+		if (!SavedTimeStep.IsSet())
+		{
+			FSavedTimeStep& Saved = SavedTimeStep.Emplace();
+			Saved.bUseFixedTimeStep = FApp::UseFixedTimeStep();
+			Saved.FixedDeltaTime = FApp::GetFixedDeltaTime();
+			Saved.bDisableWorldRendering = Viewport && Viewport->bDisableWorldRendering;
+			Saved.VSync = VSyncVar ? VSyncVar->GetInt() : 0;
+		}
+
+		// The engine skips its frame-rate wait on a fixed timestep; vsync
+		// would still hold presents to the display rate.
+		FApp::SetUseFixedTimeStep(true);
+		FApp::SetFixedDeltaTime(1.0 / Fps);
+		if (VSyncVar)
+		{
+			VSyncVar->Set(0, ECVF_SetByCode);
+		}
+		if (Viewport)
+		{
+			Viewport->bDisableWorldRendering = !bRender;
+		}
+	}
+
+	TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+	Object->SetBoolField(TEXT("fixed"), FApp::UseFixedTimeStep());
+	Object->SetNumberField(TEXT("deltaSeconds"), FApp::GetFixedDeltaTime());
+	Object->SetBoolField(TEXT("render"), !Viewport || !Viewport->bDisableWorldRendering);
+	return Encode(Object);
+}
+
+void APlayUnrealDriver::RestoreTimeStep()
+{
+	if (!SavedTimeStep.IsSet()) return;
+
+	const FSavedTimeStep& Saved = SavedTimeStep.GetValue();
+	FApp::SetUseFixedTimeStep(Saved.bUseFixedTimeStep);
+	FApp::SetFixedDeltaTime(Saved.FixedDeltaTime);
+	if (IConsoleVariable* VSyncVar = IConsoleManager::Get().FindConsoleVariable(TEXT("r.VSync")))
+	{
+		VSyncVar->Set(Saved.VSync, ECVF_SetByCode);
+	}
+	if (UGameViewportClient* Viewport = GetWorld() ? GetWorld()->GetGameViewport() : nullptr)
+	{
+		Viewport->bDisableWorldRendering = Saved.bDisableWorldRendering;
+	}
+	SavedTimeStep.Reset();
+}
+
+FString APlayUnrealDriver::StartWait(FLatentWait&& Wait)
+{
+	Wait.Handle = FPlayUnrealAutomationModule::Get().GetAsyncResults().Create(TEXT("wait"));
+	Wait.StartFrame = GFrameCounter;
+	Wait.StartTime = GetWorld()->GetTimeSeconds();
+
+	const int32 Handle = Wait.Handle;
+	if (!AdvanceWait(Wait))
+	{
+		Waits.Add(MoveTemp(Wait));
+		SetActorTickEnabled(true);
+	}
+
+	TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+	Object->SetNumberField(TEXT("handle"), Handle);
+	return Encode(Object);
+}
+
+bool APlayUnrealDriver::AdvanceWait(FLatentWait& Wait)
+{
+	const double Now = GetWorld()->GetTimeSeconds();
+	FPlayUnrealAsyncResults& Results = FPlayUnrealAutomationModule::Get().GetAsyncResults();
+	if (!Results.IsPending(Wait.Handle))
+	{
+		// Cancelled by the client.
+		return true;
+	}
+
+	bool bDone = GFrameCounter >= Wait.TargetFrame && Now >= Wait.TargetTime;
+	TSharedPtr<FJsonValue> Value;
+	if (bDone && Wait.Condition.IsValid())
+	{
+		bDone = Wait.Condition->Evaluate(Value);
+		if (!bDone && (Wait.bGameTimeDeadline ? Now : FPlatformTime::Seconds()) >= Wait.Deadline)
+		{
+			Results.Fail(Wait.Handle, FString::Printf(
+				TEXT("Condition timed out; last value %s"), *PlayUnrealJson::ValueToString(Value)));
+			return true;
+		}
+	}
+	if (!bDone) return false;
+
+	TSharedRef<FJsonObject> Result = MakeShared<FJsonObject>();
+	Result->SetNumberField(TEXT("frame"), static_cast<double>(GFrameCounter));
+	Result->SetNumberField(TEXT("frames"), static_cast<double>(GFrameCounter - Wait.StartFrame));
+	Result->SetNumberField(TEXT("seconds"), Now - Wait.StartTime);
+	if (Wait.Condition.IsValid())
+	{
+		Result->SetField(TEXT("value"), Value);
+	}
+	Results.Succeed(Wait.Handle, Result);
+	return true;
+}
+
+// ---------------------------------------------------------------------------
+// Batching
+// ---------------------------------------------------------------------------
+
+/** Completed batches older than this are dropped if nobody fetches them. */
+static constexpr int32 MaxRetainedBatches = 64;
+
+FString APlayUnrealDriver::ExecuteBatch(const FString& CommandsJSON)
+{
+	TSharedPtr<FJsonValue> Root;
+	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(CommandsJSON);
+	if (!FJsonSerializer::Deserialize(Reader, Root) || !Root.IsValid())
+	{
+		return PlayUnrealJson::Error(TEXT("CommandsJSON is not valid JSON"));
+	}
+
+	FBatch Batch;
+	Batch.StartFrame = GFrameCounter;
+	Batch.StartTime = FPlatformTime::Seconds();
+
+	const TArray<TSharedPtr<FJsonValue>>* CommandValues = nullptr;
+	if (Root->Type == EJson::Array)
+	{
+		CommandValues = &Root->AsArray();
+	}
+	else if (Root->Type == EJson::Object)
+	{
+		const TSharedPtr<FJsonObject> RootObject = Root->AsObject();
+		RootObject->TryGetArrayField(TEXT("commands"), CommandValues);
+		RootObject->TryGetBoolField(TEXT("stopOnError"), Batch.bStopOnError);
+	}
+
+	if (!CommandValues)
+	{
+		return PlayUnrealJson::Error(TEXT("Expected an array of commands or {\"commands\": [...]}"));
+	}
+
+	for (const TSharedPtr<FJsonValue>& Value : *CommandValues)
+	{
+		const TSharedPtr<FJsonObject>* CommandObject = nullptr;
+		FBatchCommand Command;
+		if (!Value.IsValid() || !Value->TryGetObject(CommandObject)
+			|| !((*CommandObject)->TryGetStringField(TEXT("method"), Command.Method)
+				|| (*CommandObject)->TryGetNumberField(TEXT("binding"), Command.Binding)))
+		{
+			return PlayUnrealJson::Error(FString::Printf(
+				TEXT("Command %d needs a \"method\" or \"binding\" field"), Batch.Commands.Num()));
+		}
+
+		const TSharedPtr<FJsonObject>* ParamsObject = nullptr;
+		if ((*CommandObject)->TryGetObjectField(TEXT("params"), ParamsObject))
+		{
+			Command.Params = *ParamsObject;
+		}
+
+		int32 FrameOffset = 0;
+		if ((*CommandObject)->TryGetNumberField(TEXT("frame"), FrameOffset))
+		{
+			Command.FrameOffset = FMath::Max(FrameOffset, 0);
+		}
+
+		Batch.Commands.Add(MoveTemp(Command));
+	}
+
+	const int32 BatchId = NextBatchId++;
+	AdvanceBatch(Batch);
+
+	const FString Response = BatchToResponse(BatchId, Batch);
+	if (!Batch.IsComplete())
+	{
+		// Drop the oldest retained batches so abandoned ones cannot pile up.
+		while (Batches.Num() >= MaxRetainedBatches)
+		{
+			int32 OldestId = MAX_int32;
+			for (const TPair<int32, FBatch>& Pair : Batches)
+			{
+				OldestId = FMath::Min(OldestId, Pair.Key);
+			}
+			Batches.Remove(OldestId);
+		}
+
+		Batches.Add(BatchId, MoveTemp(Batch));
+		SetActorTickEnabled(true);
+	}
+
+	UE_LOG(LogTemp, Verbose, TEXT("PlayUnreal: ExecuteBatch(%d) -> %s"), BatchId, *Response);
+	return Response;
+}
+
+FString APlayUnrealDriver::GetBatchResults(int32 BatchId)
+{
+	const FBatch* Batch = Batches.Find(BatchId);
+	if (!Batch)
+	{
+		return PlayUnrealJson::Error(FString::Printf(TEXT("Unknown batch %d"), BatchId));
+	}
+
+	const FString Response = BatchToResponse(BatchId, *Batch);
+	if (Batch->IsComplete())
+	{
+		Batches.Remove(BatchId);
+	}
+	return Response;
+}
+
+void APlayUnrealDriver::AdvanceBatch(FBatch& Batch)
+{
+	const double FrameStartTime = FPlatformTime::Seconds();
+	while (!Batch.IsComplete())
+	{
+		const FBatchCommand& Command = Batch.Commands[Batch.NextCommand];
+		if (GFrameCounter < Batch.StartFrame + Command.FrameOffset)
+		{
+			return;
+		}
+
+		// Every command waits behind the ones ahead of it, from arrival for
+		// commands due at once, else from the frame it came due in.
+		if (!Command.Method.IsEmpty())
+		{
+			const double DueTime = Command.FrameOffset == 0 ? Batch.StartTime : FrameStartTime;
+			FPlayUnrealAutomationModule::Get().GetMetrics().RecordQueueDelay(
+				FName(*Command.Method), FPlatformTime::Seconds() - DueTime);
+		}
+
+		TSharedPtr<FJsonValue> Result;
+		FString Error;
+		bool bOk = false;
+		if (Command.Binding != INDEX_NONE)
+		{
+			const TSharedPtr<FPlayUnrealFunctionBinding>* Binding = Bindings.Find(Command.Binding);
+			TSharedPtr<FJsonObject> Outputs;
+			bOk = Binding && InvokeBindingOutputs(**Binding, Command.Params, Outputs, Error);
+			if (!Binding)
+			{
+				Error = FString::Printf(TEXT("Unknown binding %d"), Command.Binding);
+			}
+			if (bOk)
+			{
+				Result = MakeShared<FJsonValueObject>(Outputs);
+			}
+		}
+		else
+		{
+			// Batches cannot nest; a batch inside a batch would only hide ordering.
+			if (Command.Method == GET_FUNCTION_NAME_STRING_CHECKED(APlayUnrealDriver, ExecuteBatch))
+			{
+				Error = TEXT("ExecuteBatch cannot be nested");
+			}
+			else
+			{
+				// Nested driver results stay JSON; only the batch itself is encoded.
+				TGuardValue<EWireFormat> JsonResults(WireFormat, EWireFormat::Json);
+				bOk = InvokeDriverFunction(Command.Method, Command.Params, Result, Error);
+			}
+		}
+		if (bOk && Result.IsValid() && Result->Type == EJson::Boolean && !Result->AsBool())
+		{
+			bOk = false;
+			Error = TEXT("returned false");
+		}
+
+		TSharedRef<FJsonObject> Entry = MakeShared<FJsonObject>();
+		if (Command.Binding != INDEX_NONE)
+		{
+			Entry->SetNumberField(TEXT("binding"), Command.Binding);
+		}
+		else
+		{
+			Entry->SetStringField(TEXT("method"), Command.Method);
+		}
+		Entry->SetBoolField(TEXT("ok"), bOk);
+		Entry->SetNumberField(TEXT("frame"), static_cast<double>(GFrameCounter - Batch.StartFrame));
+		if (Result.IsValid())
+		{
+			Entry->SetField(TEXT("result"), Result);
+		}
+		if (!bOk)
+		{
+			Entry->SetStringField(TEXT("error"), Error);
+		}
+		Batch.Results.Add(MakeShared<FJsonValueObject>(Entry));
+
+		++Batch.NextCommand;
+		if (!bOk && Batch.bStopOnError)
+		{
+			Batch.bFailed = true;
+		}
+	}
+}
+
+FString APlayUnrealDriver::BatchToResponse(int32 BatchId, const FBatch& Batch) const
+{
+	TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+	Object->SetNumberField(TEXT("batch"), BatchId);
+	Object->SetBoolField(TEXT("complete"), Batch.IsComplete());
+	Object->SetArrayField(TEXT("results"), Batch.Results);
+	return Encode(Object);
+}
+
+bool APlayUnrealDriver::DispatchCall(const FString& Method,
+                                     const TSharedPtr<FJsonObject>& Params,
+                                     TSharedPtr<FJsonValue>& OutResult,
+                                     FString& OutError)
+{
+	{
+		TGuardValue<EWireFormat> JsonResults(WireFormat, EWireFormat::Json);
+		if (!InvokeDriverFunction(Method, Params, OutResult, OutError))
+		{
+			return false;
+		}
+	}
+
+	FString Text;
+	if (!OutResult.IsValid() || !OutResult->TryGetString(Text) || Text.IsEmpty()
+		|| (Text[0] != TCHAR('{') && Text[0] != TCHAR('[')))
+	{
+		return true;
+	}
+
+	TSharedPtr<FJsonValue> Parsed;
+	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Text);
+	if (!FJsonSerializer::Deserialize(Reader, Parsed) || !Parsed.IsValid())
+	{
+		return true;
+	}
+
+	const TSharedPtr<FJsonObject>* Object = nullptr;
+	bool bSucceeded = true;
+	if (Parsed->TryGetObject(Object) && (*Object)->TryGetBoolField(TEXT("ok"), bSucceeded) && !bSucceeded)
+	{
+		(*Object)->TryGetStringField(TEXT("error"), OutError);
+		return false;
+	}
+	OutResult = Parsed;
+	return true;
+}
+
+int32 APlayUnrealDriver::GetPIEInstance() const
+{
+	const FWorldContext* Context = GEngine ? GEngine->GetWorldContextFromWorld(GetWorld()) : nullptr;
+	return Context && Context->WorldType == EWorldType::PIE ? Context->PIEInstance : INDEX_NONE;
+}
+
+TSharedRef<FJsonObject> APlayUnrealDriver::DescribeWorld() const
+{
+	const UWorld* World = GetWorld();
+
+	const TCHAR* NetMode = TEXT("standalone");
+	switch (World->GetNetMode())
+	{
+	case NM_DedicatedServer: NetMode = TEXT("dedicatedServer"); break;
+	case NM_ListenServer:    NetMode = TEXT("listenServer"); break;
+	case NM_Client:          NetMode = TEXT("client"); break;
+	default: break;
+	}
+
+	TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+	Object->SetStringField(TEXT("world"), World->GetName());
+	Object->SetStringField(TEXT("driver"), GetPathName());
+	Object->SetNumberField(TEXT("pieInstance"), GetPIEInstance());
+	Object->SetStringField(TEXT("netMode"), NetMode);
+	return Object;
+}
+
+bool APlayUnrealDriver::InvokeDriverFunction(const FString& Method,
+                                             const TSharedPtr<FJsonObject>& Params,
+                                             TSharedPtr<FJsonValue>& OutResult,
+                                             FString& OutError)
+{
+	const FName MethodName(*Method);
+
+	TSharedPtr<FPlayUnrealFunctionBinding>& Binding = DriverBindings.FindOrAdd(MethodName);
+	if (!Binding.IsValid())
+	{
+		Binding = FPlayUnrealFunctionBinding::Create(this, MethodName, OutError);
+		if (!Binding.IsValid())
+		{
+			DriverBindings.Remove(MethodName);
+			OutError = FString::Printf(TEXT("Unknown driver method '%s'"), *Method);
+			return false;
+		}
+	}
+
+	TSharedPtr<FJsonObject> Outputs;
+	if (!Binding->Invoke(Params, Outputs, OutError))
+	{
+		return false;
+	}
+
+	// Plain driver methods report just their return value.
+	if (Outputs->Values.Num() == 0)
+	{
+		OutResult = MakeShared<FJsonValueNull>();
+	}
+	else if (Outputs->Values.Num() == 1 && Outputs->HasField(TEXT("ReturnValue")))
+	{
+		OutResult = Outputs->TryGetField(TEXT("ReturnValue"));
+	}
+	else
+	{
+		OutResult = MakeShared<FJsonValueObject>(Outputs);
+	}
+	return true;
+}
+
+// ---------------------------------------------------------------------------
+// Recording
+// ---------------------------------------------------------------------------
+
+#if WITH_PLAYUNREAL_AUTOMATION
+
+/** Result fields holding IDs that later calls pass back, and the parameter taking them. */
+struct FPlayUnrealReplayIdField
+{
+	const TCHAR* ResultField;
+	const TCHAR* Param;
+};
+
+static const FPlayUnrealReplayIdField ReplayIdFields[] = {
+	{ TEXT("handle"), TEXT("Handle") },
+	{ TEXT("tracker"), TEXT("Tracker") },
+	{ TEXT("binding"), TEXT("Binding") },
+	{ TEXT("snapshot"), TEXT("Snapshot") },
+	{ TEXT("batch"), TEXT("BatchId") },
+};
+
+/**
+ * Result fields holding the frame counter or a clock reading, which differ
+ * on every run. Relative "frames" counts are deterministic and compared.
+ */
+static const TCHAR* const ReplayTimingFields[] = {
+	TEXT("frame"),
+	TEXT("seconds"),
+	TEXT("time"),
+};
+
+/** Mismatches beyond this many are counted but not reported. */
+static constexpr int32 MaxReportedMismatches = 20;
+
+static FString ResolveSessionPath(const FString& Path)
+{
+	FString Relative = Path;
+	if (Relative.IsEmpty())
+	{
+		Relative = FPaths::Combine(TEXT("PlayUnreal/Sessions"),
+			FDateTime::Now().ToString(TEXT("%Y%m%d-%H%M%S")) + TEXT(".pulog"));
+	}
+	return FPaths::IsRelative(Relative) ? FPaths::Combine(FPaths::ProjectSavedDir(), Relative) : Relative;
+}
+
+/**
+ * A recorded or replayed result as an object, looking inside JSON strings
+ * and the MessagePack responses sent while a client used that wire format.
+ */
+static TSharedPtr<FJsonObject> ParseResultObject(const FString& ResultJson)
+{
+	TSharedPtr<FJsonValue> Value;
+	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(ResultJson);
+	if (!FJsonSerializer::Deserialize(Reader, Value) || !Value.IsValid())
+	{
+		return nullptr;
+	}
+
+	FString Text;
+	if (Value->TryGetString(Text))
+	{
+		if (TSharedPtr<FJsonValue> Decoded = FPlayUnrealMsgPackReader::ParseWireString(Text))
+		{
+			Value = Decoded;
+		}
+		else
+		{
+			return PlayUnrealJson::ParseObject(Text);
+		}
+	}
+	const TSharedPtr<FJsonObject>* Object = nullptr;
+	return Value->TryGetObject(Object) ? *Object : nullptr;
+}
+
+static TSharedRef<FJsonObject> WithoutTimings(const FJsonObject& Object);
+
+static TSharedPtr<FJsonValue> WithoutTimings(const TSharedPtr<FJsonValue>& Value)
+{
+	const TSharedPtr<FJsonObject>* Object = nullptr;
+	if (Value.IsValid() && Value->TryGetObject(Object) && Object->IsValid())
+	{
+		return MakeShared<FJsonValueObject>(WithoutTimings(**Object));
+	}
+	const TArray<TSharedPtr<FJsonValue>>* Array = nullptr;
+	if (Value.IsValid() && Value->TryGetArray(Array))
+	{
+		TArray<TSharedPtr<FJsonValue>> Copy;
+		Copy.Reserve(Array->Num());
+		for (const TSharedPtr<FJsonValue>& Element : *Array)
+		{
+			Copy.Add(WithoutTimings(Element));
+		}
+		return MakeShared<FJsonValueArray>(Copy);
+	}
+	return Value;
+}
+
+/** A copy of a result without its ReplayTimingFields, at any depth. */
+static TSharedRef<FJsonObject> WithoutTimings(const FJsonObject& Object)
+{
+	TSharedRef<FJsonObject> Copy = MakeShared<FJsonObject>();
+	for (const TPair<FString, TSharedPtr<FJsonValue>>& Pair : Object.Values)
+	{
+		bool bTiming = false;
+		for (const TCHAR* Field : ReplayTimingFields)
+		{
+			bTiming |= Pair.Key == Field;
+		}
+		if (!bTiming)
+		{
+			Copy->SetField(Pair.Key, WithoutTimings(Pair.Value));
+		}
+	}
+	return Copy;
+}
+
+/** True if two results differ only in the IDs the replay maps and in timings. */
+static bool EqualExceptIds(const TSharedPtr<FJsonObject>& Expected, const TSharedPtr<FJsonObject>& Actual)
+{
+	if (!Expected.IsValid() || !Actual.IsValid()) return false;
+
+	TSharedRef<FJsonObject> ExpectedCopy = WithoutTimings(*Expected);
+	TSharedRef<FJsonObject> ActualCopy = WithoutTimings(*Actual);
+	for (const FPlayUnrealReplayIdField& Field : ReplayIdFields)
+	{
+		ExpectedCopy->RemoveField(Field.ResultField);
+		ActualCopy->RemoveField(Field.ResultField);
+	}
+	return PlayUnrealJson::ToString(ExpectedCopy) == PlayUnrealJson::ToString(ActualCopy);
+}
+
+FString APlayUnrealDriver::StartRecording(const FString& Path)
+{
+	const double FixedDeltaSeconds = FApp::UseFixedTimeStep() ? FApp::GetFixedDeltaTime() : 0.0;
+
+	FString Error;
+	TUniquePtr<FPlayUnrealSessionLogWriter> Writer =
+		FPlayUnrealSessionLogWriter::Create(ResolveSessionPath(Path), FixedDeltaSeconds, Error);
+	if (!Writer.IsValid())
+	{
+		return PlayUnrealJson::Error(Error);
+	}
+
+	Recorder = TSharedPtr<FPlayUnrealSessionLogWriter>(Writer.Release());
+	RecordStartFrame = GFrameCounter;
+
+	TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+	Object->SetBoolField(TEXT("ok"), true);
+	Object->SetStringField(TEXT("path"), Recorder->GetPath());
+	return PlayUnrealJson::ToString(Object);
+}
+
+FString APlayUnrealDriver::StopRecording()
+{
+	if (!Recorder.IsValid())
+	{
+		return PlayUnrealJson::Error(TEXT("No recording is running"));
+	}
+
+	TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+	Object->SetStringField(TEXT("path"), Recorder->GetPath());
+	Object->SetNumberField(TEXT("commands"), Recorder->GetNumRecords());
+	Object->SetNumberField(TEXT("bytes"), static_cast<double>(Recorder->GetNumBytes()));
+	Recorder.Reset();
+	return PlayUnrealJson::ToString(Object);
+}
+
+FString APlayUnrealDriver::ReplaySession(const FString& OptionsJSON)
+{
+	TSharedPtr<FJsonObject> Options = PlayUnrealJson::ParseObject(OptionsJSON.IsEmpty() ? TEXT("{}") : OptionsJSON);
+	if (!Options.IsValid())
+	{
+		return PlayUnrealJson::Error(TEXT("OptionsJSON is not a JSON object"));
+	}
+	if (Replay.IsValid())
+	{
+		return PlayUnrealJson::Error(TEXT("A replay is already running"));
+	}
+
+	FString Path;
+	if (!Options->TryGetStringField(TEXT("path"), Path) || Path.IsEmpty())
+	{
+		return PlayUnrealJson::Error(TEXT("path is required"));
+	}
+
+	FString Error;
+	TUniquePtr<FPlayUnrealSessionLogReader> Reader = FPlayUnrealSessionLogReader::Open(ResolveSessionPath(Path), Error);
+	if (!Reader.IsValid())
+	{
+		return PlayUnrealJson::Error(Error);
+	}
+
+	double Fps = Reader->GetFixedDeltaSeconds() > 0.0 ? 1.0 / Reader->GetFixedDeltaSeconds() : 60.0;
+	bool bRender = false;
+	Options->TryGetNumberField(TEXT("fps"), Fps);
+	Options->TryGetBoolField(TEXT("render"), bRender);
+	if (Fps <= 0.0)
+	{
+		return PlayUnrealJson::Error(TEXT("fps must be positive"));
+	}
+
+	TSharedPtr<FReplay> Active = MakeShared<FReplay>();
+	Active->Reader = TSharedPtr<FPlayUnrealSessionLogReader>(Reader.Release());
+	Options->TryGetBoolField(TEXT("stopOnMismatch"), Active->bStopOnMismatch);
+
+	// Responses carrying session IDs or timings differ on every run.
+	const TArray<TSharedPtr<FJsonValue>>* Ignore = nullptr;
+	if (Options->TryGetArrayField(TEXT("ignore"), Ignore))
+	{
+		for (const TSharedPtr<FJsonValue>& Method : *Ignore)
+		{
+			Active->Ignored.Add(FName(*Method->AsString()));
+		}
+	}
+	else
+	{
+		Active->Ignored.Add(GET_FUNCTION_NAME_CHECKED(APlayUnrealDriver, Ping));
+		Active->Ignored.Add(GET_FUNCTION_NAME_CHECKED(APlayUnrealDriver, GetMetrics));
+		Active->Ignored.Add(GET_FUNCTION_NAME_CHECKED(APlayUnrealDriver, EndPerfCapture));
+		Active->Ignored.Add(GET_FUNCTION_NAME_CHECKED(APlayUnrealDriver, OpenFrameChannel));
+		Active->Ignored.Add(GET_FUNCTION_NAME_CHECKED(APlayUnrealDriver, CloseFrameChannel));
+	}
+
+	// Recorded frame offsets become fixed steps, run as fast as the engine can.
+	TSharedRef<FJsonObject> Step = MakeShared<FJsonObject>();
+	Step->SetNumberField(TEXT("fps"), Fps);
+	Step->SetBoolField(TEXT("render"), bRender);
+	SetFixedTimestep(PlayUnrealJson::ToString(Step));
+
+	Active->Handle = FPlayUnrealAutomationModule::Get().GetAsyncResults().Create(TEXT("replay"));
+	Active->StartFrame = GFrameCounter;
+	Active->StartTime = FPlatformTime::Seconds();
+	Replay = Active;
+	SetActorTickEnabled(true);
+
+	TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+	Object->SetNumberField(TEXT("handle"), Active->Handle);
+	return Encode(Object);
+}
+
+bool APlayUnrealDriver::AdvanceReplay(FReplay& Active)
+{
+	if (!FPlayUnrealAutomationModule::Get().GetAsyncResults().IsPending(Active.Handle))
+	{
+		return true;
+	}
+
+	const uint64 Elapsed = GFrameCounter - Active.StartFrame;
+	uint32 Frame = 0;
+	FPlayUnrealSessionLogReader::FRecord Record;
+	while (Active.Reader->PeekFrame(Frame) && Frame <= Elapsed)
+	{
+		const int32 Index = Active.Reader->GetNumRead();
+		Active.Reader->Next(Record);
+
+		// IDs handed out by the recorded session become the replay's own.
+		TSharedPtr<FJsonObject> Params = PlayUnrealJson::ParseObject(Record.Params);
+		for (const FPlayUnrealReplayIdField& Field : ReplayIdFields)
+		{
+			int32 RecordedId = 0;
+			const TMap<int32, int32>* Mapped = Active.Ids.Find(Field.ResultField);
+			if (Mapped && Params.IsValid() && Params->TryGetNumberField(Field.Param, RecordedId))
+			{
+				if (const int32* ReplayedId = Mapped->Find(RecordedId))
+				{
+					Params->SetNumberField(Field.Param, *ReplayedId);
+				}
+			}
+		}
+
+		TSharedPtr<FJsonValue> Result;
+		FString Error;
+		const FString Actual = InvokeDriverFunction(Record.Method, Params, Result, Error)
+			? PlayUnrealJson::ValueToString(Result)
+			: PlayUnrealJson::Error(Error);
+
+		const TSharedPtr<FJsonObject> ExpectedObject = ParseResultObject(Record.Result);
+		const TSharedPtr<FJsonObject> ActualObject = ParseResultObject(Actual);
+		if (ExpectedObject.IsValid() && ActualObject.IsValid())
+		{
+			for (const FPlayUnrealReplayIdField& Field : ReplayIdFields)
+			{
+				int32 RecordedId = 0;
+				int32 ReplayedId = 0;
+				if (ExpectedObject->TryGetNumberField(Field.ResultField, RecordedId)
+					&& ActualObject->TryGetNumberField(Field.ResultField, ReplayedId))
+				{
+					Active.Ids.FindOrAdd(Field.ResultField).Add(RecordedId, ReplayedId);
+				}
+			}
+		}
+
+		if (Actual != Record.Result && !Active.Ignored.Contains(FName(*Record.Method))
+			&& !EqualExceptIds(ExpectedObject, ActualObject))
+		{
+			if (Active.Mismatches.Num() < MaxReportedMismatches)
+			{
+				TSharedRef<FJsonObject> Entry = MakeShared<FJsonObject>();
+				Entry->SetNumberField(TEXT("index"), Index);
+				Entry->SetNumberField(TEXT("frame"), Record.Frame);
+				Entry->SetStringField(TEXT("method"), Record.Method);
+				Entry->SetStringField(TEXT("expected"), Record.Result);
+				Entry->SetStringField(TEXT("actual"), Actual);
+				Active.Mismatches.Add(MakeShared<FJsonValueObject>(Entry));
+			}
+			++Active.MismatchCount;
+			if (Active.bStopOnMismatch)
+			{
+				return true;
+			}
+		}
+	}
+	return !Active.Reader->PeekFrame(Frame);
+}
+
+void APlayUnrealDriver::FinishReplay(const FString& Error)
+{
+	TSharedPtr<FReplay> Finished = MoveTemp(Replay);
+	Replay.Reset();
+	RestoreTimeStep();
+
+	FPlayUnrealAsyncResults& Results = FPlayUnrealAutomationModule::Get().GetAsyncResults();
+	const double Seconds = FPlatformTime::Seconds() - Finished->StartTime;
+	if (!Error.IsEmpty())
+	{
+		Results.Fail(Finished->Handle, Error);
+	}
+	else
+	{
+		TSharedRef<FJsonObject> Result = MakeShared<FJsonObject>();
+		Result->SetNumberField(TEXT("commands"), Finished->Reader->GetNumRead());
+		Result->SetNumberField(TEXT("frames"), static_cast<double>(GFrameCounter - Finished->StartFrame));
+		Result->SetNumberField(TEXT("seconds"), Seconds);
+		Result->SetNumberField(TEXT("mismatchCount"), Finished->MismatchCount);
+		Result->SetArrayField(TEXT("mismatches"), Finished->Mismatches);
+		Results.Succeed(Finished->Handle, Result);
+	}
+
+	const FString Suffix = Error.IsEmpty() ? FString() : FString::Printf(TEXT(" (%s)"), *Error);
+	UE_LOG(LogTemp, Log, TEXT("PlayUnreal: Replay finished: %d commands, %d mismatches in %.2fs%s"),
+		Finished->Reader->GetNumRead(), Finished->MismatchCount, Seconds, *Suffix);
+
+	if (Finished->bExitWhenDone)
+	{
+		const bool bPassed = Error.IsEmpty() && Finished->MismatchCount == 0;
+		FPlatformMisc::RequestExitWithStatus(false, bPassed ? 0 : 1);
+	}
+}
+
+#else
+
+FString APlayUnrealDriver::StartRecording(const FString& Path)
+{
+	return CompiledOut(TEXT("Session recording"));
+}
+
+FString APlayUnrealDriver::StopRecording()
+{
+	return CompiledOut(TEXT("Session recording"));
+}
+
+FString APlayUnrealDriver::ReplaySession(const FString& OptionsJSON)
+{
+	return CompiledOut(TEXT("Session replay"));
+}
+
+#endif // WITH_PLAYUNREAL_AUTOMATION
+
+// ---------------------------------------------------------------------------
+// Planning
 // ---------------------------------------------------------------------------
-// Timing
-// ---------------------------------------------------------------------------
 
-void APlayUnrealDriver::WaitForSeconds(float Seconds)
+FString APlayUnrealDriver::NavigateTo(const FString& GoalJSON)
+{
+	TSharedPtr<FJsonObject> Goal = PlayUnrealJson::ParseObject(GoalJSON.IsEmpty() ? TEXT("{}") : GoalJSON);
+	if (!Goal.IsValid())
+	{
+		return PlayUnrealJson::Error(TEXT("GoalJSON is not a JSON object"));
+	}
+
+	TSharedPtr<FPlayUnrealHopPlanner> Planner = MakeShared<FPlayUnrealHopPlanner>();
+	FString Error;
+	if (!Planner->InitFromJson(*Goal, GetWorld(), Error))
+	{
+		return PlayUnrealJson::Error(Error);
+	}
+
+	FPlayUnrealAsyncResults& Results = FPlayUnrealAutomationModule::Get().GetAsyncResults();
+	if (HopPlannerHandle != INDEX_NONE)
+	{
+		Results.Fail(HopPlannerHandle, TEXT("Replaced by a new NavigateTo"));
+	}
+	HopPlanner = Planner;
+	HopPlannerHandle = Results.Create(TEXT("navigate"));
+	SetActorTickEnabled(true);
+
+	TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+	Object->SetNumberField(TEXT("handle"), HopPlannerHandle);
+	return Encode(Object);
+}
+
+FString APlayUnrealDriver::GetNavigationStatus() const
 {
-	// Note: This blocks the game thread briefly. For non-blocking waits,
-	// use a timer. This is acceptable for automation scripts that are
-	// orchestrating from an external process.
-	if (Seconds > 0.0f && Seconds < 30.0f)
+	if (!HopPlanner.IsValid())
+	{
+		return PlayUnrealJson::Error(TEXT("NavigateTo has not been called"));
+	}
+	return Encode(HopPlanner->ToJson());
+}
+
+void APlayUnrealDriver::AdvanceHopPlanner()
+{
+	FPlayUnrealAsyncResults& Results = FPlayUnrealAutomationModule::Get().GetAsyncResults();
+	if (!Results.IsPending(HopPlannerHandle))
+	{
+		// Cancelled by the client.
+		HopPlannerHandle = INDEX_NONE;
+		return;
+	}
+
+	switch (HopPlanner->Tick(GetWorld()))
 	{
-		FTimerHandle Handle;
-		GetWorld()->GetTimerManager().SetTimer(Handle, Seconds, false);
+	case FPlayUnrealHopPlanner::EStatus::Running:
+		return;
+	case FPlayUnrealHopPlanner::EStatus::Succeeded:
+		Results.Succeed(HopPlannerHandle, HopPlanner->ToJson());
+		break;
+	case FPlayUnrealHopPlanner::EStatus::Failed:
+		Results.Fail(HopPlannerHandle, HopPlanner->GetFailure());
+		break;
 	}
+	HopPlannerHandle = INDEX_NONE;
 }
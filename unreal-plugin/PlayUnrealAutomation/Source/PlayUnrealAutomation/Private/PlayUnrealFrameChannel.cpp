@@ -0,0 +1,343 @@
+// PlayUnrealFrameChannel.cpp
+
+#include "PlayUnrealFrameChannel.h"
+
+// The frame channel is only compiled with WITH_PLAYUNREAL_AUTOMATION.
+#if WITH_PLAYUNREAL_AUTOMATION
+
+#include "Components/Widget.h"
+#include "Dom/JsonObject.h"
+#include "Engine/Engine.h"
+#include "Engine/GameViewportClient.h"
+#include "Framework/Application/SlateApplication.h"
+#include "HAL/PlatformProcess.h"
+#include "PlayUnrealScreenCapture.h"
+#include "RHIGPUReadback.h"
+#include "RenderingThread.h"
+#include "Rendering/SlateRenderer.h"
+#include "Widgets/SViewport.h"
+#include "Widgets/SWindow.h"
+
+namespace
+{
+	const uint8 Magic[4] = { 'P', 'U', 'F', 'B' };
+	constexpr uint32 FormatVersion = 1;
+	constexpr uint32 FormatBGRA8 = 1;
+	constexpr int64 HeaderSize = 64;
+	constexpr int64 SlotHeaderSize = 32;
+	constexpr int32 MaxSlots = 16;
+	constexpr int32 MaxDownscale = 8;
+	/** Readbacks in flight; a frame finding none free is skipped. */
+	constexpr int32 NumReadbacks = 3;
+
+	// Header and slot field offsets, as documented in the header.
+	constexpr int64 HeaderLatestOffset = 24;
+	constexpr int64 HeaderClosedOffset = 36;
+
+	void WriteU32(uint8* At, uint32 Value)
+	{
+		FMemory::Memcpy(At, &Value, sizeof(Value));
+	}
+
+	void WriteU64(uint8* At, uint64 Value)
+	{
+		FMemory::Memcpy(At, &Value, sizeof(Value));
+	}
+
+	/** Sequence fields are what readers synchronize on, so they are stored as a whole. */
+	void PublishU64(uint8* At, uint64 Value)
+	{
+		FPlatformAtomics::AtomicStore(reinterpret_cast<volatile int64*>(At), static_cast<int64>(Value));
+	}
+
+	FIntRect GeometryToWindowRect(const FGeometry& Geometry, const SWindow& Window)
+	{
+		const FVector2D Offset = Geometry.GetAbsolutePosition() - Window.GetPositionInScreen();
+		const FVector2D Size = Geometry.GetAbsoluteSize();
+		return FIntRect(
+			FIntPoint(FMath::RoundToInt(Offset.X), FMath::RoundToInt(Offset.Y)),
+			FIntPoint(FMath::RoundToInt(Offset.X + Size.X), FMath::RoundToInt(Offset.Y + Size.Y)));
+	}
+}
+
+FPlayUnrealFrameChannel::~FPlayUnrealFrameChannel()
+{
+	if (CropTicker.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(CropTicker);
+	}
+	if (BackBufferHandle.IsValid() && FSlateApplication::IsInitialized())
+	{
+		if (FSlateRenderer* Renderer = FSlateApplication::Get().GetRenderer())
+		{
+			Renderer->OnBackBufferReadyToPresent().Remove(BackBufferHandle);
+		}
+	}
+	FlushRenderingCommands();
+
+	if (Region)
+	{
+		// Readers still attached see the flag; the name goes with the last of them.
+		WriteU32(Base + HeaderClosedOffset, 1);
+		FPlatformMemory::UnmapNamedSharedMemoryRegion(Region);
+	}
+}
+
+TUniquePtr<FPlayUnrealFrameChannel> FPlayUnrealFrameChannel::Open(FOptions&& Options, FString& OutError)
+{
+	check(IsInGameThread());
+
+	if (FPlayUnrealScreenCapture::GetRenderMode() == FPlayUnrealScreenCapture::ERenderMode::None)
+	{
+		OutError = TEXT("Rendering is disabled (-nullrhi); run with -RenderOffScreen to stream frames without a window");
+		return nullptr;
+	}
+	if (Options.Slots < 2 || Options.Slots > MaxSlots)
+	{
+		OutError = FString::Printf(TEXT("slots must be between 2 and %d"), MaxSlots);
+		return nullptr;
+	}
+	if (Options.Downscale < 1 || Options.Downscale > MaxDownscale)
+	{
+		OutError = FString::Printf(TEXT("downscale must be between 1 and %d"), MaxDownscale);
+		return nullptr;
+	}
+	if (Options.EveryNth < 1)
+	{
+		OutError = TEXT("everyNth must be at least 1");
+		return nullptr;
+	}
+
+	FSlateRenderer* Renderer = FSlateApplication::IsInitialized()
+		? FSlateApplication::Get().GetRenderer() : nullptr;
+	UGameViewportClient* Viewport = GEngine ? GEngine->GameViewport.Get() : nullptr;
+	TSharedPtr<SWindow> GameWindow = Viewport ? Viewport->GetWindow() : nullptr;
+	if (!Renderer || !GameWindow.IsValid())
+	{
+		OutError = TEXT("No game window to stream");
+		return nullptr;
+	}
+
+	// Slots fit the largest frame the crop can produce; a window grown
+	// later is clipped to them.
+	FIntRect Crop = Options.Crop;
+	if (Crop.IsEmpty() && !Options.Widget.IsValid())
+	{
+		if (TSharedPtr<SViewport> ViewportWidget = Viewport->GetGameViewportWidget())
+		{
+			Crop = GeometryToWindowRect(ViewportWidget->GetCachedGeometry(), *GameWindow);
+		}
+	}
+	const FVector2D WindowSize = GameWindow->GetSizeInScreen();
+	const FIntPoint Extent = Options.Crop.IsEmpty()
+		? FIntPoint(FMath::CeilToInt(WindowSize.X), FMath::CeilToInt(WindowSize.Y))
+		: Options.Crop.Size();
+
+	TUniquePtr<FPlayUnrealFrameChannel> Channel(new FPlayUnrealFrameChannel());
+	Channel->Name = Options.Name.IsEmpty()
+		? FString::Printf(TEXT("PlayUnrealFrames-%u"), FPlatformProcess::GetCurrentProcessId())
+		: Options.Name;
+	Channel->Slots = Options.Slots;
+	Channel->Downscale = Options.Downscale;
+	Channel->EveryNth = Options.EveryNth;
+	Channel->MaxSize = FIntPoint(
+		FMath::DivideAndRoundUp(FMath::Max(Extent.X, 1), Options.Downscale),
+		FMath::DivideAndRoundUp(FMath::Max(Extent.Y, 1), Options.Downscale));
+	Channel->SlotBytes = Align(SlotHeaderSize + int64(Channel->MaxSize.X) * Channel->MaxSize.Y * 4, 64);
+
+	const int64 TotalBytes = HeaderSize + Channel->Slots * Channel->SlotBytes;
+	const uint32 Access = static_cast<uint32>(FPlatformMemory::ESharedMemoryAccess::Read)
+		| static_cast<uint32>(FPlatformMemory::ESharedMemoryAccess::Write);
+	Channel->Region = FPlatformMemory::MapNamedSharedMemoryRegion(Channel->Name, true, Access, TotalBytes);
+	if (!Channel->Region)
+	{
+		OutError = FString::Printf(TEXT("Cannot create shared memory '%s' (%lld bytes)"), *Channel->Name, TotalBytes);
+		return nullptr;
+	}
+
+	uint8* Base = static_cast<uint8*>(Channel->Region->GetAddress());
+	Channel->Base = Base;
+	FMemory::Memzero(Base, TotalBytes);
+	FMemory::Memcpy(Base, Magic, UE_ARRAY_COUNT(Magic));
+	WriteU32(Base + 4, FormatVersion);
+	WriteU32(Base + 8, Channel->Slots);
+	WriteU32(Base + 12, static_cast<uint32>(Channel->SlotBytes));
+	WriteU32(Base + 16, Channel->MaxSize.X);
+	WriteU32(Base + 20, Channel->MaxSize.Y);
+	WriteU32(Base + 32, FormatBGRA8);
+
+	Channel->Readbacks.SetNum(NumReadbacks);
+	for (FReadback& Readback : Channel->Readbacks)
+	{
+		Readback.Texture = MakeUnique<FRHIGPUTextureReadback>(TEXT("PlayUnrealFrameChannel"));
+	}
+
+	Channel->Window = GameWindow.Get();
+	Channel->Crop = Crop;
+	Channel->Widget = Options.Widget;
+	if (Channel->Widget.IsValid())
+	{
+		Channel->TickCrop(0.0f);
+		Channel->CropTicker = FTSTicker::GetCoreTicker().AddTicker(
+			FTickerDelegate::CreateRaw(Channel.Get(), &FPlayUnrealFrameChannel::TickCrop));
+	}
+
+	Channel->BackBufferHandle = Renderer->OnBackBufferReadyToPresent().AddRaw(
+		Channel.Get(), &FPlayUnrealFrameChannel::OnBackBufferReady);
+	return Channel;
+}
+
+TSharedRef<FJsonObject> FPlayUnrealFrameChannel::Describe() const
+{
+	TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+	Object->SetStringField(TEXT("name"), Name);
+	Object->SetNumberField(TEXT("bytes"), static_cast<double>(HeaderSize + Slots * SlotBytes));
+	Object->SetNumberField(TEXT("slots"), Slots);
+	Object->SetNumberField(TEXT("slotBytes"), static_cast<double>(SlotBytes));
+	Object->SetNumberField(TEXT("maxWidth"), MaxSize.X);
+	Object->SetNumberField(TEXT("maxHeight"), MaxSize.Y);
+	Object->SetStringField(TEXT("format"), TEXT("bgra8"));
+	return Object;
+}
+
+TSharedRef<FJsonObject> FPlayUnrealFrameChannel::GetStats() const
+{
+	TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+	Object->SetNumberField(TEXT("frames"), static_cast<double>(Published.load()));
+	Object->SetNumberField(TEXT("skipped"), static_cast<double>(Skipped.load()));
+	return Object;
+}
+
+bool FPlayUnrealFrameChannel::TickCrop(float DeltaSeconds)
+{
+	UWidget* Target = Widget.Get();
+	UGameViewportClient* Viewport = GEngine ? GEngine->GameViewport.Get() : nullptr;
+	TSharedPtr<SWindow> GameWindow = Viewport ? Viewport->GetWindow() : nullptr;
+	if (!Target || GameWindow.Get() != Window)
+	{
+		// Keep the last crop: the widget may only be between rebuilds.
+		return true;
+	}
+
+	const FIntRect Rect = GeometryToWindowRect(Target->GetCachedGeometry(), *GameWindow);
+	if (Rect != WidgetCrop)
+	{
+		WidgetCrop = Rect;
+		ENQUEUE_RENDER_COMMAND(PlayUnrealFrameChannelCrop)(
+			[this, Rect](FRHICommandListImmediate&)
+			{
+				Crop = Rect;
+			});
+	}
+	return true;
+}
+
+void FPlayUnrealFrameChannel::OnBackBufferReady(SWindow& PresentedWindow, const FTextureRHIRef& BackBuffer)
+{
+	check(IsInRenderingThread());
+
+	PollReadbacks();
+
+	if (&PresentedWindow != Window || !BackBuffer.IsValid()) return;
+	if (Presented++ % EveryNth != 0) return;
+
+	FReadback* Free = Readbacks.FindByPredicate([](const FReadback& Readback) { return !Readback.bBusy; });
+	if (!Free)
+	{
+		Skipped.fetch_add(1);
+		return;
+	}
+
+	FRHICommandListImmediate& RHICmdList = FRHICommandListExecutor::GetImmediateCommandList();
+	Free->Texture->EnqueueCopy(RHICmdList, BackBuffer);
+	Free->PixelFormat = BackBuffer->GetFormat();
+	Free->Size = BackBuffer->GetSizeXY();
+	Free->Crop = Crop;
+	Free->Frame = GFrameCounterRenderThread;
+	Free->bBusy = true;
+}
+
+void FPlayUnrealFrameChannel::PollReadbacks()
+{
+	// Oldest first, so sequence numbers follow frame order.
+	for (;;)
+	{
+		FReadback* Oldest = nullptr;
+		for (FReadback& Readback : Readbacks)
+		{
+			if (Readback.bBusy && (!Oldest || Readback.Frame < Oldest->Frame))
+			{
+				Oldest = &Readback;
+			}
+		}
+		if (!Oldest || !Oldest->Texture->IsReady()) return;
+
+		int32 RowPitchInPixels = 0;
+		if (const void* Data = Oldest->Texture->Lock(RowPitchInPixels))
+		{
+			Publish(static_cast<const uint8*>(Data), RowPitchInPixels, *Oldest);
+		}
+		Oldest->Texture->Unlock();
+		Oldest->bBusy = false;
+	}
+}
+
+uint8* FPlayUnrealFrameChannel::SlotAt(int64 Sequence) const
+{
+	return Base + HeaderSize + ((Sequence - 1) % Slots) * SlotBytes;
+}
+
+void FPlayUnrealFrameChannel::Publish(const uint8* Pixels, int32 RowPitchInPixels, const FReadback& Readback)
+{
+	FIntRect Rect(FIntPoint::ZeroValue, Readback.Size);
+	if (!Readback.Crop.IsEmpty())
+	{
+		Rect.Clip(Readback.Crop);
+	}
+	const int32 Width = FMath::Min(FMath::DivideAndRoundUp(Rect.Width(), Downscale), MaxSize.X);
+	const int32 Height = FMath::Min(FMath::DivideAndRoundUp(Rect.Height(), Downscale), MaxSize.Y);
+	if (Width <= 0 || Height <= 0)
+	{
+		Skipped.fetch_add(1);
+		return;
+	}
+
+	const int64 Sequence = Published.load() + 1;
+	uint8* Slot = SlotAt(Sequence);
+	PublishU64(Slot, 0);
+	WriteU64(Slot + 8, Readback.Frame);
+	WriteU32(Slot + 16, Width);
+	WriteU32(Slot + 20, Height);
+	WriteU32(Slot + 24, Width * 4);
+
+	// Converted straight from the staging buffer into the slot. BGRA8 back
+	// buffers at full size are copied a row at a time; their alpha is
+	// whatever the renderer left there.
+	const int32 BytesPerPixel = GPixelFormats[Readback.PixelFormat].BlockBytes;
+	const bool bCopyRows = Readback.PixelFormat == PF_B8G8R8A8 && Downscale == 1;
+	uint8* Out = Slot + SlotHeaderSize;
+	for (int32 Y = 0; Y < Height; ++Y)
+	{
+		const uint8* Row = Pixels
+			+ (static_cast<int64>(Rect.Min.Y + Y * Downscale) * RowPitchInPixels + Rect.Min.X) * BytesPerPixel;
+		uint8* OutRow = Out + static_cast<int64>(Y) * Width * 4;
+		if (bCopyRows)
+		{
+			FMemory::Memcpy(OutRow, Row, Width * 4);
+			continue;
+		}
+		for (int32 X = 0; X < Width; ++X)
+		{
+			const FColor Color = FPlayUnrealScreenCapture::DecodePixel(Row + X * Downscale * BytesPerPixel,
+				Readback.PixelFormat);
+			FMemory::Memcpy(OutRow + X * 4, &Color, 4);
+		}
+	}
+
+	FPlatformMisc::MemoryBarrier();
+	PublishU64(Slot, Sequence);
+	PublishU64(Base + HeaderLatestOffset, Sequence);
+	Published.store(Sequence);
+}
+
+#endif // WITH_PLAYUNREAL_AUTOMATION
@@ -0,0 +1,129 @@
+// PlayUnrealFrameChannel.h
+//
+// Opt-in stream of game frames into a named shared-memory ring, so a local
+// client can assert on raw pixels at frame rate without PNG encoding or
+// disk. Each presented back buffer of the game window is copied to a
+// staging texture (a few readbacks in flight, frames are skipped rather
+// than stalling the GPU). When a readback is ready, the render thread
+// crops, downscales and converts it to BGRA8 straight into the next ring
+// slot.
+//
+// Layout (little-endian; offsets in bytes):
+//
+//   header  0 "PUFB" | 4 u32 version | 8 u32 slots | 12 u32 slot bytes
+//           | 16 u32 max width | 20 u32 max height | 24 u64 latest sequence
+//           | 32 u32 format (1 = BGRA8) | 36 u32 closed | ... 64
+//   slot i  at 64 + i * slot bytes:
+//           0 u64 sequence | 8 u64 engine frame | 16 u32 width
+//           | 20 u32 height | 24 u32 row bytes | 28 u32 reserved | 32 pixels
+//
+// Frame sequence N (from 1) goes to slot (N - 1) % slots. A slot's sequence
+// is 0 while it is being written. Readers take the latest sequence, check
+// the slot carries it before and after using the pixels, and drop the
+// frame if it changed in between.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "HAL/PlatformMemory.h"
+#include "RHI.h"
+#include "RHIResources.h"
+#include "UObject/WeakObjectPtr.h"
+#include <atomic>
+
+class FJsonObject;
+class FRHIGPUTextureReadback;
+class SWindow;
+class UWidget;
+
+class FPlayUnrealFrameChannel
+{
+public:
+	struct FOptions
+	{
+		/** Shared-memory name; empty picks PlayUnrealFrames-<pid>. */
+		FString Name;
+		int32 Slots = 3;
+		/** Keep every Nth pixel in each direction (1-8). */
+		int32 Downscale = 1;
+		/** Publish every Nth presented frame. */
+		int32 EveryNth = 1;
+		/** Back buffer region to keep; empty keeps the game viewport. */
+		FIntRect Crop;
+		/** Follow this widget's geometry each frame instead of Crop. */
+		TWeakObjectPtr<UWidget> Widget;
+	};
+
+	~FPlayUnrealFrameChannel();
+
+	/**
+	 * Create the shared-memory ring, sized for the game window as it is now,
+	 * and start publishing frames.
+	 *
+	 * @return  Null with a reason in OutError if rendering or shared memory
+	 *          is unavailable.
+	 */
+	static TUniquePtr<FPlayUnrealFrameChannel> Open(FOptions&& Options, FString& OutError);
+
+	/** {"name", "bytes", "slots", "slotBytes", "maxWidth", "maxHeight", "format"}. */
+	TSharedRef<FJsonObject> Describe() const;
+
+	/** {"frames": published, "skipped": frames with no readback free}. */
+	TSharedRef<FJsonObject> GetStats() const;
+
+private:
+	FPlayUnrealFrameChannel() = default;
+
+	/** A staging copy waiting for the GPU. */
+	struct FReadback
+	{
+		TUniquePtr<FRHIGPUTextureReadback> Texture;
+		EPixelFormat PixelFormat = PF_Unknown;
+		FIntPoint Size = FIntPoint::ZeroValue;
+		FIntRect Crop;
+		uint64 Frame = 0;
+		bool bBusy = false;
+	};
+
+	/** Render thread: called for every window presented by Slate. */
+	void OnBackBufferReady(SWindow& Window, const FTextureRHIRef& BackBuffer);
+
+	/** Render thread: publish readbacks the GPU has finished. */
+	void PollReadbacks();
+
+	/** Render thread: write one frame into the next slot. */
+	void Publish(const uint8* Pixels, int32 RowPitchInPixels, const FReadback& Readback);
+
+	/** Game thread: follow the widget's geometry. */
+	bool TickCrop(float DeltaSeconds);
+
+	uint8* SlotAt(int64 Sequence) const;
+
+	FString Name;
+	FPlatformMemory::FSharedMemoryRegion* Region = nullptr;
+	uint8* Base = nullptr;
+	int32 Slots = 0;
+	int64 SlotBytes = 0;
+	FIntPoint MaxSize = FIntPoint::ZeroValue;
+	int32 Downscale = 1;
+	int32 EveryNth = 1;
+
+	/** Window to capture; only compared, never dereferenced off the game thread. */
+	const SWindow* Window = nullptr;
+	FDelegateHandle BackBufferHandle;
+
+	// Game thread: widget crop, handed to the render thread when it changes.
+	TWeakObjectPtr<UWidget> Widget;
+	FIntRect WidgetCrop;
+	FTSTicker::FDelegateHandle CropTicker;
+
+	// Render thread only.
+	FIntRect Crop;
+	TArray<FReadback> Readbacks;
+	uint64 Presented = 0;
+
+	// Written on the render thread, read anywhere.
+	std::atomic<int64> Published{0};
+	std::atomic<int64> Skipped{0};
+};
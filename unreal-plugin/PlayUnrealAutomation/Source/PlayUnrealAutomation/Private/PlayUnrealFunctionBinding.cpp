@@ -0,0 +1,198 @@
+// PlayUnrealFunctionBinding.cpp
+
+#include "PlayUnrealFunctionBinding.h"
+#include "Dom/JsonObject.h"
+#include "JsonObjectConverter.h"
+#include "PlayUnrealMsgPack.h"
+#include "UObject/StructOnScope.h"
+#include "UObject/UObjectGlobals.h"
+
+FPlayUnrealFunctionBinding::~FPlayUnrealFunctionBinding()
+{
+	FMemory::Free(Buffer);
+}
+
+TSharedPtr<FPlayUnrealFunctionBinding> FPlayUnrealFunctionBinding::Create(
+	UObject* Object, FName FunctionName, FString& OutError)
+{
+	if (!Object)
+	{
+		OutError = TEXT("Object not found");
+		return nullptr;
+	}
+
+	UFunction* Function = Object->FindFunction(FunctionName);
+	if (!Function || !Function->HasAnyFunctionFlags(FUNC_BlueprintCallable))
+	{
+		OutError = FString::Printf(TEXT("No BlueprintCallable function '%s' on %s"),
+			*FunctionName.ToString(), *Object->GetName());
+		return nullptr;
+	}
+
+	TSharedPtr<FPlayUnrealFunctionBinding> Binding = MakeShareable(new FPlayUnrealFunctionBinding());
+	Binding->Object = Object;
+	Binding->Function = Function;
+	// InitializeStruct/DestroyStruct cover every property of the function,
+	// Blueprint locals included, not just the ParmsSize parameter block.
+	Binding->Buffer = static_cast<uint8*>(
+		FMemory::Malloc(FMath::Max<int32>(Function->GetStructureSize(), 1), Function->GetMinAlignment()));
+
+	for (TFieldIterator<FProperty> It(Function); It && It->HasAnyPropertyFlags(CPF_Parm); ++It)
+	{
+		FParam& Param = Binding->Params.AddDefaulted_GetRef();
+		Param.Property = *It;
+		Param.Name = It->GetName();
+		// Out params passed by non-const reference are both read and written.
+		Param.bOutput = It->HasAnyPropertyFlags(CPF_OutParm | CPF_ReturnParm);
+		Param.bInput = !It->HasAnyPropertyFlags(CPF_ReturnParm)
+			&& (!It->HasAnyPropertyFlags(CPF_OutParm) || It->HasAnyPropertyFlags(CPF_ReferenceParm));
+	}
+	return Binding;
+}
+
+TSharedPtr<FPlayUnrealFunctionBinding> FPlayUnrealFunctionBinding::Create(
+	const FString& ObjectPath, FName FunctionName, FString& OutError)
+{
+	UObject* Object = StaticFindObject(UObject::StaticClass(), nullptr, *ObjectPath);
+	if (!Object)
+	{
+		OutError = FString::Printf(TEXT("Object not found: %s"), *ObjectPath);
+		return nullptr;
+	}
+	return Create(Object, FunctionName, OutError);
+}
+
+bool FPlayUnrealFunctionBinding::Invoke(const TSharedPtr<FJsonObject>& InParams,
+                                        TSharedPtr<FJsonObject>& OutOutputs, FString& OutError)
+{
+	return Call(InParams, [this, &OutOutputs](const uint8* Memory)
+	{
+		OutOutputs = MakeShared<FJsonObject>();
+		for (const FParam& Param : Params)
+		{
+			if (!Param.bOutput) continue;
+
+			TSharedPtr<FJsonValue> Value = FJsonObjectConverter::UPropertyToJsonValue(
+				Param.Property, Param.Property->ContainerPtrToValuePtr<void>(Memory));
+			if (Value.IsValid())
+			{
+				OutOutputs->SetField(Param.Name, Value);
+			}
+		}
+	}, OutError);
+}
+
+bool FPlayUnrealFunctionBinding::Invoke(const TSharedPtr<FJsonObject>& InParams,
+                                        FPlayUnrealMsgPackWriter& Writer, FString& OutError)
+{
+	return Call(InParams, [this, &Writer](const uint8* Memory)
+	{
+		uint32 NumOutputs = 0;
+		for (const FParam& Param : Params)
+		{
+			NumOutputs += Param.bOutput ? 1 : 0;
+		}
+
+		Writer.WriteMapHeader(NumOutputs);
+		for (const FParam& Param : Params)
+		{
+			if (!Param.bOutput) continue;
+
+			const void* Value = Param.Property->ContainerPtrToValuePtr<void>(Memory);
+			Writer.WriteString(Param.Name);
+			if (const FStrProperty* Str = CastField<FStrProperty>(Param.Property))
+			{
+				const FString& Text = Str->GetPropertyValue(Value);
+				const TCHAR First = Text.Len() > 0 ? Text[0] : 0;
+				if ((First == TCHAR('{') || First == TCHAR('[')) && Writer.WriteJsonText(Text))
+				{
+					continue;
+				}
+			}
+			Writer.WriteProperty(Param.Property, Value);
+		}
+	}, OutError);
+}
+
+bool FPlayUnrealFunctionBinding::Call(const TSharedPtr<FJsonObject>& InParams,
+                                      TFunctionRef<void(const uint8*)> ReadOutputs, FString& OutError)
+{
+	UObject* Target = Object.Get();
+	UFunction* Func = Function.Get();
+	if (!Target || !Func)
+	{
+		OutError = TEXT("Bound object no longer exists");
+		return false;
+	}
+
+	// A function that calls back into the same binding would trample the
+	// shared buffer, so recursive calls get a temporary one.
+	TOptional<FStructOnScope> Scratch;
+	uint8* Memory = Buffer;
+	if (bInvoking)
+	{
+		Scratch.Emplace(Func);
+		Memory = Scratch->GetStructMemory();
+	}
+	else
+	{
+		Func->InitializeStruct(Memory);
+	}
+	TGuardValue<bool> InvokingGuard(bInvoking, true);
+
+	bool bOk = true;
+	if (InParams.IsValid())
+	{
+		for (const FParam& Param : Params)
+		{
+			if (!Param.bInput) continue;
+
+			TSharedPtr<FJsonValue> Value = InParams->TryGetField(Param.Name);
+			if (!Value.IsValid())
+			{
+				// Accept any casing, as Remote Control does.
+				for (const TPair<FString, TSharedPtr<FJsonValue>>& Pair : InParams->Values)
+				{
+					if (Pair.Key.Equals(Param.Name, ESearchCase::IgnoreCase))
+					{
+						Value = Pair.Value;
+						break;
+					}
+				}
+			}
+			if (Value.IsValid() && !FJsonObjectConverter::JsonValueToUProperty(
+				Value, Param.Property, Param.Property->ContainerPtrToValuePtr<void>(Memory)))
+			{
+				OutError = FString::Printf(TEXT("Invalid value for parameter '%s'"), *Param.Name);
+				bOk = false;
+				break;
+			}
+		}
+	}
+
+	if (bOk)
+	{
+		Target->ProcessEvent(Func, Memory);
+		ReadOutputs(Memory);
+	}
+
+	if (!Scratch.IsSet())
+	{
+		Func->DestroyStruct(Memory);
+	}
+	return bOk;
+}
+
+TArray<TSharedPtr<FJsonValue>> FPlayUnrealFunctionBinding::DescribeParams() const
+{
+	TArray<TSharedPtr<FJsonValue>> Out;
+	for (const FParam& Param : Params)
+	{
+		TSharedRef<FJsonObject> Entry = MakeShared<FJsonObject>();
+		Entry->SetStringField(TEXT("name"), Param.Name);
+		Entry->SetStringField(TEXT("type"), Param.Property->GetCPPType());
+		Entry->SetBoolField(TEXT("out"), Param.bOutput);
+		Out.Add(MakeShared<FJsonValueObject>(Entry));
+	}
+	return Out;
+}
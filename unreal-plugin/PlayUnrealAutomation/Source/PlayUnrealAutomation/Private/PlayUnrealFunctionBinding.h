@@ -0,0 +1,86 @@
+// PlayUnrealFunctionBinding.h
+//
+// A UFUNCTION on a live object, resolved once into everything a call
+// needs: the object, the UFunction, a reusable parameter buffer and the
+// list of parameters to fill from JSON. Repeated calls skip object path
+// and function name lookups and only convert values.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtr.h"
+
+class FJsonObject;
+class FJsonValue;
+class FPlayUnrealMsgPackWriter;
+class UFunction;
+
+class FPlayUnrealFunctionBinding
+{
+public:
+	~FPlayUnrealFunctionBinding();
+
+	/**
+	 * Bind a BlueprintCallable function on an object.
+	 *
+	 * @return  The binding, or null with a reason in OutError.
+	 */
+	static TSharedPtr<FPlayUnrealFunctionBinding> Create(UObject* Object, FName FunctionName,
+	                                                     FString& OutError);
+
+	/** Resolve the object by path first, then bind as above. */
+	static TSharedPtr<FPlayUnrealFunctionBinding> Create(const FString& ObjectPath, FName FunctionName,
+	                                                     FString& OutError);
+
+	/** True while the bound object is alive. */
+	bool IsValid() const { return Object.IsValid() && Function.IsValid(); }
+
+	UObject* GetObject() const { return Object.Get(); }
+	UFunction* GetFunction() const { return Function.Get(); }
+
+	/**
+	 * Call the function.
+	 *
+	 * @param Params      Input parameters by name; missing ones are zeroed.
+	 * @param OutOutputs  {"ReturnValue": ..., <out param>: ...}, the same
+	 *                    shape Remote Control returns.
+	 * @return            False with a reason in OutError on failure.
+	 */
+	bool Invoke(const TSharedPtr<FJsonObject>& Params, TSharedPtr<FJsonObject>& OutOutputs,
+	            FString& OutError);
+
+	/**
+	 * Call the function and write the same outputs map as MessagePack,
+	 * straight from the parameter memory. Output strings holding a JSON
+	 * object or array (game hooks such as GetLaneHazardsJSON) are written
+	 * as that data rather than as text.
+	 */
+	bool Invoke(const TSharedPtr<FJsonObject>& Params, FPlayUnrealMsgPackWriter& Writer,
+	            FString& OutError);
+
+	/** Describe the parameters as [{"name", "type", "out"}]. */
+	TArray<TSharedPtr<FJsonValue>> DescribeParams() const;
+
+private:
+	struct FParam
+	{
+		FProperty* Property = nullptr;
+		FString Name;
+		bool bInput = false;
+		bool bOutput = false;
+	};
+
+	FPlayUnrealFunctionBinding() = default;
+
+	/** Fill the inputs, call, and hand the parameter memory to ReadOutputs. */
+	bool Call(const TSharedPtr<FJsonObject>& Params, TFunctionRef<void(const uint8*)> ReadOutputs,
+	          FString& OutError);
+
+	TWeakObjectPtr<UObject> Object;
+	TWeakObjectPtr<UFunction> Function;
+	TArray<FParam> Params;
+	/** Frame memory (parameters and locals), allocated once and reinitialized per call. */
+	/** Parameter memory, allocated once and reinitialized per call. */
+	uint8* Buffer = nullptr;
+	bool bInvoking = false;
+};
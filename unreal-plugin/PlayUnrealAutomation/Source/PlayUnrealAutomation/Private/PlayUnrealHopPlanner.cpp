@@ -0,0 +1,547 @@
+// PlayUnrealHopPlanner.cpp
+
+#include "PlayUnrealHopPlanner.h"
+#include "Dom/JsonObject.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Kismet/GameplayStatics.h"
+#include "PlayUnrealCondition.h"
+#include "PlayUnrealFunctionBinding.h"
+#include "UObject/UObjectGlobals.h"
+
+namespace
+{
+	/** Column order of the hazard capture. */
+	enum EHazardField : int32
+	{
+		FieldX,
+		FieldY,
+		FieldVX,
+		FieldEX,
+		FieldSpeed,
+		FieldWidth,
+		FieldMovesRight,
+		FieldRideable,
+	};
+
+	/** Farthest sidestep considered when lining up with a platform. */
+	constexpr int32 PlatformSearchCols = 4;
+	/** How far ahead platform arrivals are searched, and in what steps. */
+	constexpr float PlatformSearchSeconds = 6.0f;
+	constexpr float PlatformSearchStep = 0.02f;
+	/** A pawn within this of a platform's edge still rides it. */
+	constexpr float RideTolerance = 10.0f;
+
+	bool ReadFloat(const FJsonObject& Object, const TCHAR* Name, float& Out)
+	{
+		double Value = 0.0;
+		if (!Object.TryGetNumberField(Name, Value)) return false;
+		Out = static_cast<float>(Value);
+		return true;
+	}
+
+	const TCHAR* DescribeStep(const FIntPoint& Step)
+	{
+		return Step.Y > 0 ? TEXT("up") : Step.Y < 0 ? TEXT("down") : Step.X > 0 ? TEXT("right") : TEXT("left");
+	}
+}
+
+bool FPlayUnrealHopPlanner::InitFromJson(const FJsonObject& Goal, UWorld* World, FString& OutError)
+{
+	Goal.TryGetNumberField(TEXT("targetCol"), TargetCol);
+	Goal.TryGetNumberField(TEXT("targetRow"), TargetRow);
+	Goal.TryGetNumberField(TEXT("maxDeaths"), MaxDeaths);
+
+	const TSharedPtr<FJsonObject>* Grid = nullptr;
+	if (Goal.TryGetObjectField(TEXT("grid"), Grid))
+	{
+		ReadFloat(**Grid, TEXT("cellSize"), CellSize);
+		(*Grid)->TryGetNumberField(TEXT("cols"), Cols);
+		ReadFloat(**Grid, TEXT("originX"), OriginX);
+		ReadFloat(**Grid, TEXT("originY"), OriginY);
+	}
+
+	float CapsuleRadius = 34.0f;
+	float SafetyMargin = 80.0f;
+	ReadFloat(Goal, TEXT("hopDuration"), HopDuration);
+	ReadFloat(Goal, TEXT("settle"), Settle);
+	ReadFloat(Goal, TEXT("capsuleRadius"), CapsuleRadius);
+	ReadFloat(Goal, TEXT("safetyMargin"), SafetyMargin);
+	Danger = CapsuleRadius + SafetyMargin;
+	PlatformInset = CapsuleRadius + 10.0f;
+	ReadFloat(Goal, TEXT("platformInset"), PlatformInset);
+
+	if (CellSize <= 0.0f || Cols <= 0 || HopDuration <= 0.0f)
+	{
+		OutError = TEXT("cellSize, cols and hopDuration must be positive");
+		return false;
+	}
+	if (TargetCol < 0 || TargetCol >= Cols || TargetRow <= 0)
+	{
+		OutError = FString::Printf(TEXT("Target (%d, %d) is outside the grid"), TargetCol, TargetRow);
+		return false;
+	}
+
+	Goal.TryGetStringField(TEXT("pawn"), PawnPath);
+
+	const TSharedPtr<FJsonObject>* HopObject = nullptr;
+	if (Goal.TryGetObjectField(TEXT("hop"), HopObject))
+	{
+		FString Function;
+		if ((*HopObject)->TryGetStringField(TEXT("function"), Function))
+		{
+			HopFunction = FName(*Function);
+		}
+		(*HopObject)->TryGetStringField(TEXT("param"), HopParam);
+	}
+
+	// The hazard capture reads the game's properties by name; any the
+	// hazards lack read as NaN and fall back to velocity and bounds.
+	TSharedRef<FJsonObject> Query = MakeShared<FJsonObject>();
+	FString Speed = TEXT("Speed");
+	FString Width = TEXT("HazardWidth");
+	FString MovesRight = TEXT("bMovesRight");
+	FString Rideable = TEXT("bIsRideable");
+	const TSharedPtr<FJsonObject>* HazardObject = nullptr;
+	if (Goal.TryGetObjectField(TEXT("hazards"), HazardObject))
+	{
+		FString Filter;
+		if ((*HazardObject)->TryGetStringField(TEXT("class"), Filter))
+		{
+			Query->SetStringField(TEXT("class"), Filter);
+		}
+		if ((*HazardObject)->TryGetStringField(TEXT("tag"), Filter))
+		{
+			Query->SetStringField(TEXT("tag"), Filter);
+		}
+		(*HazardObject)->TryGetStringField(TEXT("speed"), Speed);
+		(*HazardObject)->TryGetStringField(TEXT("width"), Width);
+		(*HazardObject)->TryGetStringField(TEXT("movesRight"), MovesRight);
+		(*HazardObject)->TryGetStringField(TEXT("rideable"), Rideable);
+	}
+	if (!Query->HasField(TEXT("class")) && !Query->HasField(TEXT("tag")))
+	{
+		Query->SetStringField(TEXT("tag"), TEXT("Hazard"));
+	}
+
+	const TArray<FString> FieldNames = { TEXT("x"), TEXT("y"), TEXT("vx"), TEXT("ex"), Speed, Width, MovesRight, Rideable };
+	TArray<TSharedPtr<FJsonValue>> Fields;
+	for (const FString& Field : FieldNames)
+	{
+		Fields.Add(MakeShared<FJsonValueString>(Field));
+	}
+	Query->SetArrayField(TEXT("fields"), Fields);
+	if (!Hazards.InitFromJson(*Query, OutError))
+	{
+		return false;
+	}
+
+	auto ParseCondition = [&Goal, &OutError](const TCHAR* Key, TSharedPtr<FPlayUnrealCondition>& OutCondition)
+	{
+		const TSharedPtr<FJsonObject>* Description = nullptr;
+		if (!Goal.TryGetObjectField(Key, Description)) return true;
+
+		OutCondition = MakeShared<FPlayUnrealCondition>();
+		if (!OutCondition->InitFromJson(**Description, OutError))
+		{
+			OutError = FString::Printf(TEXT("\"%s\": %s"), Key, *OutError);
+			return false;
+		}
+		return true;
+	};
+	if (!ParseCondition(TEXT("while"), WhileCondition) || !ParseCondition(TEXT("until"), UntilCondition))
+	{
+		return false;
+	}
+
+	double Timeout = 120.0;
+	Goal.TryGetNumberField(TEXT("timeout"), Timeout);
+	StartTime = World->GetTimeSeconds();
+	StartFrame = GFrameCounter;
+	Deadline = StartTime + Timeout;
+	return true;
+}
+
+AActor* FPlayUnrealHopPlanner::ResolvePawn(UWorld* World)
+{
+	// Respawning games may replace the pawn, so a lost one is looked up again.
+	if (!Pawn.IsValid())
+	{
+		Pawn = PawnPath.IsEmpty()
+			? static_cast<AActor*>(UGameplayStatics::GetPlayerPawn(World, 0))
+			: FindObject<AActor>(nullptr, *PawnPath);
+	}
+	return Pawn.Get();
+}
+
+FPlayUnrealHopPlanner::EStatus FPlayUnrealHopPlanner::Tick(UWorld* World)
+{
+	if (Status != EStatus::Running) return Status;
+
+	const double Now = World->GetTimeSeconds();
+	if (Now >= Deadline)
+	{
+		Failure = FString::Printf(TEXT("Goal not reached after %.1f game seconds"), Now - StartTime);
+		return Status = EStatus::Failed;
+	}
+
+	AActor* Actor = ResolvePawn(World);
+	if (!Actor)
+	{
+		LastDecision = TEXT("no pawn");
+		return Status;
+	}
+
+	TSharedPtr<FJsonValue> Value;
+	if (UntilCondition.IsValid() && UntilCondition->Evaluate(Value))
+	{
+		return Status = EStatus::Succeeded;
+	}
+	if (WhileCondition.IsValid() && !WhileCondition->Evaluate(Value))
+	{
+		LastDecision = TEXT("paused");
+		return Status;
+	}
+	if (Now < NextDecisionTime) return Status;
+
+	const FVector Location = Actor->GetActorLocation();
+	const int32 Col = FMath::RoundToInt((Location.X - OriginX) / CellSize);
+	const int32 Row = FMath::RoundToInt((Location.Y - OriginY) / CellSize);
+	Position = FIntPoint(Col, Row);
+
+	// A pawn sent back more than one row has died and respawned.
+	if (LastRow != INDEX_NONE && Row < LastRow - 1 && ++Deaths > MaxDeaths)
+	{
+		Failure = FString::Printf(TEXT("Gave up after %d deaths"), Deaths);
+		return Status = EStatus::Failed;
+	}
+	LastRow = Row;
+
+	if (Row >= TargetRow)
+	{
+		return Status = EStatus::Succeeded;
+	}
+
+	Hazards.Capture(World);
+	BuildLanes();
+	++Decisions;
+
+	const FIntPoint Up(0, 1);
+	const FIntPoint Down(0, -1);
+	const int32 Toward = Col < TargetCol ? 1 : -1;
+	const int32 Next = Row + 1;
+	const ELane Here = GetLane(Row);
+	const ELane Ahead = Next >= TargetRow ? ELane::Safe : GetLane(Next);
+
+	// A zero step waits for a better frame.
+	FIntPoint Step = FIntPoint::ZeroValue;
+	switch (Ahead)
+	{
+	case ELane::Safe:
+		Step = Here == ELane::Safe && Col != TargetCol ? FIntPoint(Toward, 0) : Up;
+		break;
+
+	case ELane::Road:
+		if (IsRoadSafe(Next, Col))
+		{
+			Step = Up;
+			break;
+		}
+		// Sidestep to a column clear for the next row, preferring the
+		// target's side; any safe sidestep beats standing still.
+		for (const int32 Dir : { Toward, -Toward })
+		{
+			const int32 Side = Col + Dir;
+			if (Side < 0 || Side >= Cols || !IsLateralSafe(Row, Side)) continue;
+			if (IsRoadSafe(Next, Side))
+			{
+				Step = FIntPoint(Dir, 0);
+				break;
+			}
+			if (Step == FIntPoint::ZeroValue)
+			{
+				Step = FIntPoint(Dir, 0);
+			}
+		}
+		if (Step == FIntPoint::ZeroValue && Row > 0
+			&& (GetLane(Row - 1) != ELane::Road || IsRoadSafe(Row - 1, Col)))
+		{
+			Step = Down;
+		}
+		break;
+
+	case ELane::River:
+		if (Here == ELane::River)
+		{
+			// Riding: the pawn drifts with its platform until it lands.
+			const float Drift = GetDrift(Row, Location.X);
+			if (IsOnPlatform(Next, Location.X + Drift * HopDuration, HopDuration))
+			{
+				Step = Up;
+			}
+		}
+		else
+		{
+			float Wait = 0.0f;
+			const int32 PlatformCol = FindPlatformColumn(Next, Col, PlatformSearchSeconds, Wait);
+			if (PlatformCol != INDEX_NONE && PlatformCol != Col)
+			{
+				const int32 Dir = PlatformCol > Col ? 1 : -1;
+				if (IsLateralSafe(Row, Col + Dir))
+				{
+					Step = FIntPoint(Dir, 0);
+				}
+			}
+			else if (PlatformCol != INDEX_NONE && IsOnPlatform(Next, Location.X, HopDuration))
+			{
+				Step = Up;
+			}
+		}
+		break;
+	}
+
+	if (Step == FIntPoint::ZeroValue)
+	{
+		LastDecision = TEXT("wait");
+		return Status;
+	}
+
+	if (!Hop(Actor, Step))
+	{
+		return Status = EStatus::Failed;
+	}
+	++Hops;
+	LastDecision = DescribeStep(Step);
+	NextDecisionTime = Now + HopDuration + Settle;
+	return Status;
+}
+
+void FPlayUnrealHopPlanner::BuildLanes()
+{
+	const int32 Count = Hazards.GetCount();
+	const int32 NumRows = TargetRow + 1;
+	const TArrayView<const float> X = Hazards.GetColumn(FieldX);
+	const TArrayView<const float> Y = Hazards.GetColumn(FieldY);
+	const TArrayView<const float> VX = Hazards.GetColumn(FieldVX);
+	const TArrayView<const float> EX = Hazards.GetColumn(FieldEX);
+	const TArrayView<const float> Speed = Hazards.GetColumn(FieldSpeed);
+	const TArrayView<const float> Width = Hazards.GetColumn(FieldWidth);
+	const TArrayView<const float> MovesRight = Hazards.GetColumn(FieldMovesRight);
+	const TArrayView<const float> Rideable = Hazards.GetColumn(FieldRideable);
+
+	// Counting sort by row, so each lane is one contiguous range.
+	TArray<int32> Rows;
+	Rows.SetNumUninitialized(Count);
+	Lanes.First.Init(0, NumRows + 1);
+	Lanes.bHasHazard.Init(0, NumRows);
+	Lanes.bHasRideable.Init(0, NumRows);
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		const int32 Row = FMath::RoundToInt((Y[Index] - OriginY) / CellSize);
+		Rows[Index] = Row >= 0 && Row < NumRows ? Row : INDEX_NONE;
+		if (Rows[Index] != INDEX_NONE)
+		{
+			++Lanes.First[Row + 1];
+		}
+	}
+	for (int32 Row = 0; Row < NumRows; ++Row)
+	{
+		Lanes.First[Row + 1] += Lanes.First[Row];
+	}
+
+	const int32 Num = Lanes.First[NumRows];
+	Lanes.X.SetNumUninitialized(Num);
+	Lanes.Velocity.SetNumUninitialized(Num);
+	Lanes.HalfWidth.SetNumUninitialized(Num);
+	Lanes.WrapMin.SetNumUninitialized(Num);
+	Lanes.WrapRange.SetNumUninitialized(Num);
+	Lanes.InvWrapRange.SetNumUninitialized(Num);
+	Lanes.bRideable.SetNumUninitialized(Num);
+
+	TArray<int32> Cursor(Lanes.First.GetData(), NumRows);
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		const int32 Row = Rows[Index];
+		if (Row == INDEX_NONE) continue;
+
+		const int32 Slot = Cursor[Row]++;
+		const float Direction = !FMath::IsNaN(MovesRight[Index])
+			? (MovesRight[Index] > 0.5f ? 1.0f : -1.0f)
+			: (VX[Index] < 0.0f ? -1.0f : 1.0f);
+		const float WorldWidth = !FMath::IsNaN(Width[Index]) ? Width[Index] * CellSize : 2.0f * EX[Index];
+
+		// Hazards wrap one hazard length beyond either edge of the grid.
+		Lanes.X[Slot] = X[Index];
+		Lanes.Velocity[Slot] = !FMath::IsNaN(Speed[Index]) ? Speed[Index] * Direction : VX[Index];
+		Lanes.HalfWidth[Slot] = 0.5f * WorldWidth;
+		Lanes.WrapMin[Slot] = OriginX - WorldWidth;
+		Lanes.WrapRange[Slot] = Cols * CellSize + 2.0f * WorldWidth;
+		Lanes.InvWrapRange[Slot] = 1.0f / Lanes.WrapRange[Slot];
+		Lanes.bRideable[Slot] = !FMath::IsNaN(Rideable[Index]) && Rideable[Index] > 0.5f;
+
+		Lanes.bHasHazard[Row] = 1;
+		Lanes.bHasRideable[Row] |= Lanes.bRideable[Slot];
+	}
+
+	// Every decision this frame reads the same samples across the hop.
+	Samples.SetNumUninitialized(NumSamples * Num);
+	for (int32 Sample = 0; Sample < NumSamples; ++Sample)
+	{
+		Predict(0, Num, Sample * HopDuration / (NumSamples - 1), Samples.GetData() + Sample * Num);
+	}
+}
+
+void FPlayUnrealHopPlanner::Predict(int32 Begin, int32 End, float T, float* Out) const
+{
+	const float* RESTRICT X = Lanes.X.GetData();
+	const float* RESTRICT Velocity = Lanes.Velocity.GetData();
+	const float* RESTRICT WrapMin = Lanes.WrapMin.GetData();
+	const float* RESTRICT WrapRange = Lanes.WrapRange.GetData();
+	const float* RESTRICT InvWrapRange = Lanes.InvWrapRange.GetData();
+	float* RESTRICT Result = Out;
+
+	for (int32 Index = Begin; Index < End; ++Index)
+	{
+		const float Offset = X[Index] + Velocity[Index] * T - WrapMin[Index];
+		Result[Index] = Offset - FMath::FloorToFloat(Offset * InvWrapRange[Index]) * WrapRange[Index] + WrapMin[Index];
+	}
+}
+
+FPlayUnrealHopPlanner::ELane FPlayUnrealHopPlanner::GetLane(int32 Row) const
+{
+	if (!Lanes.bHasHazard.IsValidIndex(Row)) return ELane::Safe;
+	return Lanes.bHasRideable[Row] ? ELane::River : Lanes.bHasHazard[Row] ? ELane::Road : ELane::Safe;
+}
+
+bool FPlayUnrealHopPlanner::IsRoadSafe(int32 Row, int32 Col) const
+{
+	if (!Lanes.bHasHazard.IsValidIndex(Row)) return true;
+
+	const float PawnX = ColumnToX(Col);
+	const int32 Num = Lanes.Num();
+	const int32 Begin = Lanes.First[Row];
+	const int32 End = Lanes.First[Row + 1];
+	for (int32 Sample = 0; Sample < NumSamples; ++Sample)
+	{
+		const float* Predicted = Samples.GetData() + Sample * Num;
+		for (int32 Index = Begin; Index < End; ++Index)
+		{
+			if (!Lanes.bRideable[Index]
+				&& FMath::Abs(PawnX - Predicted[Index]) < Lanes.HalfWidth[Index] + Danger)
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+bool FPlayUnrealHopPlanner::IsOnPlatform(int32 Row, float X, float T) const
+{
+	if (!Lanes.bHasRideable.IsValidIndex(Row) || !Lanes.bHasRideable[Row]) return false;
+
+	const int32 Begin = Lanes.First[Row];
+	const int32 End = Lanes.First[Row + 1];
+	Scratch.SetNumUninitialized(Lanes.Num());
+	Predict(Begin, End, T, Scratch.GetData());
+	for (int32 Index = Begin; Index < End; ++Index)
+	{
+		if (Lanes.bRideable[Index] && FMath::Abs(X - Scratch[Index]) <= Lanes.HalfWidth[Index] - PlatformInset)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool FPlayUnrealHopPlanner::IsLateralSafe(int32 Row, int32 Col) const
+{
+	switch (GetLane(Row))
+	{
+	case ELane::Road:
+		return IsRoadSafe(Row, Col);
+	case ELane::River:
+		return IsOnPlatform(Row, ColumnToX(Col), 0.0f) || IsOnPlatform(Row, ColumnToX(Col), HopDuration);
+	default:
+		return true;
+	}
+}
+
+float FPlayUnrealHopPlanner::GetDrift(int32 Row, float X) const
+{
+	if (!Lanes.bHasRideable.IsValidIndex(Row)) return 0.0f;
+
+	for (int32 Index = Lanes.First[Row]; Index < Lanes.First[Row + 1]; ++Index)
+	{
+		if (Lanes.bRideable[Index] && FMath::Abs(X - Lanes.X[Index]) <= Lanes.HalfWidth[Index] + RideTolerance)
+		{
+			return Lanes.Velocity[Index];
+		}
+	}
+	return 0.0f;
+}
+
+int32 FPlayUnrealHopPlanner::FindPlatformColumn(int32 Row, int32 Col, float MaxWait, float& OutWait) const
+{
+	int32 BestCol = INDEX_NONE;
+	float BestScore = TNumericLimits<float>::Max();
+
+	const int32 FirstCol = FMath::Max(0, Col - PlatformSearchCols);
+	const int32 LastCol = FMath::Min(Cols - 1, Col + PlatformSearchCols);
+	for (int32 Candidate = FirstCol; Candidate <= LastCol; ++Candidate)
+	{
+		const float SidestepCost = FMath::Abs(Candidate - Col) * (HopDuration + Settle);
+		for (float Wait = 0.0f; Wait < MaxWait && Wait + SidestepCost < BestScore; Wait += PlatformSearchStep)
+		{
+			if (IsOnPlatform(Row, ColumnToX(Candidate), Wait + HopDuration))
+			{
+				BestScore = Wait + SidestepCost;
+				BestCol = Candidate;
+				OutWait = Wait;
+				break;
+			}
+		}
+	}
+	return BestCol;
+}
+
+bool FPlayUnrealHopPlanner::Hop(AActor* Actor, const FIntPoint& Direction)
+{
+	if (!HopBinding.IsValid() || HopBinding->GetObject() != Actor)
+	{
+		HopBinding = FPlayUnrealFunctionBinding::Create(Actor, HopFunction, Failure);
+		if (!HopBinding.IsValid()) return false;
+	}
+
+	TSharedRef<FJsonObject> Vector = MakeShared<FJsonObject>();
+	Vector->SetNumberField(TEXT("X"), Direction.X);
+	Vector->SetNumberField(TEXT("Y"), Direction.Y);
+	Vector->SetNumberField(TEXT("Z"), 0.0);
+	TSharedRef<FJsonObject> Params = MakeShared<FJsonObject>();
+	Params->SetObjectField(HopParam, Vector);
+
+	TSharedPtr<FJsonObject> Outputs;
+	return HopBinding->Invoke(Params, Outputs, Failure);
+}
+
+TSharedRef<FJsonObject> FPlayUnrealHopPlanner::ToJson() const
+{
+	TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+	Object->SetStringField(TEXT("status"), Status == EStatus::Running ? TEXT("running")
+		: Status == EStatus::Succeeded ? TEXT("succeeded") : TEXT("failed"));
+	Object->SetNumberField(TEXT("col"), Position.X);
+	Object->SetNumberField(TEXT("row"), Position.Y);
+	Object->SetNumberField(TEXT("targetCol"), TargetCol);
+	Object->SetNumberField(TEXT("targetRow"), TargetRow);
+	Object->SetNumberField(TEXT("hops"), Hops);
+	Object->SetNumberField(TEXT("deaths"), Deaths);
+	Object->SetNumberField(TEXT("decisions"), Decisions);
+	Object->SetStringField(TEXT("lastDecision"), LastDecision);
+	Object->SetNumberField(TEXT("hazards"), Lanes.Num());
+	Object->SetNumberField(TEXT("frames"), static_cast<double>(GFrameCounter - StartFrame));
+	if (Status == EStatus::Failed)
+	{
+		Object->SetStringField(TEXT("error"), Failure);
+	}
+	return Object;
+}
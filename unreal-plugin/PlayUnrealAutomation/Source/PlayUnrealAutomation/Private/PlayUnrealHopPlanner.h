@@ -0,0 +1,165 @@
+// PlayUnrealHopPlanner.h
+//
+// In-engine hop planning for lane-crossing games (Frogger and the like):
+// the engine-side counterpart of Tools/PlayUnreal/path_planner.py. Every
+// tick it captures the hazard actors, predicts where each will be over the
+// next hop and decides one hop (or to wait) for a grid-moving pawn until
+// the pawn reaches its goal. Each decision sees this frame's hazards, with
+// no network round trip in the loop.
+//
+// The game stays unknown to the plugin. Hazards are found by class or tag
+// and read through reflection (speed, width, direction, rideable); the pawn
+// hops through one of its UFUNCTIONs taking a direction vector. Lane kinds
+// are inferred: a row with rideable hazards is a river, a row with other
+// hazards a road, and an empty row is safe.
+//
+// Predictions run over struct-of-arrays hazard columns (as captured by
+// FPlayUnrealActorSnapshot). The kernel is a branch-free loop over
+// contiguous floats that the compiler vectorizes, covering all lanes in
+// one pass per sample time.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PlayUnrealActorSnapshot.h"
+#include "UObject/WeakObjectPtr.h"
+
+class AActor;
+class FJsonObject;
+class FPlayUnrealCondition;
+class FPlayUnrealFunctionBinding;
+class UWorld;
+
+class FPlayUnrealHopPlanner
+{
+public:
+	enum class EStatus : uint8
+	{
+		Running,
+		Succeeded,
+		Failed,
+	};
+
+	/**
+	 * Configure from a goal description; see APlayUnrealDriver::NavigateTo
+	 * for the keys. Returns false with a reason if it is malformed.
+	 */
+	bool InitFromJson(const FJsonObject& Goal, UWorld* World, FString& OutError);
+
+	/** Make at most one decision for this frame. */
+	EStatus Tick(UWorld* World);
+
+	/** Why the planner failed, once Tick returned Failed. */
+	const FString& GetFailure() const { return Failure; }
+
+	/** Progress: position, goal, hops, deaths and the last decision. */
+	TSharedRef<FJsonObject> ToJson() const;
+
+private:
+	enum class ELane : uint8
+	{
+		Safe,
+		Road,
+		River,
+	};
+
+	/** Hazards of one frame, grouped by row, one array per attribute. */
+	struct FLanes
+	{
+		TArray<float> X;
+		/** Signed, units per second. */
+		TArray<float> Velocity;
+		TArray<float> HalfWidth;
+		TArray<float> WrapMin;
+		TArray<float> WrapRange;
+		TArray<float> InvWrapRange;
+		TArray<uint8> bRideable;
+		/** Hazards of row R are [First[R], First[R + 1]). */
+		TArray<int32> First;
+		/** Per row: any hazard, any rideable. */
+		TArray<uint8> bHasHazard;
+		TArray<uint8> bHasRideable;
+
+		int32 Num() const { return X.Num(); }
+	};
+
+	/** Number of prediction samples across a hop, end points included. */
+	static constexpr int32 NumSamples = 8;
+
+	AActor* ResolvePawn(UWorld* World);
+
+	void BuildLanes();
+
+	/** Predicted X of hazards [Begin, End) at time T, into Out[Begin..End). */
+	void Predict(int32 Begin, int32 End, float T, float* Out) const;
+
+	ELane GetLane(int32 Row) const;
+
+	/** No road hazard comes near the column for the whole hop. */
+	bool IsRoadSafe(int32 Row, int32 Col) const;
+
+	/** A platform carries a pawn at X at time T (after now). */
+	bool IsOnPlatform(int32 Row, float X, float T) const;
+
+	/** Safe to stand on (Row, Col) through one hop. */
+	bool IsLateralSafe(int32 Row, int32 Col) const;
+
+	/** Velocity of the platform under X now, or 0. */
+	float GetDrift(int32 Row, float X) const;
+
+	/**
+	 * Column in reach whose platform arrives soonest, counting the sidesteps
+	 * to reach it. INDEX_NONE if nothing arrives within MaxWait.
+	 */
+	int32 FindPlatformColumn(int32 Row, int32 Col, float MaxWait, float& OutWait) const;
+
+	float ColumnToX(int32 Col) const { return OriginX + Col * CellSize; }
+
+	/** Hop one cell; Direction is a grid step (+Y is up). */
+	bool Hop(AActor* Pawn, const FIntPoint& Direction);
+
+	// Goal
+	int32 TargetCol = 6;
+	int32 TargetRow = 14;
+	int32 MaxDeaths = 8;
+	double Deadline = 0.0;
+
+	// Grid and timing
+	float CellSize = 100.0f;
+	int32 Cols = 13;
+	float OriginX = 0.0f;
+	float OriginY = 0.0f;
+	float HopDuration = 0.15f;
+	float Settle = 0.04f;
+	float Danger = 114.0f;
+	float PlatformInset = 44.0f;
+
+	// Game hooks
+	FString PawnPath;
+	TWeakObjectPtr<AActor> Pawn;
+	FName HopFunction = TEXT("RequestHop");
+	FString HopParam = TEXT("Direction");
+	TSharedPtr<FPlayUnrealFunctionBinding> HopBinding;
+	TSharedPtr<FPlayUnrealCondition> WhileCondition;
+	TSharedPtr<FPlayUnrealCondition> UntilCondition;
+
+	// Hazard capture: x, y, vx, ex, speed, width, movesRight, rideable.
+	FPlayUnrealActorSnapshot Hazards;
+	FLanes Lanes;
+	/** NumSamples rows of Lanes.Num() predicted X, sample S at S/(NumSamples-1) of a hop. */
+	TArray<float> Samples;
+	mutable TArray<float> Scratch;
+
+	// Progress
+	double StartTime = 0.0;
+	double NextDecisionTime = 0.0;
+	uint64 StartFrame = 0;
+	FIntPoint Position = FIntPoint(INDEX_NONE, INDEX_NONE);
+	int32 LastRow = INDEX_NONE;
+	int32 Hops = 0;
+	int32 Deaths = 0;
+	int32 Decisions = 0;
+	FString LastDecision;
+	FString Failure;
+	EStatus Status = EStatus::Running;
+};
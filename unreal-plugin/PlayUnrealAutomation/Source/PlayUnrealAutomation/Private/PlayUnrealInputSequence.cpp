@@ -0,0 +1,346 @@
+// PlayUnrealInputSequence.cpp
+
+#include "PlayUnrealInputSequence.h"
+#include "Algo/StableSort.h"
+#include "Dom/JsonObject.h"
+#include "Dom/JsonValue.h"
+#include "Engine/Engine.h"
+#include "Engine/GameViewportClient.h"
+#include "Framework/Application/SlateApplication.h"
+#include "UnrealClient.h"
+#include "Widgets/SViewport.h"
+
+bool FPlayUnrealInputSequence::ParseModifiers(const TArray<FString>& Names, uint8& OutModifiers, FString& OutError)
+{
+	for (const FString& Name : Names)
+	{
+		if (Name.Equals(TEXT("shift"), ESearchCase::IgnoreCase))
+		{
+			OutModifiers |= Shift;
+		}
+		else if (Name.Equals(TEXT("ctrl"), ESearchCase::IgnoreCase) || Name.Equals(TEXT("control"), ESearchCase::IgnoreCase))
+		{
+			OutModifiers |= Ctrl;
+		}
+		else if (Name.Equals(TEXT("alt"), ESearchCase::IgnoreCase))
+		{
+			OutModifiers |= Alt;
+		}
+		else if (Name.Equals(TEXT("cmd"), ESearchCase::IgnoreCase) || Name.Equals(TEXT("command"), ESearchCase::IgnoreCase))
+		{
+			OutModifiers |= Cmd;
+		}
+		else
+		{
+			OutError = FString::Printf(TEXT("Unknown modifier '%s'"), *Name);
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool ParseKey(const FString& Name, FKey& OutKey, FString& OutError)
+{
+	OutKey = FKey(FName(*Name));
+	if (!OutKey.IsValid())
+	{
+		OutError = FString::Printf(TEXT("Unknown key '%s'"), *Name);
+		return false;
+	}
+	return true;
+}
+
+bool FPlayUnrealInputSequence::InitFromJson(const TArray<TSharedPtr<FJsonValue>>& Values, FString& OutError)
+{
+	uint32 Frame = 0;
+	FVector2D Position = FVector2D::ZeroVector;
+	for (int32 Index = 0; Index < Values.Num(); ++Index)
+	{
+		const TSharedPtr<FJsonObject>* Object = nullptr;
+		if (!Values[Index].IsValid() || !Values[Index]->TryGetObject(Object))
+		{
+			OutError = FString::Printf(TEXT("Event %d is not an object"), Index);
+			return false;
+		}
+		const FJsonObject& Description = **Object;
+
+		int32 EventFrame = 0;
+		if (Description.TryGetNumberField(TEXT("frame"), EventFrame))
+		{
+			Frame = static_cast<uint32>(FMath::Max(EventFrame, 0));
+		}
+
+		FEvent Event;
+		Event.Frame = Frame;
+
+		TArray<FString> ModifierNames;
+		if (Description.TryGetStringArrayField(TEXT("modifiers"), ModifierNames)
+			&& !ParseModifiers(ModifierNames, Event.Modifiers, OutError))
+		{
+			return false;
+		}
+
+		FString Type;
+		Description.TryGetStringField(TEXT("type"), Type);
+
+		FString KeyName;
+		const bool bHasKey = Description.TryGetStringField(TEXT("key"), KeyName);
+		// Mouse events without a position stay where the last one was.
+		Description.TryGetNumberField(TEXT("x"), Position.X);
+		Description.TryGetNumberField(TEXT("y"), Position.Y);
+		Event.Position = Position;
+
+		FString Button = TEXT("left");
+		Description.TryGetStringField(TEXT("button"), Button);
+		const FKey MouseButton = Button == TEXT("right") ? EKeys::RightMouseButton
+			: Button == TEXT("middle") ? EKeys::MiddleMouseButton : EKeys::LeftMouseButton;
+
+		if (Type == TEXT("keyDown") || Type == TEXT("keyUp") || Type == TEXT("key"))
+		{
+			if (!bHasKey)
+			{
+				OutError = FString::Printf(TEXT("Event %d needs a \"key\""), Index);
+				return false;
+			}
+			if (!ParseKey(KeyName, Event.Key, OutError))
+			{
+				return false;
+			}
+			Event.Type = Type == TEXT("keyUp") ? EType::KeyUp : EType::KeyDown;
+			Events.Add(Event);
+
+			if (Type == TEXT("key"))
+			{
+				int32 Hold = 1;
+				Description.TryGetNumberField(TEXT("hold"), Hold);
+				Event.Type = EType::KeyUp;
+				Event.Frame += FMath::Max(Hold, 1);
+				Events.Add(Event);
+			}
+		}
+		else if (Type == TEXT("char") || Type == TEXT("text"))
+		{
+			FString Text;
+			if (!Description.TryGetStringField(TEXT("text"), Text) && !Description.TryGetStringField(TEXT("char"), Text))
+			{
+				OutError = FString::Printf(TEXT("Event %d needs a \"text\""), Index);
+				return false;
+			}
+			Event.Type = EType::Char;
+			for (const TCHAR Character : Text)
+			{
+				Event.Character = Character;
+				Events.Add(Event);
+				if (Type == TEXT("char")) break;
+			}
+		}
+		else if (Type == TEXT("mouseMove"))
+		{
+			Event.Type = EType::MouseMove;
+			Events.Add(Event);
+		}
+		else if (Type == TEXT("mouseDown") || Type == TEXT("mouseUp") || Type == TEXT("click"))
+		{
+			Event.Key = MouseButton;
+			Event.Type = Type == TEXT("mouseUp") ? EType::MouseUp : EType::MouseDown;
+			Events.Add(Event);
+
+			if (Type == TEXT("click"))
+			{
+				Event.Type = EType::MouseUp;
+				Event.Frame += 1;
+				Events.Add(Event);
+			}
+		}
+		else if (Type == TEXT("wheel"))
+		{
+			Event.Type = EType::Wheel;
+			Description.TryGetNumberField(TEXT("delta"), Event.WheelDelta);
+			Events.Add(Event);
+		}
+		else
+		{
+			OutError = FString::Printf(TEXT("Event %d has unknown type '%s'"), Index, *Type);
+			return false;
+		}
+	}
+
+	Algo::StableSortBy(Events, &FEvent::Frame);
+	return true;
+}
+
+bool FPlayUnrealInputSequence::AddKeyChord(const FString& Chord, FString& OutError)
+{
+	TArray<FString> Parts;
+	Chord.ParseIntoArray(Parts, TEXT("+"));
+	if (Parts.IsEmpty())
+	{
+		OutError = TEXT("Empty key chord");
+		return false;
+	}
+
+	FEvent Event;
+	const FString KeyName = Parts.Pop();
+	if (!ParseModifiers(Parts, Event.Modifiers, OutError) || !ParseKey(KeyName, Event.Key, OutError))
+	{
+		return false;
+	}
+
+	Event.Type = EType::KeyDown;
+	Events.Add(Event);
+	Event.Type = EType::KeyUp;
+	Event.Frame = 1;
+	Events.Add(Event);
+	Algo::StableSortBy(Events, &FEvent::Frame);
+	return true;
+}
+
+void FPlayUnrealInputSequence::AddText(const FString& Text)
+{
+	FEvent Event;
+	Event.Type = EType::Char;
+	for (const TCHAR Character : Text)
+	{
+		Event.Character = Character;
+		Events.Add(Event);
+	}
+	Algo::StableSortBy(Events, &FEvent::Frame);
+}
+
+bool FPlayUnrealInputSequence::Advance(uint64 Frame)
+{
+	if (!bStarted)
+	{
+		bStarted = true;
+		StartFrame = Frame;
+	}
+
+	while (NextEvent < Events.Num() && StartFrame + Events[NextEvent].Frame <= Frame)
+	{
+		Dispatch(Events[NextEvent++]);
+	}
+	return NextEvent >= Events.Num();
+}
+
+void FPlayUnrealInputSequence::ReleaseHeld()
+{
+	FEvent Event;
+	Event.Type = EType::KeyUp;
+	for (const FKey& Key : TSet<FKey>(HeldKeys))
+	{
+		Event.Key = Key;
+		Dispatch(Event);
+	}
+
+	Event.Type = EType::MouseUp;
+	for (const FKey& Button : TSet<FKey>(HeldButtons))
+	{
+		Event.Key = Button;
+		Dispatch(Event);
+	}
+}
+
+FModifierKeysState FPlayUnrealInputSequence::MakeModifierState(uint8 Modifiers) const
+{
+	return FModifierKeysState(
+		(Modifiers & Shift) || HeldKeys.Contains(EKeys::LeftShift), HeldKeys.Contains(EKeys::RightShift),
+		(Modifiers & Ctrl) || HeldKeys.Contains(EKeys::LeftControl), HeldKeys.Contains(EKeys::RightControl),
+		(Modifiers & Alt) || HeldKeys.Contains(EKeys::LeftAlt), HeldKeys.Contains(EKeys::RightAlt),
+		(Modifiers & Cmd) || HeldKeys.Contains(EKeys::LeftCommand), HeldKeys.Contains(EKeys::RightCommand),
+		false);
+}
+
+bool FPlayUnrealInputSequence::ViewportToScreen(const FVector2D& Position, FVector2D& OutScreen)
+{
+	UGameViewportClient* Viewport = GEngine ? GEngine->GameViewport.Get() : nullptr;
+	TSharedPtr<SViewport> Widget = Viewport ? Viewport->GetGameViewportWidget() : nullptr;
+	if (!Widget.IsValid() || !Viewport->Viewport)
+	{
+		return false;
+	}
+
+	const FGeometry& Geometry = Widget->GetCachedGeometry();
+	const FIntPoint Pixels = Viewport->Viewport->GetSizeXY();
+	const FVector2D Scale = Pixels.X > 0 && Pixels.Y > 0
+		? Geometry.GetAbsoluteSize() / FVector2D(Pixels) : FVector2D(1.0, 1.0);
+	OutScreen = Geometry.GetAbsolutePosition() + Position * Scale;
+	return true;
+}
+
+void FPlayUnrealInputSequence::Dispatch(const FEvent& Event)
+{
+	if (!FSlateApplication::IsInitialized()) return;
+	FSlateApplication& Slate = FSlateApplication::Get();
+
+	switch (Event.Type)
+	{
+	case EType::KeyDown:
+	case EType::KeyUp:
+	{
+		const uint32* KeyCode = nullptr;
+		const uint32* CharCode = nullptr;
+		FInputKeyManager::Get().GetCodesFromKey(Event.Key, KeyCode, CharCode);
+
+		const bool bDown = Event.Type == EType::KeyDown;
+		const bool bRepeat = bDown && HeldKeys.Contains(Event.Key);
+		if (bDown)
+		{
+			HeldKeys.Add(Event.Key);
+		}
+		else
+		{
+			HeldKeys.Remove(Event.Key);
+		}
+
+		const FKeyEvent KeyEvent(Event.Key, MakeModifierState(Event.Modifiers), 0, bRepeat,
+			CharCode ? *CharCode : 0, KeyCode ? *KeyCode : 0);
+		if (bDown)
+		{
+			Slate.ProcessKeyDownEvent(KeyEvent);
+		}
+		else
+		{
+			Slate.ProcessKeyUpEvent(KeyEvent);
+		}
+		break;
+	}
+	case EType::Char:
+		Slate.ProcessKeyCharEvent(FCharacterEvent(Event.Character, MakeModifierState(Event.Modifiers), 0, false));
+		break;
+	case EType::MouseMove:
+	case EType::MouseDown:
+	case EType::MouseUp:
+	case EType::Wheel:
+	{
+		FVector2D Screen;
+		if (!ViewportToScreen(Event.Position, Screen))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("PlayUnreal: Dropped mouse input, no game viewport"));
+			break;
+		}
+
+		if (Event.Type == EType::MouseDown)
+		{
+			HeldButtons.Add(Event.Key);
+		}
+		else if (Event.Type == EType::MouseUp)
+		{
+			HeldButtons.Remove(Event.Key);
+		}
+
+		const FKey EffectingButton = Event.Type == EType::MouseDown || Event.Type == EType::MouseUp ? Event.Key : EKeys::Invalid;
+		const FPointerEvent PointerEvent(FSlateApplication::CursorPointerIndex, Screen, CursorPosition,
+			HeldButtons, EffectingButton, Event.WheelDelta, MakeModifierState(Event.Modifiers));
+		CursorPosition = Screen;
+
+		switch (Event.Type)
+		{
+		case EType::MouseMove: Slate.ProcessMouseMoveEvent(PointerEvent); break;
+		case EType::MouseDown: Slate.ProcessMouseButtonDownEvent(nullptr, PointerEvent); break;
+		case EType::MouseUp:   Slate.ProcessMouseButtonUpEvent(PointerEvent); break;
+		default:               Slate.ProcessMouseWheelOrGestureEvent(PointerEvent, nullptr); break;
+		}
+		break;
+	}
+	}
+}
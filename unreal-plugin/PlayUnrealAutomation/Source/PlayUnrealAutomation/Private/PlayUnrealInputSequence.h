@@ -0,0 +1,106 @@
+// PlayUnrealInputSequence.h
+//
+// A timed list of keyboard and mouse events injected through
+// FSlateApplication, so they reach widgets and the game viewport exactly as
+// hardware input would. Events are scheduled against frame offsets from the
+// start of the sequence, which lets a client send many inputs in one call
+// with engine-side timing between them:
+//
+//   [{"type": "key", "key": "Up", "hold": 2},
+//    {"frame": 10, "type": "key", "key": "Left"},
+//    {"frame": 20, "type": "text", "text": "AAA"},
+//    {"frame": 30, "type": "click", "x": 640, "y": 360}]
+//
+// Types: keyDown, keyUp, key (down, then up after "hold" frames, default 1),
+// char, text (one char event per character), mouseMove, mouseDown, mouseUp,
+// click (down, then up a frame later) and wheel ("delta"). Mouse positions
+// are in game viewport pixels. "modifiers" is a list of shift, ctrl, alt and
+// cmd. An event without "frame" runs on the previous event's frame.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "InputCoreTypes.h"
+
+class FJsonValue;
+
+class FPlayUnrealInputSequence
+{
+public:
+	/** Parse the events. Returns false with a reason if one is malformed. */
+	bool InitFromJson(const TArray<TSharedPtr<FJsonValue>>& Events, FString& OutError);
+
+	/** Add a key press (down now, up a frame later) from a chord like "Ctrl+S". */
+	bool AddKeyChord(const FString& Chord, FString& OutError);
+
+	/** Add one char event per character of Text, all on the first frame. */
+	void AddText(const FString& Text);
+
+	/**
+	 * Dispatch every event due by Frame. The first call fixes the frame
+	 * that offsets count from.
+	 *
+	 * @return  True once every event has been dispatched.
+	 */
+	bool Advance(uint64 Frame);
+
+	/** Send key and button ups for anything still held, e.g. after a cancel. */
+	void ReleaseHeld();
+
+	int32 Num() const { return Events.Num(); }
+
+	/** Frame the sequence started on (valid after the first Advance). */
+	uint64 GetStartFrame() const { return StartFrame; }
+
+private:
+	enum class EType : uint8
+	{
+		KeyDown,
+		KeyUp,
+		Char,
+		MouseMove,
+		MouseDown,
+		MouseUp,
+		Wheel,
+	};
+
+	enum EModifier : uint8
+	{
+		Shift = 1 << 0,
+		Ctrl  = 1 << 1,
+		Alt   = 1 << 2,
+		Cmd   = 1 << 3,
+	};
+
+	struct FEvent
+	{
+		uint32 Frame = 0;
+		EType Type = EType::KeyDown;
+		FKey Key;
+		TCHAR Character = 0;
+		/** Game viewport pixels. */
+		FVector2D Position = FVector2D::ZeroVector;
+		float WheelDelta = 0.0f;
+		uint8 Modifiers = 0;
+	};
+
+	static bool ParseModifiers(const TArray<FString>& Names, uint8& OutModifiers, FString& OutError);
+
+	/** Modifier state from explicit modifiers plus modifier keys being held. */
+	FModifierKeysState MakeModifierState(uint8 Modifiers) const;
+
+	/** Viewport pixels to Slate's absolute (desktop) space. */
+	static bool ViewportToScreen(const FVector2D& Position, FVector2D& OutScreen);
+
+	void Dispatch(const FEvent& Event);
+
+	/** Sorted by frame; events on the same frame keep their order. */
+	TArray<FEvent> Events;
+	int32 NextEvent = 0;
+	bool bStarted = false;
+	uint64 StartFrame = 0;
+
+	TSet<FKey> HeldKeys;
+	TSet<FKey> HeldButtons;
+	FVector2D CursorPosition = FVector2D::ZeroVector;
+};
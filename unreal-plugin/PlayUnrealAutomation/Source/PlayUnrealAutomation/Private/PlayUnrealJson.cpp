@@ -0,0 +1,51 @@
+// PlayUnrealJson.cpp
+
+#include "PlayUnrealJson.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+
+namespace PlayUnrealJson
+{
+	using FCondensedWriter = TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>;
+	using FCondensedWriterFactory = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>;
+
+	FString ToString(const TSharedRef<FJsonObject>& Object)
+	{
+		FString Out;
+		TSharedRef<FCondensedWriter> Writer = FCondensedWriterFactory::Create(&Out);
+		FJsonSerializer::Serialize(Object, Writer);
+		return Out;
+	}
+
+	FString ValueToString(const TSharedPtr<FJsonValue>& Value)
+	{
+		if (!Value.IsValid()) return TEXT("null");
+
+		// The serializer only writes bare values when given an identifier-less
+		// root, which requires the value to be wrapped in a shared ref.
+		FString Out;
+		TSharedRef<FCondensedWriter> Writer = FCondensedWriterFactory::Create(&Out);
+		FJsonSerializer::Serialize(Value.ToSharedRef(), FString(), Writer);
+		return Out;
+	}
+
+	TSharedPtr<FJsonObject> ParseObject(const FString& Text)
+	{
+		TSharedPtr<FJsonObject> Object;
+		TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Text);
+		if (!FJsonSerializer::Deserialize(Reader, Object))
+		{
+			return nullptr;
+		}
+		return Object;
+	}
+
+	FString Error(const FString& Message)
+	{
+		TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+		Object->SetBoolField(TEXT("ok"), false);
+		Object->SetStringField(TEXT("error"), Message);
+		return ToString(Object);
+	}
+}
@@ -0,0 +1,26 @@
+// PlayUnrealJson.h
+//
+// Small JSON helpers shared by the driver and the plugin's servers.
+// All responses are condensed (no whitespace) to keep payloads small.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FJsonObject;
+class FJsonValue;
+
+namespace PlayUnrealJson
+{
+	/** Serialize an object to a condensed JSON string. */
+	FString ToString(const TSharedRef<FJsonObject>& Object);
+
+	/** Serialize a single value (of any JSON type) to a condensed string. */
+	FString ValueToString(const TSharedPtr<FJsonValue>& Value);
+
+	/** Parse a JSON object, returning null if Text is not an object. */
+	TSharedPtr<FJsonObject> ParseObject(const FString& Text);
+
+	/** Build the standard {"ok": false, "error": "..."} response. */
+	FString Error(const FString& Message);
+}
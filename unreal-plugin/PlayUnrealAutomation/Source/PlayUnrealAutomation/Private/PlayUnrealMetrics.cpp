@@ -0,0 +1,110 @@
+// PlayUnrealMetrics.cpp
+
+#include "PlayUnrealMetrics.h"
+#include "Dom/JsonObject.h"
+#include "Misc/ScopeLock.h"
+
+UE_TRACE_CHANNEL_DEFINE(PlayUnrealChannel);
+
+/** 2^(1/5): five buckets per doubling, 20 doublings from 1 us to ~1 s. */
+static const double HistogramGrowth = FMath::Pow(2.0, 0.2);
+static const double HistogramLogGrowth = FMath::Loge(HistogramGrowth);
+
+void FPlayUnrealLatencyHistogram::Add(double Seconds)
+{
+	int32 Bucket = 0;
+	if (Seconds > MinSeconds)
+	{
+		Bucket = FMath::Min(NumBuckets - 1,
+			FMath::FloorToInt32(FMath::Loge(Seconds / MinSeconds) / HistogramLogGrowth));
+	}
+	++Buckets[Bucket];
+	++Count;
+	Sum += Seconds;
+	Max = FMath::Max(Max, Seconds);
+}
+
+double FPlayUnrealLatencyHistogram::Percentile(double Fraction) const
+{
+	if (Count == 0) return 0.0;
+
+	const uint64 Rank = FMath::Max<uint64>(1, static_cast<uint64>(FMath::CeilToDouble(Fraction * Count)));
+	uint64 Seen = 0;
+	for (int32 Bucket = 0; Bucket < NumBuckets; ++Bucket)
+	{
+		Seen += Buckets[Bucket];
+		if (Seen >= Rank)
+		{
+			// Geometric middle of the bucket, never above the largest sample.
+			const double Middle = MinSeconds * FMath::Pow(HistogramGrowth, Bucket + 0.5);
+			return FMath::Min(Middle, Max);
+		}
+	}
+	return Max;
+}
+
+TSharedRef<FJsonObject> FPlayUnrealLatencyHistogram::ToJson() const
+{
+	TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+	Object->SetNumberField(TEXT("count"), static_cast<double>(Count));
+	Object->SetNumberField(TEXT("mean"), GetMean() * 1000.0);
+	Object->SetNumberField(TEXT("max"), Max * 1000.0);
+	Object->SetNumberField(TEXT("p50"), Percentile(0.50) * 1000.0);
+	Object->SetNumberField(TEXT("p95"), Percentile(0.95) * 1000.0);
+	Object->SetNumberField(TEXT("p99"), Percentile(0.99) * 1000.0);
+	return Object;
+}
+
+void FPlayUnrealMetrics::RecordCall(FName Method, double Seconds)
+{
+	FScopeLock ScopeLock(&Lock);
+	Methods.FindOrAdd(Method).Exec.Add(Seconds);
+}
+
+void FPlayUnrealMetrics::RecordQueueDelay(FName Method, double Seconds)
+{
+	FScopeLock ScopeLock(&Lock);
+	Methods.FindOrAdd(Method).Queue.Add(Seconds);
+}
+
+TSharedRef<FJsonObject> FPlayUnrealMetrics::ToJson() const
+{
+	TSharedRef<FJsonObject> MethodsObject = MakeShared<FJsonObject>();
+	{
+		FScopeLock ScopeLock(&Lock);
+		for (const TPair<FName, FMethodStats>& Pair : Methods)
+		{
+			TSharedRef<FJsonObject> Entry = Pair.Value.Exec.ToJson();
+			if (Pair.Value.Queue.GetCount() > 0)
+			{
+				Entry->SetObjectField(TEXT("queue"), Pair.Value.Queue.ToJson());
+			}
+			MethodsObject->SetObjectField(Pair.Key.ToString(), Entry);
+		}
+	}
+
+	TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+	Object->SetStringField(TEXT("unit"), TEXT("ms"));
+	Object->SetObjectField(TEXT("methods"), MethodsObject);
+	return Object;
+}
+
+void FPlayUnrealMetrics::Reset()
+{
+	FScopeLock ScopeLock(&Lock);
+	Methods.Reset();
+}
+
+#if STATS
+TStatId FPlayUnrealMetrics::GetStatId(FName Method)
+{
+	FScopeLock ScopeLock(&Lock);
+	if (const TStatId* Found = StatIds.Find(Method))
+	{
+		return *Found;
+	}
+	const TStatId StatId = FDynamicStats::CreateStatId<FStatGroup_STATGROUP_PlayUnreal>(Method.ToString());
+	StatIds.Add(Method, StatId);
+	return StatId;
+}
+#endif
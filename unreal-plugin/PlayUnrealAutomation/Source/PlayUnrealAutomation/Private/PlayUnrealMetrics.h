@@ -0,0 +1,81 @@
+// PlayUnrealMetrics.h
+//
+// Per-method call counts and latency histograms for driver UFUNCTIONs.
+// Execution time is measured around ProcessEvent on the game thread; queue
+// delay is recorded by whoever knows when a call arrived (batches now, the
+// plugin's own transports later). The same calls also show up under
+// "stat PlayUnreal" and on the PlayUnreal Insights trace channel.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+
+class FJsonObject;
+
+DECLARE_STATS_GROUP(TEXT("PlayUnreal"), STATGROUP_PlayUnreal, STATCAT_Advanced);
+
+UE_TRACE_CHANNEL_EXTERN(PlayUnrealChannel);
+
+/** Log-bucketed latency histogram; percentiles are accurate to ~10%. */
+class FPlayUnrealLatencyHistogram
+{
+public:
+	/** Bucket i covers [MinSeconds * Growth^i, MinSeconds * Growth^(i+1)). */
+	static constexpr int32 NumBuckets = 100;
+	static constexpr double MinSeconds = 1e-6;
+
+	void Add(double Seconds);
+
+	/** Latency in seconds below which Fraction (0..1) of samples fall. */
+	double Percentile(double Fraction) const;
+
+	uint64 GetCount() const { return Count; }
+	double GetMean() const { return Count ? Sum / Count : 0.0; }
+	double GetMax() const { return Max; }
+
+	/** {"count", "mean", "max", "p50", "p95", "p99"} in milliseconds. */
+	TSharedRef<FJsonObject> ToJson() const;
+
+private:
+	uint32 Buckets[NumBuckets] = {};
+	uint64 Count = 0;
+	double Sum = 0.0;
+	double Max = 0.0;
+};
+
+class FPlayUnrealMetrics
+{
+public:
+	/** Record the game-thread execution time of one call. */
+	void RecordCall(FName Method, double Seconds);
+
+	/** Record how long a call waited between arrival and dispatch. */
+	void RecordQueueDelay(FName Method, double Seconds);
+
+	/** {"unit": "ms", "methods": {Name: {..., "queue": {...}}}}. */
+	TSharedRef<FJsonObject> ToJson() const;
+
+	void Reset();
+
+#if STATS
+	/** Per-method cycle stat in STATGROUP_PlayUnreal, created on first use. */
+	TStatId GetStatId(FName Method);
+#endif
+
+private:
+	struct FMethodStats
+	{
+		FPlayUnrealLatencyHistogram Exec;
+		FPlayUnrealLatencyHistogram Queue;
+	};
+
+	mutable FCriticalSection Lock;
+	TMap<FName, FMethodStats> Methods;
+
+#if STATS
+	TMap<FName, TStatId> StatIds;
+#endif
+};
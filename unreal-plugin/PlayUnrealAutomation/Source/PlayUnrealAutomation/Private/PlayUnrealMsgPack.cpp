@@ -0,0 +1,545 @@
+// PlayUnrealMsgPack.cpp
+
+#include "PlayUnrealMsgPack.h"
+#include "Dom/JsonObject.h"
+#include "JsonObjectConverter.h"
+#include "Misc/Base64.h"
+#include "Serialization/JsonReader.h"
+#include "UObject/EnumProperty.h"
+#include "UObject/TextProperty.h"
+#include "UObject/UnrealType.h"
+
+const TCHAR* FPlayUnrealMsgPackWriter::WirePrefix = TEXT("msgpack:");
+
+void FPlayUnrealMsgPackWriter::WriteBigEndian(uint64 Value, int32 NumBytes)
+{
+	for (int32 Shift = (NumBytes - 1) * 8; Shift >= 0; Shift -= 8)
+	{
+		WriteByte(static_cast<uint8>(Value >> Shift));
+	}
+}
+
+void FPlayUnrealMsgPackWriter::WriteNil()
+{
+	WriteByte(0xc0);
+}
+
+void FPlayUnrealMsgPackWriter::WriteBool(bool bValue)
+{
+	WriteByte(bValue ? 0xc3 : 0xc2);
+}
+
+void FPlayUnrealMsgPackWriter::WriteNumber(double Value)
+{
+	// JSON numbers are doubles; integral ones go out as the smallest int.
+	if (FMath::IsFinite(Value) && Value == FMath::FloorToDouble(Value)
+		&& Value >= -9.2e18 && Value <= 9.2e18)
+	{
+		WriteInt(static_cast<int64>(Value));
+		return;
+	}
+	uint64 Bits;
+	FMemory::Memcpy(&Bits, &Value, sizeof(Bits));
+	WriteByte(0xcb);
+	WriteBigEndian(Bits, 8);
+}
+
+void FPlayUnrealMsgPackWriter::WriteInt(int64 Value)
+{
+	if (Value >= 0)
+	{
+		if (Value < 0x80)                { WriteByte(static_cast<uint8>(Value)); }
+		else if (Value <= MAX_uint8)     { WriteByte(0xcc); WriteBigEndian(Value, 1); }
+		else if (Value <= MAX_uint16)    { WriteByte(0xcd); WriteBigEndian(Value, 2); }
+		else if (Value <= MAX_uint32)    { WriteByte(0xce); WriteBigEndian(Value, 4); }
+		else                             { WriteByte(0xcf); WriteBigEndian(Value, 8); }
+	}
+	else
+	{
+		if (Value >= -32)                { WriteByte(static_cast<uint8>(static_cast<int8>(Value))); }
+		else if (Value >= MIN_int8)      { WriteByte(0xd0); WriteBigEndian(static_cast<uint64>(Value), 1); }
+		else if (Value >= MIN_int16)     { WriteByte(0xd1); WriteBigEndian(static_cast<uint64>(Value), 2); }
+		else if (Value >= MIN_int32)     { WriteByte(0xd2); WriteBigEndian(static_cast<uint64>(Value), 4); }
+		else                             { WriteByte(0xd3); WriteBigEndian(static_cast<uint64>(Value), 8); }
+	}
+}
+
+void FPlayUnrealMsgPackWriter::WriteString(const FString& Value)
+{
+	FTCHARToUTF8 Utf8(*Value);
+	const uint32 Length = Utf8.Length();
+	if (Length < 32)                     { WriteByte(0xa0 | static_cast<uint8>(Length)); }
+	else if (Length <= MAX_uint8)        { WriteByte(0xd9); WriteBigEndian(Length, 1); }
+	else if (Length <= MAX_uint16)       { WriteByte(0xda); WriteBigEndian(Length, 2); }
+	else                                 { WriteByte(0xdb); WriteBigEndian(Length, 4); }
+	Bytes.Append(reinterpret_cast<const uint8*>(Utf8.Get()), Length);
+}
+
+void FPlayUnrealMsgPackWriter::WriteBinary(const uint8* Data, uint32 Length)
+{
+	if (Length <= MAX_uint8)             { WriteByte(0xc4); WriteBigEndian(Length, 1); }
+	else if (Length <= MAX_uint16)       { WriteByte(0xc5); WriteBigEndian(Length, 2); }
+	else                                 { WriteByte(0xc6); WriteBigEndian(Length, 4); }
+	Bytes.Append(Data, Length);
+}
+
+void FPlayUnrealMsgPackWriter::WriteArrayHeader(uint32 Count)
+{
+	if (Count < 16)                      { WriteByte(0x90 | static_cast<uint8>(Count)); }
+	else if (Count <= MAX_uint16)        { WriteByte(0xdc); WriteBigEndian(Count, 2); }
+	else                                 { WriteByte(0xdd); WriteBigEndian(Count, 4); }
+}
+
+void FPlayUnrealMsgPackWriter::WriteMapHeader(uint32 Count)
+{
+	if (Count < 16)                      { WriteByte(0x80 | static_cast<uint8>(Count)); }
+	else if (Count <= MAX_uint16)        { WriteByte(0xde); WriteBigEndian(Count, 2); }
+	else                                 { WriteByte(0xdf); WriteBigEndian(Count, 4); }
+}
+
+void FPlayUnrealMsgPackWriter::WriteValue(const TSharedPtr<FJsonValue>& Value)
+{
+	if (!Value.IsValid())
+	{
+		WriteNil();
+		return;
+	}
+
+	switch (Value->Type)
+	{
+	case EJson::Boolean:
+		WriteBool(Value->AsBool());
+		break;
+	case EJson::Number:
+		WriteNumber(Value->AsNumber());
+		break;
+	case EJson::String:
+		WriteString(Value->AsString());
+		break;
+	case EJson::Array:
+	{
+		const TArray<TSharedPtr<FJsonValue>>& Array = Value->AsArray();
+		WriteArrayHeader(Array.Num());
+		for (const TSharedPtr<FJsonValue>& Element : Array)
+		{
+			WriteValue(Element);
+		}
+		break;
+	}
+	case EJson::Object:
+		WriteObject(Value->AsObject());
+		break;
+	default:
+		WriteNil();
+		break;
+	}
+}
+
+void FPlayUnrealMsgPackWriter::WriteObject(const TSharedPtr<FJsonObject>& Object)
+{
+	if (!Object.IsValid())
+	{
+		WriteNil();
+		return;
+	}
+
+	WriteMapHeader(Object->Values.Num());
+	for (const TPair<FString, TSharedPtr<FJsonValue>>& Pair : Object->Values)
+	{
+		WriteString(Pair.Key);
+		WriteValue(Pair.Value);
+	}
+}
+
+// ---------------------------------------------------------------------------
+// JSON text
+// ---------------------------------------------------------------------------
+
+/** Placeholder size for a container header: map32/array32, the largest. */
+static constexpr int32 ContainerPlaceholderSize = 5;
+
+void FPlayUnrealMsgPackWriter::PatchContainerHeader(int32 Offset, uint32 Count, bool bMap)
+{
+	FPlayUnrealMsgPackWriter Header;
+	if (bMap)
+	{
+		Header.WriteMapHeader(Count);
+	}
+	else
+	{
+		Header.WriteArrayHeader(Count);
+	}
+	const int32 HeaderSize = Header.Bytes.Num();
+	FMemory::Memcpy(Bytes.GetData() + Offset, Header.Bytes.GetData(), HeaderSize);
+	// The elements follow the placeholder; close the gap a smaller header leaves.
+	if (HeaderSize < ContainerPlaceholderSize)
+	{
+		Bytes.RemoveAt(Offset + HeaderSize, ContainerPlaceholderSize - HeaderSize, EAllowShrinking::No);
+	}
+}
+
+bool FPlayUnrealMsgPackWriter::WriteJsonText(const FString& Text)
+{
+	struct FContainer
+	{
+		int32 Offset;
+		uint32 Count;
+		bool bMap;
+	};
+
+	const int32 Start = Bytes.Num();
+	TArray<FContainer, TInlineAllocator<16>> Open;
+	bool bDone = false;
+
+	// Counts are unknown until a container closes, so each one starts with
+	// a placeholder header that is patched to its final size on close.
+	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Text);
+	EJsonNotation Notation;
+	while (!bDone && Reader->ReadNext(Notation))
+	{
+		if (Notation == EJsonNotation::ObjectEnd || Notation == EJsonNotation::ArrayEnd)
+		{
+			if (Open.IsEmpty()) break;
+			const FContainer Closed = Open.Pop(EAllowShrinking::No);
+			PatchContainerHeader(Closed.Offset, Closed.Count, Closed.bMap);
+			bDone = Open.IsEmpty();
+			continue;
+		}
+		if (Notation == EJsonNotation::Error) break;
+
+		if (!Open.IsEmpty())
+		{
+			++Open.Last().Count;
+			if (Open.Last().bMap)
+			{
+				WriteString(Reader->GetIdentifier());
+			}
+		}
+
+		switch (Notation)
+		{
+		case EJsonNotation::ObjectStart:
+		case EJsonNotation::ArrayStart:
+			Open.Add({ Bytes.Num(), 0, Notation == EJsonNotation::ObjectStart });
+			Bytes.AddUninitialized(ContainerPlaceholderSize);
+			break;
+		case EJsonNotation::Boolean:
+			WriteBool(Reader->GetValueAsBoolean());
+			break;
+		case EJsonNotation::String:
+			WriteString(Reader->GetValueAsString());
+			break;
+		case EJsonNotation::Number:
+			WriteNumber(Reader->GetValueAsNumber());
+			break;
+		default:
+			WriteNil();
+			break;
+		}
+		bDone = Open.IsEmpty();
+	}
+
+	if (!bDone || !Reader->GetErrorMessage().IsEmpty())
+	{
+		Bytes.SetNum(Start, EAllowShrinking::No);
+		return false;
+	}
+	return true;
+}
+
+// ---------------------------------------------------------------------------
+// Properties
+// ---------------------------------------------------------------------------
+
+void FPlayUnrealMsgPackWriter::WriteProperty(const FProperty* Property, const void* Value)
+{
+	if (Property->ArrayDim == 1)
+	{
+		WritePropertyElement(Property, Value);
+		return;
+	}
+
+	// Static arrays are JSON arrays too.
+	WriteArrayHeader(Property->ArrayDim);
+	for (int32 Index = 0; Index < Property->ArrayDim; ++Index)
+	{
+		WritePropertyElement(Property, static_cast<const uint8*>(Value) + Index * Property->ElementSize);
+	}
+}
+
+void FPlayUnrealMsgPackWriter::WritePropertyElement(const FProperty* Property, const void* Value)
+{
+	if (const FBoolProperty* Bool = CastField<FBoolProperty>(Property))
+	{
+		WriteBool(Bool->GetPropertyValue(Value));
+	}
+	else if (const FEnumProperty* EnumProperty = CastField<FEnumProperty>(Property))
+	{
+		const int64 Raw = EnumProperty->GetUnderlyingProperty()->GetSignedIntPropertyValue(Value);
+		WriteString(EnumProperty->GetEnum()->GetNameStringByValue(Raw));
+	}
+	else if (const FNumericProperty* Numeric = CastField<FNumericProperty>(Property))
+	{
+		if (const UEnum* Enum = Numeric->GetIntPropertyEnum())
+		{
+			WriteString(Enum->GetNameStringByValue(Numeric->GetSignedIntPropertyValue(Value)));
+		}
+		else if (Numeric->IsFloatingPoint())
+		{
+			WriteNumber(Numeric->GetFloatingPointPropertyValue(Value));
+		}
+		else
+		{
+			WriteInt(Numeric->GetSignedIntPropertyValue(Value));
+		}
+	}
+	else if (const FStrProperty* Str = CastField<FStrProperty>(Property))
+	{
+		WriteString(Str->GetPropertyValue(Value));
+	}
+	else if (const FNameProperty* Name = CastField<FNameProperty>(Property))
+	{
+		WriteString(Name->GetPropertyValue(Value).ToString());
+	}
+	else if (const FTextProperty* TextProperty = CastField<FTextProperty>(Property))
+	{
+		WriteString(TextProperty->GetPropertyValue(Value).ToString());
+	}
+	else if (const FArrayProperty* Array = CastField<FArrayProperty>(Property))
+	{
+		FScriptArrayHelper Helper(Array, Value);
+		WriteArrayHeader(Helper.Num());
+		for (int32 Index = 0; Index < Helper.Num(); ++Index)
+		{
+			WriteProperty(Array->Inner, Helper.GetRawPtr(Index));
+		}
+	}
+	else if (const FSetProperty* Set = CastField<FSetProperty>(Property))
+	{
+		FScriptSetHelper Helper(Set, Value);
+		WriteArrayHeader(Helper.Num());
+		for (int32 Index = 0; Index < Helper.GetMaxIndex(); ++Index)
+		{
+			if (Helper.IsValidIndex(Index))
+			{
+				WriteProperty(Set->ElementProp, Helper.GetElementPtr(Index));
+			}
+		}
+	}
+	else if (const FMapProperty* Map = CastField<FMapProperty>(Property))
+	{
+		// JSON object keys are strings: export non-string keys as text.
+		FScriptMapHelper Helper(Map, Value);
+		WriteMapHeader(Helper.Num());
+		for (int32 Index = 0; Index < Helper.GetMaxIndex(); ++Index)
+		{
+			if (!Helper.IsValidIndex(Index)) continue;
+
+			const void* Key = Helper.GetKeyPtr(Index);
+			if (CastField<FStrProperty>(Map->KeyProp) || CastField<FNameProperty>(Map->KeyProp))
+			{
+				WriteProperty(Map->KeyProp, Key);
+			}
+			else
+			{
+				FString KeyText;
+				Map->KeyProp->ExportTextItem_Direct(KeyText, Key, nullptr, nullptr, PPF_None);
+				WriteString(KeyText);
+			}
+			WriteProperty(Map->ValueProp, Helper.GetValuePtr(Index));
+		}
+	}
+	else if (const FStructProperty* Struct = CastField<FStructProperty>(Property))
+	{
+		uint32 Count = 0;
+		for (TFieldIterator<FProperty> It(Struct->Struct); It; ++It)
+		{
+			++Count;
+		}
+		WriteMapHeader(Count);
+		for (TFieldIterator<FProperty> It(Struct->Struct); It; ++It)
+		{
+			WriteString(FJsonObjectConverter::StandardizeCase(It->GetAuthoredName()));
+			WriteProperty(*It, It->ContainerPtrToValuePtr<void>(Value));
+		}
+	}
+	else if (const FObjectPropertyBase* ObjectProperty = CastField<FObjectPropertyBase>(Property))
+	{
+		const UObject* Object = ObjectProperty->GetObjectPropertyValue(Value);
+		if (Object)
+		{
+			WriteString(Object->GetPathName());
+		}
+		else
+		{
+			WriteNil();
+		}
+	}
+	else
+	{
+		// Anything rarer (interfaces, delegates, field paths) as the JSON
+		// converter writes it.
+		WriteValue(FJsonObjectConverter::UPropertyToJsonValue(const_cast<FProperty*>(Property), Value));
+	}
+}
+
+FString FPlayUnrealMsgPackWriter::ToWireString() const
+{
+	return WirePrefix + FBase64::Encode(Bytes);
+}
+
+// ---------------------------------------------------------------------------
+// Reader
+// ---------------------------------------------------------------------------
+
+/** Nesting beyond this is treated as malformed rather than recursed into. */
+static constexpr int32 MaxReadDepth = 64;
+
+TSharedPtr<FJsonValue> FPlayUnrealMsgPackReader::ParseWireString(const FString& Text)
+{
+	if (!Text.StartsWith(FPlayUnrealMsgPackWriter::WirePrefix, ESearchCase::CaseSensitive))
+	{
+		return nullptr;
+	}
+
+	TArray<uint8> Bytes;
+	if (!FBase64::Decode(Text.RightChop(FCString::Strlen(FPlayUnrealMsgPackWriter::WirePrefix)), Bytes))
+	{
+		return nullptr;
+	}
+
+	FPlayUnrealMsgPackReader Reader(Bytes);
+	TSharedPtr<FJsonValue> Value = Reader.ReadValue(0);
+	return Reader.Offset == Bytes.Num() ? Value : nullptr;
+}
+
+bool FPlayUnrealMsgPackReader::ReadBigEndian(int32 NumBytes, uint64& OutValue)
+{
+	if (Offset + NumBytes > Bytes.Num()) return false;
+
+	OutValue = 0;
+	for (int32 Index = 0; Index < NumBytes; ++Index)
+	{
+		OutValue = (OutValue << 8) | Bytes[Offset++];
+	}
+	return true;
+}
+
+bool FPlayUnrealMsgPackReader::ReadUtf8(uint32 Length, FString& OutValue)
+{
+	if (Length > static_cast<uint32>(Bytes.Num() - Offset)) return false;
+
+	const FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(Bytes.GetData() + Offset), Length);
+	OutValue = FString::ConstructFromPtrSize(Converted.Get(), Converted.Length());
+	Offset += Length;
+	return true;
+}
+
+TSharedPtr<FJsonValue> FPlayUnrealMsgPackReader::ReadValue(int32 Depth)
+{
+	if (Depth > MaxReadDepth || Offset >= Bytes.Num()) return nullptr;
+
+	const uint8 Code = Bytes[Offset++];
+	uint64 Raw = 0;
+	uint32 Length = 0;
+	bool bMap = false;
+
+	if (Code < 0x80)                     { return MakeShared<FJsonValueNumber>(Code); }
+	if (Code >= 0xe0)                    { return MakeShared<FJsonValueNumber>(static_cast<int8>(Code)); }
+	if ((Code & 0xe0) == 0xa0)           { Length = Code & 0x1f; }
+	else if ((Code & 0xf0) == 0x90)      { Length = Code & 0x0f; }
+	else if ((Code & 0xf0) == 0x80)      { Length = Code & 0x0f; bMap = true; }
+
+	switch (Code)
+	{
+	case 0xc0: return MakeShared<FJsonValueNull>();
+	case 0xc2: return MakeShared<FJsonValueBoolean>(false);
+	case 0xc3: return MakeShared<FJsonValueBoolean>(true);
+	case 0xcc: case 0xcd: case 0xce: case 0xcf:
+		if (!ReadBigEndian(1 << (Code - 0xcc), Raw)) return nullptr;
+		return MakeShared<FJsonValueNumber>(static_cast<double>(Raw));
+	case 0xd0: case 0xd1: case 0xd2: case 0xd3:
+	{
+		const int32 NumBytes = 1 << (Code - 0xd0);
+		if (!ReadBigEndian(NumBytes, Raw)) return nullptr;
+		// Sign-extend from the encoded width.
+		const int32 Unused = 64 - NumBytes * 8;
+		return MakeShared<FJsonValueNumber>(static_cast<double>(static_cast<int64>(Raw << Unused) >> Unused));
+	}
+	case 0xca:
+	{
+		if (!ReadBigEndian(4, Raw)) return nullptr;
+		const uint32 Bits = static_cast<uint32>(Raw);
+		float Value;
+		FMemory::Memcpy(&Value, &Bits, sizeof(Value));
+		return MakeShared<FJsonValueNumber>(Value);
+	}
+	case 0xcb:
+	{
+		if (!ReadBigEndian(8, Raw)) return nullptr;
+		double Value;
+		FMemory::Memcpy(&Value, &Raw, sizeof(Value));
+		return MakeShared<FJsonValueNumber>(Value);
+	}
+	case 0xc4: case 0xc5: case 0xc6:
+	{
+		if (!ReadBigEndian(1 << (Code - 0xc4), Raw) || Raw > static_cast<uint64>(Bytes.Num() - Offset)) return nullptr;
+		const FString Encoded = FBase64::Encode(Bytes.GetData() + Offset, static_cast<uint32>(Raw));
+		Offset += static_cast<int32>(Raw);
+		return MakeShared<FJsonValueString>(Encoded);
+	}
+	case 0xd9: case 0xda: case 0xdb:
+		if (!ReadBigEndian(1 << (Code - 0xd9), Raw)) return nullptr;
+		Length = static_cast<uint32>(Raw);
+		break;
+	case 0xdc: case 0xdd:
+		if (!ReadBigEndian(2 << (Code - 0xdc), Raw)) return nullptr;
+		Length = static_cast<uint32>(Raw);
+		break;
+	case 0xde: case 0xdf:
+		if (!ReadBigEndian(2 << (Code - 0xde), Raw)) return nullptr;
+		Length = static_cast<uint32>(Raw);
+		bMap = true;
+		break;
+	default:
+		break;
+	}
+
+	if ((Code & 0xe0) == 0xa0 || (Code >= 0xd9 && Code <= 0xdb))
+	{
+		FString Value;
+		return ReadUtf8(Length, Value) ? MakeShared<FJsonValueString>(Value) : nullptr;
+	}
+	if ((Code & 0xf0) == 0x90 || Code == 0xdc || Code == 0xdd)
+	{
+		// Every element takes at least one byte, which bounds the reservation.
+		if (Length > static_cast<uint32>(Bytes.Num() - Offset)) return nullptr;
+		TArray<TSharedPtr<FJsonValue>> Array;
+		Array.Reserve(Length);
+		for (uint32 Index = 0; Index < Length; ++Index)
+		{
+			TSharedPtr<FJsonValue> Element = ReadValue(Depth + 1);
+			if (!Element.IsValid()) return nullptr;
+			Array.Add(Element);
+		}
+		return MakeShared<FJsonValueArray>(Array);
+	}
+	if (bMap)
+	{
+		TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+		for (uint32 Index = 0; Index < Length; ++Index)
+		{
+			// The writer only emits string keys.
+			TSharedPtr<FJsonValue> Key = ReadValue(Depth + 1);
+			FString KeyText;
+			if (!Key.IsValid() || !Key->TryGetString(KeyText)) return nullptr;
+			TSharedPtr<FJsonValue> Value = ReadValue(Depth + 1);
+			if (!Value.IsValid()) return nullptr;
+			Object->SetField(KeyText, Value);
+		}
+		return MakeShared<FJsonValueObject>(Object);
+	}
+
+	// 0xc1 and the extension types are never written.
+	return nullptr;
+}
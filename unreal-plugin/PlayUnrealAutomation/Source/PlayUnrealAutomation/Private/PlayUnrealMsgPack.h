@@ -0,0 +1,92 @@
+// PlayUnrealMsgPack.h
+//
+// MessagePack encoding for driver responses. Remote Control can only carry
+// a string ReturnValue, so encoded payloads travel as a prefixed base64
+// string: "msgpack:<base64>". Clients opt in with SetWireFormat.
+//
+// Large responses are written from their source data: property memory
+// (WriteProperty) and the JSON text game hooks return (WriteJsonText).
+// WriteValue/WriteObject cover the small responses built as JSON objects.
+// FPlayUnrealMsgPackReader turns an encoded response back into JSON values
+// for the engine's own use (session replay comparing results).
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FJsonValue;
+class FJsonObject;
+class FProperty;
+
+class FPlayUnrealMsgPackWriter
+{
+public:
+	/** Prefix that marks a response string as base64 MessagePack. */
+	static const TCHAR* WirePrefix;
+
+	void WriteNil();
+	void WriteBool(bool bValue);
+	void WriteNumber(double Value);
+	void WriteInt(int64 Value);
+	void WriteString(const FString& Value);
+	void WriteBinary(const uint8* Data, uint32 Length);
+	void WriteArrayHeader(uint32 Count);
+	void WriteMapHeader(uint32 Count);
+
+	/** Write a JSON value tree. */
+	void WriteValue(const TSharedPtr<FJsonValue>& Value);
+	void WriteObject(const TSharedPtr<FJsonObject>& Object);
+
+	/**
+	 * Transcode JSON text token by token, without building a DOM.
+	 *
+	 * @return  False, with nothing written, if Text is not valid JSON.
+	 */
+	bool WriteJsonText(const FString& Text);
+
+	/**
+	 * Write a property value straight from its memory, in the shape
+	 * FJsonObjectConverter gives it: structs as maps keyed by
+	 * standardized field names, enums by name, objects by path.
+	 */
+	void WriteProperty(const FProperty* Property, const void* Value);
+
+	const TArray<uint8>& GetBytes() const { return Bytes; }
+
+	/** The encoded bytes as "msgpack:<base64>". */
+	FString ToWireString() const;
+
+private:
+	void WriteByte(uint8 Byte) { Bytes.Add(Byte); }
+	void WriteBigEndian(uint64 Value, int32 NumBytes);
+
+	/** One element of a property, ignoring its static array dimension. */
+	void WritePropertyElement(const FProperty* Property, const void* Value);
+
+	/** Replace the 5-byte placeholder at Offset with the final header. */
+	void PatchContainerHeader(int32 Offset, uint32 Count, bool bMap);
+
+	TArray<uint8> Bytes;
+};
+
+class FPlayUnrealMsgPackReader
+{
+public:
+	/**
+	 * Decode a "msgpack:<base64>" response into the JSON value it encodes.
+	 * Binary values become base64 strings, as the JSON wire format sends them.
+	 *
+	 * @return  Null if Text is not an encoded response or is malformed.
+	 */
+	static TSharedPtr<FJsonValue> ParseWireString(const FString& Text);
+
+private:
+	explicit FPlayUnrealMsgPackReader(const TArray<uint8>& InBytes) : Bytes(InBytes) {}
+
+	TSharedPtr<FJsonValue> ReadValue(int32 Depth);
+	bool ReadBigEndian(int32 NumBytes, uint64& OutValue);
+	bool ReadUtf8(uint32 Length, FString& OutValue);
+
+	const TArray<uint8>& Bytes;
+	int32 Offset = 0;
+};
@@ -0,0 +1,316 @@
+// PlayUnrealPerfCapture.cpp
+
+#include "PlayUnrealPerfCapture.h"
+
+// Perf capture is only compiled with WITH_PLAYUNREAL_AUTOMATION.
+#if WITH_PLAYUNREAL_AUTOMATION
+
+#include "Dom/JsonObject.h"
+#include "DynamicRHI.h"
+#include "HAL/PlatformMemory.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "ProfilingDebugging/TraceAuxiliary.h"
+#include "RHI.h"
+#include "RenderCore.h"
+
+namespace
+{
+	constexpr int64 DefaultMaxFrames = 36000;
+	constexpr int64 MinMaxFrames = 60;
+	constexpr int64 MaxMaxFrames = 1 << 22;
+	/** GetStats() is too slow to call every frame on some platforms. */
+	constexpr uint64 MemorySampleFrames = 30;
+	constexpr double BytesPerMB = 1024.0 * 1024.0;
+
+	/** The trace records what a frame-time regression is usually chased with. */
+	const TCHAR* const TraceChannels = TEXT("cpu,gpu,frame,bookmark,PlayUnreal");
+
+	/**
+	 * Read an output option: true picks the default file, a string is a
+	 * path relative to Saved/ (or absolute). False when it is off.
+	 */
+	bool ReadOutputPath(const FJsonObject& Options, const TCHAR* Key, const FString& DefaultFile, FString& OutPath)
+	{
+		bool bEnabled = false;
+		FString Path;
+		if (Options.TryGetStringField(Key, Path) && !Path.IsEmpty())
+		{
+			bEnabled = true;
+		}
+		else if (Options.TryGetBoolField(Key, bEnabled) && bEnabled)
+		{
+			Path = FPaths::Combine(TEXT("PlayUnreal/Perf"), DefaultFile);
+		}
+		if (!bEnabled) return false;
+
+		OutPath = FPaths::IsRelative(Path) ? FPaths::Combine(FPaths::ProjectSavedDir(), Path) : Path;
+		return true;
+	}
+
+	/** {"mean", "p50", "p90", "p95", "p99", "max"} of Values, which get sorted. */
+	TSharedRef<FJsonObject> SummarizeTimes(TArray<float>& Values)
+	{
+		TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+		if (Values.IsEmpty()) return Object;
+
+		Values.Sort();
+		double Sum = 0.0;
+		for (const float Value : Values)
+		{
+			Sum += Value;
+		}
+
+		// Nearest rank, so a percentile is always a frame that happened.
+		const auto Percentile = [&Values](double Fraction)
+		{
+			const int32 Rank = FMath::CeilToInt32(Fraction * Values.Num());
+			return Values[FMath::Clamp(Rank - 1, 0, Values.Num() - 1)];
+		};
+		Object->SetNumberField(TEXT("mean"), Sum / Values.Num());
+		Object->SetNumberField(TEXT("p50"), Percentile(0.50));
+		Object->SetNumberField(TEXT("p90"), Percentile(0.90));
+		Object->SetNumberField(TEXT("p95"), Percentile(0.95));
+		Object->SetNumberField(TEXT("p99"), Percentile(0.99));
+		Object->SetNumberField(TEXT("max"), Values.Last());
+		return Object;
+	}
+
+	TSharedRef<FJsonObject> SummarizeCounts(const TArray<uint32>& Values)
+	{
+		uint64 Sum = 0;
+		uint32 Max = 0;
+		for (const uint32 Value : Values)
+		{
+			Sum += Value;
+			Max = FMath::Max(Max, Value);
+		}
+
+		TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+		Object->SetNumberField(TEXT("mean"), Values.IsEmpty() ? 0.0 : static_cast<double>(Sum) / Values.Num());
+		Object->SetNumberField(TEXT("max"), Max);
+		return Object;
+	}
+}
+
+FPlayUnrealPerfCapture::~FPlayUnrealPerfCapture()
+{
+	FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+#if UE_TRACE_ENABLED
+	if (bTraceStarted)
+	{
+		FTraceAuxiliary::Stop();
+	}
+#endif
+}
+
+TUniquePtr<FPlayUnrealPerfCapture> FPlayUnrealPerfCapture::Begin(const FJsonObject& Options, FString& OutError)
+{
+	TUniquePtr<FPlayUnrealPerfCapture> Capture(new FPlayUnrealPerfCapture());
+
+	if (!Options.TryGetStringField(TEXT("name"), Capture->Name) || Capture->Name.IsEmpty())
+	{
+		Capture->Name = TEXT("perf-") + FDateTime::Now().ToString(TEXT("%Y%m%d-%H%M%S"));
+	}
+
+	int64 MaxFrames = DefaultMaxFrames;
+	Options.TryGetNumberField(TEXT("maxFrames"), MaxFrames);
+	if (MaxFrames < MinMaxFrames || MaxFrames > MaxMaxFrames)
+	{
+		OutError = FString::Printf(TEXT("maxFrames must be between %lld and %lld"), MinMaxFrames, MaxMaxFrames);
+		return nullptr;
+	}
+
+	double HitchMs = Capture->HitchMs;
+	Options.TryGetNumberField(TEXT("hitchMs"), HitchMs);
+	if (!(HitchMs > 0.0))
+	{
+		OutError = TEXT("hitchMs must be positive");
+		return nullptr;
+	}
+	Capture->HitchMs = static_cast<float>(HitchMs);
+
+	ReadOutputPath(Options, TEXT("csv"), Capture->Name + TEXT(".csv"), Capture->CsvPath);
+
+	if (ReadOutputPath(Options, TEXT("trace"), Capture->Name + TEXT(".utrace"), Capture->TracePath))
+	{
+#if UE_TRACE_ENABLED
+		if (FTraceAuxiliary::IsConnected())
+		{
+			OutError = TEXT("An Insights trace is already running");
+			return nullptr;
+		}
+		if (!FTraceAuxiliary::Start(FTraceAuxiliary::EConnectionType::File, *Capture->TracePath, TraceChannels))
+		{
+			OutError = FString::Printf(TEXT("Cannot start a trace to %s"), *Capture->TracePath);
+			return nullptr;
+		}
+		Capture->bTraceStarted = true;
+#else
+		OutError = TEXT("Insights tracing is not compiled into this build");
+		return nullptr;
+#endif
+	}
+
+	// The whole ring up front, so sampling never allocates.
+	Capture->Capacity = MaxFrames;
+	Capture->Ring.SetNum(MaxFrames);
+
+	const FPlatformMemoryStats Memory = FPlatformMemory::GetStats();
+	Capture->StartUsedPhysical = Memory.UsedPhysical;
+	Capture->PeakUsedPhysical = Memory.UsedPhysical;
+	Capture->PeakUsedVirtual = Memory.UsedVirtual;
+	Capture->StartSeconds = FPlatformTime::Seconds();
+
+	Capture->EndFrameHandle = FCoreDelegates::OnEndFrame.AddRaw(Capture.Get(), &FPlayUnrealPerfCapture::OnEndFrame);
+	return Capture;
+}
+
+void FPlayUnrealPerfCapture::OnEndFrame()
+{
+	const double Now = FPlatformTime::Seconds();
+	if (LastFrameSeconds == 0.0)
+	{
+		// The frame Begin was called in only partly belongs to the capture.
+		LastFrameSeconds = Now;
+		return;
+	}
+
+	FFrame& Sample = Ring[NumCaptured % Capacity];
+	Sample.Frame = GFrameCounter;
+	Sample.FrameMs = static_cast<float>((Now - LastFrameSeconds) * 1000.0);
+	Sample.GameMs = FPlatformTime::ToMilliseconds(GGameThreadTime);
+	Sample.RenderMs = FPlatformTime::ToMilliseconds(GRenderThreadTime);
+	Sample.RhiMs = FPlatformTime::ToMilliseconds(GRHIThreadTime);
+	Sample.GpuMs = FPlatformTime::ToMilliseconds(RHIGetGPUFrameCycles(0));
+	Sample.DrawCalls = GNumDrawCallsRHI[0];
+	Sample.Primitives = GNumPrimitivesDrawnRHI[0];
+	LastFrameSeconds = Now;
+
+	Hitches += Sample.FrameMs > HitchMs ? 1 : 0;
+	if (++NumCaptured % MemorySampleFrames == 0)
+	{
+		SampleMemory();
+	}
+}
+
+void FPlayUnrealPerfCapture::SampleMemory()
+{
+	const FPlatformMemoryStats Memory = FPlatformMemory::GetStats();
+	PeakUsedPhysical = FMath::Max<uint64>(PeakUsedPhysical, Memory.UsedPhysical);
+	PeakUsedVirtual = FMath::Max<uint64>(PeakUsedVirtual, Memory.UsedVirtual);
+}
+
+void FPlayUnrealPerfCapture::GetFrames(TArray<FFrame>& OutFrames) const
+{
+	const int64 Num = GetNumFrames();
+	const int64 Oldest = NumCaptured - Num;
+	OutFrames.Reset(Num);
+	for (int64 Index = Oldest; Index < NumCaptured; ++Index)
+	{
+		OutFrames.Add(Ring[Index % Capacity]);
+	}
+}
+
+bool FPlayUnrealPerfCapture::WriteCsv(const TArray<FFrame>& Frames, FString& OutError) const
+{
+	FString Csv = TEXT("frame,frameMs,gameMs,renderMs,rhiMs,gpuMs,drawCalls,primitives\n");
+	for (const FFrame& Frame : Frames)
+	{
+		Csv += FString::Printf(TEXT("%llu,%.3f,%.3f,%.3f,%.3f,%.3f,%u,%u\n"), Frame.Frame, Frame.FrameMs,
+			Frame.GameMs, Frame.RenderMs, Frame.RhiMs, Frame.GpuMs, Frame.DrawCalls, Frame.Primitives);
+	}
+
+	if (!FFileHelper::SaveStringToFile(Csv, *CsvPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+	{
+		OutError = FString::Printf(TEXT("Cannot write %s"), *CsvPath);
+		return false;
+	}
+	return true;
+}
+
+TSharedRef<FJsonObject> FPlayUnrealPerfCapture::End()
+{
+	FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+	EndFrameHandle.Reset();
+	SampleMemory();
+	const uint64 EndUsedPhysical = FPlatformMemory::GetStats().UsedPhysical;
+
+	TArray<FFrame> Frames;
+	GetFrames(Frames);
+
+	TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+	Object->SetStringField(TEXT("name"), Name);
+	Object->SetNumberField(TEXT("frames"), Frames.Num());
+	Object->SetNumberField(TEXT("dropped"), static_cast<double>(NumCaptured - Frames.Num()));
+	Object->SetNumberField(TEXT("seconds"), FPlatformTime::Seconds() - StartSeconds);
+	Object->SetNumberField(TEXT("hitches"), Hitches);
+	Object->SetNumberField(TEXT("hitchMs"), HitchMs);
+
+	// One column at a time, so only one scratch array is alive.
+	TArray<float> Times;
+	Times.Reserve(Frames.Num());
+	const auto AddTimes = [&Frames, &Times, &Object](const TCHAR* Key, float FFrame::*Field)
+	{
+		Times.Reset();
+		for (const FFrame& Frame : Frames)
+		{
+			Times.Add(Frame.*Field);
+		}
+		Object->SetObjectField(Key, SummarizeTimes(Times));
+	};
+	AddTimes(TEXT("frame"), &FFrame::FrameMs);
+	AddTimes(TEXT("game"), &FFrame::GameMs);
+	AddTimes(TEXT("render"), &FFrame::RenderMs);
+	AddTimes(TEXT("rhi"), &FFrame::RhiMs);
+	AddTimes(TEXT("gpu"), &FFrame::GpuMs);
+
+	TArray<uint32> Counts;
+	Counts.Reserve(Frames.Num());
+	for (const FFrame& Frame : Frames)
+	{
+		Counts.Add(Frame.DrawCalls);
+	}
+	Object->SetObjectField(TEXT("drawCalls"), SummarizeCounts(Counts));
+	Counts.Reset();
+	for (const FFrame& Frame : Frames)
+	{
+		Counts.Add(Frame.Primitives);
+	}
+	Object->SetObjectField(TEXT("primitives"), SummarizeCounts(Counts));
+
+	TSharedRef<FJsonObject> Memory = MakeShared<FJsonObject>();
+	Memory->SetNumberField(TEXT("peakUsedMB"), PeakUsedPhysical / BytesPerMB);
+	Memory->SetNumberField(TEXT("peakVirtualMB"), PeakUsedVirtual / BytesPerMB);
+	Memory->SetNumberField(TEXT("startUsedMB"), StartUsedPhysical / BytesPerMB);
+	Memory->SetNumberField(TEXT("endUsedMB"), EndUsedPhysical / BytesPerMB);
+	Object->SetObjectField(TEXT("memory"), Memory);
+
+	if (!CsvPath.IsEmpty())
+	{
+		FString Error;
+		if (WriteCsv(Frames, Error))
+		{
+			Object->SetStringField(TEXT("csv"), CsvPath);
+		}
+		else
+		{
+			UE_LOG(LogTemp, Warning, TEXT("PlayUnreal: %s"), *Error);
+		}
+	}
+
+#if UE_TRACE_ENABLED
+	if (bTraceStarted)
+	{
+		FTraceAuxiliary::Stop();
+		bTraceStarted = false;
+		Object->SetStringField(TEXT("trace"), TracePath);
+	}
+#endif
+	return Object;
+}
+
+#endif // WITH_PLAYUNREAL_AUTOMATION
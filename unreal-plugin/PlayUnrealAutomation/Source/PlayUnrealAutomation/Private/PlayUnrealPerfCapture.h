@@ -0,0 +1,96 @@
+// PlayUnrealPerfCapture.h
+//
+// Frame timing capture for performance gates. Between Begin and End, every
+// frame's timings are sampled at the end of the frame into a fixed-size
+// ring buffer: wall-clock frame time, game, render and RHI thread times,
+// GPU time, and RHI draw calls and primitives. Memory is sampled every
+// few frames for high-water marks. End summarizes the frames with exact
+// percentiles and can write them as CSV. Begin can also start an Unreal
+// Insights file trace covering the same frames.
+//
+// Thread and GPU times are the engine's stat unit values (GGameThreadTime
+// and friends). They lag the wall-clock frame by a frame or two, as in
+// "stat unit".
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FJsonObject;
+
+class FPlayUnrealPerfCapture
+{
+public:
+	~FPlayUnrealPerfCapture();
+
+	/**
+	 * Start capturing from the next frame.
+	 *
+	 * Options: {"name": label for files, "maxFrames": ring size (36000),
+	 * "hitchMs": frames slower than this count as hitches (50),
+	 * "csv": true or a path, "trace": true or a path}. Paths are
+	 * relative to Saved/; true picks PlayUnreal/Perf/<name>.csv/.utrace.
+	 *
+	 * @return  Null with a reason in OutError if the options are malformed.
+	 */
+	static TUniquePtr<FPlayUnrealPerfCapture> Begin(const FJsonObject& Options, FString& OutError);
+
+	/**
+	 * Stop capturing and summarize: {"name", "frames", "dropped", "seconds",
+	 * "hitches", "hitchMs", "frame", "game", "render", "rhi", "gpu" (each
+	 * {"mean", "p50", "p90", "p95", "p99", "max"} in ms), "drawCalls",
+	 * "primitives" ({"mean", "max"}), "memory" ({"peakUsedMB",
+	 * "peakVirtualMB", "startUsedMB", "endUsedMB"}), "csv"?, "trace"?}.
+	 * Stops the trace and writes the CSV if they were requested.
+	 */
+	TSharedRef<FJsonObject> End();
+
+	const FString& GetName() const { return Name; }
+	int32 GetNumFrames() const { return FMath::Min<int64>(NumCaptured, Capacity); }
+
+private:
+	FPlayUnrealPerfCapture() = default;
+
+	/** One frame's sample. Times are in milliseconds. */
+	struct FFrame
+	{
+		uint64 Frame = 0;
+		float FrameMs = 0.0f;
+		float GameMs = 0.0f;
+		float RenderMs = 0.0f;
+		float RhiMs = 0.0f;
+		float GpuMs = 0.0f;
+		uint32 DrawCalls = 0;
+		uint32 Primitives = 0;
+	};
+
+	void OnEndFrame();
+	void SampleMemory();
+
+	/** Frames in capture order, oldest first. */
+	void GetFrames(TArray<FFrame>& OutFrames) const;
+
+	bool WriteCsv(const TArray<FFrame>& Frames, FString& OutError) const;
+
+	FString Name;
+	int64 Capacity = 0;
+	float HitchMs = 50.0f;
+
+	/** Ring buffer; the next sample goes to NumCaptured % Capacity. */
+	TArray<FFrame> Ring;
+	int64 NumCaptured = 0;
+	int32 Hitches = 0;
+
+	double StartSeconds = 0.0;
+	double LastFrameSeconds = 0.0;
+
+	uint64 StartUsedPhysical = 0;
+	uint64 PeakUsedPhysical = 0;
+	uint64 PeakUsedVirtual = 0;
+
+	FString CsvPath;
+	FString TracePath;
+	bool bTraceStarted = false;
+
+	FDelegateHandle EndFrameHandle;
+};
@@ -0,0 +1,143 @@
+// PlayUnrealPropertyWatch.cpp
+
+#include "PlayUnrealPropertyWatch.h"
+#include "Dom/JsonObject.h"
+#include "Dom/JsonValue.h"
+#include "JsonObjectConverter.h"
+#include "UObject/UObjectGlobals.h"
+
+FPlayUnrealPropertyWatch::~FPlayUnrealPropertyWatch()
+{
+	for (FEntry& Entry : Entries)
+	{
+		ReleaseCopy(Entry);
+	}
+}
+
+TUniquePtr<FPlayUnrealPropertyWatch> FPlayUnrealPropertyWatch::Create(const TArray<TSharedPtr<FJsonValue>>& Entries,
+                                                                     FString& OutError)
+{
+	TUniquePtr<FPlayUnrealPropertyWatch> Watch(new FPlayUnrealPropertyWatch());
+	TSet<FString> Keys;
+	for (const TSharedPtr<FJsonValue>& Value : Entries)
+	{
+		const TSharedPtr<FJsonObject>* Description = nullptr;
+		FEntry Entry;
+		FString Property;
+		if (!Value.IsValid() || !Value->TryGetObject(Description)
+			|| !(*Description)->TryGetStringField(TEXT("object"), Entry.ObjectPath)
+			|| !(*Description)->TryGetStringField(TEXT("property"), Property)
+			|| Entry.ObjectPath.IsEmpty() || Property.IsEmpty())
+		{
+			OutError = TEXT("Watch entries need \"object\" and \"property\"");
+			return nullptr;
+		}
+		Entry.PropertyName = FName(*Property);
+		if (!(*Description)->TryGetStringField(TEXT("key"), Entry.Key) || Entry.Key.IsEmpty())
+		{
+			Entry.Key = Property;
+		}
+
+		bool bDuplicate = false;
+		Keys.Add(Entry.Key, &bDuplicate);
+		if (bDuplicate)
+		{
+			OutError = FString::Printf(TEXT("Duplicate watch key %s; give one of them a \"key\""), *Entry.Key);
+			return nullptr;
+		}
+		Watch->Entries.Add(MoveTemp(Entry));
+	}
+	if (Watch->Entries.IsEmpty())
+	{
+		OutError = TEXT("Nothing to watch");
+		return nullptr;
+	}
+
+	Watch->Sample();
+	return Watch;
+}
+
+void FPlayUnrealPropertyWatch::ReleaseCopy(FEntry& Entry)
+{
+	if (!Entry.Copy) return;
+
+	// Without its class the property may be gone; leave the value undestroyed.
+	if (!Entry.bPlainData && Entry.Class.IsValid())
+	{
+		Entry.Property->DestroyValue(Entry.Copy);
+	}
+	FMemory::Free(Entry.Copy);
+	Entry.Copy = nullptr;
+}
+
+bool FPlayUnrealPropertyWatch::Resolve(FEntry& Entry, bool& bOutRebound)
+{
+	UObject* Target = Entry.Object.Get();
+	if (Target && Entry.Class.Get() == Target->GetClass()) return Entry.Property != nullptr;
+
+	bOutRebound = true;
+	ReleaseCopy(Entry);
+	Entry.Property = nullptr;
+	Entry.Class = nullptr;
+
+	Target = StaticFindObject(UObject::StaticClass(), nullptr, *Entry.ObjectPath);
+	Entry.Object = Target;
+	if (!Target) return false;
+
+	Entry.Class = Target->GetClass();
+	Entry.Property = Target->GetClass()->FindPropertyByName(Entry.PropertyName);
+	if (!Entry.Property) return false;
+
+	Entry.bPlainData = Entry.Property->HasAnyPropertyFlags(CPF_IsPlainOldData);
+	Entry.Copy = FMemory::Malloc(Entry.Property->GetSize(), Entry.Property->GetMinAlignment());
+	Entry.Property->InitializeValue(Entry.Copy);
+	Entry.Property->CopyCompleteValue(Entry.Copy, Entry.Property->ContainerPtrToValuePtr<void>(Target));
+	return true;
+}
+
+void FPlayUnrealPropertyWatch::Sample()
+{
+	Frame = GFrameCounter;
+	for (FEntry& Entry : Entries)
+	{
+		bool bRebound = false;
+		const bool bWasResolved = Entry.bResolved;
+		Entry.bResolved = Resolve(Entry, bRebound);
+		if (Entry.bResolved != bWasResolved || (Entry.bResolved && bRebound))
+		{
+			// Appeared, went away or moved to a new object (level reload).
+			Entry.bDirty = true;
+			continue;
+		}
+		if (!Entry.bResolved) continue;
+
+		const void* Live = Entry.Property->ContainerPtrToValuePtr<void>(Entry.Object.Get());
+		const bool bSame = Entry.bPlainData
+			? FMemory::Memcmp(Live, Entry.Copy, Entry.Property->GetSize()) == 0
+			: Entry.Property->Identical(Live, Entry.Copy);
+		if (!bSame)
+		{
+			Entry.Property->CopyCompleteValue(Entry.Copy, Live);
+			Entry.bDirty = true;
+		}
+	}
+}
+
+TSharedRef<FJsonObject> FPlayUnrealPropertyWatch::Report(bool bChangesOnly)
+{
+	// Game code may have run since this frame's sample.
+	Sample();
+
+	TSharedRef<FJsonObject> Values = MakeShared<FJsonObject>();
+	for (FEntry& Entry : Entries)
+	{
+		if (bChangesOnly && !Entry.bDirty) continue;
+		Entry.bDirty = false;
+
+		TSharedPtr<FJsonValue> Value = Entry.bResolved
+			? FJsonObjectConverter::UPropertyToJsonValue(Entry.Property, Entry.Copy)
+			: nullptr;
+		Values->SetField(Entry.Key, Value.IsValid() ? Value : MakeShared<FJsonValueNull>());
+	}
+	return Values;
+}
@@ -0,0 +1,84 @@
+// PlayUnrealPropertyWatch.h
+//
+// A set of (object, property) pairs registered once and read in one call.
+// Each FProperty is resolved once per object and kept with a copy of the
+// value it last had. Once per frame the watch compares every property's
+// live memory against that copy (memcmp for plain data, Identical()
+// otherwise) and notes which ones changed, so reporting converts only those
+// values to JSON and polling state costs no reflection lookups and no
+// per-property round trips.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtr.h"
+
+class FJsonObject;
+class FJsonValue;
+
+class FPlayUnrealPropertyWatch
+{
+public:
+	~FPlayUnrealPropertyWatch();
+
+	/**
+	 * Build a watch from [{"object": path, "property": name, "key": name}].
+	 * "key" names the value in reports and defaults to the property name.
+	 * Objects that do not exist yet are looked up again every frame.
+	 *
+	 * @return  Null with a reason in OutError if an entry is malformed or
+	 *          two entries share a key.
+	 */
+	static TUniquePtr<FPlayUnrealPropertyWatch> Create(const TArray<TSharedPtr<FJsonValue>>& Entries,
+	                                                  FString& OutError);
+
+	/** Compare every watched property against its copy. Once per frame. */
+	void Sample();
+
+	/**
+	 * Sample, then return values keyed by entry key (null while the object or property cannot
+	 * be resolved), and mark them reported.
+	 *
+	 * @param bChangesOnly  Only entries that changed in any frame since the
+	 *                      last report; a value that changed and changed
+	 *                      back is reported too.
+	 */
+	TSharedRef<FJsonObject> Report(bool bChangesOnly);
+
+	/** Frame of the last sample. */
+	uint64 GetFrame() const { return Frame; }
+
+private:
+	FPlayUnrealPropertyWatch() = default;
+
+	struct FEntry
+	{
+		FString Key;
+		FString ObjectPath;
+		FName PropertyName;
+
+		TWeakObjectPtr<UObject> Object;
+		/** Class Property belongs to; the property is dropped with it. */
+		TWeakObjectPtr<UClass> Class;
+		FProperty* Property = nullptr;
+		bool bPlainData = false;
+
+		/** The value at the last Sample(), Property->GetSize() bytes. */
+		void* Copy = nullptr;
+		bool bResolved = false;
+		/** Changed since the last report. */
+		bool bDirty = true;
+	};
+
+	/**
+	 * Bind the entry to its object, again if the object went away.
+	 *
+	 * @param bOutRebound  Set if the entry had to be looked up again.
+	 * @return             True if the property can be read.
+	 */
+	static bool Resolve(FEntry& Entry, bool& bOutRebound);
+	static void ReleaseCopy(FEntry& Entry);
+
+	TArray<FEntry> Entries;
+	uint64 Frame = 0;
+};
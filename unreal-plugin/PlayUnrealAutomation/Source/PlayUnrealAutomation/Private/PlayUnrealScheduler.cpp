@@ -0,0 +1,108 @@
+// PlayUnrealScheduler.cpp
+
+#include "PlayUnrealScheduler.h"
+#include "Dom/JsonObject.h"
+#include "HAL/PlatformTime.h"
+#include "PlayUnrealAsyncResults.h"
+#include "Tasks/Task.h"
+
+FPlayUnrealScheduler::FPlayUnrealScheduler(FPlayUnrealAsyncResults& InResults)
+	: Results(InResults)
+{
+}
+
+FPlayUnrealScheduler::~FPlayUnrealScheduler()
+{
+	if (TickHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(TickHandle);
+	}
+}
+
+void FPlayUnrealScheduler::Add(FJob Job)
+{
+	check(IsInGameThread());
+	// A slice that queues more work must not reallocate Jobs under itself.
+	(bTicking ? PendingJobs : Jobs).Add(MoveTemp(Job));
+
+	// Only tick while there is something to run.
+	if (!TickHandle.IsValid())
+	{
+		TickHandle = FTSTicker::GetCoreTicker().AddTicker(
+			FTickerDelegate::CreateRaw(this, &FPlayUnrealScheduler::Tick));
+	}
+}
+
+void FPlayUnrealScheduler::SetBudgetMs(double Milliseconds)
+{
+	BudgetSeconds = FMath::Max(Milliseconds, 0.01) / 1000.0;
+}
+
+void FPlayUnrealScheduler::Offload(int32 Handle, TUniqueFunction<TSharedRef<FJsonObject>()> Work)
+{
+	FPlayUnrealAsyncResults* ResultsPtr = &Results;
+	UE::Tasks::Launch(UE_SOURCE_LOCATION, [ResultsPtr, Handle, Work = MoveTemp(Work)]()
+	{
+		// Skip the work if the client cancelled in the meantime.
+		if (ResultsPtr->IsPending(Handle))
+		{
+			ResultsPtr->Succeed(Handle, Work());
+		}
+	});
+}
+
+bool FPlayUnrealScheduler::Tick(float DeltaTime)
+{
+	const double Start = FPlatformTime::Seconds();
+	const double Deadline = Start + BudgetSeconds;
+
+	// Every job gets at least one slice per frame, however small the
+	// budget, so none of them stalls; after that they share what is left.
+	int32 Remaining = Jobs.Num();
+	TGuardValue<bool> TickingGuard(bTicking, true);
+	while (!Jobs.IsEmpty() && (Remaining > 0 || FPlatformTime::Seconds() < Deadline))
+	{
+		if (NextJob >= Jobs.Num())
+		{
+			NextJob = 0;
+		}
+
+		++Slices;
+		--Remaining;
+		if (Jobs[NextJob](Deadline))
+		{
+			Jobs.RemoveAt(NextJob);
+		}
+		else
+		{
+			++NextJob;
+		}
+	}
+	Jobs.Append(MoveTemp(PendingJobs));
+	PendingJobs.Reset();
+
+	const double Elapsed = FPlatformTime::Seconds() - Start;
+	++Frames;
+	Overruns += Elapsed > BudgetSeconds ? 1 : 0;
+	MaxFrameSeconds = FMath::Max(MaxFrameSeconds, Elapsed);
+
+	if (Jobs.IsEmpty())
+	{
+		NextJob = 0;
+		TickHandle.Reset();
+		return false;
+	}
+	return true;
+}
+
+TSharedRef<FJsonObject> FPlayUnrealScheduler::ToJson() const
+{
+	TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+	Object->SetNumberField(TEXT("budgetMs"), GetBudgetMs());
+	Object->SetNumberField(TEXT("queued"), Jobs.Num() + PendingJobs.Num());
+	Object->SetNumberField(TEXT("slices"), static_cast<double>(Slices));
+	Object->SetNumberField(TEXT("frames"), static_cast<double>(Frames));
+	Object->SetNumberField(TEXT("overruns"), static_cast<double>(Overruns));
+	Object->SetNumberField(TEXT("maxFrameMs"), MaxFrameSeconds * 1000.0);
+	return Object;
+}
@@ -0,0 +1,76 @@
+// PlayUnrealScheduler.h
+//
+// Per-frame time budget for deferred automation work, so heavy queries do
+// not stretch the frames a test is measuring. A job is a resumable slice
+// function: it is called once per frame with a deadline, does as much as
+// it can before it, and returns true when finished. Jobs share the budget
+// round-robin, so a long query cannot starve the others.
+//
+// Work that touches no UObjects (building and encoding responses) goes to
+// UE::Tasks workers through Offload() instead of spending the budget.
+//
+// Work that must observe a single frame stays out of the scheduler: world
+// snapshots (SnapshotWorld/RestoreWorld) capture and restore every actor on
+// the same frame, or they would not reproduce a state. Actor name lookups
+// go through UPlayUnrealActorIndex and are too short to slice.
+//
+// The budget defaults to 2 ms; override with -PlayUnrealBudgetMs=N or
+// APlayUnrealDriver::SetFrameBudget.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+
+class FJsonObject;
+class FPlayUnrealAsyncResults;
+
+class FPlayUnrealScheduler
+{
+public:
+	/** Called with the FPlatformTime::Seconds() deadline; true when done. */
+	using FJob = TFunction<bool(double Deadline)>;
+
+	static constexpr double DefaultBudgetMs = 2.0;
+
+	explicit FPlayUnrealScheduler(FPlayUnrealAsyncResults& InResults);
+	~FPlayUnrealScheduler();
+
+	/** Queue a job. Its first slice runs on the next frame, even when added from a job. */
+	void Add(FJob Job);
+
+	void SetBudgetMs(double Milliseconds);
+	double GetBudgetMs() const { return BudgetSeconds * 1000.0; }
+
+	/**
+	 * Run Work on a task worker and complete Handle with its result.
+	 * Work must not touch UObjects.
+	 */
+	void Offload(int32 Handle, TUniqueFunction<TSharedRef<FJsonObject>()> Work);
+
+	/** {"budgetMs", "queued", "slices", "frames", "overruns", "maxFrameMs"}. */
+	TSharedRef<FJsonObject> ToJson() const;
+
+private:
+	bool Tick(float DeltaTime);
+
+	FPlayUnrealAsyncResults& Results;
+
+	double BudgetSeconds = DefaultBudgetMs / 1000.0;
+
+	/** Round-robin queue; the job at NextJob runs first next frame. */
+	TArray<FJob> Jobs;
+	int32 NextJob = 0;
+
+	/** Jobs added while Tick runs slices; merged into Jobs after them. */
+	TArray<FJob> PendingJobs;
+	bool bTicking = false;
+
+	uint64 Slices = 0;
+	uint64 Frames = 0;
+	/** Frames where a slice ran past the deadline. */
+	uint64 Overruns = 0;
+	double MaxFrameSeconds = 0.0;
+
+	FTSTicker::FDelegateHandle TickHandle;
+};
@@ -0,0 +1,329 @@
+// PlayUnrealScreenCapture.cpp
+
+#include "PlayUnrealScreenCapture.h"
+#include "Dom/JsonObject.h"
+#include "Engine/Engine.h"
+#include "Engine/GameViewportClient.h"
+#include "Framework/Application/SlateApplication.h"
+#include "HAL/FileManager.h"
+#include "IImageWrapper.h"
+#include "IImageWrapperModule.h"
+#include "Misc/App.h"
+#include "Misc/Base64.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Modules/ModuleManager.h"
+#include "PlayUnrealAsyncResults.h"
+#include "RHIGPUReadback.h"
+#include "RenderingThread.h"
+#include "Rendering/SlateRenderer.h"
+#include "Tasks/Task.h"
+#include "Widgets/SViewport.h"
+#include "Widgets/SWindow.h"
+
+FPlayUnrealScreenCapture::FPlayUnrealScreenCapture(FPlayUnrealAsyncResults& InResults)
+	: Results(InResults)
+{
+	// Make sure the module is loaded on the game thread before tasks use it.
+	FModuleManager::LoadModuleChecked<IImageWrapperModule>(TEXT("ImageWrapper"));
+}
+
+FPlayUnrealScreenCapture::~FPlayUnrealScreenCapture()
+{
+	if (WorldRenderingTicker.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(WorldRenderingTicker);
+		if (UGameViewportClient* Viewport = WorldRenderingViewport.Get())
+		{
+			Viewport->bDisableWorldRendering = true;
+		}
+	}
+	if (BackBufferHandle.IsValid() && FSlateApplication::IsInitialized())
+	{
+		if (FSlateRenderer* Renderer = FSlateApplication::Get().GetRenderer())
+		{
+			Renderer->OnBackBufferReadyToPresent().Remove(BackBufferHandle);
+		}
+	}
+	FlushRenderingCommands();
+}
+
+FPlayUnrealScreenCapture::ERenderMode FPlayUnrealScreenCapture::GetRenderMode()
+{
+	if (!FApp::CanEverRender())
+	{
+		return ERenderMode::None;
+	}
+	return FParse::Param(FCommandLine::Get(), TEXT("RenderOffScreen")) ? ERenderMode::OffScreen : ERenderMode::Gpu;
+}
+
+const TCHAR* FPlayUnrealScreenCapture::RenderModeToString(ERenderMode Mode)
+{
+	switch (Mode)
+	{
+	case ERenderMode::OffScreen: return TEXT("offscreen");
+	case ERenderMode::None:      return TEXT("none");
+	default:                     return TEXT("gpu");
+	}
+}
+
+int32 FPlayUnrealScreenCapture::Request(FRequest&& Request, FString& OutError)
+{
+	check(IsInGameThread());
+
+	// The RHI is chosen at startup, so a null-RHI process can never capture;
+	// fail now rather than leave a handle waiting for a frame that never comes.
+	if (GetRenderMode() == ERenderMode::None)
+	{
+		OutError = TEXT("Rendering is disabled (-nullrhi); run with -RenderOffScreen to capture without a window");
+		return INDEX_NONE;
+	}
+
+	FSlateRenderer* Renderer = FSlateApplication::IsInitialized()
+		? FSlateApplication::Get().GetRenderer() : nullptr;
+	UGameViewportClient* Viewport = GEngine ? GEngine->GameViewport.Get() : nullptr;
+	TSharedPtr<SWindow> Window = Viewport ? Viewport->GetWindow() : nullptr;
+	if (!Renderer || !Window.IsValid())
+	{
+		OutError = TEXT("No game window to capture");
+		return INDEX_NONE;
+	}
+
+	if (!BackBufferHandle.IsValid())
+	{
+		BackBufferHandle = Renderer->OnBackBufferReadyToPresent().AddRaw(
+			this, &FPlayUnrealScreenCapture::OnBackBufferReady);
+	}
+
+	// In PIE the game shares a window with the editor; keep only its viewport.
+	if (Request.Crop.IsEmpty())
+	{
+		if (TSharedPtr<SViewport> ViewportWidget = Viewport->GetGameViewportWidget())
+		{
+			const FGeometry& Geometry = ViewportWidget->GetCachedGeometry();
+			const FVector2D Offset = Geometry.GetAbsolutePosition() - Window->GetPositionInScreen();
+			const FVector2D Size = Geometry.GetAbsoluteSize();
+			Request.Crop = FIntRect(
+				FIntPoint(FMath::RoundToInt(Offset.X), FMath::RoundToInt(Offset.Y)),
+				FIntPoint(FMath::RoundToInt(Offset.X + Size.X), FMath::RoundToInt(Offset.Y + Size.Y)));
+		}
+	}
+
+	FPending Pending;
+	Pending.Handle = Results.Create(TEXT("screenshot"));
+	Pending.Request = MoveTemp(Request);
+	Pending.Frame = GFrameCounter;
+	Pending.Window = Window.Get();
+
+	const int32 Handle = Pending.Handle;
+
+	if (Viewport->bDisableWorldRendering || WorldRenderingViewport == Viewport)
+	{
+		Viewport->bDisableWorldRendering = false;
+		WorldRenderingViewport = Viewport;
+		WorldRenderingHandles.Add(Handle);
+		if (!WorldRenderingTicker.IsValid())
+		{
+			WorldRenderingTicker = FTSTicker::GetCoreTicker().AddTicker(
+				FTickerDelegate::CreateRaw(this, &FPlayUnrealScreenCapture::TickWorldRendering));
+		}
+	}
+
+	ENQUEUE_RENDER_COMMAND(PlayUnrealQueueCapture)(
+		[this, Pending = MoveTemp(Pending)](FRHICommandListImmediate&) mutable
+		{
+			Queued.Add(MoveTemp(Pending));
+		});
+	return Handle;
+}
+
+bool FPlayUnrealScreenCapture::TickWorldRendering(float DeltaSeconds)
+{
+	WorldRenderingHandles.RemoveAll([this](int32 Handle) { return !Results.IsPending(Handle); });
+	if (!WorldRenderingHandles.IsEmpty())
+	{
+		return true;
+	}
+
+	if (UGameViewportClient* Viewport = WorldRenderingViewport.Get())
+	{
+		Viewport->bDisableWorldRendering = true;
+	}
+	WorldRenderingViewport.Reset();
+	WorldRenderingTicker.Reset();
+	return false;
+}
+
+void FPlayUnrealScreenCapture::OnBackBufferReady(SWindow& Window, const FTextureRHIRef& BackBuffer)
+{
+	check(IsInRenderingThread());
+
+	PollReadbacks();
+
+	if (Queued.IsEmpty() || !BackBuffer.IsValid()) return;
+
+	TArray<FPending> ForThisWindow;
+	Queued.RemoveAll([&Window, &ForThisWindow](FPending& Pending)
+	{
+		if (Pending.Window != &Window) return false;
+		ForThisWindow.Add(MoveTemp(Pending));
+		return true;
+	});
+	if (ForThisWindow.IsEmpty()) return;
+
+	FRHICommandListImmediate& RHICmdList = FRHICommandListExecutor::GetImmediateCommandList();
+
+	TUniquePtr<FInFlight> Capture = MakeUnique<FInFlight>();
+	Capture->Readback = MakeUnique<FRHIGPUTextureReadback>(TEXT("PlayUnrealCapture"));
+	Capture->Readback->EnqueueCopy(RHICmdList, BackBuffer);
+	Capture->PixelFormat = BackBuffer->GetFormat();
+	Capture->Size = BackBuffer->GetSizeXY();
+	Capture->Requests = MoveTemp(ForThisWindow);
+
+	InFlight.Add(MoveTemp(Capture));
+}
+
+void FPlayUnrealScreenCapture::PollReadbacks()
+{
+	for (int32 Index = 0; Index < InFlight.Num();)
+	{
+		FInFlight& Capture = *InFlight[Index];
+		if (!Capture.Readback->IsReady())
+		{
+			++Index;
+			continue;
+		}
+
+		// Copy out of the staging buffer right away; everything else
+		// happens off the render thread.
+		int32 RowPitchInPixels = 0;
+		const void* Data = Capture.Readback->Lock(RowPitchInPixels);
+		const int32 BytesPerPixel = GPixelFormats[Capture.PixelFormat].BlockBytes;
+		TArray<uint8> Pixels;
+		if (Data)
+		{
+			Pixels.Append(static_cast<const uint8*>(Data),
+				RowPitchInPixels * Capture.Size.Y * BytesPerPixel);
+		}
+		Capture.Readback->Unlock();
+
+		UE::Tasks::Launch(UE_SOURCE_LOCATION,
+			[&Results = Results, Requests = MoveTemp(Capture.Requests), Pixels = MoveTemp(Pixels),
+			 Format = Capture.PixelFormat, Size = Capture.Size, RowPitchInPixels]()
+			{
+				for (const FPending& Pending : Requests)
+				{
+					Encode(Results, Pending, Pixels, Format, Size, RowPitchInPixels);
+				}
+			});
+
+		InFlight.RemoveAt(Index);
+	}
+}
+
+FColor FPlayUnrealScreenCapture::DecodePixel(const uint8* Src, EPixelFormat Format)
+{
+	switch (Format)
+	{
+	case PF_B8G8R8A8:
+		return FColor(Src[2], Src[1], Src[0], 255);
+	case PF_R8G8B8A8:
+		return FColor(Src[0], Src[1], Src[2], 255);
+	case PF_A2B10G10R10:
+	{
+		const uint32 Packed = *reinterpret_cast<const uint32*>(Src);
+		return FColor(
+			static_cast<uint8>(((Packed >> 0) & 0x3FF) >> 2),
+			static_cast<uint8>(((Packed >> 10) & 0x3FF) >> 2),
+			static_cast<uint8>(((Packed >> 20) & 0x3FF) >> 2),
+			255);
+	}
+	case PF_FloatRGBA:
+	{
+		const FFloat16* Half = reinterpret_cast<const FFloat16*>(Src);
+		return FLinearColor(Half[0].GetFloat(), Half[1].GetFloat(), Half[2].GetFloat()).ToFColor(true);
+	}
+	default:
+		return FColor::Black;
+	}
+}
+
+void FPlayUnrealScreenCapture::Encode(FPlayUnrealAsyncResults& Results, const FPending& Pending,
+                                      const TArray<uint8>& Pixels, EPixelFormat PixelFormat,
+                                      FIntPoint Size, int32 RowPitchInPixels)
+{
+	const FRequest& Request = Pending.Request;
+	if (!Results.IsPending(Pending.Handle))
+	{
+		// Cancelled while the readback was in flight.
+		return;
+	}
+	if (Pixels.IsEmpty())
+	{
+		Results.Fail(Pending.Handle, TEXT("Back buffer readback failed"));
+		return;
+	}
+
+	FIntRect Rect(FIntPoint::ZeroValue, Size);
+	if (!Request.Crop.IsEmpty())
+	{
+		Rect.Clip(Request.Crop);
+	}
+	const int32 Width = Rect.Width();
+	const int32 Height = Rect.Height();
+	if (Width <= 0 || Height <= 0)
+	{
+		Results.Fail(Pending.Handle, TEXT("Capture region is empty"));
+		return;
+	}
+
+	const int32 BytesPerPixel = GPixelFormats[PixelFormat].BlockBytes;
+	TArray<FColor> Colors;
+	Colors.SetNumUninitialized(Width * Height);
+	for (int32 Y = 0; Y < Height; ++Y)
+	{
+		const uint8* Row = Pixels.GetData()
+			+ (static_cast<int64>(Rect.Min.Y + Y) * RowPitchInPixels + Rect.Min.X) * BytesPerPixel;
+		for (int32 X = 0; X < Width; ++X)
+		{
+			Colors[Y * Width + X] = DecodePixel(Row + X * BytesPerPixel, PixelFormat);
+		}
+	}
+
+	IImageWrapperModule& ImageWrapperModule =
+		FModuleManager::GetModuleChecked<IImageWrapperModule>(TEXT("ImageWrapper"));
+	const bool bJpeg = Request.Format == EFormat::Jpeg;
+	TSharedPtr<IImageWrapper> Wrapper =
+		ImageWrapperModule.CreateImageWrapper(bJpeg ? EImageFormat::JPEG : EImageFormat::PNG);
+	if (!Wrapper.IsValid()
+		|| !Wrapper->SetRaw(Colors.GetData(), Colors.Num() * sizeof(FColor), Width, Height, ERGBFormat::BGRA, 8))
+	{
+		Results.Fail(Pending.Handle, TEXT("Image encoder unavailable"));
+		return;
+	}
+	const TArray64<uint8> Compressed = Wrapper->GetCompressed(bJpeg ? Request.Quality : 0);
+
+	TSharedRef<FJsonObject> Result = MakeShared<FJsonObject>();
+	Result->SetNumberField(TEXT("width"), Width);
+	Result->SetNumberField(TEXT("height"), Height);
+	Result->SetNumberField(TEXT("frame"), static_cast<double>(Pending.Frame));
+	Result->SetStringField(TEXT("format"), bJpeg ? TEXT("jpeg") : TEXT("png"));
+
+	if (Request.FullPath.IsEmpty())
+	{
+		Result->SetStringField(TEXT("bytes"), FBase64::Encode(Compressed.GetData(), Compressed.Num()));
+	}
+	else
+	{
+		IFileManager::Get().MakeDirectory(*FPaths::GetPath(Request.FullPath), true);
+		if (!FFileHelper::SaveArrayToFile(Compressed, *Request.FullPath))
+		{
+			Results.Fail(Pending.Handle, FString::Printf(TEXT("Cannot write %s"), *Request.FullPath));
+			return;
+		}
+		Result->SetStringField(TEXT("path"), Request.FullPath);
+	}
+
+	Results.Succeed(Pending.Handle, Result);
+}
@@ -0,0 +1,117 @@
+// PlayUnrealScreenCapture.h
+//
+// Non-blocking screenshot pipeline. A request is picked up by the next
+// back buffer presented for the game window: the render thread copies it
+// into a staging texture, later frames poll the readback, and a background
+// task converts, crops and encodes the pixels. The result is written under
+// Saved/ or returned inline as base64, through FPlayUnrealAsyncResults.
+//
+// Headless runs: under -nullrhi requests fail at once. When world rendering
+// is switched off (SetFixedTimestep "render": false) it is turned back on
+// only until the captures that need it complete.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "RHI.h"
+#include "RHIResources.h"
+
+class FPlayUnrealAsyncResults;
+class FRHIGPUTextureReadback;
+class SWindow;
+class UGameViewportClient;
+
+class FPlayUnrealScreenCapture
+{
+public:
+	enum class EFormat : uint8
+	{
+		Png,
+		Jpeg,
+	};
+
+	struct FRequest
+	{
+		/** Absolute output path; empty returns the bytes inline instead. */
+		FString FullPath;
+		EFormat Format = EFormat::Png;
+		/** JPEG quality (1-100); ignored for PNG. */
+		int32 Quality = 85;
+		/** Region of the window back buffer to keep (empty keeps all). */
+		FIntRect Crop;
+	};
+
+	/** How this process renders, as reported by Ping. */
+	enum class ERenderMode : uint8
+	{
+		/** Windowed GPU rendering. */
+		Gpu,
+		/** GPU rendering without a visible window (-RenderOffScreen). */
+		OffScreen,
+		/** No rendering at all (-nullrhi); nothing can be captured. */
+		None,
+	};
+
+	static ERenderMode GetRenderMode();
+	static const TCHAR* RenderModeToString(ERenderMode Mode);
+
+	/** Convert one back buffer pixel to 8-bit BGRA (opaque). */
+	static FColor DecodePixel(const uint8* Src, EPixelFormat Format);
+
+	explicit FPlayUnrealScreenCapture(FPlayUnrealAsyncResults& InResults);
+	~FPlayUnrealScreenCapture();
+
+	/**
+	 * Queue a capture of the next presented game frame.
+	 *
+	 * @return  Handle in the async result table, or INDEX_NONE if Slate
+	 *          rendering is unavailable (the reason is in OutError).
+	 */
+	int32 Request(FRequest&& Request, FString& OutError);
+
+private:
+	struct FPending
+	{
+		int32 Handle = INDEX_NONE;
+		FRequest Request;
+		uint64 Frame = 0;
+		/** Window to capture; only compared, never dereferenced off the game thread. */
+		const SWindow* Window = nullptr;
+	};
+
+	/** A staging copy shared by every request served from the same frame. */
+	struct FInFlight
+	{
+		TUniquePtr<FRHIGPUTextureReadback> Readback;
+		EPixelFormat PixelFormat = PF_Unknown;
+		FIntPoint Size = FIntPoint::ZeroValue;
+		TArray<FPending> Requests;
+	};
+
+	/** Render thread: called for every window presented by Slate. */
+	void OnBackBufferReady(SWindow& Window, const FTextureRHIRef& BackBuffer);
+
+	/** Game thread: turn world rendering off again once its captures are done. */
+	bool TickWorldRendering(float DeltaSeconds);
+
+	/** Render thread: hand finished readbacks to encoding tasks. */
+	void PollReadbacks();
+
+	/** Worker thread: convert, crop, encode and deliver one request. */
+	static void Encode(FPlayUnrealAsyncResults& Results, const FPending& Pending,
+	                   const TArray<uint8>& Pixels, EPixelFormat PixelFormat,
+	                   FIntPoint Size, int32 RowPitchInPixels);
+
+	FPlayUnrealAsyncResults& Results;
+	FDelegateHandle BackBufferHandle;
+
+	// Game thread only: captures that re-enabled world rendering for themselves.
+	TArray<int32> WorldRenderingHandles;
+	TWeakObjectPtr<UGameViewportClient> WorldRenderingViewport;
+	FTSTicker::FDelegateHandle WorldRenderingTicker;
+
+	// Render thread only.
+	TArray<FPending> Queued;
+	TArray<TUniquePtr<FInFlight>> InFlight;
+};
@@ -0,0 +1,528 @@
+// PlayUnrealSelector.cpp
+
+#include "PlayUnrealSelector.h"
+#include "Blueprint/UserWidget.h"
+#include "Blueprint/WidgetTree.h"
+#include "Components/PanelWidget.h"
+#include "Components/Widget.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "PlayUnrealWidgetRegistry.h"
+#include "UObject/UObjectHash.h"
+#include "UObject/UnrealType.h"
+
+/** Compiled selectors beyond this count flush the cache. */
+static constexpr int32 MaxCachedSelectors = 256;
+
+struct FPlayUnrealSelector::FWalk
+{
+	int32 Limit = 0;
+	TArray<FMatch>* Matches = nullptr;
+	const UPlayUnrealWidgetRegistry* Registry = nullptr;
+	TArray<const UWidget*> Stack;
+};
+
+TSharedPtr<const FPlayUnrealSelector> FPlayUnrealSelector::Compile(const FString& Selector, FString& OutError)
+{
+	check(IsInGameThread());
+
+	static TMap<FString, TSharedPtr<const FPlayUnrealSelector>> Cache;
+	if (const TSharedPtr<const FPlayUnrealSelector>* Found = Cache.Find(Selector))
+	{
+		return *Found;
+	}
+
+	TSharedPtr<FPlayUnrealSelector> Compiled = MakeShared<FPlayUnrealSelector>();
+	if (!Compiled->Parse(Selector, OutError))
+	{
+		return nullptr;
+	}
+
+	if (Cache.Num() >= MaxCachedSelectors)
+	{
+		Cache.Reset();
+	}
+	Cache.Add(Selector, Compiled);
+	return Compiled;
+}
+
+bool FPlayUnrealSelector::IsSelector(const FString& Text)
+{
+	if (Text.StartsWith(TEXT("id=")) || Text.StartsWith(TEXT("path="))) return true;
+
+	for (const TCHAR Char : Text)
+	{
+		if (FChar::IsWhitespace(Char) || Char == TCHAR('#') || Char == TCHAR('@') || Char == TCHAR('[')
+			|| Char == TCHAR(':') || Char == TCHAR('>'))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+// ---------------------------------------------------------------------------
+// Parsing
+// ---------------------------------------------------------------------------
+
+static bool IsIdentChar(TCHAR Char)
+{
+	return !FChar::IsWhitespace(Char) && Char != TCHAR('#') && Char != TCHAR('@') && Char != TCHAR('[')
+		&& Char != TCHAR(']') && Char != TCHAR(':') && Char != TCHAR('>') && Char != TCHAR('"')
+		&& Char != TCHAR('=') && Char != TCHAR('*') && Char != TCHAR('^') && Char != TCHAR('\'');
+}
+
+static FString ReadIdent(const FString& Text, int32& Index)
+{
+	const int32 Start = Index;
+	while (Index < Text.Len() && IsIdentChar(Text[Index]))
+	{
+		++Index;
+	}
+	return Text.Mid(Start, Index - Start);
+}
+
+bool FPlayUnrealSelector::Parse(const FString& Selector, FString& OutError)
+{
+	const FString Text = Selector.TrimStartAndEnd();
+
+	if (Text.StartsWith(TEXT("id=")))
+	{
+		// An empty ID would match every widget.
+		if (Text.Len() == 3)
+		{
+			OutError = TEXT("Empty value for 'id='");
+			return false;
+		}
+		Steps.AddDefaulted_GetRef().Id = Text.RightChop(3);
+	}
+	else if (Text.StartsWith(TEXT("path=")))
+	{
+		TArray<FString> Segments;
+		Text.RightChop(5).ParseIntoArray(Segments, TEXT("/"));
+		for (const FString& Segment : Segments)
+		{
+			Steps.AddDefaulted_GetRef().NameOrId = Segment;
+		}
+	}
+	else
+	{
+		int32 Index = 0;
+		ECombinator Combinator = ECombinator::Descendant;
+		while (Index < Text.Len())
+		{
+			const TCHAR Char = Text[Index];
+			if (FChar::IsWhitespace(Char))
+			{
+				++Index;
+				continue;
+			}
+			if (Char == TCHAR('>'))
+			{
+				if (Steps.IsEmpty())
+				{
+					OutError = TEXT("Selector cannot start with '>'");
+					return false;
+				}
+				Combinator = ECombinator::Child;
+				++Index;
+				continue;
+			}
+
+			FStep& Step = Steps.AddDefaulted_GetRef();
+			Step.Combinator = Combinator;
+			Combinator = ECombinator::Descendant;
+			if (!ParseStep(Text, Index, Step, OutError))
+			{
+				return false;
+			}
+		}
+	}
+
+	if (Steps.IsEmpty())
+	{
+		OutError = TEXT("Empty selector");
+		return false;
+	}
+	if (Steps.Num() > MaxSteps)
+	{
+		OutError = FString::Printf(TEXT("Selector has more than %d steps"), MaxSteps);
+		return false;
+	}
+
+	Steps[0].Combinator = ECombinator::Descendant;
+	for (FStep& Step : Steps)
+	{
+		Step.IdName = Step.Id.IsEmpty() ? NAME_None : FName(*Step.Id);
+		Step.NameOrIdName = Step.NameOrId.IsEmpty() ? NAME_None : FName(*Step.NameOrId);
+	}
+	bRequireVisibleMatch = Steps.Last().Visibility == EVisibilityFilter::Visible;
+	return true;
+}
+
+bool FPlayUnrealSelector::ParseStep(const FString& Text, int32& Index, FStep& OutStep, FString& OutError) const
+{
+	const int32 Start = Index;
+	OutStep.Type = ReadIdent(Text, Index);
+
+	while (Index < Text.Len() && !FChar::IsWhitespace(Text[Index]) && Text[Index] != TCHAR('>'))
+	{
+		const TCHAR Marker = Text[Index++];
+		if (Marker == TCHAR('#') || Marker == TCHAR('@'))
+		{
+			FString& Value = Marker == TCHAR('#') ? OutStep.Id : OutStep.Name;
+			Value = ReadIdent(Text, Index);
+			if (Value.IsEmpty())
+			{
+				OutError = FString::Printf(TEXT("Empty value after '%c' in selector"), Marker);
+				return false;
+			}
+		}
+		else if (Marker == TCHAR(':'))
+		{
+			const FString Pseudo = ReadIdent(Text, Index);
+			if (Pseudo == TEXT("visible"))
+			{
+				OutStep.Visibility = EVisibilityFilter::Visible;
+			}
+			else if (Pseudo == TEXT("hidden"))
+			{
+				OutStep.Visibility = EVisibilityFilter::Hidden;
+			}
+			else
+			{
+				OutError = FString::Printf(TEXT("Unknown pseudo-class ':%s'"), *Pseudo);
+				return false;
+			}
+		}
+		else if (Marker == TCHAR('['))
+		{
+			FAttribute& Attribute = OutStep.Attributes.AddDefaulted_GetRef();
+			const FString Key = ReadIdent(Text, Index);
+			if (Key != TEXT("id") && Key != TEXT("name") && Key != TEXT("text") && Key != TEXT("class"))
+			{
+				OutError = FString::Printf(TEXT("Unknown attribute '%s'"), *Key);
+				return false;
+			}
+			Attribute.Key = FName(*Key);
+
+			if (Text.Mid(Index, 2) == TEXT("*="))
+			{
+				Attribute.Op = EOp::Contains;
+				Index += 2;
+			}
+			else if (Text.Mid(Index, 2) == TEXT("^="))
+			{
+				Attribute.Op = EOp::StartsWith;
+				Index += 2;
+			}
+			else if (Index < Text.Len() && Text[Index] == TCHAR('='))
+			{
+				++Index;
+			}
+			else
+			{
+				OutError = FString::Printf(TEXT("Expected '=' after [%s"), *Key);
+				return false;
+			}
+
+			if (Index < Text.Len() && (Text[Index] == TCHAR('"') || Text[Index] == TCHAR('\'')))
+			{
+				const TCHAR Quote = Text[Index++];
+				const int32 ValueStart = Index;
+				while (Index < Text.Len() && Text[Index] != Quote)
+				{
+					++Index;
+				}
+				Attribute.Value = Text.Mid(ValueStart, Index - ValueStart);
+				++Index;
+			}
+			else
+			{
+				const int32 ValueStart = Index;
+				while (Index < Text.Len() && Text[Index] != TCHAR(']'))
+				{
+					++Index;
+				}
+				Attribute.Value = Text.Mid(ValueStart, Index - ValueStart).TrimEnd();
+			}
+
+			if (Index >= Text.Len() || Text[Index] != TCHAR(']'))
+			{
+				OutError = TEXT("Unterminated '[' in selector");
+				return false;
+			}
+			++Index;
+			if (Attribute.Value.IsEmpty())
+			{
+				OutError = FString::Printf(TEXT("Empty value for [%s] in selector"), *Key);
+				return false;
+			}
+		}
+		else
+		{
+			OutError = FString::Printf(TEXT("Unexpected '%c' in selector"), Marker);
+			return false;
+		}
+	}
+
+	if (Index == Start)
+	{
+		OutError = TEXT("Empty selector step");
+		return false;
+	}
+	return true;
+}
+
+// ---------------------------------------------------------------------------
+// Matching
+// ---------------------------------------------------------------------------
+
+bool FPlayUnrealSelector::GetWidgetText(const UWidget* Widget, FString& OutText)
+{
+	const FTextProperty* Property = Widget ? FindFProperty<FTextProperty>(Widget->GetClass(), TEXT("Text")) : nullptr;
+	if (!Property) return false;
+
+	OutText = Property->GetPropertyValue_InContainer(Widget).ToString();
+	return true;
+}
+
+/** Parent widget, crossing from a tree's root to the user widget that owns it. */
+static const UWidget* GetParentWidget(const UWidget* Widget)
+{
+	if (const UWidget* Parent = Widget->GetParent())
+	{
+		return Parent;
+	}
+	return Widget->GetTypedOuter<UUserWidget>();
+}
+
+bool FPlayUnrealSelector::IsEffectivelyVisible(const UWidget* Widget)
+{
+	while (Widget)
+	{
+		if (!Widget->IsVisible()) return false;
+
+		const UWidget* Parent = GetParentWidget(Widget);
+		if (!Parent)
+		{
+			const UUserWidget* RootUserWidget = Cast<UUserWidget>(Widget);
+			return !RootUserWidget || RootUserWidget->IsInViewport();
+		}
+		Widget = Parent;
+	}
+	return false;
+}
+
+static bool IsClassNamed(const UClass* Class, const FString& Name)
+{
+	for (; Class; Class = Class->GetSuperClass())
+	{
+		if (Class->GetName().Equals(Name, ESearchCase::IgnoreCase)) return true;
+	}
+	return false;
+}
+
+bool FPlayUnrealSelector::StepMatches(const FStep& Step, const UWidget* Widget, bool bVisible,
+                                      const UPlayUnrealWidgetRegistry* Registry) const
+{
+	if (Step.Visibility == EVisibilityFilter::Visible && !bVisible) return false;
+	if (Step.Visibility == EVisibilityFilter::Hidden && bVisible) return false;
+	if (!Step.Type.IsEmpty() && !IsClassNamed(Widget->GetClass(), Step.Type)) return false;
+	if (!Step.Name.IsEmpty() && Widget->GetName() != Step.Name) return false;
+
+	if (!Step.IdName.IsNone() && (!Registry || Registry->GetIdName(Widget) != Step.IdName)) return false;
+	if (!Step.NameOrIdName.IsNone() && Widget->GetFName() != Step.NameOrIdName
+		&& (!Registry || Registry->GetIdName(Widget) != Step.NameOrIdName))
+	{
+		return false;
+	}
+
+	for (const FAttribute& Attribute : Step.Attributes)
+	{
+		FString Actual;
+		if (Attribute.Key == TEXT("text"))
+		{
+			if (!GetWidgetText(Widget, Actual)) return false;
+		}
+		else if (Attribute.Key == TEXT("id"))
+		{
+			Actual = Registry ? Registry->GetId(Widget) : FString();
+		}
+		else if (Attribute.Key == TEXT("name"))
+		{
+			Actual = Widget->GetName();
+		}
+		else
+		{
+			Actual = Widget->GetClass()->GetName();
+		}
+		const bool bMatches = Attribute.Op == EOp::Contains ? Actual.Contains(Attribute.Value)
+			: Attribute.Op == EOp::StartsWith ? Actual.StartsWith(Attribute.Value)
+			: Actual == Attribute.Value;
+		if (!bMatches) return false;
+	}
+	return true;
+}
+
+bool FPlayUnrealSelector::Visit(FWalk& Walk, UWidget* Widget, uint32 ActiveSteps, bool bParentVisible) const
+{
+	// Children of a hidden widget are hidden too.
+	const bool bVisible = bParentVisible && Widget->IsVisible();
+	if (!bVisible && bRequireVisibleMatch) return true;
+
+	Walk.Stack.Push(Widget);
+
+	const int32 LastStep = Steps.Num() - 1;
+	uint32 ChildSteps = 0;
+	for (uint32 Mask = ActiveSteps; Mask != 0; Mask &= Mask - 1)
+	{
+		const int32 Step = FMath::CountTrailingZeros(Mask);
+		if (StepMatches(Steps[Step], Widget, bVisible, Walk.Registry))
+		{
+			if (Step == LastStep)
+			{
+				FMatch& Match = Walk.Matches->AddDefaulted_GetRef();
+				Match.Widget = Widget;
+				Match.bVisible = bVisible;
+				for (const UWidget* Ancestor : Walk.Stack)
+				{
+					if (!Match.Path.IsEmpty()) Match.Path += TEXT("/");
+					Match.Path += Ancestor->GetName();
+				}
+				if (Walk.Limit > 0 && Walk.Matches->Num() >= Walk.Limit)
+				{
+					Walk.Stack.Pop();
+					return false;
+				}
+			}
+			else
+			{
+				ChildSteps |= 1u << (Step + 1);
+			}
+		}
+		// A descendant step may still match further down; a child step
+		// only ever applies to the level right below its parent's match.
+		if (Steps[Step].Combinator == ECombinator::Descendant)
+		{
+			ChildSteps |= 1u << Step;
+		}
+	}
+
+	bool bContinue = true;
+	if (ChildSteps != 0)
+	{
+		if (UUserWidget* UserWidget = Cast<UUserWidget>(Widget))
+		{
+			UWidget* Root = UserWidget->WidgetTree ? UserWidget->WidgetTree->RootWidget.Get() : nullptr;
+			bContinue = !Root || Visit(Walk, Root, ChildSteps, bVisible);
+		}
+		else if (UPanelWidget* Panel = Cast<UPanelWidget>(Widget))
+		{
+			for (int32 Index = 0; bContinue && Index < Panel->GetChildrenCount(); ++Index)
+			{
+				if (UWidget* Child = Panel->GetChildAt(Index))
+				{
+					bContinue = Visit(Walk, Child, ChildSteps, bVisible);
+				}
+			}
+		}
+	}
+
+	Walk.Stack.Pop();
+	return bContinue;
+}
+
+bool FPlayUnrealSelector::IsIdLookup() const
+{
+	const FStep& Step = Steps[0];
+	return Steps.Num() == 1 && !Step.Id.IsEmpty() && Step.Type.IsEmpty() && Step.Name.IsEmpty()
+		&& Step.NameOrId.IsEmpty() && Step.Attributes.IsEmpty() && Step.Visibility == EVisibilityFilter::Any;
+}
+
+void FPlayUnrealSelector::MatchById(const UWorld* World, int32 Limit, TArray<FMatch>& OutMatches) const
+{
+	UPlayUnrealWidgetRegistry* Registry = UPlayUnrealWidgetRegistry::Get(World);
+	if (!Registry) return;
+
+	TArray<UWidget*> Widgets;
+	Registry->FindAll(Steps[0].Id, Widgets, World);
+	for (UWidget* Widget : Widgets)
+	{
+		FMatch& Match = OutMatches.AddDefaulted_GetRef();
+		Match.Widget = Widget;
+		Match.bVisible = IsEffectivelyVisible(Widget);
+		for (const UWidget* Ancestor = Widget; Ancestor; Ancestor = GetParentWidget(Ancestor))
+		{
+			Match.Path = Match.Path.IsEmpty() ? Ancestor->GetName() : Ancestor->GetName() + TEXT("/") + Match.Path;
+		}
+		if (Limit > 0 && OutMatches.Num() >= Limit) return;
+	}
+}
+
+void FPlayUnrealSelector::Match(const UWorld* World, int32 Limit, TArray<FMatch>& OutMatches) const
+{
+	if (!World) return;
+
+	if (IsIdLookup())
+	{
+		MatchById(World, Limit, OutMatches);
+		return;
+	}
+
+	TArray<TWeakObjectPtr<UUserWidget>> Roots;
+	CollectRoots(World, Roots);
+	for (const TWeakObjectPtr<UUserWidget>& Root : Roots)
+	{
+		if (!MatchRoot(Root.Get(), Limit, OutMatches)) return;
+	}
+}
+
+void FPlayUnrealSelector::CollectRoots(const UWorld* World, TArray<TWeakObjectPtr<UUserWidget>>& OutRoots)
+{
+	if (!World) return;
+
+	// CreateWidget outers a widget to the world, its game instance or a
+	// player controller, so only their direct inners can be viewport roots;
+	// widgets of other worlds and PIE instances are never visited.
+	TArray<const UObject*, TInlineAllocator<4>> Owners;
+	Owners.Add(World);
+	if (const UGameInstance* GameInstance = World->GetGameInstance())
+	{
+		Owners.Add(GameInstance);
+	}
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		if (const APlayerController* Controller = It->Get())
+		{
+			Owners.Add(Controller);
+		}
+	}
+
+	TArray<UObject*> Inners;
+	for (const UObject* Owner : Owners)
+	{
+		Inners.Reset();
+		GetObjectsWithOuter(Owner, Inners, false);
+		for (UObject* Inner : Inners)
+		{
+			UUserWidget* Root = Cast<UUserWidget>(Inner);
+			if (Root && !Root->IsTemplate() && Root->GetWorld() == World && Root->IsInViewport())
+			{
+				OutRoots.Add(Root);
+			}
+		}
+	}
+}
+
+bool FPlayUnrealSelector::MatchRoot(UUserWidget* Root, int32 Limit, TArray<FMatch>& OutMatches) const
+{
+	if (!Root) return true;
+
+	FWalk Walk;
+	Walk.Limit = Limit;
+	Walk.Matches = &OutMatches;
+	Walk.Registry = UPlayUnrealWidgetRegistry::Get(Root);
+	return Visit(Walk, Root, 1u, true);
+}
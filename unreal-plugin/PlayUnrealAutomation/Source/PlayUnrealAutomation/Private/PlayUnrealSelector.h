@@ -0,0 +1,142 @@
+// PlayUnrealSelector.h
+//
+// Compiled widget selectors, matched over the UMG trees of the user widgets
+// in a world's viewport. A selector is a chain of steps separated by
+// whitespace (descendant) or ">" (direct child):
+//
+//   Button#StartButton               class Button (or subclass), automation ID
+//   MainMenu_C VerticalBox > Button  descendant / child chains
+//   @PlayLabel                       widget object name
+//   TextBlock[text="Play"]           text equals ("*=" contains, "^=" starts with)
+//   Button:visible                   effectively visible (":hidden" for the opposite)
+//
+// The protocol shorthands are accepted too: "id=StartButton" is one step
+// matching an automation ID, and "path=Menu/Buttons/Start" is a descendant
+// chain whose segments match a widget name or automation ID.
+//
+// Compile() caches by selector string, so polling the same assertion does
+// not re-parse it. Matching walks each tree once, carrying the set of
+// partially matched steps, and skips subtrees that can no longer match.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtr.h"
+
+class UPlayUnrealWidgetRegistry;
+class UUserWidget;
+class UWidget;
+class UWorld;
+
+class FPlayUnrealSelector
+{
+public:
+	/** One match, with the widget chain from its root user widget. */
+	struct FMatch
+	{
+		UWidget* Widget = nullptr;
+		bool bVisible = false;
+		FString Path;
+	};
+
+	/**
+	 * Compile a selector, or return the cached compilation.
+	 *
+	 * @return  Null with a reason in OutError if the selector is malformed.
+	 */
+	static TSharedPtr<const FPlayUnrealSelector> Compile(const FString& Selector, FString& OutError);
+
+	/** True for strings Compile() should see; plain strings are bare automation IDs. */
+	static bool IsSelector(const FString& Text);
+
+	/**
+	 * Collect matches in World in tree order.
+	 *
+	 * @param Limit  Stop after this many matches (0 = all).
+	 */
+	void Match(const UWorld* World, int32 Limit, TArray<FMatch>& OutMatches) const;
+
+	/**
+	 * Match in slices: collect the roots once, then match them one at a
+	 * time (roots destroyed in between are skipped). An "id=" selector
+	 * has no roots to walk; use Match for it.
+	 */
+	bool NeedsTreeWalk() const { return !IsIdLookup(); }
+	static void CollectRoots(const UWorld* World, TArray<TWeakObjectPtr<UUserWidget>>& OutRoots);
+
+	/** @return  False once Limit matches have been collected. */
+	bool MatchRoot(UUserWidget* Root, int32 Limit, TArray<FMatch>& OutMatches) const;
+
+	/** Text of a widget with a "Text" property (TextBlock, EditableText, ...). */
+	static bool GetWidgetText(const UWidget* Widget, FString& OutText);
+
+	/** True if the widget and every parent up to the viewport is visible. */
+	static bool IsEffectivelyVisible(const UWidget* Widget);
+
+private:
+	enum class ECombinator : uint8
+	{
+		Descendant,
+		Child,
+	};
+
+	enum class EOp : uint8
+	{
+		Equals,
+		Contains,
+		StartsWith,
+	};
+
+	enum class EVisibilityFilter : uint8
+	{
+		Any,
+		Visible,
+		Hidden,
+	};
+
+	struct FAttribute
+	{
+		FName Key;
+		EOp Op = EOp::Equals;
+		FString Value;
+	};
+
+	struct FStep
+	{
+		ECombinator Combinator = ECombinator::Descendant;
+		FString Type;
+		FString Id;
+		FString Name;
+		/** path= segment: matches the widget name or its automation ID. */
+		FString NameOrId;
+		/** Id and NameOrId interned, as the registry stores IDs. */
+		FName IdName;
+		FName NameOrIdName;
+		TArray<FAttribute> Attributes;
+		EVisibilityFilter Visibility = EVisibilityFilter::Any;
+	};
+
+	/** Match state threaded through one tree walk. */
+	struct FWalk;
+
+	bool Parse(const FString& Selector, FString& OutError);
+	bool ParseStep(const FString& Text, int32& Index, FStep& OutStep, FString& OutError) const;
+
+	bool StepMatches(const FStep& Step, const UWidget* Widget, bool bVisible,
+	                 const UPlayUnrealWidgetRegistry* Registry) const;
+
+	/** "id=X" needs no tree walk: the registry already indexes IDs. */
+	bool IsIdLookup() const;
+	void MatchById(const UWorld* World, int32 Limit, TArray<FMatch>& OutMatches) const;
+
+	/** Returns false once the limit is reached. */
+	bool Visit(FWalk& Walk, UWidget* Widget, uint32 ActiveSteps, bool bParentVisible) const;
+
+	/** Steps are at most 32, so the in-flight set fits in a mask. */
+	static constexpr int32 MaxSteps = 32;
+
+	TArray<FStep> Steps;
+
+	/** The last step needs a visible widget, so hidden subtrees are skipped. */
+	bool bRequireVisibleMatch = false;
+};
@@ -0,0 +1,195 @@
+// PlayUnrealSessionLog.cpp
+
+#include "PlayUnrealSessionLog.h"
+
+// Session recording is only compiled with WITH_PLAYUNREAL_AUTOMATION.
+#if WITH_PLAYUNREAL_AUTOMATION
+
+#include "Async/MappedFileHandle.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+	const uint8 Magic[4] = { 'P', 'U', 'S', 'L' };
+	constexpr uint32 FormatVersion = 1;
+	constexpr int64 HeaderSize = 16;
+	constexpr int64 RecordHeaderSize = 16;
+
+	void WriteU32(TArray<uint8>& Out, uint32 Value)
+	{
+		for (int32 Shift = 0; Shift < 32; Shift += 8)
+		{
+			Out.Add(static_cast<uint8>(Value >> Shift));
+		}
+	}
+
+	uint32 ReadU32(const uint8* Data)
+	{
+		return uint32(Data[0]) | uint32(Data[1]) << 8 | uint32(Data[2]) << 16 | uint32(Data[3]) << 24;
+	}
+
+	void WriteString(TArray<uint8>& Out, const FTCHARToUTF8& Text)
+	{
+		Out.Append(reinterpret_cast<const uint8*>(Text.Get()), Text.Length());
+	}
+
+	FString ReadString(const uint8* Data, uint32 Length)
+	{
+		const FUTF8ToTCHAR Text(reinterpret_cast<const ANSICHAR*>(Data), Length);
+		return FString(Text.Length(), Text.Get());
+	}
+}
+
+// ---------------------------------------------------------------------------
+// Writer
+// ---------------------------------------------------------------------------
+
+FPlayUnrealSessionLogWriter::~FPlayUnrealSessionLogWriter()
+{
+	if (File.IsValid())
+	{
+		File->Flush();
+	}
+}
+
+TUniquePtr<FPlayUnrealSessionLogWriter> FPlayUnrealSessionLogWriter::Create(
+	const FString& FullPath, double FixedDeltaSeconds, FString& OutError)
+{
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	PlatformFile.CreateDirectoryTree(*FPaths::GetPath(FullPath));
+
+	TUniquePtr<IFileHandle> File(PlatformFile.OpenWrite(*FullPath));
+	if (!File.IsValid())
+	{
+		OutError = FString::Printf(TEXT("Cannot open %s for writing"), *FullPath);
+		return nullptr;
+	}
+
+	TArray<uint8> Header;
+	Header.Append(Magic, UE_ARRAY_COUNT(Magic));
+	WriteU32(Header, FormatVersion);
+	uint64 DeltaBits = 0;
+	FMemory::Memcpy(&DeltaBits, &FixedDeltaSeconds, sizeof(DeltaBits));
+	WriteU32(Header, static_cast<uint32>(DeltaBits));
+	WriteU32(Header, static_cast<uint32>(DeltaBits >> 32));
+	check(Header.Num() == HeaderSize);
+
+	if (!File->Write(Header.GetData(), Header.Num()))
+	{
+		OutError = FString::Printf(TEXT("Cannot write to %s"), *FullPath);
+		return nullptr;
+	}
+
+	TUniquePtr<FPlayUnrealSessionLogWriter> Writer(new FPlayUnrealSessionLogWriter());
+	Writer->File = MoveTemp(File);
+	Writer->Path = FullPath;
+	Writer->NumBytes = HeaderSize;
+	return Writer;
+}
+
+void FPlayUnrealSessionLogWriter::Append(uint32 Frame, const FString& Method,
+                                         const FString& Params, const FString& Result)
+{
+	const FTCHARToUTF8 MethodUtf8(*Method);
+	const FTCHARToUTF8 ParamsUtf8(*Params);
+	const FTCHARToUTF8 ResultUtf8(*Result);
+
+	// One write per record, so a crash loses at most the call in flight.
+	Scratch.Reset();
+	WriteU32(Scratch, Frame);
+	WriteU32(Scratch, MethodUtf8.Length());
+	WriteU32(Scratch, ParamsUtf8.Length());
+	WriteU32(Scratch, ResultUtf8.Length());
+	WriteString(Scratch, MethodUtf8);
+	WriteString(Scratch, ParamsUtf8);
+	WriteString(Scratch, ResultUtf8);
+
+	if (File->Write(Scratch.GetData(), Scratch.Num()))
+	{
+		++NumRecords;
+		NumBytes += Scratch.Num();
+	}
+	else
+	{
+		UE_LOG(LogTemp, Warning, TEXT("PlayUnreal: Failed to append %s to %s"), *Method, *Path);
+	}
+}
+
+// ---------------------------------------------------------------------------
+// Reader
+// ---------------------------------------------------------------------------
+
+FPlayUnrealSessionLogReader::~FPlayUnrealSessionLogReader()
+{
+	// The region must go before the file it maps.
+	Region.Reset();
+	MappedFile.Reset();
+}
+
+TUniquePtr<FPlayUnrealSessionLogReader> FPlayUnrealSessionLogReader::Open(const FString& FullPath, FString& OutError)
+{
+	TUniquePtr<IMappedFileHandle> MappedFile(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*FullPath));
+	if (!MappedFile.IsValid() || MappedFile->GetFileSize() < HeaderSize)
+	{
+		OutError = FString::Printf(TEXT("Cannot map session log %s"), *FullPath);
+		return nullptr;
+	}
+
+	TUniquePtr<IMappedFileRegion> Region(MappedFile->MapRegion(0, MappedFile->GetFileSize(), true));
+	if (!Region.IsValid())
+	{
+		OutError = FString::Printf(TEXT("Cannot map session log %s"), *FullPath);
+		return nullptr;
+	}
+
+	const uint8* Data = Region->GetMappedPtr();
+	if (FMemory::Memcmp(Data, Magic, UE_ARRAY_COUNT(Magic)) != 0 || ReadU32(Data + 4) != FormatVersion)
+	{
+		OutError = FString::Printf(TEXT("%s is not a version %u session log"), *FullPath, FormatVersion);
+		return nullptr;
+	}
+
+	TUniquePtr<FPlayUnrealSessionLogReader> Reader(new FPlayUnrealSessionLogReader());
+	const uint64 DeltaBits = uint64(ReadU32(Data + 8)) | uint64(ReadU32(Data + 12)) << 32;
+	FMemory::Memcpy(&Reader->FixedDeltaSeconds, &DeltaBits, sizeof(DeltaBits));
+	Reader->Data = Data;
+	Reader->Size = Region->GetMappedSize();
+	Reader->Offset = HeaderSize;
+	Reader->MappedFile = MoveTemp(MappedFile);
+	Reader->Region = MoveTemp(Region);
+	return Reader;
+}
+
+bool FPlayUnrealSessionLogReader::PeekFrame(uint32& OutFrame) const
+{
+	if (Offset + RecordHeaderSize > Size) return false;
+
+	const uint8* Record = Data + Offset;
+	const int64 Body = int64(ReadU32(Record + 4)) + ReadU32(Record + 8) + ReadU32(Record + 12);
+	if (Offset + RecordHeaderSize + Body > Size) return false;
+
+	OutFrame = ReadU32(Record);
+	return true;
+}
+
+bool FPlayUnrealSessionLogReader::Next(FRecord& OutRecord)
+{
+	if (!PeekFrame(OutRecord.Frame)) return false;
+
+	const uint8* Record = Data + Offset;
+	const uint32 MethodLength = ReadU32(Record + 4);
+	const uint32 ParamsLength = ReadU32(Record + 8);
+	const uint32 ResultLength = ReadU32(Record + 12);
+
+	const uint8* Text = Record + RecordHeaderSize;
+	OutRecord.Method = ReadString(Text, MethodLength);
+	OutRecord.Params = ReadString(Text + MethodLength, ParamsLength);
+	OutRecord.Result = ReadString(Text + MethodLength + ParamsLength, ResultLength);
+
+	Offset += RecordHeaderSize + MethodLength + ParamsLength + ResultLength;
+	++NumRead;
+	return true;
+}
+
+#endif // WITH_PLAYUNREAL_AUTOMATION
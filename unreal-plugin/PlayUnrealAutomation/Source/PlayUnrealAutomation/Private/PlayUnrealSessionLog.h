@@ -0,0 +1,97 @@
+// PlayUnrealSessionLog.h
+//
+// Append-only binary log of driver calls, for replaying a session in the
+// engine without a client. The file is a header followed by one record per
+// call, written as the call returns:
+//
+//   header  "PUSL" | u32 version | f64 fixed delta seconds (0 = variable)
+//   record  u32 frame | u32 method bytes | u32 params bytes | u32 result bytes
+//           | method | params | result
+//
+// Integers are little-endian; strings are UTF-8 without terminators. The
+// frame is counted from the start of the recording, params is the call's
+// input parameters as a JSON object and result its return value as JSON.
+// A record cut short (the process died mid-write) ends the log.
+//
+// The reader maps the file instead of loading it, so long sessions are
+// replayed straight from the page cache.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class IFileHandle;
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+class FPlayUnrealSessionLogWriter
+{
+public:
+	~FPlayUnrealSessionLogWriter();
+
+	/**
+	 * Create (or truncate) a log at FullPath.
+	 *
+	 * @param FixedDeltaSeconds  The engine's fixed timestep, or 0 when the
+	 *                           session runs on variable frame times.
+	 * @return                   Null with a reason in OutError on failure.
+	 */
+	static TUniquePtr<FPlayUnrealSessionLogWriter> Create(const FString& FullPath, double FixedDeltaSeconds,
+	                                                      FString& OutError);
+
+	void Append(uint32 Frame, const FString& Method, const FString& Params, const FString& Result);
+
+	const FString& GetPath() const { return Path; }
+	int32 GetNumRecords() const { return NumRecords; }
+	int64 GetNumBytes() const { return NumBytes; }
+
+private:
+	FPlayUnrealSessionLogWriter() = default;
+
+	TUniquePtr<IFileHandle> File;
+	FString Path;
+	int32 NumRecords = 0;
+	int64 NumBytes = 0;
+
+	/** Reused per record so appending does not allocate. */
+	TArray<uint8> Scratch;
+};
+
+class FPlayUnrealSessionLogReader
+{
+public:
+	struct FRecord
+	{
+		uint32 Frame = 0;
+		FString Method;
+		FString Params;
+		FString Result;
+	};
+
+	~FPlayUnrealSessionLogReader();
+
+	/** Map a log for reading. Null with a reason in OutError on failure. */
+	static TUniquePtr<FPlayUnrealSessionLogReader> Open(const FString& FullPath, FString& OutError);
+
+	double GetFixedDeltaSeconds() const { return FixedDeltaSeconds; }
+
+	/** Frame of the next record, without decoding it. False at the end. */
+	bool PeekFrame(uint32& OutFrame) const;
+
+	/** Decode the next record and advance. False at the end. */
+	bool Next(FRecord& OutRecord);
+
+	/** Records decoded so far. */
+	int32 GetNumRead() const { return NumRead; }
+
+private:
+	FPlayUnrealSessionLogReader() = default;
+
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> Region;
+	const uint8* Data = nullptr;
+	int64 Size = 0;
+	int64 Offset = 0;
+	int32 NumRead = 0;
+	double FixedDeltaSeconds = 0.0;
+};
@@ -2,10 +2,20 @@
 
 #include "PlayUnrealStatics.h"
 #include "Components/Widget.h"
+#include "Dom/JsonObject.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/Actor.h"
+#include "PlayUnrealActorIndex.h"
+#include "PlayUnrealAutomationModule.h"
+#include "PlayUnrealJson.h"
+#include "PlayUnrealWidgetRegistry.h"
+#include "UObject/UObjectHash.h"
 
-// Store automation IDs in a static map keyed by widget pointer.
-// This avoids modifying UWidget internals and works across UE versions.
-static TMap<TWeakObjectPtr<const UWidget>, FString> AutomationIdMap;
+// Automation IDs live in the game instance's UPlayUnrealWidgetRegistry,
+// which indexes them in both directions. This avoids modifying UWidget
+// internals and works across UE versions.
 
 void UPlayUnrealStatics::SetAutomationId(UWidget* Widget, const FString& Id)
 {
@@ -16,15 +26,20 @@ void UPlayUnrealStatics::SetAutomationId(UWidget* Widget, const FString& Id)
 		return;
 	}
 
-	if (Id.IsEmpty())
+	UPlayUnrealWidgetRegistry* Registry = UPlayUnrealWidgetRegistry::Get(Widget);
+	if (!Registry)
 	{
-		AutomationIdMap.Remove(Widget);
-	}
-	else
-	{
-		AutomationIdMap.Add(Widget, Id);
+		// Builds without automation have no registry; games tag widgets anyway.
+#if WITH_PLAYUNREAL_AUTOMATION
+		UE_LOG(LogTemp, Warning,
+			TEXT("PlayUnreal: SetAutomationId(%s) called outside a game instance"),
+			*Widget->GetName());
+#endif
+		return;
 	}
 
+	Registry->Register(Widget, Id);
+
 	UE_LOG(LogTemp, Verbose,
 		TEXT("PlayUnreal: SetAutomationId(%s) = '%s'"),
 		*Widget->GetName(), *Id);
@@ -32,8 +47,97 @@ void UPlayUnrealStatics::SetAutomationId(UWidget* Widget, const FString& Id)
 
 FString UPlayUnrealStatics::GetAutomationId(const UWidget* Widget)
 {
-	if (!Widget) return FString();
+	const UPlayUnrealWidgetRegistry* Registry = UPlayUnrealWidgetRegistry::Get(Widget);
+	return Registry ? Registry->GetId(Widget) : FString();
+}
 
-	const FString* Found = AutomationIdMap.Find(Widget);
-	return Found ? *Found : FString();
+FString UPlayUnrealStatics::ResolveObjects(const TArray<FString>& ClassNames)
+{
+	// Clients call this first, before they know where the driver is.
+	FPlayUnrealAutomationModule::Get().Activate();
+	return PlayUnrealJson::ToString(ResolveObjectsToJson(ClassNames));
+}
+
+TSharedRef<FJsonObject> UPlayUnrealStatics::ResolveObjectsToJson(const TArray<FString>& ClassNames,
+                                                                  UWorld* World)
+{
+	TArray<UWorld*> Worlds;
+	if (World)
+	{
+		Worlds.Add(World);
+	}
+	else if (GEngine)
+	{
+		for (const FWorldContext& Context : GEngine->GetWorldContexts())
+		{
+			UWorld* ContextWorld = Context.World();
+			if (ContextWorld && ContextWorld->IsGameWorld())
+			{
+				Worlds.Add(ContextWorld);
+			}
+		}
+	}
+
+	TSharedRef<FJsonObject> Objects = MakeShared<FJsonObject>();
+	TArray<TSharedPtr<FJsonValue>> Unknown;
+	for (const FString& ClassName : ClassNames)
+	{
+		UClass* Class = UPlayUnrealActorIndex::ResolveClass(ClassName);
+		if (!Class)
+		{
+			Unknown.Add(MakeShared<FJsonValueString>(ClassName));
+			continue;
+		}
+
+		TArray<TSharedPtr<FJsonValue>> Paths;
+		if (Class->IsChildOf(AActor::StaticClass()))
+		{
+			// Actors come from each world's index instead of an object scan.
+			// A world without one (its subsystems not created yet, or torn
+			// down) is iterated instead.
+			for (UWorld* Searched : Worlds)
+			{
+				TArray<AActor*> Actors;
+				if (UPlayUnrealActorIndex* Index = Searched->GetSubsystem<UPlayUnrealActorIndex>())
+				{
+					Index->FindByClass(Class, Actors);
+				}
+				else
+				{
+					for (TActorIterator<AActor> It(Searched, Class); It; ++It)
+					{
+						Actors.Add(*It);
+					}
+				}
+				for (const AActor* Actor : Actors)
+				{
+					Paths.Add(MakeShared<FJsonValueString>(Actor->GetPathName()));
+				}
+			}
+		}
+		else
+		{
+			// Other objects (game instance, subsystems, widgets) through the
+			// class hash, so only instances of Class and its subclasses are visited.
+			TArray<UObject*> Instances;
+			GetObjectsOfClass(Class, Instances, true, RF_ClassDefaultObject | RF_ArchetypeObject);
+			for (const UObject* Instance : Instances)
+			{
+				if (Worlds.Contains(Instance->GetWorld()))
+				{
+					Paths.Add(MakeShared<FJsonValueString>(Instance->GetPathName()));
+				}
+			}
+		}
+		Objects->SetArrayField(ClassName, Paths);
+	}
+
+	TSharedRef<FJsonObject> Result = MakeShared<FJsonObject>();
+	Result->SetNumberField(TEXT("worldGeneration"), FPlayUnrealAutomationModule::Get().GetWorldGeneration());
+	Result->SetObjectField(TEXT("objects"), Objects);
+	if (!Unknown.IsEmpty())
+	{
+		Result->SetArrayField(TEXT("unknown"), Unknown);
+	}
+	return Result;
 }
@@ -0,0 +1,286 @@
+// PlayUnrealStreamServer.cpp
+
+#include "PlayUnrealStreamServer.h"
+
+// WebSocketNetworking is only linked with WITH_PLAYUNREAL_AUTOMATION.
+#if WITH_PLAYUNREAL_AUTOMATION
+
+#include "Dom/JsonObject.h"
+#include "INetworkingWebSocket.h"
+#include "IWebSocketNetworkingModule.h"
+#include "IWebSocketServer.h"
+#include "PlayUnrealAsyncResults.h"
+#include "PlayUnrealJson.h"
+#include "WebSocketNetworkingDelegates.h"
+
+FPlayUnrealStreamServer::FPlayUnrealStreamServer(FPlayUnrealAsyncResults& InResults)
+	: Results(InResults)
+{
+}
+
+FPlayUnrealStreamServer::~FPlayUnrealStreamServer()
+{
+	Stop();
+}
+
+bool FPlayUnrealStreamServer::Start(uint32 InPort)
+{
+	Stop();
+
+	IWebSocketNetworkingModule& WebSocketModule =
+		FModuleManager::LoadModuleChecked<IWebSocketNetworkingModule>(TEXT("WebSocketNetworking"));
+
+	FWebSocketClientConnectedCallBack OnConnected;
+	OnConnected.BindRaw(this, &FPlayUnrealStreamServer::OnClientConnected);
+
+	// Loopback only, like the TCP transport: subscriptions can read any
+	// property and call parameterless functions.
+	Server = WebSocketModule.CreateServer();
+	if (!Server.IsValid() || !Server->Init(InPort, OnConnected, TEXT("127.0.0.1")))
+	{
+		UE_LOG(LogTemp, Warning,
+			TEXT("PlayUnreal: Stream server failed to listen on port %u"), InPort);
+		Server.Reset();
+		return false;
+	}
+
+	Port = InPort;
+	TickHandle = FTSTicker::GetCoreTicker().AddTicker(
+		FTickerDelegate::CreateRaw(this, &FPlayUnrealStreamServer::Tick));
+	CompletedHandle = Results.OnCompleted.AddRaw(this, &FPlayUnrealStreamServer::OnOperationCompleted);
+
+	UE_LOG(LogTemp, Log, TEXT("PlayUnreal: Stream server listening on port %u"), Port);
+	return true;
+}
+
+void FPlayUnrealStreamServer::Stop()
+{
+	if (TickHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(TickHandle);
+		TickHandle.Reset();
+	}
+	Results.OnCompleted.Remove(CompletedHandle);
+	CompletedHandle.Reset();
+
+	for (TUniquePtr<FClient>& Client : Clients)
+	{
+		delete Client->Socket;
+	}
+	Clients.Reset();
+	Server.Reset();
+	Port = 0;
+}
+
+bool FPlayUnrealStreamServer::Tick(float DeltaTime)
+{
+	Server->Tick();
+
+	Clients.RemoveAll([](const TUniquePtr<FClient>& Client)
+	{
+		if (Client->bClosed)
+		{
+			delete Client->Socket;
+			return true;
+		}
+		return false;
+	});
+
+	for (TUniquePtr<FClient>& Client : Clients)
+	{
+		for (FSubscription& Subscription : Client->Subscriptions)
+		{
+			TSharedRef<FJsonObject> Changed = Evaluate(Subscription, false);
+			if (Changed->Values.IsEmpty()) continue;
+
+			TSharedRef<FJsonObject> Message = MakeShared<FJsonObject>();
+			Message->SetStringField(TEXT("op"), TEXT("changed"));
+			Message->SetStringField(TEXT("id"), Subscription.Id);
+			Message->SetNumberField(TEXT("frame"), static_cast<double>(GFrameCounter));
+			Message->SetObjectField(TEXT("values"), Changed);
+			Send(*Client, Message);
+		}
+	}
+
+	return true;
+}
+
+void FPlayUnrealStreamServer::OnClientConnected(INetworkingWebSocket* Socket)
+{
+	TUniquePtr<FClient>& Client = Clients.Add_GetRef(MakeUnique<FClient>());
+	Client->Socket = Socket;
+
+	FWebSocketPacketReceivedCallBack OnReceived;
+	OnReceived.BindRaw(this, &FPlayUnrealStreamServer::OnClientMessage, Client.Get());
+	Socket->SetReceiveCallBack(OnReceived);
+
+	FWebSocketInfoCallBack OnClosed;
+	OnClosed.BindRaw(this, &FPlayUnrealStreamServer::OnClientClosed, Client.Get());
+	Socket->SetSocketClosedCallBack(OnClosed);
+
+	UE_LOG(LogTemp, Log, TEXT("PlayUnreal: Stream client connected (%s)"),
+		*Socket->RemoteEndPoint(true));
+}
+
+void FPlayUnrealStreamServer::OnClientMessage(void* Data, int32 Size, FClient* Client)
+{
+	const FUTF8ToTCHAR Converted(static_cast<const ANSICHAR*>(Data), Size);
+	const FString Text(Converted.Length(), Converted.Get());
+
+	TSharedPtr<FJsonObject> Message = PlayUnrealJson::ParseObject(Text);
+	FString Op;
+	if (!Message.IsValid() || !Message->TryGetStringField(TEXT("op"), Op))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("PlayUnreal: Ignoring malformed stream message"));
+		return;
+	}
+
+	if (Op == TEXT("subscribe"))
+	{
+		HandleSubscribe(*Client, Message.ToSharedRef());
+	}
+	else if (Op == TEXT("unsubscribe"))
+	{
+		HandleUnsubscribe(*Client, Message.ToSharedRef());
+	}
+	else if (Op == TEXT("await"))
+	{
+		HandleAwait(*Client, Message.ToSharedRef());
+	}
+	else
+	{
+		UE_LOG(LogTemp, Warning, TEXT("PlayUnreal: Unknown stream op '%s'"), *Op);
+	}
+}
+
+void FPlayUnrealStreamServer::OnClientClosed(FClient* Client)
+{
+	// Sockets cannot be deleted from inside their own callback; Tick reaps them.
+	Client->bClosed = true;
+}
+
+void FPlayUnrealStreamServer::HandleSubscribe(FClient& Client, const TSharedRef<FJsonObject>& Message)
+{
+	FSubscription Subscription;
+	Message->TryGetStringField(TEXT("id"), Subscription.Id);
+
+	const TArray<TSharedPtr<FJsonValue>>* WatchValues = nullptr;
+	if (Message->TryGetArrayField(TEXT("watches"), WatchValues))
+	{
+		for (const TSharedPtr<FJsonValue>& Value : *WatchValues)
+		{
+			const TSharedPtr<FJsonObject>* WatchObject = nullptr;
+			if (!Value.IsValid() || !Value->TryGetObject(WatchObject)) continue;
+
+			FWatch Watch;
+			if (!Watch.Reader.InitFromJson(**WatchObject)) continue;
+			if (!(*WatchObject)->TryGetStringField(TEXT("key"), Watch.Key))
+			{
+				Watch.Key = Watch.Reader.GetMemberName().ToString();
+			}
+			Subscription.Watches.Add(MoveTemp(Watch));
+		}
+	}
+
+	// Replace an existing subscription with the same ID.
+	Client.Subscriptions.RemoveAll([&Subscription](const FSubscription& Existing)
+	{
+		return Existing.Id == Subscription.Id;
+	});
+
+	TSharedRef<FJsonObject> Reply = MakeShared<FJsonObject>();
+	Reply->SetStringField(TEXT("op"), TEXT("subscribed"));
+	Reply->SetStringField(TEXT("id"), Subscription.Id);
+	Reply->SetNumberField(TEXT("frame"), static_cast<double>(GFrameCounter));
+	Reply->SetObjectField(TEXT("values"), Evaluate(Subscription, true));
+	Send(Client, Reply);
+
+	Client.Subscriptions.Add(MoveTemp(Subscription));
+}
+
+void FPlayUnrealStreamServer::HandleUnsubscribe(FClient& Client, const TSharedRef<FJsonObject>& Message)
+{
+	FString Id;
+	Message->TryGetStringField(TEXT("id"), Id);
+	Client.Subscriptions.RemoveAll([&Id](const FSubscription& Existing)
+	{
+		return Existing.Id == Id;
+	});
+}
+
+void FPlayUnrealStreamServer::HandleAwait(FClient& Client, const TSharedRef<FJsonObject>& Message)
+{
+	int32 Handle = INDEX_NONE;
+	Message->TryGetNumberField(TEXT("handle"), Handle);
+
+	if (Results.IsPending(Handle))
+	{
+		Client.AwaitedHandles.Add(Handle);
+		return;
+	}
+
+	// Already finished (or unknown): answer right away.
+	TSharedPtr<FJsonObject> Completed = TakeCompleted(Handle);
+	if (!Completed.IsValid())
+	{
+		Completed = MakeShared<FJsonObject>();
+		Completed->SetStringField(TEXT("op"), TEXT("completed"));
+		Completed->SetNumberField(TEXT("handle"), Handle);
+		Completed->SetStringField(TEXT("status"), TEXT("failed"));
+		Completed->SetStringField(TEXT("error"), FString::Printf(TEXT("Unknown handle %d"), Handle));
+	}
+	Send(Client, Completed.ToSharedRef());
+}
+
+void FPlayUnrealStreamServer::OnOperationCompleted(int32 Handle)
+{
+	TSharedPtr<FJsonObject> Completed;
+	for (TUniquePtr<FClient>& Client : Clients)
+	{
+		if (Client->AwaitedHandles.Remove(Handle) == 0) continue;
+
+		if (!Completed.IsValid())
+		{
+			Completed = TakeCompleted(Handle);
+			if (!Completed.IsValid()) return;
+		}
+		Send(*Client, Completed.ToSharedRef());
+	}
+}
+
+TSharedPtr<FJsonObject> FPlayUnrealStreamServer::TakeCompleted(int32 Handle)
+{
+	TSharedPtr<FJsonObject> Completed = Results.Take(Handle);
+	if (Completed.IsValid())
+	{
+		Completed->SetStringField(TEXT("op"), TEXT("completed"));
+	}
+	return Completed;
+}
+
+TSharedRef<FJsonObject> FPlayUnrealStreamServer::Evaluate(FSubscription& Subscription, bool bAll)
+{
+	TSharedRef<FJsonObject> Values = MakeShared<FJsonObject>();
+	for (FWatch& Watch : Subscription.Watches)
+	{
+		TSharedPtr<FJsonValue> Value = Watch.Reader.Read();
+		const FString Serialized = PlayUnrealJson::ValueToString(Value);
+		if (bAll || !Watch.bHasValue || Serialized != Watch.LastValue)
+		{
+			Values->SetField(Watch.Key, Value.IsValid() ? Value : MakeShared<FJsonValueNull>());
+		}
+		Watch.LastValue = Serialized;
+		Watch.bHasValue = true;
+	}
+	return Values;
+}
+
+void FPlayUnrealStreamServer::Send(FClient& Client, const TSharedRef<FJsonObject>& Message)
+{
+	if (Client.bClosed) return;
+
+	const FTCHARToUTF8 Utf8(*PlayUnrealJson::ToString(Message));
+	Client.Socket->Send(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length(), false);
+}
+
+#endif // WITH_PLAYUNREAL_AUTOMATION
@@ -0,0 +1,107 @@
+// PlayUnrealStreamServer.h
+//
+// WebSocket channel that pushes value changes to subscribed clients, so
+// scripts can wait on game state without polling over Remote Control.
+//
+// Protocol (JSON text messages):
+//
+//   -> {"op": "subscribe", "id": "s1", "watches": [
+//          {"key": "state", "object": "/Game/...GameMode_0", "function": "GetGameStateJSON"},
+//          {"key": "wave",  "object": "/Game/...GameMode_0", "property": "CurrentWave"}]}
+//   <- {"op": "subscribed", "id": "s1", "frame": 1200, "values": {"state": ..., "wave": 1}}
+//   <- {"op": "changed", "id": "s1", "frame": 1207, "values": {"wave": 2}}
+//   -> {"op": "unsubscribe", "id": "s1"}
+//
+//   -> {"op": "await", "handle": 12}
+//   <- {"op": "completed", "handle": 12, "kind": "wait", "status": "done", "result": {...}}
+//
+// Watches are evaluated once per engine frame, so any number of changes
+// within a frame are coalesced into a single "changed" message. Awaited
+// handles (see FPlayUnrealAsyncResults) are pushed as soon as they complete.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "PlayUnrealValueReader.h"
+
+class FJsonObject;
+class FJsonValue;
+class INetworkingWebSocket;
+class IWebSocketServer;
+class FPlayUnrealAsyncResults;
+
+class FPlayUnrealStreamServer
+{
+public:
+	/** Default port; override with -PlayUnrealStreamPort=N. */
+	static constexpr uint32 DefaultPort = 30040;
+
+	explicit FPlayUnrealStreamServer(FPlayUnrealAsyncResults& InResults);
+	~FPlayUnrealStreamServer();
+
+	/** Start listening. Returns false if the port could not be bound. */
+	bool Start(uint32 InPort);
+
+	/** Close every connection and stop listening. */
+	void Stop();
+
+	bool IsRunning() const { return Server.IsValid(); }
+	uint32 GetPort() const { return Port; }
+
+private:
+	/** One watched value: a property read or a parameterless function call. */
+	struct FWatch
+	{
+		FString Key;
+		FPlayUnrealValueReader Reader;
+
+		FString LastValue;
+		bool bHasValue = false;
+	};
+
+	struct FSubscription
+	{
+		FString Id;
+		TArray<FWatch> Watches;
+	};
+
+	struct FClient
+	{
+		INetworkingWebSocket* Socket = nullptr;
+		TArray<FSubscription> Subscriptions;
+		TSet<int32> AwaitedHandles;
+		bool bClosed = false;
+	};
+
+	bool Tick(float DeltaTime);
+
+	void OnClientConnected(INetworkingWebSocket* Socket);
+	void OnClientMessage(void* Data, int32 Size, FClient* Client);
+	void OnClientClosed(FClient* Client);
+
+	void HandleSubscribe(FClient& Client, const TSharedRef<FJsonObject>& Message);
+	void HandleUnsubscribe(FClient& Client, const TSharedRef<FJsonObject>& Message);
+	void HandleAwait(FClient& Client, const TSharedRef<FJsonObject>& Message);
+
+	/** Push a completed async result to every client awaiting it. */
+	void OnOperationCompleted(int32 Handle);
+
+	/** Build a "completed" message; releases the result. Null if unknown. */
+	TSharedPtr<FJsonObject> TakeCompleted(int32 Handle);
+
+	/**
+	 * Evaluate every watch in a subscription. Returns the values that
+	 * changed since the last evaluation (or all values if bAll).
+	 */
+	TSharedRef<FJsonObject> Evaluate(FSubscription& Subscription, bool bAll);
+
+	static void Send(FClient& Client, const TSharedRef<FJsonObject>& Message);
+
+	FPlayUnrealAsyncResults& Results;
+	TUniquePtr<IWebSocketServer> Server;
+	TArray<TUniquePtr<FClient>> Clients;
+	FTSTicker::FDelegateHandle TickHandle;
+	FDelegateHandle CompletedHandle;
+	uint32 Port = 0;
+};
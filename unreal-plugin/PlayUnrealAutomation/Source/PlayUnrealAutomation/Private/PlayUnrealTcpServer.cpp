@@ -0,0 +1,597 @@
+// PlayUnrealTcpServer.cpp
+
+#include "PlayUnrealTcpServer.h"
+
+// Sockets and Networking are only linked with WITH_PLAYUNREAL_AUTOMATION.
+#if WITH_PLAYUNREAL_AUTOMATION
+
+#include "Common/TcpListener.h"
+#include "Common/TcpSocketBuilder.h"
+#include "Dom/JsonObject.h"
+#include "HAL/RunnableThread.h"
+#include "Interfaces/IPv4/IPv4Endpoint.h"
+#include "Misc/Guid.h"
+#include "Misc/ScopeLock.h"
+#include "PlayUnrealAsyncResults.h"
+#include "PlayUnrealAutomationModule.h"
+#include "PlayUnrealDriver.h"
+#include "PlayUnrealJson.h"
+#include "PlayUnrealMetrics.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+
+// ---------------------------------------------------------------------------
+// Connection
+// ---------------------------------------------------------------------------
+
+/** One client socket plus the thread that reads and frames its requests. */
+class FPlayUnrealTcpServer::FConnection
+	: public FRunnable
+	, public TSharedFromThis<FConnection, ESPMode::ThreadSafe>
+{
+public:
+	FConnection(FSocket* InSocket, FString InRemote, TQueue<FRequest, EQueueMode::Mpsc>& InRequests)
+		: SessionId(FGuid::NewGuid().ToString())
+		, Socket(InSocket)
+		, Remote(MoveTemp(InRemote))
+		, Requests(InRequests)
+	{
+	}
+
+	virtual ~FConnection() override
+	{
+		Close();
+	}
+
+	void StartThread()
+	{
+		Thread = FRunnableThread::Create(this, TEXT("PlayUnrealTcpConnection"));
+	}
+
+	/** Stop the reader thread and release the socket. Game thread only. */
+	void Close()
+	{
+		bStopping = true;
+		if (Socket)
+		{
+			// Unblocks the reader's Recv.
+			Socket->Shutdown(ESocketShutdownMode::ReadWrite);
+		}
+		if (Thread)
+		{
+			Thread->WaitForCompletion();
+			delete Thread;
+			Thread = nullptr;
+		}
+		if (Socket)
+		{
+			ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Socket);
+			Socket = nullptr;
+		}
+	}
+
+	bool IsClosed() const { return bClosed; }
+	const FString& GetRemote() const { return Remote; }
+
+	// Session state, touched only on the game thread.
+	const FString SessionId;
+	TWeakObjectPtr<APlayUnrealDriver> SessionDriver;
+	bool bSessionOpen = false;
+	FPlayUnrealMetrics SessionMetrics;
+
+	/** Frame and send one message. Safe to call from any thread. */
+	void Send(const TSharedRef<FJsonObject>& Message)
+	{
+		const FTCHARToUTF8 Utf8(*PlayUnrealJson::ToString(Message));
+		const uint32 Length = Utf8.Length();
+
+		TArray<uint8> Frame;
+		Frame.SetNumUninitialized(4 + Length);
+		Frame[0] = static_cast<uint8>(Length);
+		Frame[1] = static_cast<uint8>(Length >> 8);
+		Frame[2] = static_cast<uint8>(Length >> 16);
+		Frame[3] = static_cast<uint8>(Length >> 24);
+		FMemory::Memcpy(Frame.GetData() + 4, Utf8.Get(), Length);
+
+		FScopeLock SendScope(&SendLock);
+		int32 Offset = 0;
+		while (Socket && !bClosed && Offset < Frame.Num())
+		{
+			int32 Sent = 0;
+			if (!Socket->Send(Frame.GetData() + Offset, Frame.Num() - Offset, Sent) || Sent <= 0)
+			{
+				break;
+			}
+			Offset += Sent;
+		}
+	}
+
+	virtual uint32 Run() override
+	{
+		TArray<uint8> Payload;
+		while (!bStopping)
+		{
+			uint8 Header[4];
+			if (!ReadExact(Header, 4)) break;
+
+			const uint32 Length = Header[0] | (Header[1] << 8) | (Header[2] << 16) | (static_cast<uint32>(Header[3]) << 24);
+			if (Length > MaxFrameBytes)
+			{
+				UE_LOG(LogTemp, Warning, TEXT("PlayUnreal: Closing TCP client %s, frame of %u bytes"), *Remote, Length);
+				break;
+			}
+
+			Payload.SetNumUninitialized(Length);
+			if (!ReadExact(Payload.GetData(), Length)) break;
+
+			Enqueue(Payload);
+		}
+		bClosed = true;
+		return 0;
+	}
+
+private:
+	bool ReadExact(uint8* Data, uint32 Count)
+	{
+		uint32 Offset = 0;
+		while (Offset < Count)
+		{
+			int32 Read = 0;
+			if (!Socket->Recv(Data + Offset, Count - Offset, Read) || Read <= 0)
+			{
+				return false;
+			}
+			Offset += Read;
+		}
+		return true;
+	}
+
+	void Enqueue(const TArray<uint8>& Payload)
+	{
+		const double ArrivalSeconds = FPlatformTime::Seconds();
+		const FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(Payload.GetData()), Payload.Num());
+		TSharedPtr<FJsonObject> Message = PlayUnrealJson::ParseObject(FString(Converted.Length(), Converted.Get()));
+
+		FRequest Request;
+		int64 CancelId = 0;
+		if (Message.IsValid() && Message->TryGetNumberField(TEXT("cancel"), CancelId))
+		{
+			Request.CancelId = CancelId;
+		}
+		if (!Message.IsValid()
+			|| !Message->TryGetNumberField(TEXT("id"), Request.Id)
+			|| (!Request.CancelId.IsSet() && !Message->TryGetStringField(TEXT("method"), Request.Method)))
+		{
+			TSharedRef<FJsonObject> Reply = MakeShared<FJsonObject>();
+			Reply->SetNumberField(TEXT("id"), static_cast<double>(Request.Id));
+			Reply->SetBoolField(TEXT("ok"), false);
+			Reply->SetStringField(TEXT("error"), TEXT("Expected {\"id\": N, \"method\": \"...\", \"params\": {...}}"));
+			Send(Reply);
+			return;
+		}
+
+		const TSharedPtr<FJsonObject>* Params = nullptr;
+		if (Message->TryGetObjectField(TEXT("params"), Params))
+		{
+			Request.Params = *Params;
+		}
+		Message->TryGetNumberField(TEXT("timeout"), Request.TimeoutSeconds);
+		Message->TryGetBoolField(TEXT("await"), Request.bAwait);
+		Request.Connection = AsShared();
+		Request.ArrivalSeconds = ArrivalSeconds;
+		Requests.Enqueue(MoveTemp(Request));
+	}
+
+	FSocket* Socket = nullptr;
+	FString Remote;
+	TQueue<FRequest, EQueueMode::Mpsc>& Requests;
+	FRunnableThread* Thread = nullptr;
+	FCriticalSection SendLock;
+	std::atomic<bool> bStopping { false };
+	std::atomic<bool> bClosed { false };
+};
+
+// ---------------------------------------------------------------------------
+// Server
+// ---------------------------------------------------------------------------
+
+FPlayUnrealTcpServer::FPlayUnrealTcpServer(FPlayUnrealAsyncResults& InResults, FPlayUnrealMetrics& InMetrics)
+	: Results(InResults)
+	, Metrics(InMetrics)
+{
+}
+
+FPlayUnrealTcpServer::~FPlayUnrealTcpServer()
+{
+	Stop();
+}
+
+bool FPlayUnrealTcpServer::Start(uint32 InPort)
+{
+	Stop();
+
+	// Loopback only: the transport can call any BlueprintCallable function.
+	// The socket is bound here rather than by FTcpListener so a busy port
+	// is reported synchronously.
+	const FIPv4Endpoint Endpoint(FIPv4Address::InternalLoopback, static_cast<uint16>(InPort));
+	ListenSocket = FTcpSocketBuilder(TEXT("PlayUnrealTcpServer"))
+		.AsReusable()
+		.BoundToEndpoint(Endpoint)
+		.Listening(8);
+	if (!ListenSocket)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("PlayUnreal: TCP server failed to listen on port %u"), InPort);
+		return false;
+	}
+
+	Listener = MakeUnique<FTcpListener>(*ListenSocket, FTimespan::FromMilliseconds(100));
+	Listener->OnConnectionAccepted().BindRaw(this, &FPlayUnrealTcpServer::OnConnectionAccepted);
+
+	Port = InPort;
+	TickHandle = FTSTicker::GetCoreTicker().AddTicker(
+		FTickerDelegate::CreateRaw(this, &FPlayUnrealTcpServer::Tick));
+	CompletedHandle = Results.OnCompleted.AddRaw(this, &FPlayUnrealTcpServer::OnOperationCompleted);
+
+	UE_LOG(LogTemp, Log, TEXT("PlayUnreal: TCP server listening on port %u"), Port);
+	return true;
+}
+
+void FPlayUnrealTcpServer::Stop()
+{
+	if (TickHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(TickHandle);
+		TickHandle.Reset();
+	}
+	Results.OnCompleted.Remove(CompletedHandle);
+	CompletedHandle.Reset();
+
+	// Stop accepting before tearing down the connections it would add.
+	Listener.Reset();
+	if (ListenSocket)
+	{
+		ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(ListenSocket);
+		ListenSocket = nullptr;
+	}
+
+	TArray<TSharedPtr<FConnection, ESPMode::ThreadSafe>> Closing;
+	{
+		FScopeLock ConnectionsScope(&ConnectionsLock);
+		Closing = MoveTemp(Connections);
+	}
+	for (const FInFlight& Call : InFlight)
+	{
+		Results.Cancel(Call.Handle, TEXT("Transport stopped"));
+		Results.Take(Call.Handle);
+	}
+	InFlight.Reset();
+
+	for (const TSharedPtr<FConnection, ESPMode::ThreadSafe>& Connection : Closing)
+	{
+		Connection->Close();
+	}
+	Requests.Empty();
+	Port = 0;
+}
+
+bool FPlayUnrealTcpServer::OnConnectionAccepted(FSocket* Socket, const FIPv4Endpoint& Endpoint)
+{
+	Socket->SetNonBlocking(false);
+	Socket->SetNoDelay(true);
+
+	TSharedPtr<FConnection, ESPMode::ThreadSafe> Connection =
+		MakeShared<FConnection, ESPMode::ThreadSafe>(Socket, Endpoint.ToString(), Requests);
+	{
+		FScopeLock ConnectionsScope(&ConnectionsLock);
+		Connections.Add(Connection);
+	}
+	Connection->StartThread();
+
+	UE_LOG(LogTemp, Log, TEXT("PlayUnreal: TCP client connected (%s)"), *Connection->GetRemote());
+	return true;
+}
+
+bool FPlayUnrealTcpServer::Tick(float DeltaTime)
+{
+	FRequest Request;
+	while (Requests.Dequeue(Request))
+	{
+		Dispatch(Request);
+	}
+	Request = FRequest();
+
+	const double Now = FPlatformTime::Seconds();
+	for (int32 Index = InFlight.Num() - 1; Index >= 0; --Index)
+	{
+		const bool bGone = InFlight[Index].Connection->IsClosed();
+		if (bGone || (InFlight[Index].Deadline > 0.0 && Now >= InFlight[Index].Deadline))
+		{
+			const FInFlight Call = InFlight[Index];
+			InFlight.RemoveAtSwap(Index);
+			AbortInFlight(Call, bGone ? TEXT("Client disconnected") : TEXT("Timed out"));
+		}
+	}
+
+	// Reader threads of closed connections have already returned.
+	TArray<TSharedPtr<FConnection, ESPMode::ThreadSafe>> Closed;
+	{
+		FScopeLock ConnectionsScope(&ConnectionsLock);
+		for (int32 Index = Connections.Num() - 1; Index >= 0; --Index)
+		{
+			if (Connections[Index]->IsClosed())
+			{
+				Closed.Add(Connections[Index]);
+				Connections.RemoveAtSwap(Index);
+			}
+		}
+	}
+	for (const TSharedPtr<FConnection, ESPMode::ThreadSafe>& Connection : Closed)
+	{
+		UE_LOG(LogTemp, Log, TEXT("PlayUnreal: TCP client disconnected (%s)"), *Connection->GetRemote());
+		Connection->Close();
+	}
+
+	return true;
+}
+
+void FPlayUnrealTcpServer::Dispatch(const FRequest& Request)
+{
+	if (Request.CancelId.IsSet())
+	{
+		HandleCancel(Request);
+		return;
+	}
+
+	if (HandleSessionMethod(Request))
+	{
+		return;
+	}
+
+	FConnection& Connection = *Request.Connection;
+	const FName Method(*Request.Method);
+	const double StartSeconds = FPlatformTime::Seconds();
+	Metrics.RecordQueueDelay(Method, StartSeconds - Request.ArrivalSeconds);
+	Connection.SessionMetrics.RecordQueueDelay(Method, StartSeconds - Request.ArrivalSeconds);
+
+	TSharedPtr<FJsonValue> Result;
+	FString Error;
+	bool bOk = false;
+	if (APlayUnrealDriver* Driver = ResolveDriver(Connection, Error))
+	{
+		bOk = Driver->DispatchCall(Request.Method, Request.Params, Result, Error);
+	}
+	Connection.SessionMetrics.RecordCall(Method, FPlatformTime::Seconds() - StartSeconds);
+
+	// Calls that started an operation return exactly {"handle": N} and are
+	// answered when N completes. GetAsyncResult's reply names a handle too,
+	// but it has already taken the result and must be answered now.
+	const TSharedPtr<FJsonObject>* ResultObject = nullptr;
+	int32 Handle = INDEX_NONE;
+	if (bOk && Request.bAwait && Result.IsValid() && Result->TryGetObject(ResultObject)
+		&& (*ResultObject)->Values.Num() == 1
+		&& (*ResultObject)->TryGetNumberField(TEXT("handle"), Handle))
+	{
+		FInFlight& Call = InFlight.AddDefaulted_GetRef();
+		Call.Connection = Request.Connection;
+		Call.Id = Request.Id;
+		Call.Handle = Handle;
+		Call.Deadline = Request.TimeoutSeconds > 0.0 ? FPlatformTime::Seconds() + Request.TimeoutSeconds : 0.0;
+
+		// The operation may already have finished inside the call.
+		if (!Results.IsPending(Handle))
+		{
+			OnOperationCompleted(Handle);
+		}
+		return;
+	}
+
+	SendReply(*Request.Connection, Request.Id, bOk, Result, Error);
+}
+
+bool FPlayUnrealTcpServer::HandleSessionMethod(const FRequest& Request)
+{
+	FConnection& Connection = *Request.Connection;
+	FString Error;
+
+	if (Request.Method == TEXT("OpenSession"))
+	{
+		FString Selector;
+		if (Request.Params.IsValid())
+		{
+			Request.Params->TryGetStringField(TEXT("world"), Selector);
+		}
+
+		APlayUnrealDriver* Driver = SelectDriver(Selector, Error);
+		if (!Driver)
+		{
+			SendReply(Connection, Request.Id, false, nullptr, Error);
+			return true;
+		}
+		Connection.SessionDriver = Driver;
+		Connection.bSessionOpen = true;
+
+		TSharedRef<FJsonObject> Session = MakeShared<FJsonObject>();
+		Session->SetStringField(TEXT("session"), Connection.SessionId);
+		Session->SetObjectField(TEXT("world"), Driver->DescribeWorld());
+		SendReply(Connection, Request.Id, true, MakeShared<FJsonValueObject>(Session), FString());
+
+		UE_LOG(LogTemp, Log, TEXT("PlayUnreal: Session %s (%s) bound to %s"),
+			*Connection.SessionId, *Connection.GetRemote(), *Driver->GetWorld()->GetName());
+		return true;
+	}
+
+	if (Request.Method == TEXT("ListWorlds"))
+	{
+		TArray<TSharedPtr<FJsonValue>> Worlds;
+		for (APlayUnrealDriver* Driver : FPlayUnrealAutomationModule::Get().GetDrivers())
+		{
+			TSharedRef<FJsonObject> World = Driver->DescribeWorld();
+			World->SetNumberField(TEXT("sessions"), CountSessions(Driver));
+			Worlds.Add(MakeShared<FJsonValueObject>(World));
+		}
+		SendReply(Connection, Request.Id, true, MakeShared<FJsonValueArray>(Worlds), FString());
+		return true;
+	}
+
+	if (Request.Method == TEXT("GetSessionMetrics"))
+	{
+		TSharedRef<FJsonObject> SessionMetrics = Connection.SessionMetrics.ToJson();
+		SessionMetrics->SetStringField(TEXT("session"), Connection.SessionId);
+		SendReply(Connection, Request.Id, true, MakeShared<FJsonValueObject>(SessionMetrics), FString());
+		return true;
+	}
+
+	return false;
+}
+
+APlayUnrealDriver* FPlayUnrealTcpServer::ResolveDriver(FConnection& Connection, FString& OutError) const
+{
+	if (Connection.bSessionOpen)
+	{
+		APlayUnrealDriver* Driver = Connection.SessionDriver.Get();
+		if (!Driver)
+		{
+			OutError = TEXT("The session's world has ended; call OpenSession again");
+		}
+		return Driver;
+	}
+
+	APlayUnrealDriver* Driver = FPlayUnrealAutomationModule::Get().GetActiveDriver();
+	if (!Driver)
+	{
+		OutError = TEXT("No APlayUnrealDriver is in play");
+	}
+	return Driver;
+}
+
+APlayUnrealDriver* FPlayUnrealTcpServer::SelectDriver(const FString& Selector, FString& OutError) const
+{
+	const TArray<APlayUnrealDriver*> Drivers = FPlayUnrealAutomationModule::Get().GetDrivers();
+	if (Drivers.IsEmpty())
+	{
+		OutError = TEXT("No APlayUnrealDriver is in play");
+		return nullptr;
+	}
+
+	if (Selector.IsEmpty() || Selector == TEXT("auto"))
+	{
+		APlayUnrealDriver* Best = nullptr;
+		int32 BestSessions = MAX_int32;
+		for (APlayUnrealDriver* Driver : Drivers)
+		{
+			const int32 Sessions = CountSessions(Driver);
+			if (Sessions < BestSessions)
+			{
+				Best = Driver;
+				BestSessions = Sessions;
+			}
+		}
+		return Best;
+	}
+
+	FString InstanceText = Selector;
+	InstanceText.RemoveFromStart(TEXT("pie:"));
+	const bool bByInstance = InstanceText.IsNumeric();
+	const int32 Instance = bByInstance ? FCString::Atoi(*InstanceText) : INDEX_NONE;
+
+	for (APlayUnrealDriver* Driver : Drivers)
+	{
+		if (bByInstance ? Driver->GetPIEInstance() == Instance
+			: Driver->GetWorld()->GetName() == Selector || Driver->GetPathName() == Selector)
+		{
+			return Driver;
+		}
+	}
+
+	OutError = FString::Printf(TEXT("No driver in a world matching '%s'"), *Selector);
+	return nullptr;
+}
+
+int32 FPlayUnrealTcpServer::CountSessions(const APlayUnrealDriver* Driver) const
+{
+	FScopeLock ConnectionsScope(&ConnectionsLock);
+	int32 Count = 0;
+	for (const TSharedPtr<FConnection, ESPMode::ThreadSafe>& Connection : Connections)
+	{
+		Count += Connection->bSessionOpen && Connection->SessionDriver.Get() == Driver ? 1 : 0;
+	}
+	return Count;
+}
+
+void FPlayUnrealTcpServer::HandleCancel(const FRequest& Request)
+{
+	const int32 Index = InFlight.IndexOfByPredicate([&Request](const FInFlight& Call)
+	{
+		return Call.Connection == Request.Connection && Call.Id == Request.CancelId.GetValue();
+	});
+
+	if (Index != INDEX_NONE)
+	{
+		const FInFlight Call = InFlight[Index];
+		InFlight.RemoveAtSwap(Index);
+		AbortInFlight(Call, TEXT("Cancelled"));
+	}
+
+	TSharedRef<FJsonObject> Cancelled = MakeShared<FJsonObject>();
+	Cancelled->SetBoolField(TEXT("cancelled"), Index != INDEX_NONE);
+	SendReply(*Request.Connection, Request.Id, true, MakeShared<FJsonValueObject>(Cancelled), FString());
+}
+
+void FPlayUnrealTcpServer::OnOperationCompleted(int32 Handle)
+{
+	TSharedPtr<FJsonObject> Completed;
+	for (int32 Index = InFlight.Num() - 1; Index >= 0; --Index)
+	{
+		if (InFlight[Index].Handle != Handle) continue;
+
+		if (!Completed.IsValid())
+		{
+			Completed = Results.Take(Handle);
+			if (!Completed.IsValid())
+			{
+				// Another client (GetAsyncResult, the stream) took the result first.
+				Completed = MakeShared<FJsonObject>();
+				Completed->SetStringField(TEXT("status"), TEXT("failed"));
+				Completed->SetStringField(TEXT("error"), FString::Printf(
+					TEXT("Result of operation %d was already taken"), Handle));
+			}
+		}
+
+		FString Status;
+		Completed->TryGetStringField(TEXT("status"), Status);
+		if (Status == TEXT("pending")) return;
+
+		FString Error;
+		Completed->TryGetStringField(TEXT("error"), Error);
+		SendReply(*InFlight[Index].Connection, InFlight[Index].Id, Status == TEXT("done"),
+			Completed->TryGetField(TEXT("result")), Error);
+		InFlight.RemoveAtSwap(Index);
+	}
+}
+
+void FPlayUnrealTcpServer::AbortInFlight(const FInFlight& Call, const FString& Error)
+{
+	// Already removed from InFlight, so the completion broadcast is a no-op.
+	Results.Cancel(Call.Handle, Error);
+	Results.Take(Call.Handle);
+	SendReply(*Call.Connection, Call.Id, false, nullptr, Error);
+}
+
+void FPlayUnrealTcpServer::SendReply(FConnection& Connection, int64 Id, bool bOk,
+                                     const TSharedPtr<FJsonValue>& Result, const FString& Error)
+{
+	TSharedRef<FJsonObject> Reply = MakeShared<FJsonObject>();
+	Reply->SetNumberField(TEXT("id"), static_cast<double>(Id));
+	Reply->SetBoolField(TEXT("ok"), bOk);
+	if (bOk)
+	{
+		Reply->SetField(TEXT("result"), Result.IsValid() ? Result : MakeShared<FJsonValueNull>());
+	}
+	else
+	{
+		Reply->SetStringField(TEXT("error"), Error);
+	}
+	Connection.Send(Reply);
+}
+
+#endif // WITH_PLAYUNREAL_AUTOMATION
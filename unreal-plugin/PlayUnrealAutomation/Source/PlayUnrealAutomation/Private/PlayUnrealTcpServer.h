@@ -0,0 +1,147 @@
+// PlayUnrealTcpServer.h
+//
+// Persistent TCP transport for driver calls, bypassing the Remote Control
+// HTTP stack. Each message is a little-endian uint32 byte length followed
+// by that many bytes of UTF-8 JSON:
+//
+//   -> {"id": 7, "method": "ClickById", "params": {"Id": "StartButton"}}
+//   <- {"id": 7, "ok": true, "result": true}
+//   <- {"id": 8, "ok": false, "error": "..."}
+//
+// Clients may pipeline: send many requests without waiting, and match the
+// replies by id. Each connection has a reader thread that frames and parses
+// requests; all of them are dispatched to APlayUnrealDriver on the game
+// thread, every request that has arrived being run in the same tick.
+//
+// Calls that start an async operation (screenshots, waits) are held open
+// and answered with the operation's outcome when it completes, so replies
+// can arrive out of order. Such requests accept an optional "timeout" in
+// seconds, "await": false to get the bare {"handle": N} instead, and can be
+// cancelled:
+//
+//   -> {"id": 9, "method": "WaitForCondition", "params": {...}, "timeout": 5}
+//   -> {"id": 10, "cancel": 9}
+//   <- {"id": 9, "ok": false, "error": "Cancelled"}
+//   <- {"id": 10, "ok": true, "result": {"cancelled": true}}
+//
+// Every connection is its own session. Until it calls OpenSession it talks
+// to the most recent driver in play; OpenSession pins it to one world (a
+// PIE instance in multi-client PIE), so parallel test workers can share one
+// editor. Three methods are answered by the transport itself:
+//
+//   OpenSession {"world": "auto" | "pie:N" | world name}  -> {"session", "world"}
+//   ListWorlds {}                                          -> [{"world", "pieInstance", "netMode", "sessions"}]
+//   GetSessionMetrics {}                                   -> GetMetrics shape, this session only
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Queue.h"
+#include "Containers/Ticker.h"
+#include "HAL/Runnable.h"
+
+class APlayUnrealDriver;
+class FJsonObject;
+class FJsonValue;
+class FPlayUnrealAsyncResults;
+class FPlayUnrealMetrics;
+class FRunnableThread;
+class FSocket;
+class FTcpListener;
+struct FIPv4Endpoint;
+
+class FPlayUnrealTcpServer
+{
+public:
+	/** Default port; override with -PlayUnrealTcpPort=N (0 disables). */
+	static constexpr uint32 DefaultPort = 30041;
+
+	/** A frame larger than this closes the connection. */
+	static constexpr uint32 MaxFrameBytes = 64 * 1024 * 1024;
+
+	FPlayUnrealTcpServer(FPlayUnrealAsyncResults& InResults, FPlayUnrealMetrics& InMetrics);
+	~FPlayUnrealTcpServer();
+
+	/** Start listening on localhost. Returns false if the port could not be bound. */
+	bool Start(uint32 InPort);
+
+	/** Close every connection and stop listening. */
+	void Stop();
+
+	bool IsRunning() const { return Listener.IsValid(); }
+	uint32 GetPort() const { return Port; }
+
+private:
+	class FConnection;
+
+	struct FRequest
+	{
+		TSharedPtr<FConnection, ESPMode::ThreadSafe> Connection;
+		int64 Id = 0;
+		FString Method;
+		TSharedPtr<FJsonObject> Params;
+		/** FPlatformTime::Seconds() when the frame was fully read. */
+		double ArrivalSeconds = 0.0;
+		/** Seconds an async call may stay open (0 = no limit). */
+		double TimeoutSeconds = 0.0;
+		/** Hold async calls open until their operation completes. */
+		bool bAwait = true;
+		/** Set for {"cancel": id} requests. */
+		TOptional<int64> CancelId;
+	};
+
+	/** An async call whose reply waits for its operation to complete. */
+	struct FInFlight
+	{
+		TSharedPtr<FConnection, ESPMode::ThreadSafe> Connection;
+		int64 Id = 0;
+		int32 Handle = INDEX_NONE;
+		/** FPlatformTime::Seconds() deadline (0 = none). */
+		double Deadline = 0.0;
+	};
+
+	/** Called on the listener thread. */
+	bool OnConnectionAccepted(FSocket* Socket, const FIPv4Endpoint& Endpoint);
+
+	bool Tick(float DeltaTime);
+	void Dispatch(const FRequest& Request);
+	void HandleCancel(const FRequest& Request);
+
+	/** Answer OpenSession, ListWorlds and GetSessionMetrics. False for other methods. */
+	bool HandleSessionMethod(const FRequest& Request);
+
+	/** The driver a connection's calls go to. */
+	APlayUnrealDriver* ResolveDriver(FConnection& Connection, FString& OutError) const;
+
+	/** Pick a driver for OpenSession; "auto" takes the one with the fewest sessions. */
+	APlayUnrealDriver* SelectDriver(const FString& Selector, FString& OutError) const;
+
+	int32 CountSessions(const APlayUnrealDriver* Driver) const;
+
+	/** Answer in-flight calls waiting on Handle. */
+	void OnOperationCompleted(int32 Handle);
+
+	/** Cancel an in-flight call's operation and answer it with Error. */
+	void AbortInFlight(const FInFlight& Call, const FString& Error);
+
+	static void SendReply(FConnection& Connection, int64 Id, bool bOk,
+	                      const TSharedPtr<FJsonValue>& Result, const FString& Error);
+
+	FPlayUnrealAsyncResults& Results;
+	FPlayUnrealMetrics& Metrics;
+	FSocket* ListenSocket = nullptr;
+	TUniquePtr<FTcpListener> Listener;
+
+	/** Requests framed by reader threads, waiting for the game thread. */
+	TQueue<FRequest, EQueueMode::Mpsc> Requests;
+
+	mutable FCriticalSection ConnectionsLock;
+	TArray<TSharedPtr<FConnection, ESPMode::ThreadSafe>> Connections;
+
+	/** Game thread only. */
+	TArray<FInFlight> InFlight;
+
+	FTSTicker::FDelegateHandle TickHandle;
+	FDelegateHandle CompletedHandle;
+	uint32 Port = 0;
+};
@@ -0,0 +1,63 @@
+// PlayUnrealValueReader.cpp
+
+#include "PlayUnrealValueReader.h"
+#include "Dom/JsonObject.h"
+#include "JsonObjectConverter.h"
+#include "UObject/StructOnScope.h"
+#include "UObject/UObjectGlobals.h"
+
+bool FPlayUnrealValueReader::InitFromJson(const FJsonObject& Description)
+{
+	Description.TryGetStringField(TEXT("object"), ObjectPath);
+
+	FString Member;
+	if (Description.TryGetStringField(TEXT("property"), Member))
+	{
+		PropertyName = FName(*Member);
+	}
+	else if (Description.TryGetStringField(TEXT("function"), Member))
+	{
+		FunctionName = FName(*Member);
+	}
+	return !Member.IsEmpty();
+}
+
+bool FPlayUnrealValueReader::Resolve()
+{
+	if (Object.IsValid()) return true;
+
+	UObject* Found = StaticFindObject(UObject::StaticClass(), nullptr, *ObjectPath);
+	if (!Found) return false;
+
+	Object = Found;
+	Property = PropertyName.IsNone()
+		? nullptr : Found->GetClass()->FindPropertyByName(PropertyName);
+	Function = FunctionName.IsNone()
+		? nullptr : Found->FindFunction(FunctionName);
+	return true;
+}
+
+TSharedPtr<FJsonValue> FPlayUnrealValueReader::Read()
+{
+	if (!Resolve()) return nullptr;
+
+	UObject* Target = Object.Get();
+	if (Property)
+	{
+		return FJsonObjectConverter::UPropertyToJsonValue(
+			Property, Property->ContainerPtrToValuePtr<void>(Target));
+	}
+
+	UFunction* Func = Function.Get();
+	if (!Func) return nullptr;
+
+	// Only parameterless queries can be read; the return value is the value.
+	const FProperty* ReturnProperty = Func->GetReturnProperty();
+	if (!ReturnProperty || Func->NumParms != 1) return nullptr;
+
+	FStructOnScope Params(Func);
+	Target->ProcessEvent(Func, Params.GetStructMemory());
+	return FJsonObjectConverter::UPropertyToJsonValue(
+		const_cast<FProperty*>(ReturnProperty),
+		ReturnProperty->ContainerPtrToValuePtr<void>(Params.GetStructMemory()));
+}
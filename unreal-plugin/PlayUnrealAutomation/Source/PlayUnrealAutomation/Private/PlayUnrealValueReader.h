@@ -0,0 +1,45 @@
+// PlayUnrealValueReader.h
+//
+// Reads a value off a live object by path: either a property or the return
+// value of a parameterless function. The object and member are resolved
+// once and re-resolved only if the object goes away (e.g. level reload).
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtr.h"
+
+class FJsonObject;
+class FJsonValue;
+class UFunction;
+
+class FPlayUnrealValueReader
+{
+public:
+	FPlayUnrealValueReader() = default;
+
+	/**
+	 * Read from a JSON description: {"object": path} plus either
+	 * "property" or "function". Returns false if neither member is given.
+	 */
+	bool InitFromJson(const FJsonObject& Description);
+
+	const FString& GetObjectPath() const { return ObjectPath; }
+
+	/** Name of the property or function being read. */
+	FName GetMemberName() const { return PropertyName.IsNone() ? FunctionName : PropertyName; }
+
+	/** Current value, or null if the object or member cannot be resolved. */
+	TSharedPtr<FJsonValue> Read();
+
+private:
+	bool Resolve();
+
+	FString ObjectPath;
+	FName PropertyName;
+	FName FunctionName;
+
+	TWeakObjectPtr<UObject> Object;
+	FProperty* Property = nullptr;
+	TWeakObjectPtr<UFunction> Function;
+};
@@ -0,0 +1,167 @@
+// PlayUnrealVisibilityTracker.cpp
+
+#include "PlayUnrealVisibilityTracker.h"
+#include "Components/Widget.h"
+#include "Dom/JsonObject.h"
+#include "Engine/Engine.h"
+#include "Engine/GameViewportClient.h"
+#include "Engine/World.h"
+#include "Framework/Application/SlateApplication.h"
+#include "PlayUnrealSelector.h"
+#include "PlayUnrealWidgetRegistry.h"
+#include "UnrealClient.h"
+#include "Widgets/SViewport.h"
+
+FPlayUnrealVisibilityTracker::FPlayUnrealVisibilityTracker(const UWorld* InWorld)
+	: World(InWorld)
+{
+	if (FSlateApplication::IsInitialized())
+	{
+		PostTickHandle = FSlateApplication::Get().OnPostTick().AddRaw(this, &FPlayUnrealVisibilityTracker::OnPostTick);
+	}
+}
+
+FPlayUnrealVisibilityTracker::~FPlayUnrealVisibilityTracker()
+{
+	if (PostTickHandle.IsValid() && FSlateApplication::IsInitialized())
+	{
+		FSlateApplication::Get().OnPostTick().Remove(PostTickHandle);
+	}
+}
+
+int32 FPlayUnrealVisibilityTracker::AddSet(const TArray<FString>& Ids)
+{
+	const int32 SetId = NextSetId++;
+	FSet& Set = Sets.Add(SetId);
+
+	for (const FString& Id : Ids)
+	{
+		if (Set.Ids.Contains(Id)) continue;
+		Set.Ids.Add(Id);
+
+		// New IDs get a state right away so the first report is complete.
+		FTracked& Entry = Tracked.FindOrAdd(Id);
+		if (Entry.RefCount++ == 0)
+		{
+			Entry.State = Compute(Id);
+		}
+	}
+	return SetId;
+}
+
+bool FPlayUnrealVisibilityTracker::RemoveSet(int32 SetId)
+{
+	FSet Set;
+	if (!Sets.RemoveAndCopyValue(SetId, Set)) return false;
+
+	for (const FString& Id : Set.Ids)
+	{
+		FTracked& Entry = Tracked.FindChecked(Id);
+		if (--Entry.RefCount == 0)
+		{
+			Tracked.Remove(Id);
+		}
+	}
+	return true;
+}
+
+TSharedPtr<FJsonObject> FPlayUnrealVisibilityTracker::Report(int32 SetId, bool bChangesOnly)
+{
+	FSet* Set = Sets.Find(SetId);
+	if (!Set) return nullptr;
+
+	TSharedRef<FJsonObject> Widgets = MakeShared<FJsonObject>();
+	for (const FString& Id : Set->Ids)
+	{
+		const FState& Current = Tracked.FindChecked(Id).State;
+		const FState* Reported = Set->Reported.Find(Id);
+		if (bChangesOnly && Reported && *Reported == Current) continue;
+
+		Set->Reported.Add(Id, Current);
+		Widgets->SetObjectField(Id, ToJson(Current));
+	}
+	return Widgets;
+}
+
+bool FPlayUnrealVisibilityTracker::GetCachedVisibility(const FString& Id, bool& bOutVisible) const
+{
+	const FTracked* Entry = Tracked.Find(Id);
+	if (!Entry) return false;
+
+	bOutVisible = Entry->State.bVisible;
+	return true;
+}
+
+void FPlayUnrealVisibilityTracker::OnPostTick(float DeltaTime)
+{
+	Refresh();
+}
+
+void FPlayUnrealVisibilityTracker::Refresh()
+{
+	// Each ID is resolved once per frame, however many sets track it.
+	for (TPair<FString, FTracked>& Pair : Tracked)
+	{
+		Pair.Value.State = Compute(Pair.Key);
+	}
+	Frame = GFrameCounter;
+}
+
+FPlayUnrealVisibilityTracker::FState FPlayUnrealVisibilityTracker::Compute(const FString& Id) const
+{
+	FState State;
+	UPlayUnrealWidgetRegistry* Registry = UPlayUnrealWidgetRegistry::Get(World.Get());
+	const UWidget* Widget = Registry ? Registry->FindFirst(Id, World.Get()) : nullptr;
+	if (!Widget) return State;
+
+	State.bExists = true;
+	State.bVisible = FPlayUnrealSelector::IsEffectivelyVisible(Widget);
+
+	FVector2D Position;
+	FVector2D Size;
+	if (State.bVisible && GetViewportRect(Widget, Position, Size))
+	{
+		State.bHasRect = true;
+		State.Position = FIntPoint(FMath::RoundToInt(Position.X), FMath::RoundToInt(Position.Y));
+		State.Size = FIntPoint(FMath::RoundToInt(Size.X), FMath::RoundToInt(Size.Y));
+	}
+	return State;
+}
+
+TSharedRef<FJsonObject> FPlayUnrealVisibilityTracker::ToJson(const FState& State)
+{
+	TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+	Object->SetBoolField(TEXT("exists"), State.bExists);
+	Object->SetBoolField(TEXT("visible"), State.bVisible);
+	if (State.bHasRect)
+	{
+		TSharedRef<FJsonObject> Rect = MakeShared<FJsonObject>();
+		Rect->SetNumberField(TEXT("x"), State.Position.X);
+		Rect->SetNumberField(TEXT("y"), State.Position.Y);
+		Rect->SetNumberField(TEXT("w"), State.Size.X);
+		Rect->SetNumberField(TEXT("h"), State.Size.Y);
+		Object->SetObjectField(TEXT("rect"), Rect);
+	}
+	return Object;
+}
+
+bool FPlayUnrealVisibilityTracker::GetViewportRect(const UWidget* Widget, FVector2D& OutPosition, FVector2D& OutSize)
+{
+	UGameViewportClient* Viewport = GEngine ? GEngine->GameViewport.Get() : nullptr;
+	TSharedPtr<SViewport> ViewportWidget = Viewport ? Viewport->GetGameViewportWidget() : nullptr;
+	if (!ViewportWidget.IsValid() || !Viewport->Viewport || !Widget->GetCachedWidget().IsValid())
+	{
+		return false;
+	}
+
+	const FGeometry& ViewportGeometry = ViewportWidget->GetCachedGeometry();
+	const FGeometry& Geometry = Widget->GetCachedGeometry();
+	const FIntPoint Pixels = Viewport->Viewport->GetSizeXY();
+	const FVector2D AbsoluteSize = ViewportGeometry.GetAbsoluteSize();
+	const FVector2D Scale = AbsoluteSize.X > 0 && AbsoluteSize.Y > 0
+		? FVector2D(Pixels) / AbsoluteSize : FVector2D(1.0, 1.0);
+
+	OutPosition = (Geometry.GetAbsolutePosition() - ViewportGeometry.GetAbsolutePosition()) * Scale;
+	OutSize = Geometry.GetAbsoluteSize() * Scale;
+	return true;
+}
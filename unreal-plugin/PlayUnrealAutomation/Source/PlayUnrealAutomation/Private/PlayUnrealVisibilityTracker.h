@@ -0,0 +1,97 @@
+// PlayUnrealVisibilityTracker.h
+//
+// Opt-in, per-frame visibility tracking for tagged widgets. Clients register
+// sets of automation IDs; once per frame, after Slate has ticked (prepass and
+// paint done, so geometry is current), the tracker resolves each tracked ID
+// once and records whether it exists, is effectively visible and where it
+// is on screen. Reading a set then only compares cached states against what
+// that set last reported, so polling dozens of widgets per frame costs one
+// tree walk per ID per frame however many times they are asked about.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FJsonObject;
+class UWidget;
+class UWorld;
+
+class FPlayUnrealVisibilityTracker
+{
+public:
+	explicit FPlayUnrealVisibilityTracker(const UWorld* InWorld);
+	~FPlayUnrealVisibilityTracker();
+
+	/** Track a set of automation IDs. Returns the set's ID. */
+	int32 AddSet(const TArray<FString>& Ids);
+
+	/** Stop tracking a set. Returns false if it is unknown. */
+	bool RemoveSet(int32 SetId);
+
+	bool IsEmpty() const { return Sets.IsEmpty(); }
+
+	/**
+	 * States of a set's widgets, keyed by ID, and mark them reported.
+	 *
+	 * @param bChangesOnly  Only IDs whose state differs from the last report.
+	 * @return              Null if the set is unknown.
+	 */
+	TSharedPtr<FJsonObject> Report(int32 SetId, bool bChangesOnly);
+
+	/** Cached visibility of a tracked ID. False if the ID is not tracked. */
+	bool GetCachedVisibility(const FString& Id, bool& bOutVisible) const;
+
+	/** Frame the cached states were taken on. */
+	uint64 GetFrame() const { return Frame; }
+
+	/** Widget bounds in game viewport pixels, from its last painted geometry. */
+	static bool GetViewportRect(const UWidget* Widget, FVector2D& OutPosition, FVector2D& OutSize);
+
+private:
+	struct FState
+	{
+		bool bExists = false;
+		bool bVisible = false;
+		bool bHasRect = false;
+		/** Whole pixels, so sub-pixel layout jitter is not a change. */
+		FIntPoint Position = FIntPoint::ZeroValue;
+		FIntPoint Size = FIntPoint::ZeroValue;
+
+		bool operator==(const FState& Other) const
+		{
+			return bExists == Other.bExists && bVisible == Other.bVisible && bHasRect == Other.bHasRect
+				&& Position == Other.Position && Size == Other.Size;
+		}
+		bool operator!=(const FState& Other) const { return !(*this == Other); }
+	};
+
+	struct FTracked
+	{
+		FState State;
+		/** Number of sets tracking this ID. */
+		int32 RefCount = 0;
+	};
+
+	struct FSet
+	{
+		TArray<FString> Ids;
+		/** What this set last reported; absent IDs have not been reported. */
+		TMap<FString, FState> Reported;
+	};
+
+	void OnPostTick(float DeltaTime);
+
+	void Refresh();
+	FState Compute(const FString& Id) const;
+
+	static TSharedRef<FJsonObject> ToJson(const FState& State);
+
+	TWeakObjectPtr<const UWorld> World;
+
+	TMap<FString, FTracked> Tracked;
+	TMap<int32, FSet> Sets;
+	int32 NextSetId = 1;
+
+	uint64 Frame = 0;
+	FDelegateHandle PostTickHandle;
+};
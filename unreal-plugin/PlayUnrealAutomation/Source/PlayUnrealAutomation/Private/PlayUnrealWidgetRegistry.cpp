@@ -0,0 +1,197 @@
+// PlayUnrealWidgetRegistry.cpp
+
+#include "PlayUnrealWidgetRegistry.h"
+#include "Components/Widget.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/ScopeRWLock.h"
+#include "UObject/UObjectGlobals.h"
+
+UPlayUnrealWidgetRegistry* UPlayUnrealWidgetRegistry::Get(const UObject* Context)
+{
+	const UWorld* World = Context ? Context->GetWorld() : nullptr;
+	const UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+	return GameInstance ? GameInstance->GetSubsystem<UPlayUnrealWidgetRegistry>() : nullptr;
+}
+
+bool UPlayUnrealWidgetRegistry::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return WITH_PLAYUNREAL_AUTOMATION && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UPlayUnrealWidgetRegistry::BindHooks()
+{
+	if (EndFrameHandle.IsValid()) return;
+
+	PostGarbageCollectHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddUObject(
+		this, &UPlayUnrealWidgetRegistry::PruneStale);
+	EndFrameHandle = FCoreDelegates::OnEndFrame.AddUObject(this, &UPlayUnrealWidgetRegistry::OnEndFrame);
+}
+
+void UPlayUnrealWidgetRegistry::Deinitialize()
+{
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGarbageCollectHandle);
+	FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+
+	WidgetsById.Reset();
+	IdsByWidget.Reset();
+	{
+		FWriteScopeLock Lock(SnapshotLock);
+		Snapshot = MakeShared<FSnapshot, ESPMode::ThreadSafe>();
+	}
+	Super::Deinitialize();
+}
+
+void UPlayUnrealWidgetRegistry::Register(UWidget* Widget, const FString& Id)
+{
+	check(IsInGameThread());
+	if (!Widget) return;
+
+	Unregister(Widget);
+	if (Id.IsEmpty()) return;
+
+	const FName Name(*Id);
+	BindHooks();
+	IdsByWidget.Add(Widget, Name);
+	WidgetsById.FindOrAdd(Name).Add(Widget);
+	bSnapshotDirty = true;
+}
+
+void UPlayUnrealWidgetRegistry::Unregister(const UWidget* Widget)
+{
+	check(IsInGameThread());
+
+	FName OldId;
+	if (!IdsByWidget.RemoveAndCopyValue(Widget, OldId)) return;
+	bSnapshotDirty = true;
+
+	if (TArray<TWeakObjectPtr<UWidget>>* Widgets = WidgetsById.Find(OldId))
+	{
+		Widgets->RemoveAllSwap([Widget](const TWeakObjectPtr<UWidget>& Entry)
+		{
+			return Entry.Get() == Widget;
+		});
+		if (Widgets->IsEmpty())
+		{
+			WidgetsById.Remove(OldId);
+		}
+	}
+}
+
+FString UPlayUnrealWidgetRegistry::GetId(const UWidget* Widget) const
+{
+	const FName Name = GetIdName(Widget);
+	return Name.IsNone() ? FString() : Name.ToString();
+}
+
+FName UPlayUnrealWidgetRegistry::GetIdName(const UWidget* Widget) const
+{
+	check(IsInGameThread());
+	if (!Widget) return NAME_None;
+
+	const FName* Found = IdsByWidget.Find(Widget);
+	return Found ? *Found : NAME_None;
+}
+
+const TArray<TWeakObjectPtr<UWidget>>* UPlayUnrealWidgetRegistry::FindWidgets(const FString& Id) const
+{
+	check(IsInGameThread());
+
+	// FNAME_Find: looking up an ID nobody registered must not intern it.
+	const FName Name(*Id, FNAME_Find);
+	return Name.IsNone() ? nullptr : WidgetsById.Find(Name);
+}
+
+UWidget* UPlayUnrealWidgetRegistry::FindFirst(const FString& Id, const UWorld* World) const
+{
+	const TArray<TWeakObjectPtr<UWidget>>* Widgets = FindWidgets(Id);
+	if (!Widgets) return nullptr;
+
+	for (const TWeakObjectPtr<UWidget>& Entry : *Widgets)
+	{
+		UWidget* Widget = Entry.Get();
+		if (Widget && (!World || Widget->GetWorld() == World))
+		{
+			return Widget;
+		}
+	}
+	return nullptr;
+}
+
+void UPlayUnrealWidgetRegistry::FindAll(const FString& Id, TArray<UWidget*>& OutWidgets,
+                                        const UWorld* World) const
+{
+	const TArray<TWeakObjectPtr<UWidget>>* Widgets = FindWidgets(Id);
+	if (!Widgets) return;
+
+	for (const TWeakObjectPtr<UWidget>& Entry : *Widgets)
+	{
+		UWidget* Widget = Entry.Get();
+		if (Widget && (!World || Widget->GetWorld() == World))
+		{
+			OutWidgets.Add(Widget);
+		}
+	}
+}
+
+TSharedRef<const UPlayUnrealWidgetRegistry::FSnapshot, ESPMode::ThreadSafe> UPlayUnrealWidgetRegistry::GetSnapshot() const
+{
+	FReadScopeLock Lock(SnapshotLock);
+	return Snapshot;
+}
+
+TSharedRef<const UPlayUnrealWidgetRegistry::FSnapshot, ESPMode::ThreadSafe> UPlayUnrealWidgetRegistry::PublishSnapshot()
+{
+	check(IsInGameThread());
+	if (!bSnapshotDirty) return GetSnapshot();
+	bSnapshotDirty = false;
+
+	TSharedRef<FSnapshot, ESPMode::ThreadSafe> Next = MakeShared<FSnapshot, ESPMode::ThreadSafe>();
+	Next->WidgetsById = WidgetsById;
+	Next->IdsByWidget.Reserve(IdsByWidget.Num());
+	for (const TPair<TWeakObjectPtr<const UWidget>, FName>& Pair : IdsByWidget)
+	{
+		Next->IdsByWidget.Add(FObjectKey(Pair.Key.Get()), Pair.Value);
+	}
+	Next->Frame = GFrameCounter;
+
+	FWriteScopeLock Lock(SnapshotLock);
+	Snapshot = Next;
+	return Next;
+}
+
+void UPlayUnrealWidgetRegistry::OnEndFrame()
+{
+	PublishSnapshot();
+}
+
+void UPlayUnrealWidgetRegistry::PruneStale()
+{
+	// Collected widgets leave null weak pointers behind, in both maps.
+	int32 Removed = 0;
+	for (auto It = IdsByWidget.CreateIterator(); It; ++It)
+	{
+		if (!It.Key().IsValid())
+		{
+			It.RemoveCurrent();
+			++Removed;
+		}
+	}
+	if (Removed == 0) return;
+
+	for (auto It = WidgetsById.CreateIterator(); It; ++It)
+	{
+		It.Value().RemoveAllSwap([](const TWeakObjectPtr<UWidget>& Entry)
+		{
+			return !Entry.IsValid();
+		});
+		if (It.Value().IsEmpty())
+		{
+			It.RemoveCurrent();
+		}
+	}
+	WidgetsById.Compact();
+	IdsByWidget.Compact();
+	bSnapshotDirty = true;
+}
@@ -0,0 +1,219 @@
+// PlayUnrealWorldSnapshot.cpp
+
+#include "PlayUnrealWorldSnapshot.h"
+#include "Components/PrimitiveComponent.h"
+#include "Dom/JsonObject.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "GameFramework/MovementComponent.h"
+#include "PlayUnrealActorIndex.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/ObjectAndNameAsStringProxyArchive.h"
+#include "UObject/UnrealType.h"
+
+bool FPlayUnrealWorldSnapshot::InitFromJson(const FJsonObject& Query, FString& OutError)
+{
+	FString ClassName;
+	if (Query.TryGetStringField(TEXT("class"), ClassName))
+	{
+		FilterClass = UPlayUnrealActorIndex::ResolveClass(ClassName);
+		if (!FilterClass.IsValid())
+		{
+			OutError = FString::Printf(TEXT("Unknown class '%s'"), *ClassName);
+			return false;
+		}
+	}
+
+	FString Tag;
+	if (Query.TryGetStringField(TEXT("tag"), Tag))
+	{
+		FilterTag = FName(*Tag);
+	}
+
+	if (!FilterClass.IsValid() && FilterTag.IsNone())
+	{
+		OutError = TEXT("Snapshot needs a \"class\" or \"tag\" filter");
+		return false;
+	}
+
+	TArray<FString> Names;
+	if (Query.TryGetStringArrayField(TEXT("properties"), Names))
+	{
+		for (const FString& Name : Names)
+		{
+			PropertyNames.Add(FName(*Name));
+		}
+	}
+
+	Query.TryGetBoolField(TEXT("destroySpawned"), bDestroySpawned);
+	return true;
+}
+
+void FPlayUnrealWorldSnapshot::CollectActors(UWorld* World, TArray<AActor*>& OutActors) const
+{
+	if (UPlayUnrealActorIndex* Index = World ? World->GetSubsystem<UPlayUnrealActorIndex>() : nullptr)
+	{
+		Index->FindMatching(FilterClass.Get(), FilterTag, OutActors);
+	}
+}
+
+const TArray<FProperty*>& FPlayUnrealWorldSnapshot::ResolveProperties(UClass* Class)
+{
+	if (const TArray<FProperty*>* Found = PropertiesByClass.Find(Class))
+	{
+		return *Found;
+	}
+
+	TArray<FProperty*>& Properties = PropertiesByClass.Add(Class);
+	if (PropertyNames.IsEmpty())
+	{
+		for (TFieldIterator<FProperty> It(Class); It; ++It)
+		{
+			if (It->HasAnyPropertyFlags(CPF_SaveGame))
+			{
+				Properties.Add(*It);
+			}
+		}
+	}
+	else
+	{
+		// Names a class does not have are skipped for that class only.
+		for (const FName Name : PropertyNames)
+		{
+			if (FProperty* Property = Class->FindPropertyByName(Name))
+			{
+				Properties.Add(Property);
+			}
+		}
+	}
+	return Properties;
+}
+
+/** Physics velocity when simulating, else the movement component's. */
+static void ReadVelocity(const AActor* Actor, FVector& OutLinear, FVector& OutAngular)
+{
+	const UPrimitiveComponent* Root = Cast<UPrimitiveComponent>(Actor->GetRootComponent());
+	if (Root && Root->IsSimulatingPhysics())
+	{
+		OutLinear = Root->GetPhysicsLinearVelocity();
+		OutAngular = Root->GetPhysicsAngularVelocityInDegrees();
+	}
+	else if (const UMovementComponent* Movement = Actor->FindComponentByClass<UMovementComponent>())
+	{
+		OutLinear = Movement->Velocity;
+	}
+}
+
+static void WriteVelocity(AActor* Actor, const FVector& Linear, const FVector& Angular)
+{
+	UPrimitiveComponent* Root = Cast<UPrimitiveComponent>(Actor->GetRootComponent());
+	if (Root && Root->IsSimulatingPhysics())
+	{
+		Root->SetPhysicsLinearVelocity(Linear);
+		Root->SetPhysicsAngularVelocityInDegrees(Angular);
+	}
+	else if (UMovementComponent* Movement = Actor->FindComponentByClass<UMovementComponent>())
+	{
+		Movement->Velocity = Linear;
+	}
+}
+
+/** Save or load each property of Actor, every element of fixed-size arrays. */
+static void SerializeProperties(FArchive& Archive, AActor* Actor, const TArray<FProperty*>& Properties)
+{
+	for (const FProperty* Property : Properties)
+	{
+		for (int32 Element = 0; Element < Property->ArrayDim; ++Element)
+		{
+			Property->SerializeItem(FStructuredArchiveFromArchive(Archive).GetSlot(),
+				Property->ContainerPtrToValuePtr<void>(Actor, Element), nullptr);
+		}
+	}
+}
+
+void FPlayUnrealWorldSnapshot::Capture(UWorld* World)
+{
+	TArray<AActor*> Matching;
+	CollectActors(World, Matching);
+
+	Actors.Reset(Matching.Num());
+	Data.Reset();
+
+	// Object references are stored by path, so a reference to an actor that
+	// was destroyed in between restores as null instead of dangling.
+	FMemoryWriter Writer(Data);
+	FObjectAndNameAsStringProxyArchive Archive(Writer, false);
+
+	for (AActor* Actor : Matching)
+	{
+		FActorState& State = Actors.AddDefaulted_GetRef();
+		State.Actor = Actor;
+		State.Transform = Actor->GetActorTransform();
+		ReadVelocity(Actor, State.LinearVelocity, State.AngularVelocity);
+
+		State.DataOffset = Data.Num();
+		SerializeProperties(Archive, Actor, ResolveProperties(Actor->GetClass()));
+		State.DataSize = Data.Num() - State.DataOffset;
+	}
+}
+
+TSharedRef<FJsonObject> FPlayUnrealWorldSnapshot::Restore(UWorld* World) const
+{
+	int32 Restored = 0;
+	int32 Missing = 0;
+	int32 Destroyed = 0;
+
+	TSet<const AActor*> Captured;
+	Captured.Reserve(Actors.Num());
+
+	FMemoryReader Reader(Data);
+	FObjectAndNameAsStringProxyArchive Archive(Reader, false);
+
+	for (const FActorState& State : Actors)
+	{
+		AActor* Actor = State.Actor.Get();
+		if (!Actor || Actor->IsActorBeingDestroyed())
+		{
+			++Missing;
+			continue;
+		}
+		Captured.Add(Actor);
+
+		// Teleport so physics does not sweep or carry momentum across.
+		Actor->SetActorTransform(State.Transform, false, nullptr, ETeleportType::ResetPhysics);
+		WriteVelocity(Actor, State.LinearVelocity, State.AngularVelocity);
+
+		Reader.Seek(State.DataOffset);
+		SerializeProperties(Archive, Actor, PropertiesByClass.FindChecked(Actor->GetClass()));
+		check(Reader.Tell() == State.DataOffset + State.DataSize);
+		++Restored;
+	}
+
+	if (bDestroySpawned)
+	{
+		TArray<AActor*> Matching;
+		CollectActors(World, Matching);
+		for (AActor* Actor : Matching)
+		{
+			if (!Captured.Contains(Actor) && Actor->Destroy())
+			{
+				++Destroyed;
+			}
+		}
+	}
+
+	TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+	Object->SetNumberField(TEXT("restored"), Restored);
+	Object->SetNumberField(TEXT("missing"), Missing);
+	Object->SetNumberField(TEXT("destroyed"), Destroyed);
+	return Object;
+}
+
+TSharedRef<FJsonObject> FPlayUnrealWorldSnapshot::Describe() const
+{
+	TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+	Object->SetNumberField(TEXT("actors"), Actors.Num());
+	Object->SetNumberField(TEXT("bytes"), Data.Num());
+	return Object;
+}
@@ -0,0 +1,70 @@
+// PlayUnrealWorldSnapshot.h
+//
+// Warm-start reset for tests: capture the mutable state of a filtered set of
+// actors (transform, velocity and chosen UPROPERTYs) into an in-memory
+// archive, then write it back within one frame instead of reloading the map.
+// Actors destroyed after the capture cannot be brought back.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtr.h"
+
+class AActor;
+class FJsonObject;
+class UWorld;
+
+class FPlayUnrealWorldSnapshot
+{
+public:
+	/**
+	 * Describe the capture from {"class": ..., "tag": ..., "properties":
+	 * [...], "destroySpawned": bool}. At least one of class or tag is
+	 * required. Without "properties", each class's SaveGame properties are
+	 * captured. With "destroySpawned", Restore destroys matching actors
+	 * that did not exist at capture time (projectiles, pickups, ...).
+	 */
+	bool InitFromJson(const FJsonObject& Query, FString& OutError);
+
+	/** Capture the matching actors of World. */
+	void Capture(UWorld* World);
+
+	/**
+	 * Write the captured state back onto the surviving actors.
+	 *
+	 * @return {"restored": N, "missing": N, "destroyed": N}
+	 */
+	TSharedRef<FJsonObject> Restore(UWorld* World) const;
+
+	/** {"actors": N, "bytes": N} */
+	TSharedRef<FJsonObject> Describe() const;
+
+private:
+	struct FActorState
+	{
+		TWeakObjectPtr<AActor> Actor;
+		FTransform Transform;
+		FVector LinearVelocity = FVector::ZeroVector;
+		FVector AngularVelocity = FVector::ZeroVector;
+		/** Byte range of this actor's properties in Data. */
+		int32 DataOffset = 0;
+		int32 DataSize = 0;
+	};
+
+	/** Per-class resolution of the captured properties. */
+	const TArray<FProperty*>& ResolveProperties(UClass* Class);
+
+	void CollectActors(UWorld* World, TArray<AActor*>& OutActors) const;
+
+	TWeakObjectPtr<UClass> FilterClass;
+	FName FilterTag;
+	TArray<FName> PropertyNames;
+	bool bDestroySpawned = false;
+
+	TMap<TWeakObjectPtr<UClass>, TArray<FProperty*>> PropertiesByClass;
+
+	TArray<FActorState> Actors;
+
+	/** Property values of every actor, serialized back to back. */
+	TArray<uint8> Data;
+};
@@ -0,0 +1,112 @@
+// PlayUnrealBenchmarkTests.cpp
+//
+// PlayUnreal.Benchmark.Driver: the driver benchmark (PlayUnrealBenchmark.h)
+// inside a running game, so it also measures screenshot latency. Uses the
+// PIE or game world when there is one, a standalone world otherwise. Takes
+// the same -Actors=/-Iterations=/... options as the commandlet.
+
+#include "CoreMinimal.h"
+#include "Dom/JsonObject.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/CommandLine.h"
+#include "PlayUnrealBenchmark.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	UWorld* FindGameWorld()
+	{
+		if (!GEngine) return nullptr;
+		for (const FWorldContext& Context : GEngine->GetWorldContexts())
+		{
+			if ((Context.WorldType == EWorldType::PIE || Context.WorldType == EWorldType::Game)
+				&& Context.World() && Context.World()->GetGameInstance())
+			{
+				return Context.World();
+			}
+		}
+		return nullptr;
+	}
+
+	/** Ticks the screenshot probe, then writes the results. */
+	class FPlayUnrealScreenshotProbeCommand : public IAutomationLatentCommand
+	{
+	public:
+		FPlayUnrealScreenshotProbeCommand(FAutomationTestBase* InTest, TSharedRef<FJsonObject> InResults,
+		                                  FPlayUnrealBenchmark::FOptions InOptions, UGameInstance* InStandalone)
+			: Test(InTest)
+			, Results(InResults)
+			, Options(MoveTemp(InOptions))
+			, Probe(Options.Screenshots)
+			, Standalone(InStandalone)
+		{
+		}
+
+		virtual bool Update() override
+		{
+			if (!bStarted)
+			{
+				bStarted = true;
+				FString Reason;
+				bProbing = Options.Screenshots > 0 && Probe.Start(Reason);
+				if (!bProbing)
+				{
+					FPlayUnrealBenchmark::AddSkipped(*Results, TEXT("Screenshot"),
+						Options.Screenshots > 0 ? Reason : TEXT("-Screenshots=0"));
+				}
+			}
+			if (bProbing && !Probe.Tick()) return false;
+			if (bProbing)
+			{
+				Probe.AddTo(*Results);
+			}
+
+			if (Standalone)
+			{
+				Standalone->Shutdown();
+				Standalone->RemoveFromRoot();
+			}
+			FString Error;
+			if (!FPlayUnrealBenchmark::Write(*Results, Options.OutputPath, Error))
+			{
+				Test->AddError(Error);
+			}
+			return true;
+		}
+
+	private:
+		FAutomationTestBase* Test;
+		TSharedRef<FJsonObject> Results;
+		FPlayUnrealBenchmark::FOptions Options;
+		FPlayUnrealBenchmark::FScreenshotProbe Probe;
+		UGameInstance* Standalone;
+		bool bStarted = false;
+		bool bProbing = false;
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPlayUnrealBenchmarkDriverTest, "PlayUnreal.Benchmark.Driver",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FPlayUnrealBenchmarkDriverTest::RunTest(const FString& Parameters)
+{
+	FPlayUnrealBenchmark::FOptions Options = FPlayUnrealBenchmark::ParseOptions(FCommandLine::Get());
+
+	UGameInstance* Standalone = nullptr;
+	UWorld* World = FindGameWorld();
+	if (!World)
+	{
+		Standalone = FPlayUnrealBenchmark::CreateStandaloneWorld();
+		World = Standalone->GetWorld();
+	}
+
+	TSharedRef<FJsonObject> Results = FPlayUnrealBenchmark::Run(World, Options);
+	ADD_LATENT_AUTOMATION_COMMAND(FPlayUnrealScreenshotProbeCommand(this, Results, MoveTemp(Options), Standalone));
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,84 @@
+// PlayUnrealActorIndex.h
+//
+// Per-world index of actors by name, label, class and tag.
+// Built lazily on first query, then kept current from the world's
+// actor spawn/destroy events so lookups never scan the whole level.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "PlayUnrealActorIndex.generated.h"
+
+class AActor;
+class ULevel;
+
+UCLASS()
+class PLAYUNREALAUTOMATION_API UPlayUnrealActorIndex : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Not created in builds without WITH_PLAYUNREAL_AUTOMATION; callers handle null. */
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Deinitialize() override;
+
+	/**
+	 * Find an actor by object name or (in editor builds) actor label.
+	 * When several levels hold a match, returns the one TActorIterator
+	 * reaches first.
+	 *
+	 * @param Name  Actor name or label.
+	 * @return      The actor, or null if none matches.
+	 */
+	AActor* FindByName(const FString& Name);
+
+	/** Collect actors that are instances of Class or any subclass. */
+	void FindByClass(const UClass* Class, TArray<AActor*>& OutActors);
+
+	/**
+	 * Collect actors carrying Tag. Tags are indexed when an actor enters
+	 * the world; call MarkDirty() after changing tags at runtime.
+	 */
+	void FindByTag(FName Tag, TArray<AActor*>& OutActors);
+
+	/** Collect actors matching Class (if set) and carrying Tag (if not None). */
+	void FindMatching(const UClass* Class, FName Tag, TArray<AActor*>& OutActors);
+
+	/** Number of live actors currently indexed. */
+	int32 Num();
+
+	/** Drop the index; it is rebuilt on the next query. */
+	void MarkDirty();
+
+	/**
+	 * Resolve a class from a short name ("StaticMeshActor", "BP_Car_C")
+	 * or a full path ("/Script/Engine.StaticMeshActor").
+	 */
+	static UClass* ResolveClass(const FString& ClassName);
+
+private:
+	void EnsureBuilt();
+	void Reset();
+
+	void AddActor(AActor* Actor);
+	void RemoveActor(AActor* Actor);
+
+	void OnActorSpawned(AActor* Actor);
+	void OnActorDestroyed(AActor* Actor);
+	void OnLevelAdded(ULevel* Level, UWorld* World);
+	void OnLevelRemoved(ULevel* Level, UWorld* World);
+
+	bool bBuilt = false;
+
+	/** Names and labels are unique only within a level, so each may map to several actors. */
+	TMultiMap<FName, TWeakObjectPtr<AActor>> ActorsByName;
+	TMultiMap<FString, TWeakObjectPtr<AActor>> ActorsByLabel;
+	TMap<TWeakObjectPtr<UClass>, TSet<TWeakObjectPtr<AActor>>> ActorsByClass;
+	TMap<FName, TSet<TWeakObjectPtr<AActor>>> ActorsByTag;
+
+	FDelegateHandle SpawnedHandle;
+	FDelegateHandle DestroyedHandle;
+	FDelegateHandle LevelAddedHandle;
+	FDelegateHandle LevelRemovedHandle;
+};
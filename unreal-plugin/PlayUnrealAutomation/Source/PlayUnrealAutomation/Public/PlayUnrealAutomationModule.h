@@ -1,12 +1,97 @@
 // PlayUnrealAutomationModule.h
+//
+// Module startup only creates the bookkeeping every driver call needs. The
+// automation subsystems (world tracking, the state stream and TCP
+// transports) start on Activate(): at startup with -PlayUnreal, otherwise
+// on the first client call into the driver or UPlayUnrealStatics. A game
+// that never sees a client pays for nothing else. Builds with
+// WITH_PLAYUNREAL_AUTOMATION=0 (Shipping, see PlayUnrealAutomation.Build.cs)
+// compile out the transports, the driver's call timing and recording,
+// session replay, perf capture and the frame channel, and create neither
+// the widget registry nor the actor index.
 
 #pragma once
 
 #include "Modules/ModuleManager.h"
 
+class APlayUnrealDriver;
+class FPlayUnrealAsyncResults;
+class FPlayUnrealMetrics;
+class FPlayUnrealScheduler;
+class FPlayUnrealScreenCapture;
+class FPlayUnrealStreamServer;
+class FPlayUnrealTcpServer;
+
 class FPlayUnrealAutomationModule : public IModuleInterface
 {
 public:
+	FPlayUnrealAutomationModule();
+	virtual ~FPlayUnrealAutomationModule() override;
+
 	virtual void StartupModule() override;
 	virtual void ShutdownModule() override;
+
+	static FPlayUnrealAutomationModule& Get();
+
+	/**
+	 * Start the automation subsystems if they are not running yet. Cheap to
+	 * call again; does nothing in builds without WITH_PLAYUNREAL_AUTOMATION.
+	 */
+	void Activate();
+
+	/** True once Activate() has started the subsystems. */
+	bool IsActive() const { return bActive; }
+
+	/** Port of the state streaming WebSocket, or 0 if it is not running. */
+	uint32 GetStreamPort() const;
+
+	/** Port of the TCP call transport, or 0 if it is not running. */
+	uint32 GetTcpPort() const;
+
+	/** Drivers register themselves while they are in play. */
+	void RegisterDriver(APlayUnrealDriver* Driver);
+	void UnregisterDriver(APlayUnrealDriver* Driver);
+
+	/** The driver plugin transports dispatch to: the most recent one in play. */
+	APlayUnrealDriver* GetActiveDriver() const;
+
+	/** Every driver in play, oldest first (one per world in multi-client PIE). */
+	TArray<APlayUnrealDriver*> GetDrivers() const;
+
+	/** Handle table for operations that complete after their call returns. */
+	FPlayUnrealAsyncResults& GetAsyncResults();
+
+	/** Per-method call timing for driver UFUNCTIONs. */
+	FPlayUnrealMetrics& GetMetrics();
+
+	/** Screenshot pipeline, created on first use. */
+	FPlayUnrealScreenCapture& GetScreenCapture();
+
+	/** Per-frame budget for deferred driver work. */
+	FPlayUnrealScheduler& GetScheduler();
+
+	/**
+	 * Bumped whenever a game world is initialized or cleaned up, so clients
+	 * caching object paths can tell when they have gone stale.
+	 */
+	uint32 GetWorldGeneration() const { return WorldGeneration; }
+
+private:
+	void OnWorldChanged(UWorld* World);
+
+#if WITH_PLAYUNREAL_AUTOMATION
+	TUniquePtr<FPlayUnrealStreamServer> StreamServer;
+	TUniquePtr<FPlayUnrealTcpServer> TcpServer;
+#endif
+	TUniquePtr<FPlayUnrealAsyncResults> AsyncResults;
+	TUniquePtr<FPlayUnrealMetrics> Metrics;
+	TUniquePtr<FPlayUnrealScreenCapture> ScreenCapture;
+	TUniquePtr<FPlayUnrealScheduler> Scheduler;
+
+	TArray<TWeakObjectPtr<APlayUnrealDriver>> Drivers;
+
+	bool bActive = false;
+	uint32 WorldGeneration = 1;
+	FDelegateHandle WorldInitHandle;
+	FDelegateHandle WorldCleanupHandle;
 };
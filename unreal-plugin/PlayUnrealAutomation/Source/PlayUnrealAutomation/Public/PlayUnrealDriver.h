@@ -12,6 +12,20 @@
 #include "GameFramework/Actor.h"
 #include "PlayUnrealDriver.generated.h"
 
+class FJsonObject;
+class FJsonValue;
+class FPlayUnrealCondition;
+class FPlayUnrealFrameChannel;
+class FPlayUnrealFunctionBinding;
+class FPlayUnrealHopPlanner;
+class FPlayUnrealInputSequence;
+class FPlayUnrealPerfCapture;
+class FPlayUnrealPropertyWatch;
+class FPlayUnrealSessionLogReader;
+class FPlayUnrealSessionLogWriter;
+class FPlayUnrealVisibilityTracker;
+class FPlayUnrealWorldSnapshot;
+
 UCLASS(BlueprintType, Blueprintable)
 class PLAYUNREALAUTOMATION_API APlayUnrealDriver : public AActor
 {
@@ -20,12 +34,100 @@ class PLAYUNREALAUTOMATION_API APlayUnrealDriver : public AActor
 public:
 	APlayUnrealDriver();
 
+	virtual void BeginPlay() override;
+	virtual void Tick(float DeltaSeconds) override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/** Times (and records, see StartRecording) every driver UFUNCTION, however it is invoked. */
+	virtual void ProcessEvent(UFunction* Function, void* Parms) override;
+
+	/**
+	 * Call one of this driver's UFUNCTIONs on behalf of a plugin transport.
+	 * Results are JSON (never MessagePack), and JSON-string return values
+	 * are embedded as values; an {"ok": false} response becomes OutError.
+	 */
+	bool DispatchCall(const FString& Method,
+	                  const TSharedPtr<FJsonObject>& Params,
+	                  TSharedPtr<FJsonValue>& OutResult,
+	                  FString& OutError);
+
+	/** PIE instance of this driver's world, or INDEX_NONE outside PIE. */
+	int32 GetPIEInstance() const;
+
+	/** {"world", "driver", "pieInstance", "netMode"} for session listings. */
+	TSharedRef<FJsonObject> DescribeWorld() const;
+
 	// -- Lifecycle ----------------------------------------------------------
 
 	/** Health check. Returns version and session info as JSON. */
 	UFUNCTION(BlueprintCallable, Category = "PlayUnreal")
 	FString Ping() const;
 
+	/**
+	 * Choose how this driver encodes its responses. "json" (default) or
+	 * "msgpack" when Ping lists it; MessagePack responses are returned as
+	 * "msgpack:<base64>" strings and JSON-string return values of called
+	 * functions are embedded as structured data. Errors are always JSON.
+	 *
+	 * @param Format  "json" or "msgpack".
+	 * @return        {"ok": true, "format": ...} or an error.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "PlayUnreal")
+	FString SetWireFormat(const FString& Format);
+
+	/**
+	 * Per-method timing of driver calls since startup or the last reset:
+	 * count, mean, max and p50/p95/p99 of game-thread execution time, plus
+	 * queue delay where it is known.
+	 *
+	 * @return  {"unit": "ms", "methods": {Name: {...}}, "scheduler": {...}}.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "PlayUnreal")
+	FString GetMetrics() const;
+
+	/**
+	 * Set the game-thread time deferred driver work (QueryWidgetsAsync and
+	 * other sliced queries) may use per frame.
+	 *
+	 * @param Milliseconds  Budget per frame; the default is 2 ms.
+	 * @return              {"budgetMs", "queued", "slices", "frames",
+	 *                      "overruns", "maxFrameMs"}.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "PlayUnreal")
+	FString SetFrameBudget(float Milliseconds);
+
+	/** Clear the timing collected for GetMetrics. */
+	UFUNCTION(BlueprintCallable, Category = "PlayUnreal")
+	void ResetMetrics();
+
+	// -- Performance -------------------------------------------------------
+
+	/**
+	 * Start sampling every frame's timings (frame, game, render, RHI and
+	 * GPU time, draw calls, primitives) and memory high-water marks into a
+	 * ring buffer, for perf gates in scripted scenarios. One capture runs
+	 * at a time.
+	 *
+	 * @param OptionsJSON  {"name", "maxFrames": 36000, "hitchMs": 50,
+	 *                     "csv": true or path, "trace": true or path}.
+	 *                     Paths are relative to Saved/; "trace" starts an
+	 *                     Unreal Insights file trace for the capture.
+	 * @return             {"ok": true, "name": ...} or an error.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "PlayUnreal|Performance")
+	FString BeginPerfCapture(const FString& OptionsJSON);
+
+	/**
+	 * Stop the capture and summarize it.
+	 *
+	 * @return  {"name", "frames", "dropped", "seconds", "hitches", "frame",
+	 *          "game", "render", "rhi", "gpu" ({"mean", "p50", "p90", "p95",
+	 *          "p99", "max"} in ms), "drawCalls", "primitives", "memory",
+	 *          "csv"?, "trace"?}, or an error if no capture is running.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "PlayUnreal|Performance")
+	FString EndPerfCapture();
+
 	// -- UMG Widget Interaction --------------------------------------------
 
 	/**
@@ -33,14 +135,20 @@ public:
 	 * The ID is set via UWidget::SetAutomationId() or
 	 * UPlayUnrealStatics::SetAutomationId().
 	 *
-	 * @param Id  The automation ID string.
+	 * Enabled, visible buttons are clicked through OnClicked. Other
+	 * widgets get a mouse click through Slate at the centre of their
+	 * painted geometry (down now, up next frame), so they must be on
+	 * screen.
+	 *
+	 * @param Id  The automation ID string, or a selector (see QueryWidgets);
+	 *            the first match is clicked.
 	 * @return    True if the widget was found and clicked.
 	 */
 	UFUNCTION(BlueprintCallable, Category = "PlayUnreal|Input")
 	bool ClickById(const FString& Id);
 
 	/**
-	 * Type text into the currently focused widget.
+	 * Type text into the currently focused widget, as Slate char events.
 	 *
 	 * @param Text  The text to type.
 	 * @return      True if the text was sent successfully.
@@ -49,20 +157,34 @@ public:
 	bool TypeText(const FString& Text);
 
 	/**
-	 * Simulate a key press.
+	 * Simulate a key press through Slate: down now, up on the next frame.
 	 *
-	 * @param KeyChord  Key name (e.g., "Escape", "Enter", "SpaceBar").
-	 * @return          True if the key was pressed.
+	 * @param KeyChord  Key name with optional modifiers (e.g., "Escape",
+	 *                  "SpaceBar", "Ctrl+Shift+S").
+	 * @return          True if the key is known and was pressed.
 	 */
 	UFUNCTION(BlueprintCallable, Category = "PlayUnreal|Input")
 	bool PressKey(const FString& KeyChord);
 
+	/**
+	 * Inject a timed sequence of key, char and mouse events through Slate,
+	 * scheduled on frame offsets from this call. See
+	 * PlayUnrealInputSequence.h for the event format.
+	 *
+	 * @param EventsJSON  JSON array of events.
+	 * @return            {"handle": N}; completes with frame, frames and
+	 *                    events once the last event is dispatched.
+	 *                    Cancelling releases any keys still held.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "PlayUnreal|Input")
+	FString SendInput(const FString& EventsJSON);
+
 	// -- Widget Queries ----------------------------------------------------
 
 	/**
 	 * Check if a widget with the given Automation ID exists.
 	 *
-	 * @param Id  The automation ID string.
+	 * @param Id  The automation ID string, or a selector.
 	 * @return    True if found.
 	 */
 	UFUNCTION(BlueprintCallable, Category = "PlayUnreal|Query")
@@ -71,24 +193,149 @@ public:
 	/**
 	 * Check if a widget is visible (exists and has Visible or SelfHitTestInvisible visibility).
 	 *
-	 * @param Id  The automation ID string.
+	 * @param Id  The automation ID string, or a selector.
 	 * @return    True if visible.
 	 */
 	UFUNCTION(BlueprintCallable, Category = "PlayUnreal|Query")
 	bool IsVisible(const FString& Id) const;
 
+	/**
+	 * Find every widget matching a selector, in one call. Selectors combine
+	 * class, automation ID, name, text and visibility with descendant and
+	 * child steps (see PlayUnrealSelector.h), and are compiled once and
+	 * cached, so polling the same selector is cheap.
+	 *
+	 * @param Selector  e.g. "MainMenu_C > Button:visible", "id=StartButton",
+	 *                  "path=Menu/Buttons/Start", TextBlock[text*="Score"].
+	 * @param Limit     Stop after this many matches (0 = all).
+	 * @return          {"count": N, "widgets": [{id, name, class, path,
+	 *                  visible, text, rect}]}; rect is in viewport pixels.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "PlayUnreal|Query")
+	FString QueryWidgets(const FString& Selector, int32 Limit = 0) const;
+
+	/**
+	 * QueryWidgets spread over frames within the frame budget (see
+	 * SetFrameBudget), one root widget tree at a time, with the response
+	 * built on a task worker. Use it for scans of large UIs while frame
+	 * timing is being measured.
+	 *
+	 * @return  {"handle": N}; completes with the QueryWidgets response
+	 *          plus "frames", the number of frames the scan spanned.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "PlayUnreal|Query")
+	FString QueryWidgetsAsync(const FString& Selector, int32 Limit = 0);
+
+	/**
+	 * Track the visibility and on-screen rect of a set of automation IDs.
+	 * Each tracked ID is resolved once per frame after Slate ticks, and
+	 * IsVisible answers tracked IDs from that cache.
+	 *
+	 * @param IdsJSON  JSON array of automation IDs.
+	 * @return         {"tracker": N, "frame": F, "widgets": {id: {exists,
+	 *                 visible, rect}}} with every ID's current state.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "PlayUnreal|Query")
+	FString TrackVisibility(const FString& IdsJSON);
+
+	/**
+	 * States that changed since the tracker last reported.
+	 *
+	 * @param Tracker  ID returned by TrackVisibility.
+	 * @return         {"frame": F, "widgets": {id: {exists, visible, rect}}};
+	 *                 unchanged IDs are omitted.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "PlayUnreal|Query")
+	FString GetVisibilityChanges(int32 Tracker);
+
+	/**
+	 * Stop tracking a set. The per-frame work stops with the last set.
+	 *
+	 * @return  False if the tracker is unknown.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "PlayUnreal|Query")
+	bool UntrackVisibility(int32 Tracker);
+
 	// -- Evidence ----------------------------------------------------------
 
 	/**
 	 * Take a screenshot and save to the given path.
 	 * Path is relative to the project's Saved/ directory.
+	 * The file is written asynchronously; use CaptureScreenshot to await it.
 	 *
 	 * @param Path  Output file path (e.g., "Screenshots/test.png").
-	 * @return      Absolute path of the saved file, or empty on failure.
+	 * @return      Absolute path the file will be saved to, or empty on failure.
 	 */
 	UFUNCTION(BlueprintCallable, Category = "PlayUnreal|Evidence")
 	FString Screenshot(const FString& Path);
 
+	/**
+	 * Capture the next presented frame without blocking the game or
+	 * render thread. Readback, encoding and file I/O happen off-thread.
+	 *
+	 * OptionsJSON fields (all optional):
+	 *   "path":    output path relative to Saved/ (omit to return bytes inline)
+	 *   "format":  "png" (default) or "jpeg"
+	 *   "quality": JPEG quality 1-100 (default 85)
+	 *
+	 * For bursts, send several CaptureScreenshot calls in one ExecuteBatch
+	 * with frame offsets.
+	 *
+	 * @param OptionsJSON  Capture options.
+	 * @return             {"handle": N}; collect with GetAsyncResult.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "PlayUnreal|Evidence")
+	FString CaptureScreenshot(const FString& OptionsJSON);
+
+	/**
+	 * Publish presented game frames as raw BGRA8 pixels into a named
+	 * shared-memory ring (layout in PlayUnrealFrameChannel.h), for pixel
+	 * assertions at frame rate from a local client. One channel at a time.
+	 *
+	 * OptionsJSON fields (all optional):
+	 *   "name":      shared-memory name (default PlayUnrealFrames-<pid>)
+	 *   "slots":     ring length, 2-16 (default 3)
+	 *   "downscale": keep every Nth pixel, 1-8 (default 1)
+	 *   "everyNth":  publish every Nth frame (default 1)
+	 *   "crop":      {"x", "y", "w", "h"} in window pixels (default the game viewport)
+	 *   "widget":    automation ID or selector whose geometry is followed
+	 *
+	 * @return  {"name", "bytes", "slots", "slotBytes", "maxWidth",
+	 *          "maxHeight", "format": "bgra8"} or an error.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "PlayUnreal|Evidence")
+	FString OpenFrameChannel(const FString& OptionsJSON);
+
+	/**
+	 * Stop publishing and release the shared memory.
+	 *
+	 * @return  {"frames": published, "skipped": N}, or an error if no
+	 *          channel is open.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "PlayUnreal|Evidence")
+	FString CloseFrameChannel();
+
+	/**
+	 * Collect the outcome of an asynchronous operation.
+	 *
+	 * @param Handle  Handle returned by an asynchronous call.
+	 * @return        {"handle", "kind", "status"} plus "result" when status is
+	 *                "done" or "error" when "failed". Completed handles are
+	 *                released once read.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "PlayUnreal")
+	FString GetAsyncResult(int32 Handle);
+
+	/**
+	 * Cancel a pending async operation; it completes as failed with
+	 * "Cancelled" and its own result is discarded.
+	 *
+	 * @param Handle  Handle returned by the call that started it.
+	 * @return        True if the operation was still pending.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "PlayUnreal")
+	bool CancelAsync(int32 Handle);
+
 	// -- World Queries -----------------------------------------------------
 
 	/**
@@ -100,29 +347,330 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "PlayUnreal|World")
 	FString FindActorByName(const FString& Name) const;
 
+	/**
+	 * Find all actors of a class (including subclasses).
+	 *
+	 * @param ClassName  Short class name ("StaticMeshActor", "BP_Car") or full path.
+	 * @return           JSON array of object paths.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "PlayUnreal|World")
+	FString FindActorsByClass(const FString& ClassName) const;
+
+	/**
+	 * Find all actors carrying an actor tag.
+	 *
+	 * @param Tag  Actor tag name.
+	 * @return     JSON array of object paths.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "PlayUnreal|World")
+	FString FindActorsByTag(const FString& Tag) const;
+
+	/**
+	 * Live instances of several classes in this driver's world, in one call.
+	 * See UPlayUnrealStatics::ResolveObjects, which searches every game
+	 * world and needs no driver path.
+	 *
+	 * @param ClassNames  Short class names or full class paths.
+	 * @return            {"worldGeneration": G, "objects": {"Class": [paths]}}.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "PlayUnreal|World")
+	FString ResolveObjects(const TArray<FString>& ClassNames) const;
+
+	/**
+	 * Capture a filtered set of actors in one pass as a struct-of-arrays
+	 * buffer: one little-endian float32 column per field.
+	 *
+	 * @param QueryJSON  {"class", "tag", "fields": [...], "paths": bool,
+	 *                   "async": bool}.
+	 * @return           {"frame", "time", "count", "fields", "layout", "data"}.
+	 *                   With "async", {"handle": N}: the capture is taken
+	 *                   now and encoded on a task worker.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "PlayUnreal|World")
+	FString SnapshotActors(const FString& QueryJSON) const;
+
 	/**
 	 * Call a UFUNCTION on an arbitrary object by path.
+	 * The object and function are resolved once and cached, so repeated
+	 * calls only convert parameters.
 	 *
 	 * @param ObjectPath    UE object path.
 	 * @param FunctionName  Name of the BlueprintCallable function.
 	 * @param ParamsJSON    JSON string of parameters.
-	 * @return              JSON string of the return value.
+	 * @return              {"ReturnValue": ..., <out params>}, as Remote Control returns.
 	 */
 	UFUNCTION(BlueprintCallable, Category = "PlayUnreal|World")
 	FString CallFunction(const FString& ObjectPath,
 	                     const FString& FunctionName,
 	                     const FString& ParamsJSON);
 
+	/**
+	 * Resolve an object path and function once and return a binding ID
+	 * for CallBinding.
+	 *
+	 * @param ObjectPath    UE object path.
+	 * @param FunctionName  Name of the BlueprintCallable function.
+	 * @return              {"binding": N, "params": [{"name", "type", "out"}]}.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "PlayUnreal|World")
+	FString BindFunction(const FString& ObjectPath, const FString& FunctionName);
+
+	/**
+	 * Call a function bound with BindFunction.
+	 *
+	 * @param Binding     Binding ID.
+	 * @param ParamsJSON  JSON string of parameters.
+	 * @return            Same shape as CallFunction.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "PlayUnreal|World")
+	FString CallBinding(int32 Binding, const FString& ParamsJSON);
+
+	/**
+	 * Release a binding made by BindFunction.
+	 *
+	 * @param Binding  Binding ID.
+	 * @return         True if the binding existed.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "PlayUnreal|World")
+	bool ReleaseBinding(int32 Binding);
+
+	// -- World State -------------------------------------------------------
+
+	/**
+	 * Capture the mutable state of a filtered set of actors in memory, for
+	 * a warm-start reset with RestoreWorld instead of a level reload.
+	 *
+	 * @param QueryJSON  {"class": ..., "tag": ..., "properties": [...],
+	 *                   "destroySpawned": bool}. At least one of class or
+	 *                   tag; without properties, SaveGame ones are captured.
+	 * @return           {"snapshot": N, "actors": N, "bytes": N}
+	 */
+	UFUNCTION(BlueprintCallable, Category = "PlayUnreal|World")
+	FString SnapshotWorld(const FString& QueryJSON);
+
+	/**
+	 * Write a snapshot back within this frame: transforms, velocities and
+	 * the captured properties. The snapshot stays usable for later resets.
+	 *
+	 * @param Snapshot  ID from SnapshotWorld.
+	 * @return          {"restored": N, "missing": N, "destroyed": N}
+	 */
+	UFUNCTION(BlueprintCallable, Category = "PlayUnreal|World")
+	FString RestoreWorld(int32 Snapshot);
+
+	/**
+	 * Free a snapshot made by SnapshotWorld.
+	 *
+	 * @param Snapshot  Snapshot ID.
+	 * @return          True if the snapshot existed.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "PlayUnreal|World")
+	bool ReleaseSnapshot(int32 Snapshot);
+
+	/**
+	 * Watch a set of properties. Each property is resolved once, and
+	 * compared against a copy of its last value every frame, so reading the
+	 * set costs no reflection lookups.
+	 *
+	 * @param WatchJSON  [{"object": path, "property": name, "key": name}];
+	 *                   "key" defaults to the property name.
+	 * @return           {"watch": N, "frame": F, "values": {key: value}} with
+	 *                   every current value (null while unresolved).
+	 */
+	UFUNCTION(BlueprintCallable, Category = "PlayUnreal|World")
+	FString WatchProperties(const FString& WatchJSON);
+
+	/**
+	 * Read a watch set.
+	 *
+	 * @param Watch         ID returned by WatchProperties.
+	 * @param bChangesOnly  Only values that changed in any frame since the
+	 *                      set was last read.
+	 * @return              {"frame": F, "values": {key: value}}.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "PlayUnreal|World")
+	FString GetWatchedValues(int32 Watch, bool bChangesOnly = false);
+
+	/**
+	 * Stop watching a set.
+	 *
+	 * @return  False if the watch is unknown.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "PlayUnreal|World")
+	bool UnwatchProperties(int32 Watch);
+
 	// -- Timing ------------------------------------------------------------
 
 	/**
-	 * Wait for the given number of seconds (game time).
-	 * Useful for sequencing actions from external scripts.
+	 * Wait for the given number of seconds of game time.
+	 * Pause and time dilation are respected.
 	 *
 	 * @param Seconds  Duration to wait.
+	 * @return         {"handle": N}; collect with GetAsyncResult or await
+	 *                 it on the state stream.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "PlayUnreal")
+	FString WaitForSeconds(float Seconds);
+
+	/**
+	 * Wait for the given number of engine frames.
+	 *
+	 * @param Frames  Number of frames to wait.
+	 * @return        {"handle": N}, as WaitForSeconds.
 	 */
 	UFUNCTION(BlueprintCallable, Category = "PlayUnreal")
-	void WaitForSeconds(float Seconds);
+	FString WaitForFrames(int32 Frames);
+
+	/**
+	 * Wait until a property or query on an object matches, checked
+	 * once per frame.
+	 *
+	 * ConditionJSON: {"object": path, "property"|"function": name,
+	 * "field": optional key, "op": "eq"|"ne"|"lt"|"le"|"gt"|"ge"|"contains"|"exists",
+	 * "value": expected, "timeout": seconds (default 30)}. The timeout is
+	 * wall-clock time, or game time while a fixed timestep is set.
+	 *
+	 * @param ConditionJSON  Condition to wait for.
+	 * @return               {"handle": N}, as WaitForSeconds.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "PlayUnreal")
+	FString WaitForCondition(const FString& ConditionJSON);
+
+	/**
+	 * Wait until the world's game time reaches an absolute value. With a
+	 * fixed timestep this runs the simulation as fast as the machine can.
+	 *
+	 * @param GameSeconds  Target UWorld::GetTimeSeconds().
+	 * @return             {"handle": N}, as WaitForSeconds.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "PlayUnreal")
+	FString RunUntil(double GameSeconds);
+
+	/**
+	 * Switch the engine to a fixed delta time and unthrottled ticking, for
+	 * simulation faster than real time with reproducible frame timing.
+	 * Engine-wide; restored when disabled or when this driver leaves play.
+	 *
+	 * OptionsJSON: {"enabled": bool (default true), "fps": steps per game
+	 * second (default 60), "render": bool (default true; false skips world
+	 * rendering)}.
+	 *
+	 * @param OptionsJSON  Options; "{}" enables 60 Hz stepping.
+	 * @return             {"fixed": bool, "deltaSeconds": N, "render": bool}
+	 */
+	UFUNCTION(BlueprintCallable, Category = "PlayUnreal")
+	FString SetFixedTimestep(const FString& OptionsJSON);
+
+	// -- Batching ----------------------------------------------------------
+
+	/**
+	 * Run an ordered list of driver calls in a single round trip.
+	 *
+	 * CommandsJSON is either an array of commands or an object of the form
+	 * {"commands": [...], "stopOnError": true}. Each command looks like
+	 * {"method": "ClickById", "params": {"Id": "StartButton"}, "frame": 0}.
+	 * "frame" is an optional offset from the frame the batch arrived on;
+	 * commands run in order, each no earlier than its offset.
+	 *
+	 * A command fails if the method cannot be dispatched or if it returns
+	 * a bool false. With stopOnError, the remaining commands are skipped.
+	 *
+	 * @param CommandsJSON  JSON batch description.
+	 * @return              {"batch": N, "complete": bool, "results": [...]}.
+	 *                      Incomplete batches are collected with GetBatchResults.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "PlayUnreal|Batch")
+	FString ExecuteBatch(const FString& CommandsJSON);
+
+	/**
+	 * Fetch the results of a batch that had commands on later frames.
+	 * Completed batches are released once fetched.
+	 *
+	 * @param BatchId  The "batch" value returned by ExecuteBatch.
+	 * @return         Same shape as ExecuteBatch, or an error if unknown.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "PlayUnreal|Batch")
+	FString GetBatchResults(int32 BatchId);
+
+	// -- Recording ---------------------------------------------------------
+
+	/**
+	 * Record every driver call that arrives from a client, with its frame,
+	 * parameters and result, to an append-only log (see
+	 * PlayUnrealSessionLog.h). Calls the driver makes itself (batch
+	 * commands, replays) are not recorded. Replaces any running recording.
+	 * -PlayUnrealRecord=Path starts one when the driver begins play.
+	 *
+	 * @param Path  Relative to Saved/, or empty for
+	 *              PlayUnreal/Sessions/<timestamp>.pulog.
+	 * @return      {"ok": true, "path": full path} or an error.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "PlayUnreal|Recording")
+	FString StartRecording(const FString& Path);
+
+	/**
+	 * Finish the running recording.
+	 *
+	 * @return  {"path", "commands", "bytes"}, or an error if none is running.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "PlayUnreal|Recording")
+	FString StopRecording();
+
+	/**
+	 * Replay a recorded session in this world, each call on its recorded
+	 * frame offset, on a fixed timestep and as fast as the engine can step.
+	 * Results are compared with the recorded ones; handle, tracker,
+	 * binding, snapshot and batch IDs are mapped to the replay's own.
+	 * -PlayUnrealReplay=Path starts a replay when the driver begins play,
+	 * and -PlayUnrealReplayExit quits when it is done (exit code 1 on
+	 * mismatches).
+	 *
+	 * OptionsJSON: {"path": relative to Saved/, "fps": steps per second
+	 * (default: the recording's timestep, else 60), "render": bool (default
+	 * false), "stopOnMismatch": bool (default false), "ignore": methods
+	 * whose results are not compared (default ["Ping", "GetMetrics"])}.
+	 *
+	 * @param OptionsJSON  Replay options.
+	 * @return             {"handle": N}; completes with commands, frames,
+	 *                     seconds, mismatchCount and the first mismatches.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "PlayUnreal|Recording")
+	FString ReplaySession(const FString& OptionsJSON);
+
+	// -- Planning ----------------------------------------------------------
+
+	/**
+	 * Drive a grid-hopping pawn across hazard lanes to a goal, deciding
+	 * each hop in the engine from this frame's hazards (see
+	 * PlayUnrealHopPlanner.h). Replaces a navigation already running.
+	 *
+	 * GoalJSON: {"targetCol": 6, "targetRow": 14, "maxDeaths": 8,
+	 * "timeout": game seconds (120), "pawn": path (default player 0's pawn),
+	 * "hop": {"function": "RequestHop", "param": "Direction"},
+	 * "hazards": {"class" or "tag" (default tag "Hazard"), "speed",
+	 * "width" (cells), "movesRight", "rideable": property names},
+	 * "grid": {"cellSize": 100, "cols": 13, "originX": 0, "originY": 0},
+	 * "hopDuration": 0.15, "settle": 0.04, "capsuleRadius": 34,
+	 * "safetyMargin": 80, "platformInset": 44,
+	 * "while": condition to hop under (e.g. the game is playing),
+	 * "until": condition that also counts as reaching the goal}.
+	 * Conditions use the WaitForCondition format.
+	 *
+	 * @param GoalJSON  Goal and game description; "{}" uses the defaults.
+	 * @return          {"handle": N}; completes with the final status or
+	 *                  fails with the reason. CancelAsync stops it.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "PlayUnreal|Planning")
+	FString NavigateTo(const FString& GoalJSON);
+
+	/**
+	 * Progress of the current or last NavigateTo.
+	 *
+	 * @return  {"status", "col", "row", "targetCol", "targetRow", "hops",
+	 *          "deaths", "decisions", "lastDecision", "hazards", "frames"}.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "PlayUnreal|Planning")
+	FString GetNavigationStatus() const;
 
 protected:
 	/** Plugin version string. */
@@ -132,4 +680,199 @@ protected:
 	/** Session identifier (generated on construction). */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "PlayUnreal")
 	FString SessionId;
+
+private:
+	/** A single command inside an ExecuteBatch request. */
+	struct FBatchCommand
+	{
+		FString Method;
+		/** BindFunction ID to call instead of a driver method (INDEX_NONE if unset). */
+		int32 Binding = INDEX_NONE;
+		TSharedPtr<FJsonObject> Params;
+		uint64 FrameOffset = 0;
+	};
+
+	/** An ExecuteBatch request, possibly waiting on later frames. */
+	struct FBatch
+	{
+		TArray<FBatchCommand> Commands;
+		TArray<TSharedPtr<FJsonValue>> Results;
+		int32 NextCommand = 0;
+		uint64 StartFrame = 0;
+		double StartTime = 0.0;
+		bool bStopOnError = false;
+		bool bFailed = false;
+
+		bool IsComplete() const { return bFailed || NextCommand >= Commands.Num(); }
+	};
+
+	/** A latent wait started by one of the WaitFor* calls. */
+	struct FLatentWait
+	{
+		int32 Handle = INDEX_NONE;
+		uint64 StartFrame = 0;
+		double StartTime = 0.0;
+
+		/** Complete once GFrameCounter reaches this (0 = no frame target). */
+		uint64 TargetFrame = 0;
+		/** Complete once world time reaches this (negative = no time target). */
+		double TargetTime = -1.0;
+
+		/** Complete once this holds; fails at Deadline. */
+		TSharedPtr<FPlayUnrealCondition> Condition;
+		double Deadline = 0.0;
+		/** Deadline is in world time rather than wall-clock time. */
+		bool bGameTimeDeadline = false;
+	};
+
+	/** An input sequence with events left on later frames. */
+	struct FPendingInput
+	{
+		/** Async handle, or INDEX_NONE for PressKey's own key up. */
+		int32 Handle = INDEX_NONE;
+		TSharedPtr<FPlayUnrealInputSequence> Sequence;
+	};
+
+	/** Dispatch due events. Returns true when the sequence is finished or cancelled. */
+	bool AdvanceInput(FPendingInput& Input);
+
+	/** A ReplaySession in progress. */
+	struct FReplay
+	{
+		TSharedPtr<FPlayUnrealSessionLogReader> Reader;
+		int32 Handle = INDEX_NONE;
+		uint64 StartFrame = 0;
+		double StartTime = 0.0;
+		bool bStopOnMismatch = false;
+		/** Quit the engine when done (-PlayUnrealReplayExit). */
+		bool bExitWhenDone = false;
+		TSet<FName> Ignored;
+
+		int32 MismatchCount = 0;
+		TArray<TSharedPtr<FJsonValue>> Mismatches;
+
+		/** Recorded ID -> replayed ID, per result field ("handle", ...). */
+		TMap<FString, TMap<int32, int32>> Ids;
+	};
+
+	/** Run the replay's calls that are due. Returns true when it is done. */
+	bool AdvanceReplay(FReplay& Active);
+
+	/** Complete the replay's handle and put the timing back. */
+	void FinishReplay(const FString& Error = FString());
+
+	/** Run one NavigateTo decision and complete its handle when it ends. */
+	void AdvanceHopPlanner();
+
+	/** Engine timing in effect before SetFixedTimestep. */
+	struct FSavedTimeStep
+	{
+		bool bUseFixedTimeStep = false;
+		double FixedDeltaTime = 0.0;
+		bool bDisableWorldRendering = false;
+		int32 VSync = 0;
+	};
+
+	/** Put back the timing SetFixedTimestep replaced, if any. */
+	void RestoreTimeStep();
+
+	/** Register a wait and return its {"handle": N} response. */
+	FString StartWait(FLatentWait&& Wait);
+
+	/** Complete the wait if its target is reached. Returns true when done. */
+	bool AdvanceWait(FLatentWait& Wait);
+
+	/** Run queued commands of a batch whose frame offset has been reached. */
+	void AdvanceBatch(FBatch& Batch);
+
+	/** Serialize a batch to the ExecuteBatch response shape. */
+	FString BatchToResponse(int32 BatchId, const FBatch& Batch) const;
+
+	/**
+	 * Invoke one of this driver's BlueprintCallable functions by name,
+	 * filling parameters from JSON and converting the return value.
+	 */
+	bool InvokeDriverFunction(const FString& Method,
+	                          const TSharedPtr<FJsonObject>& Params,
+	                          TSharedPtr<FJsonValue>& OutResult,
+	                          FString& OutError);
+
+	/** Find or create the cached binding for an object path and function. */
+	TSharedPtr<FPlayUnrealFunctionBinding> FindOrBind(const FString& ObjectPath,
+	                                                  const FString& FunctionName,
+	                                                  int32& OutBindingId,
+	                                                  FString& OutError);
+
+	/** Invoke a binding and serialize its outputs (or the error). */
+	FString InvokeBinding(FPlayUnrealFunctionBinding& Binding, const FString& ParamsJSON) const;
+
+	/** Invoke a binding, post-processing its outputs for the wire format. */
+	bool InvokeBindingOutputs(FPlayUnrealFunctionBinding& Binding,
+	                          const TSharedPtr<FJsonObject>& Params,
+	                          TSharedPtr<FJsonObject>& OutOutputs,
+	                          FString& OutError) const;
+
+	/** Encode a successful response in the negotiated wire format. */
+	FString Encode(const TSharedRef<FJsonObject>& Object) const;
+
+	enum class EWireFormat : uint8
+	{
+		Json,
+		MessagePack,
+	};
+
+	EWireFormat WireFormat = EWireFormat::Json;
+
+	/** Batches that are still running or waiting to be fetched. */
+	TMap<int32, FBatch> Batches;
+
+	int32 NextBatchId = 1;
+
+	/** Waits that have not completed yet. */
+	TArray<FLatentWait> Waits;
+
+	/** Input sequences that have not finished yet. */
+	TArray<FPendingInput> Inputs;
+
+	/** Bindings by ID, and IDs by "ObjectPath::FunctionName". */
+	TMap<int32, TSharedPtr<FPlayUnrealFunctionBinding>> Bindings;
+	TMap<FString, int32> BindingIds;
+	int32 NextBindingId = 1;
+
+	/** Bindings of this driver's own functions, used by ExecuteBatch. */
+	TMap<FName, TSharedPtr<FPlayUnrealFunctionBinding>> DriverBindings;
+
+	/** Set while this driver has the engine on a fixed timestep. */
+	TOptional<FSavedTimeStep> SavedTimeStep;
+
+	/** World snapshots by ID. */
+	TMap<int32, TSharedPtr<FPlayUnrealWorldSnapshot>> WorldSnapshots;
+	int32 NextSnapshotId = 1;
+
+	/** Property watch sets by ID, sampled every frame from Tick. */
+	TMap<int32, TSharedPtr<FPlayUnrealPropertyWatch>> PropertyWatches;
+	int32 NextWatchId = 1;
+
+	/** Created by the first TrackVisibility, dropped with its last set. */
+	TSharedPtr<FPlayUnrealVisibilityTracker> VisibilityTracker;
+
+	/** Set while StartRecording is in effect. */
+	TSharedPtr<FPlayUnrealSessionLogWriter> Recorder;
+	uint64 RecordStartFrame = 0;
+
+	/** Set while ReplaySession is running. */
+	TSharedPtr<FReplay> Replay;
+
+	/** The current or last NavigateTo, and its handle while it runs. */
+	TSharedPtr<FPlayUnrealHopPlanner> HopPlanner;
+	int32 HopPlannerHandle = INDEX_NONE;
+
+	/** Set between BeginPerfCapture and EndPerfCapture. */
+	TSharedPtr<FPlayUnrealPerfCapture> PerfCapture;
+
+	/** Set between OpenFrameChannel and CloseFrameChannel. */
+	TSharedPtr<FPlayUnrealFrameChannel> FrameChannel;
+
+	/** Driver calls in progress; only the outermost is recorded. */
+	int32 CallDepth = 0;
 };
@@ -10,6 +10,9 @@
 #include "Components/Widget.h"
 #include "PlayUnrealStatics.generated.h"
 
+class FJsonObject;
+class UWorld;
+
 UCLASS()
 class PLAYUNREALAUTOMATION_API UPlayUnrealStatics : public UBlueprintFunctionLibrary
 {
@@ -37,4 +40,27 @@ public:
 	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "PlayUnreal",
 	          meta = (DisplayName = "Get Automation ID"))
 	static FString GetAutomationId(const UWidget* Widget);
+
+	/**
+	 * Find the live instances of each class in every game world, in one
+	 * pass. Callable over Remote Control on this class's CDO
+	 * (/Script/PlayUnrealAutomation.Default__PlayUnrealStatics), so clients
+	 * can find the driver and game objects without guessing paths.
+	 *
+	 * @param ClassNames  Short class names ("FrogCharacter", "BP_Car_C") or
+	 *                    full class paths.
+	 * @return            JSON {"worldGeneration": G, "objects": {"Class":
+	 *                    [paths]}, "unknown": [names]}. Cached paths stay
+	 *                    valid while worldGeneration is unchanged.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "PlayUnreal")
+	static FString ResolveObjects(const TArray<FString>& ClassNames);
+
+	/**
+	 * ResolveObjects as a JSON object, for callers that encode it themselves.
+	 *
+	 * @param World  Only search this world (null = every game world).
+	 */
+	static TSharedRef<FJsonObject> ResolveObjectsToJson(const TArray<FString>& ClassNames,
+	                                                    UWorld* World = nullptr);
 };
@@ -0,0 +1,126 @@
+// PlayUnrealWidgetRegistry.h
+//
+// Bidirectional index of widgets tagged with automation IDs.
+// UPlayUnrealStatics::SetAutomationId() feeds it; the driver queries it so
+// ID lookups do not have to walk every widget tree.
+//
+// There is one registry per game instance, so each PIE instance has its own
+// and its entries go away with it. IDs are interned as FName (which, like
+// every FName, compares case-insensitively). Entries for destroyed widgets
+// are dropped after each garbage collection, so the maps do not grow over
+// long soak runs.
+//
+// The maps themselves are game-thread only. Other threads read an immutable
+// snapshot, republished at the end of any frame that changed the registry,
+// or earlier by a game-thread caller about to hand work to another thread.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "PlayUnrealWidgetRegistry.generated.h"
+
+class UWidget;
+class UWorld;
+
+UCLASS()
+class PLAYUNREALAUTOMATION_API UPlayUnrealWidgetRegistry : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Read-only copy of the registry for off-game-thread queries. */
+	struct FSnapshot
+	{
+		/** ID -> widgets. Resolve the pointers on the game thread only. */
+		TMap<FName, TArray<TWeakObjectPtr<UWidget>>> WidgetsById;
+		/** Widget -> ID. */
+		TMap<FObjectKey, FName> IdsByWidget;
+		/** GFrameCounter when it was taken. */
+		uint64 Frame = 0;
+
+		/** Returns the automation ID of a widget, or empty if not tagged. */
+		FString GetId(const FObjectKey& Widget) const
+		{
+			const FName* Found = IdsByWidget.Find(Widget);
+			return Found ? Found->ToString() : FString();
+		}
+	};
+
+	/**
+	 * Returns the registry of the game instance Context belongs to, or null
+	 * if it has none (e.g. an editor world).
+	 */
+	static UPlayUnrealWidgetRegistry* Get(const UObject* Context);
+
+	/** Not created in builds without WITH_PLAYUNREAL_AUTOMATION, so Get() returns null. */
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Deinitialize() override;
+
+	/**
+	 * Tag a widget with an automation ID, replacing any previous ID.
+	 * An empty ID removes the widget from the registry.
+	 */
+	void Register(UWidget* Widget, const FString& Id);
+
+	/** Remove a widget from the registry. */
+	void Unregister(const UWidget* Widget);
+
+	/** Returns the automation ID of a widget, or empty if not tagged. */
+	FString GetId(const UWidget* Widget) const;
+
+	/** Returns the automation ID of a widget, or NAME_None if not tagged. */
+	FName GetIdName(const UWidget* Widget) const;
+
+	/**
+	 * Find the first live widget with the given ID.
+	 *
+	 * @param Id     The automation ID string.
+	 * @param World  If set, only widgets belonging to this world match.
+	 * @return       The widget, or null if none is registered.
+	 */
+	UWidget* FindFirst(const FString& Id, const UWorld* World = nullptr) const;
+
+	/** Collect every live widget with the given ID. */
+	void FindAll(const FString& Id, TArray<UWidget*>& OutWidgets,
+	             const UWorld* World = nullptr) const;
+
+	/** The latest published snapshot. Safe to call from any thread. */
+	TSharedRef<const FSnapshot, ESPMode::ThreadSafe> GetSnapshot() const;
+
+	/**
+	 * Publish this frame's changes now rather than at the end of the frame,
+	 * and return the result. Game thread only.
+	 */
+	TSharedRef<const FSnapshot, ESPMode::ThreadSafe> PublishSnapshot();
+
+private:
+	/** Start pruning and publishing; deferred until the first widget is tagged. */
+	void BindHooks();
+
+	/** Drop entries whose widgets were collected. */
+	void PruneStale();
+
+	/** Republish the snapshot if anything changed this frame. */
+	void OnEndFrame();
+
+	const TArray<TWeakObjectPtr<UWidget>>* FindWidgets(const FString& Id) const;
+
+	/** ID -> widgets. Several widgets may share an ID (e.g. list rows). */
+	TMap<FName, TArray<TWeakObjectPtr<UWidget>>> WidgetsById;
+
+	/** Widget -> ID. */
+	TMap<TWeakObjectPtr<const UWidget>, FName> IdsByWidget;
+
+	/** Set when the maps differ from the published snapshot. */
+	bool bSnapshotDirty = false;
+
+	/** Writers hold the lock only to swap the pointer, never to rebuild. */
+	TSharedRef<const FSnapshot, ESPMode::ThreadSafe> Snapshot = MakeShared<FSnapshot, ESPMode::ThreadSafe>();
+	mutable FRWLock SnapshotLock;
+
+	FDelegateHandle PostGarbageCollectHandle;
+	FDelegateHandle EndFrameHandle;
+};